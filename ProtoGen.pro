@@ -14,6 +14,9 @@ macx{
 
 CONFIG += c++1z
 
+# Required xml files are loaded in background threads
+CONFIG += thread
+
 SOURCES += main.cpp \
     prebuiltSources/floatspecial.c \
     protocolfloatspecial.cpp \
@@ -33,6 +36,14 @@ SOURCES += main.cpp \
     protocolcode.cpp \
     protocolbitfield.cpp \
     protocoldocumentation.cpp \
+    protocolcache.cpp \
+    protocolarena.cpp \
+    codeemitter.cpp \
+    attributeindex.cpp \
+    protocolprofiler.cpp \
+    protocolbench.cpp \
+    protocolfieldmap.cpp \
+    protocolfieldhash.cpp \
     tinyxml/tinyxml2.cpp
 
 HEADERS += \
@@ -54,6 +65,14 @@ HEADERS += \
     protocolcode.h \
     protocolbitfield.h \
     protocoldocumentation.h \
+    protocolcache.h \
+    protocolarena.h \
+    codeemitter.h \
+    attributeindex.h \
+    protocolprofiler.h \
+    protocolbench.h \
+    protocolfieldmap.h \
+    protocolfieldhash.h \
     tinyxml/tinyxml2.h
 
 RESOURCES +=
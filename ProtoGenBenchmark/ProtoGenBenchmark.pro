@@ -0,0 +1,13 @@
+TARGET = ProtoGenBenchmark
+TEMPLATE = app
+
+CONFIG   += console
+CONFIG   -= app_bundle
+CONFIG   -= qt
+
+CONFIG += c++1z
+
+SOURCES += main.cpp
+
+OTHER_FILES += \
+    baselines.txt
@@ -0,0 +1,530 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+/*!
+ * The shape of one synthetic protocol. Every packet has the same layout, so
+ * the number of fields grows linearly with the number of packets, and the
+ * time to generate the protocol should too.
+ */
+typedef struct
+{
+    std::string name;   //!< Name of the benchmark case
+    int packets;        //!< Number of packets
+    int fields;         //!< Number of plain fields in each packet
+    int depth;          //!< Nesting depth of the structure in each packet
+    int enums;          //!< Number of global enumerations
+    int bitfields;      //!< Number of bitfields in each packet
+    int arrays;         //!< Number of variable length arrays in each packet
+    int files;          //!< Number of files the packets are shared between, 0 for one file per packet
+}SyntheticCase;
+
+//! Result of running ProtoGen on one synthetic protocol
+typedef struct
+{
+    std::string name;       //!< Name of the benchmark case
+    int64_t fields;         //!< Number of fields in the protocol
+    double seconds;         //!< Wall time of ProtoGen
+    double fieldsPerSecond; //!< Throughput of ProtoGen
+    int64_t peakKB;         //!< Peak resident memory of ProtoGen, 0 if unknown
+}BenchmarkResult;
+
+static int64_t writeProtocol(const std::string& fileName, const SyntheticCase& shape);
+static bool runProtoGen(const std::string& protogen, const std::string& xml, const std::string& outputPath, double& seconds, int64_t& peakKB);
+static bool readBaselines(const std::string& fileName, std::vector<BenchmarkResult>& baselines);
+static bool writeBaselines(const std::string& fileName, const std::vector<BenchmarkResult>& results);
+static const BenchmarkResult* findResult(const std::vector<BenchmarkResult>& results, const std::string& name);
+static void makeDirectory(const std::string& path);
+static std::string liststartsWith(const std::vector<std::string>& list, const std::string& key);
+static bool contains(const std::vector<std::string>& list, const std::string& key);
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> arguments;
+    std::vector<std::string> positional;
+
+    for(int i = 1; i < argc; i++)
+    {
+        std::string argument(argv[i]);
+
+        if(argument.empty())
+            continue;
+
+        if(argument.at(0) == '-')
+        {
+            // Arguments with a value can be "-key=value" or "-key value"
+            if((argument.find('=') == std::string::npos) && (i+1 < argc) && (argv[i+1][0] != '-') &&
+               ((argument == "-baseline") || (argument == "-scale") || (argument == "-tolerance") || (argument == "-output")))
+            {
+                argument += "=" + std::string(argv[++i]);
+            }
+
+            arguments.push_back(argument);
+        }
+        else
+            positional.push_back(argument);
+    }
+
+    if(positional.empty() || contains(arguments, "-help") || contains(arguments, "-?"))
+    {
+        std::cout << "Protocol generator throughput benchmark.\n\n";
+        std::cout << "Synthesizes protocols with increasing numbers of packets, each with\n";
+        std::cout << "nested structures, enumerations, bitfields, variable length arrays, and\n";
+        std::cout << "shared files, runs ProtoGen on each, and reports the throughput and peak\n";
+        std::cout << "memory. The throughput of each case relative to the smallest case is\n";
+        std::cout << "compared to the baselines, which catches super-linear regressions on any\n";
+        std::cout << "machine. Absolute throughput is only reported.\n\n";
+        std::cout << "usage: ProtoGenBenchmark path/to/ProtoGen [options]\n\n";
+        std::cout << "-output=path     Directory for the synthetic protocols and generated code.\n";
+        std::cout << "-baseline=file   Baselines to compare against, default baselines.txt.\n";
+        std::cout << "-update          Write the results to the baseline file instead of comparing.\n";
+        std::cout << "-scale=n         Multiply the number of packets in each case by n.\n";
+        std::cout << "-tolerance=n     Allowed fractional drop in relative throughput, default 0.25.\n";
+        return 0;
+    }
+
+    std::string protogen = positional.at(0);
+
+    std::string outputPath = liststartsWith(arguments, "-output=");
+    if(outputPath.empty())
+        outputPath = "benchmark";
+
+    std::string baselineFile = liststartsWith(arguments, "-baseline=");
+    if(baselineFile.empty())
+        baselineFile = "baselines.txt";
+
+    int scale = 1;
+    std::string text = liststartsWith(arguments, "-scale=");
+    if(!text.empty())
+        scale = std::max(1, std::atoi(text.c_str()));
+
+    double tolerance = 0.25;
+    text = liststartsWith(arguments, "-tolerance=");
+    if(!text.empty())
+        tolerance = std::atof(text.c_str());
+
+    // Each case doubles the previous, the layout of the packets is the same
+    std::vector<SyntheticCase> cases;
+    cases.push_back({"small",   25*scale, 12, 2, 4, 6, 2, 8});
+    cases.push_back({"medium",  50*scale, 12, 2, 4, 6, 2, 8});
+    cases.push_back({"large",  100*scale, 12, 2, 4, 6, 2, 8});
+    cases.push_back({"huge",   200*scale, 12, 2, 4, 6, 2, 8});
+
+    makeDirectory(outputPath);
+
+    std::vector<BenchmarkResult> results;
+
+    std::cout << std::left << std::setw(10) << "Case" << std::setw(10) << "Fields" << std::setw(12) << "Time (s)"
+              << std::setw(14) << "Fields/s" << std::setw(12) << "Relative" << "Peak memory (MB)" << std::endl;
+
+    for(std::size_t i = 0; i < cases.size(); i++)
+    {
+        const SyntheticCase& shape = cases.at(i);
+
+        std::string casePath = outputPath + "/" + shape.name;
+        makeDirectory(casePath);
+
+        std::string xml = casePath + "/" + shape.name + ".xml";
+
+        BenchmarkResult result;
+        result.name = shape.name;
+        result.fields = writeProtocol(xml, shape);
+
+        if(result.fields <= 0)
+        {
+            std::cerr << "Failed to write " << xml << std::endl;
+            return 2;
+        }
+
+        if(!runProtoGen(protogen, xml, casePath + "/code/", result.seconds, result.peakKB))
+        {
+            std::cerr << "ProtoGen failed on " << xml << std::endl;
+            return 2;
+        }
+
+        result.fieldsPerSecond = result.fields/std::max(result.seconds, 1e-6);
+        results.push_back(result);
+
+        std::cout << std::setw(10) << result.name
+                  << std::setw(10) << result.fields
+                  << std::setw(12) << std::fixed << std::setprecision(3) << result.seconds
+                  << std::setw(14) << std::setprecision(0) << result.fieldsPerSecond
+                  << std::setw(12) << std::setprecision(2) << result.fieldsPerSecond/results.front().fieldsPerSecond
+                  << std::setprecision(1) << result.peakKB/1024.0 << std::endl;
+    }
+
+    if(contains(arguments, "-update"))
+    {
+        if(!writeBaselines(baselineFile, results))
+        {
+            std::cerr << "Failed to write " << baselineFile << std::endl;
+            return 2;
+        }
+
+        std::cout << "Baselines written to " << baselineFile << std::endl;
+        return 0;
+    }
+
+    std::vector<BenchmarkResult> baselines;
+    if(!readBaselines(baselineFile, baselines) || baselines.empty())
+    {
+        std::cout << "No baselines in " << baselineFile << ", use -update to create them" << std::endl;
+        return 0;
+    }
+
+    const BenchmarkResult* first = findResult(baselines, results.front().name);
+    if(first == nullptr)
+    {
+        std::cout << "Baselines do not include the " << results.front().name << " case, use -update to recreate them" << std::endl;
+        return 0;
+    }
+
+    // Absolute throughput depends on the machine, but the throughput of each
+    // case relative to the first should not, unless the generator has become
+    // super-linear. Memory per field is also compared, with the same tolerance.
+    int regressions = 0;
+    for(std::size_t i = 1; i < results.size(); i++)
+    {
+        const BenchmarkResult& result = results.at(i);
+        const BenchmarkResult* baseline = findResult(baselines, result.name);
+
+        if(baseline == nullptr)
+            continue;
+
+        double relative = result.fieldsPerSecond/results.front().fieldsPerSecond;
+        double expected = baseline->fieldsPerSecond/first->fieldsPerSecond;
+
+        if(relative < expected*(1.0 - tolerance))
+        {
+            std::cout << result.name << ": relative throughput " << std::setprecision(2) << relative << " is below the baseline of " << expected << std::endl;
+            regressions++;
+        }
+
+        if((result.peakKB > 0) && (baseline->peakKB > 0) && (baseline->fields > 0))
+        {
+            double perField = (double)result.peakKB/result.fields;
+            double expectedPerField = (double)baseline->peakKB/baseline->fields;
+
+            if(perField > expectedPerField*(1.0 + tolerance))
+            {
+                std::cout << result.name << ": peak memory per field " << std::setprecision(3) << perField << "KB is above the baseline of " << expectedPerField << "KB" << std::endl;
+                regressions++;
+            }
+        }
+    }
+
+    if(regressions > 0)
+    {
+        std::cout << regressions << " regression(s) against " << baselineFile << std::endl;
+        return 1;
+    }
+
+    std::cout << "No regressions against " << baselineFile << std::endl;
+    return 0;
+
+}// main
+
+
+/*!
+ * Write a synthetic protocol. The packets are spread across the shared files
+ * in turn. Each packet has plain fields with a mix of encodings and scaling,
+ * enumerated fields, a bitfield group, variable length arrays with their
+ * count fields, and a chain of nested structures.
+ * \param fileName is the name of the xml file to write.
+ * \param shape describes the protocol.
+ * \return the number of fields in the protocol, or 0 if the file could not be written.
+ */
+int64_t writeProtocol(const std::string& fileName, const SyntheticCase& shape)
+{
+    std::ofstream file(fileName, std::ios_base::out | std::ios_base::trunc);
+
+    if(!file.is_open())
+        return 0;
+
+    int64_t fields = 0;
+
+    file << "<?xml version=\"1.0\"?>\n";
+    file << "<Protocol name=\"Synthetic\" prefix=\"\" api=\"1\" version=\"1.0\" endian=\"big\" supportBool=\"true\" supportLongBitfield=\"true\" comment=\"Synthetic protocol with " << shape.packets << " packets\">\n\n";
+
+    file << "    <Enum name=\"packetIds\" comment=\"Packet identifiers\">\n";
+    for(int p = 0; p < shape.packets; p++)
+        file << "        <Value name=\"PKT_" << p << "\" comment=\"Identifier of packet " << p << "\"/>\n";
+    file << "    </Enum>\n\n";
+
+    for(int e = 0; e < shape.enums; e++)
+    {
+        file << "    <Enum name=\"Mode" << e << "\" file=\"SyntheticEnums\" comment=\"Global enumeration " << e << "\">\n";
+        for(int v = 0; v < 8; v++)
+            file << "        <Value name=\"MODE" << e << "_" << v << "\" comment=\"Mode " << v << "\"/>\n";
+        file << "        <Value name=\"NUM_MODE" << e << "\"/>\n";
+        file << "    </Enum>\n\n";
+    }
+
+    for(int p = 0; p < shape.packets; p++)
+    {
+        file << "    <Packet name=\"Packet" << p << "\" ID=\"PKT_" << p << "\"";
+
+        if(shape.files > 0)
+            file << " file=\"Synthetic" << (p % shape.files) << "\"";
+
+        file << " structureInterface=\"true\" parameterInterface=\"true\" comment=\"Synthetic packet " << p << "\">\n";
+
+        for(int f = 0; f < shape.fields; f++, fields++)
+        {
+            switch(f % 6)
+            {
+            default:
+            case 0: file << "        <Data name=\"u" << f << "\" inMemoryType=\"unsigned32\" encodedType=\"unsigned24\" verifyMaxValue=\"1000000\" comment=\"Plain integer\"/>\n"; break;
+            case 1: file << "        <Data name=\"s" << f << "\" inMemoryType=\"float32\" encodedType=\"signed16\" scaler=\"100\" comment=\"Scaled value\"/>\n"; break;
+            case 2: file << "        <Data name=\"r" << f << "\" inMemoryType=\"float32\" encodedType=\"unsigned16\" min=\"-10\" max=\"10\" comment=\"Ranged value\"/>\n"; break;
+            case 3: file << "        <Data name=\"d" << f << "\" inMemoryType=\"float64\" comment=\"Double precision value\"/>\n"; break;
+            case 4: file << "        <Data name=\"t" << f << "\" inMemoryType=\"string\" array=\"16\" comment=\"Text\"/>\n"; break;
+            case 5:
+                // Without global enumerations the enumerated field is a plain byte
+                if(shape.enums > 0)
+                    file << "        <Data name=\"m" << f << "\" enum=\"Mode" << ((f/6) % shape.enums) << "\" encodedType=\"unsigned8\" comment=\"Enumerated value\"/>\n";
+                else
+                    file << "        <Data name=\"m" << f << "\" inMemoryType=\"unsigned8\" comment=\"Byte value\"/>\n";
+                break;
+            }
+        }
+
+        for(int b = 0; b < shape.bitfields; b++, fields++)
+            file << "        <Data name=\"flag" << b << "\" inMemoryType=\"unsigned8\" encodedType=\"bitfield" << (1 + (b % 4)) << "\" comment=\"Bitfield\"/>\n";
+
+        for(int a = 0; a < shape.arrays; a++, fields += 2)
+        {
+            file << "        <Data name=\"num" << a << "\" inMemoryType=\"unsigned8\" comment=\"Number of samples in the array\"/>\n";
+            file << "        <Data name=\"samples" << a << "\" inMemoryType=\"float32\" encodedType=\"signed16\" scaler=\"10\" array=\"32\" variableArray=\"num" << a << "\" comment=\"Variable length array\"/>\n";
+        }
+
+        for(int d = 0; d < shape.depth; d++)
+        {
+            file << std::string(8 + 4*d, ' ') << "<Structure name=\"Level" << d << "\" comment=\"Nested structure\">\n";
+            file << std::string(12 + 4*d, ' ') << "<Data name=\"x\" inMemoryType=\"float32\" encodedType=\"signed16\" scaler=\"100\" comment=\"x\"/>\n";
+            file << std::string(12 + 4*d, ' ') << "<Data name=\"y\" inMemoryType=\"float32\" encodedType=\"signed16\" scaler=\"100\" comment=\"y\"/>\n";
+            fields += 2;
+        }
+
+        for(int d = shape.depth - 1; d >= 0; d--)
+            file << std::string(8 + 4*d, ' ') << "</Structure>\n";
+
+        file << "    </Packet>\n\n";
+
+    }// for all packets
+
+    file << "</Protocol>\n";
+
+    if(!file.good())
+        return 0;
+
+    return fields;
+
+}// writeProtocol
+
+
+/*!
+ * Run ProtoGen on a protocol, measuring its wall time and peak memory
+ * \param protogen is the path to the ProtoGen executable.
+ * \param xml is the protocol file.
+ * \param outputPath is the directory for the generated code.
+ * \param seconds receives the wall time.
+ * \param peakKB receives the peak resident memory, or 0 if it is not known.
+ * \return true if ProtoGen ran and succeeded.
+ */
+bool runProtoGen(const std::string& protogen, const std::string& xml, const std::string& outputPath, double& seconds, int64_t& peakKB)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    peakKB = 0;
+
+    #if defined(_WIN32)
+
+    std::string command = "\"\"" + protogen + "\" \"" + xml + "\" \"" + outputPath + "\" -no-doxygen > NUL\"";
+    int status = std::system(command.c_str());
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return (status == 0);
+
+    #else
+
+    pid_t child = fork();
+
+    if(child < 0)
+        return false;
+
+    if(child == 0)
+    {
+        // Quiet ProtoGen, so the benchmark output is readable
+        if(std::freopen("/dev/null", "w", stdout) == nullptr)
+            _exit(127);
+
+        execl(protogen.c_str(), protogen.c_str(), xml.c_str(), outputPath.c_str(), "-no-doxygen", (char*)nullptr);
+        _exit(127);
+    }
+
+    int status = 0;
+    struct rusage usage;
+
+    if(wait4(child, &status, 0, &usage) != child)
+        return false;
+
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    #if defined(__APPLE__)
+    // Mac reports bytes, everyone else reports kilobytes
+    peakKB = (int64_t)usage.ru_maxrss/1024;
+    #else
+    peakKB = (int64_t)usage.ru_maxrss;
+    #endif
+
+    return WIFEXITED(status) && (WEXITSTATUS(status) == 0);
+
+    #endif
+
+}// runProtoGen
+
+
+/*!
+ * Read baselines. Each line is the case name, the number of fields, the
+ * fields per second, and the peak memory in kilobytes. Lines starting with
+ * '#' are comments.
+ * \param fileName is the name of the baseline file.
+ * \param baselines receives the baselines.
+ * \return true if the file was read.
+ */
+bool readBaselines(const std::string& fileName, std::vector<BenchmarkResult>& baselines)
+{
+    std::ifstream file(fileName);
+
+    if(!file.is_open())
+        return false;
+
+    std::string line;
+    while(std::getline(file, line))
+    {
+        if(line.empty() || (line.at(0) == '#'))
+            continue;
+
+        BenchmarkResult baseline;
+        std::istringstream stream(line);
+
+        if(stream >> baseline.name >> baseline.fields >> baseline.fieldsPerSecond >> baseline.peakKB)
+        {
+            baseline.seconds = baseline.fields/std::max(baseline.fieldsPerSecond, 1e-6);
+            baselines.push_back(baseline);
+        }
+    }
+
+    return true;
+
+}// readBaselines
+
+
+/*!
+ * Write baselines, in the format read by readBaselines()
+ * \param fileName is the name of the baseline file.
+ * \param results are the results to store.
+ * \return true if the file was written.
+ */
+bool writeBaselines(const std::string& fileName, const std::vector<BenchmarkResult>& results)
+{
+    std::ofstream file(fileName, std::ios_base::out | std::ios_base::trunc);
+
+    if(!file.is_open())
+        return false;
+
+    file << "# ProtoGenBenchmark baselines, regenerate with -update\n";
+    file << "# case fields fieldsPerSecond peakKB\n";
+
+    for(std::size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult& result = results.at(i);
+        file << result.name << " " << result.fields << " " << std::fixed << std::setprecision(0) << result.fieldsPerSecond << " " << result.peakKB << "\n";
+    }
+
+    return file.good();
+}
+
+
+/*!
+ * Find a result by case name
+ * \param results is the list to search.
+ * \param name is the case name.
+ * \return the result, or nullptr if there is none with that name.
+ */
+const BenchmarkResult* findResult(const std::vector<BenchmarkResult>& results, const std::string& name)
+{
+    for(std::size_t i = 0; i < results.size(); i++)
+    {
+        if(results.at(i).name == name)
+            return &results.at(i);
+    }
+
+    return nullptr;
+}
+
+
+/*!
+ * Create a directory, it is not an error if it already exists
+ * \param path is the directory to create.
+ */
+void makeDirectory(const std::string& path)
+{
+    #if defined(_WIN32)
+    _mkdir(path.c_str());
+    #else
+    mkdir(path.c_str(), 0755);
+    #endif
+}
+
+
+/*!
+ * Search a list of arguments for one that starts with a key, returning the rest of it
+ * \param list is the list of arguments.
+ * \param key is the start of the argument.
+ * \return the argument after the key, or an empty string if there is none.
+ */
+std::string liststartsWith(const std::vector<std::string>& list, const std::string& key)
+{
+    for(std::size_t i = 0; i < list.size(); i++)
+    {
+        if(list.at(i).compare(0, key.size(), key) == 0)
+            return list.at(i).substr(key.size());
+    }
+
+    return std::string();
+}
+
+
+/*!
+ * Determine if a list of arguments contains a key
+ * \param list is the list of arguments.
+ * \param key is the argument to find.
+ * \return true if the key is in the list.
+ */
+bool contains(const std::vector<std::string>& list, const std::string& key)
+{
+    for(std::size_t i = 0; i < list.size(); i++)
+    {
+        if(list.at(i) == key)
+            return true;
+    }
+
+    return false;
+}
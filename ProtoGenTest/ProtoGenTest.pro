@@ -9,7 +9,7 @@ QT       += core
 QT       -= gui
 
 TARGET = ProtoGenTest
-CONFIG   += console
+CONFIG   += c++17 console
 CONFIG   -= app_bundle
 
 TEMPLATE = app
@@ -27,6 +27,7 @@ SOURCES += main.cpp \
     compare/base_print.cpp \
     fielddecode.c \
     fieldencode.c \
+    fieldhash.c \
     floatspecial.c \
     GPS.c \
     globaldependson.c \
@@ -55,6 +56,7 @@ HEADERS += \
     Engine.h \
     fielddecode.h \
     fieldencode.h \
+    fieldhash.h \
     floatspecial.h \
     GPS.h \
     map/base_map.hpp \
@@ -24,6 +24,7 @@ static int testConstantPacket(void);
 static int testTelemetryPacket(void);
 static int verifyTelemetryData(Telemetry_t telemetry);
 static int testThrottleSettingsPacket(void);
+static int testResumableDecode(void);
 static int testEngineSettingsPacket(void);
 static int testEngineCommandPacket(void);
 static int testGPSPacket(void);
@@ -36,6 +37,12 @@ static int testZeroLengthPacket(void);
 static int testBitfieldGroupPacket(void);
 static int testMultiDimensionPacket(void);
 static int testDefaultStringsPacket(void);
+static int testVarintPacket(void);
+static int testPackedArrayPacket(void);
+static int testBoardStructure(void);
+static int testEqualsFunction(void);
+static int testDeltaPacket(void);
+static int testHashFunction(void);
 
 static int fcompare(double input1, double input2, double epsilon);
 
@@ -76,6 +83,9 @@ int main(int argc, char *argv[])
     if(testThrottleSettingsPacket()==0)
         Return = 0;
 
+    if(testResumableDecode() == 0)
+        Return = 0;
+
     if(testEngineSettingsPacket()==0)
         Return = 0;
 
@@ -103,6 +113,24 @@ int main(int argc, char *argv[])
     if(testDefaultStringsPacket() == 0)
         Return = 0;
 
+    if(testVarintPacket() == 0)
+        Return = 0;
+
+    if(testPackedArrayPacket() == 0)
+        Return = 0;
+
+    if(testBoardStructure() == 0)
+        Return = 0;
+
+    if(testEqualsFunction() == 0)
+        Return = 0;
+
+    if(testDeltaPacket() == 0)
+        Return = 0;
+
+    if(testHashFunction() == 0)
+        Return = 0;
+
     if(Return == 1)
         std::cout << "All tests passed" << std::endl;
 
@@ -469,6 +497,145 @@ int testThrottleSettingsPacket(void)
 }
 
 
+int testResumableDecode(void)
+{
+    testPacket_t pkt;
+    ThrottleSettings_t settings;
+    ThrottleSettings_t expected;
+    ThrottleSettingsDecoder_t decoder;
+    int size, index, result;
+
+    memset(&settings, 0, sizeof(settings));
+    settings.numCurvePoints = 5;
+    settings.enableCurve = 1;
+    settings.highPWM = 2000;
+    settings.lowPWM = 1000;
+    settings.defaultBitfield = 6;
+    for(uint32_t i = 0; i < settings.numCurvePoints; i++)
+    {
+        settings.curvePoint[i].PWM = settings.lowPWM + i*100;
+        settings.curvePoint[i].throttle = i*0.2f;
+    }
+
+    encodeThrottleSettingsPacketStructure(&pkt, &settings);
+
+    memset(&expected, 0, sizeof(expected));
+    decodeThrottleSettingsPacketStructure(&pkt, &expected);
+
+    // Every fragment size, from one byte at a time to the whole packet at once
+    for(size = 1; size <= pkt.length; size++)
+    {
+        memset(&settings, 0, sizeof(settings));
+        startThrottleSettingsDecoder(&decoder, pkt.length, &settings);
+
+        result = 0;
+        for(index = 0; (index < pkt.length) && (result == 0); index += size)
+        {
+            int length = pkt.length - index;
+            if(length > size)
+                length = size;
+
+            result = feedThrottleSettingsDecoder(&decoder, pkt.data + index, length, &settings);
+        }
+
+        if((result != 1) || (memcmp(&settings, &expected, sizeof(settings)) != 0))
+        {
+            std::cout << "Resumable decode of throttle settings failed with fragments of " << size << " bytes" << std::endl;
+            return 0;
+        }
+    }
+
+    // The decoder waits for more data until the packet is complete
+    memset(&settings, 0, sizeof(settings));
+    startThrottleSettingsDecoder(&decoder, pkt.length, &settings);
+    if(feedThrottleSettingsDecoder(&decoder, pkt.data, pkt.length - 1, &settings) != 0)
+    {
+        std::cout << "Resumable decode of throttle settings finished early" << std::endl;
+        return 0;
+    }
+
+    // Too many curve points is bad data
+    pkt.data[0] = 0xF0;
+    startThrottleSettingsDecoder(&decoder, pkt.length, &settings);
+    if(feedThrottleSettingsDecoder(&decoder, pkt.data, pkt.length, &settings) != -1)
+    {
+        std::cout << "Resumable decode of throttle settings accepted bad data" << std::endl;
+        return 0;
+    }
+
+    // Default fields that are missing keep their default values
+    memset(&settings, 0, sizeof(settings));
+    encodeThrottleSettingsPacketStructure(&pkt, &settings);
+    startThrottleSettingsDecoder(&decoder, 4, &settings);
+    if( (feedThrottleSettingsDecoder(&decoder, pkt.data, 2, &settings) != 0) ||
+        (feedThrottleSettingsDecoder(&decoder, pkt.data + 2, 2, &settings) != 1) ||
+        (settings.lowPWM != 1100) ||
+        (settings.highPWM != 1900))
+    {
+        std::cout << "Resumable decode of throttle settings with defaults failed" << std::endl;
+        return 0;
+    }
+
+    // The satellites of a GPS packet are a variable length array of
+    // structures, which is decoded one element at a time
+    GPS_t gps;
+    GPS_t gpsexpected;
+    GPSDecoder_t gpsdecoder;
+
+    if(sizeof(gpsdecoder.carry) >= getGPSMaxDataLength() - getGPSMinDataLength())
+    {
+        std::cout << "Resumable GPS decoder carries the whole satellite array" << std::endl;
+        return 0;
+    }
+
+    memset(&gps, 0, sizeof(gps));
+    fillOutGPSTest(gps);
+    encodeGPSPacketStructure(&pkt, &gps);
+
+    memset(&gpsexpected, 0, sizeof(gpsexpected));
+    decodeGPSPacketStructure(&pkt, &gpsexpected);
+
+    // Most fragment sizes split a satellite across fragments
+    for(size = 1; size <= pkt.length; size++)
+    {
+        memset(&gps, 0, sizeof(gps));
+        startGPSDecoder(&gpsdecoder, pkt.length, &gps);
+
+        result = 0;
+        for(index = 0; (index < pkt.length) && (result == 0); index += size)
+        {
+            int length = pkt.length - index;
+            if(length > size)
+                length = size;
+
+            result = feedGPSDecoder(&gpsdecoder, pkt.data + index, length, &gps);
+        }
+
+        if((result != 1) || (memcmp(&gps, &gpsexpected, sizeof(gps)) != 0))
+        {
+            std::cout << "Resumable decode of GPS failed with fragments of " << size << " bytes" << std::endl;
+            return 0;
+        }
+    }
+
+    // A packet without satellites ends before the array
+    memset(&gps, 0, sizeof(gps));
+    fillOutGPSTest(gps);
+    gps.numSvInfo = 0;
+    encodeGPSPacketStructure(&pkt, &gps);
+    memset(&gps, 0, sizeof(gps));
+    startGPSDecoder(&gpsdecoder, pkt.length, &gps);
+    if((feedGPSDecoder(&gpsdecoder, pkt.data, pkt.length, &gps) != 1) || (gps.numSvInfo != 0) || (gps.Week != 1234))
+    {
+        std::cout << "Resumable decode of GPS without satellites failed" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testResumableDecode
+
+
 
 int testEngineSettingsPacket(void)
 {
@@ -1169,6 +1336,427 @@ int testDefaultStringsPacket(void)
 }
 
 
+int testVarintPacket(void)
+{
+    VarintTester_t varint;
+    testPacket_t pkt;
+
+    varint.count = 300;
+    varint.offset = -3;
+    varint.minimum32 = INT32_MIN;
+    varint.maximum32 = INT32_MAX;
+    varint.large = 1ULL << 40;
+    varint.minimum64 = INT64_MIN;
+    varint.maximum64 = INT64_MAX;
+
+    // 2 + 1 + 5 + 5 + 6 + 10 + 10 bytes
+    if(getEncodedSizeOfVarintTester_t(&varint) != 39)
+    {
+        std::cout << "Varint packet encoded size is wrong" << std::endl;
+        return 0;
+    }
+
+    encodeVarintTesterPacketStructure(&pkt, &varint);
+
+    if(pkt.length != 39)
+    {
+        std::cout << "Varint packet length is wrong" << std::endl;
+        return 0;
+    }
+
+    memset(&varint, 0, sizeof(varint));
+    if(!decodeVarintTesterPacketStructure(&pkt, &varint))
+    {
+        std::cout << "Failed to decode varint packet" << std::endl;
+        return 0;
+    }
+
+    if( (varint.count != 300)            ||
+        (varint.offset != -3)            ||
+        (varint.minimum32 != INT32_MIN)  ||
+        (varint.maximum32 != INT32_MAX)  ||
+        (varint.large != (1ULL << 40))   ||
+        (varint.minimum64 != INT64_MIN)  ||
+        (varint.maximum64 != INT64_MAX))
+    {
+        std::cout << "Varint packet decoded wrong data" << std::endl;
+        return 0;
+    }
+
+    // Small numbers of either sign use one byte each
+    memset(&varint, 0, sizeof(varint));
+    varint.offset = -64;
+    varint.large = 127;
+    varint.maximum64 = 63;
+    if(getEncodedSizeOfVarintTester_t(&varint) != 7)
+    {
+        std::cout << "Varint packet minimum encoded size is wrong" << std::endl;
+        return 0;
+    }
+
+    encodeVarintTesterPacketStructure(&pkt, &varint);
+    memset(&varint, 0, sizeof(varint));
+    if( (pkt.length != getVarintTesterMinDataLength()) ||
+        !decodeVarintTesterPacketStructure(&pkt, &varint) ||
+        (varint.offset != -64) ||
+        (varint.large != 127) ||
+        (varint.maximum64 != 63))
+    {
+        std::cout << "Varint packet with small numbers failed" << std::endl;
+        return 0;
+    }
+
+    return 1;
+}
+
+
+int testPackedArrayPacket(void)
+{
+    PackedArrayTester_t packed;
+    testPacket_t pkt;
+    const uint8_t expectedSamples[8] = {0x00, 0x00, 0x01, 0x80, 0x0F, 0xFF, 0x4D, 0x20};
+    const uint8_t expectedOffsets[2] = {0x87, 0xDE};
+
+    memset(&packed, 0, sizeof(packed));
+    packed.samples[0] = 0;
+    packed.samples[1] = 1;
+    packed.samples[2] = 2048;
+    packed.samples[3] = 4095;
+    packed.samples[4] = 1234;
+    packed.offsets[0] = -16;
+    packed.offsets[1] = -1;
+    packed.offsets[2] = 15;
+    packed.numSteps = 4;
+    packed.steps[0] = 7;
+    packed.steps[1] = 0;
+    packed.steps[2] = 5;
+    packed.steps[3] = 3;
+    packed.wide[0] = 0xFFFFFFFFFFULL;
+    packed.wide[1] = 1;
+    packed.wide[2] = 0x123456789AULL;
+
+    encodePackedArrayTesterPacketStructure(&pkt, &packed);
+
+    // 8 bytes of samples, 2 of offsets, 1 count, 2 of steps, and 15 of wide numbers
+    if(pkt.length != 28)
+    {
+        std::cout << "Packed array packet length is wrong" << std::endl;
+        return 0;
+    }
+
+    // Elements are packed most significant bits first, and signed elements keep their low bits
+    if((memcmp(pkt.data, expectedSamples, 8) != 0) || (memcmp(pkt.data + 8, expectedOffsets, 2) != 0))
+    {
+        std::cout << "Packed array packet encoded wrong data" << std::endl;
+        return 0;
+    }
+
+    memset(&packed, 0, sizeof(packed));
+    if(!decodePackedArrayTesterPacketStructure(&pkt, &packed))
+    {
+        std::cout << "Failed to decode packed array packet" << std::endl;
+        return 0;
+    }
+
+    if( (packed.samples[0] != 0) || (packed.samples[1] != 1) || (packed.samples[2] != 2048) ||
+        (packed.samples[3] != 4095) || (packed.samples[4] != 1234) ||
+        (packed.offsets[0] != -16) || (packed.offsets[1] != -1) || (packed.offsets[2] != 15) ||
+        (packed.numSteps != 4) ||
+        (packed.steps[0] != 7) || (packed.steps[1] != 0) || (packed.steps[2] != 5) || (packed.steps[3] != 3) ||
+        (packed.wide[0] != 0xFFFFFFFFFFULL) || (packed.wide[1] != 1) || (packed.wide[2] != 0x123456789AULL))
+    {
+        std::cout << "Packed array packet decoded wrong data" << std::endl;
+        return 0;
+    }
+
+    // No steps at all
+    packed.numSteps = 0;
+    encodePackedArrayTesterPacketStructure(&pkt, &packed);
+    memset(&packed, 0, sizeof(packed));
+    if( (pkt.length != getPackedArrayTesterMinDataLength()) ||
+        !decodePackedArrayTesterPacketStructure(&pkt, &packed) ||
+        (packed.numSteps != 0) ||
+        (packed.wide[2] != 0x123456789AULL))
+    {
+        std::cout << "Packed array packet with no steps failed" << std::endl;
+        return 0;
+    }
+
+    return 1;
+}
+
+
+int testBoardStructure(void)
+{
+    Board_t board;
+    uint8_t data[100];
+    int index, size;
+
+    memset(&board, 0, sizeof(board));
+    board.manufactureDate.year = 2020;
+    board.manufactureDate.month = 5;
+    board.manufactureDate.day = 12;
+    board.calibratedDate.year = 2021;
+    board.calibratedDate.month = 1;
+    board.calibratedDate.day = 30;
+    board.serialNumber = 123456;
+    board.assemblyNumber = 7890;
+    board.isCalibrated = 1;
+    strcpy(board.description, "Demonstration board");
+
+    // Two dates of 4 bytes, 8 bytes of numbers, and the string with its terminator
+    if(getEncodedSizeOfBoard_t(&board) != 36)
+    {
+        std::cout << "Board encoded size is wrong" << std::endl;
+        return 0;
+    }
+
+    index = 0;
+    encodeBoard_t(data, &index, &board);
+    if(index != getEncodedSizeOfBoard_t(&board))
+    {
+        std::cout << "Board encoded size does not match the encode" << std::endl;
+        return 0;
+    }
+
+    // Skip lands where the encode stopped, and fails if the data are cut short
+    size = index;
+    index = 0;
+    if(!skipBoard_t(data, &index, size) || (index != size))
+    {
+        std::cout << "Board skip failed" << std::endl;
+        return 0;
+    }
+
+    index = 0;
+    if(skipBoard_t(data, &index, size - 1))
+    {
+        std::cout << "Board skip of truncated data did not fail" << std::endl;
+        return 0;
+    }
+
+    board.description[0] = 0;
+    if(getEncodedSizeOfBoard_t(&board) != getMinLengthOfBoard_t())
+    {
+        std::cout << "Board encoded size with an empty description is wrong" << std::endl;
+        return 0;
+    }
+
+    memset(board.description, 'a', sizeof(board.description) - 1);
+    if(getEncodedSizeOfBoard_t(&board) != getMaxLengthOfBoard_t())
+    {
+        std::cout << "Board encoded size with a full description is wrong" << std::endl;
+        return 0;
+    }
+
+    return 1;
+}
+
+
+int testEqualsFunction(void)
+{
+    ThrottleSettings_t settings1, settings2;
+    Board_t board1, board2;
+    PackedArrayTester_t packed1, packed2;
+
+    memset(&settings1, 0, sizeof(settings1));
+    settings1.numCurvePoints = 2;
+    settings1.curvePoint[0].throttle = 0.0f;
+    settings1.curvePoint[0].PWM = 1000;
+    settings1.curvePoint[1].throttle = 1.0f;
+    settings1.curvePoint[1].PWM = 2000;
+    settings1.lowPWM = 1000;
+    settings1.highPWM = 2000;
+    settings2 = settings1;
+
+    if(!equalsThrottleSettings_t(&settings1, &settings2) || !compareThrottleSettings_t("", &settings1, &settings2).empty())
+    {
+        std::cout << "Equals failed for identical throttle settings" << std::endl;
+        return 0;
+    }
+
+    // The sign of zero does not count, exactly as in the comparison report
+    settings2.curvePoint[0].throttle = -0.0f;
+    if(!equalsThrottleSettings_t(&settings1, &settings2) || !compareThrottleSettings_t("", &settings1, &settings2).empty())
+    {
+        std::cout << "Equals failed for throttle settings which differ only in the sign of zero" << std::endl;
+        return 0;
+    }
+
+    settings2.curvePoint[1].PWM = 2001;
+    if(equalsThrottleSettings_t(&settings1, &settings2) || compareThrottleSettings_t("", &settings1, &settings2).empty())
+    {
+        std::cout << "Equals failed to find a different curve point" << std::endl;
+        return 0;
+    }
+
+    // Strings are compared up to their terminator
+    memset(&board1, 0, sizeof(board1));
+    strcpy(board1.description, "abc");
+    board2 = board1;
+    board2.description[5] = 'x';
+    if(!equalsBoard_t(&board1, &board2))
+    {
+        std::cout << "Equals failed for boards which differ after the description" << std::endl;
+        return 0;
+    }
+
+    board2.description[1] = 'x';
+    if(equalsBoard_t(&board1, &board2))
+    {
+        std::cout << "Equals failed to find a different board description" << std::endl;
+        return 0;
+    }
+
+    memset(&packed1, 0, sizeof(packed1));
+    packed1.numSteps = 2;
+    packed1.steps[1] = 5;
+    packed2 = packed1;
+    packed2.steps[4] = 1;
+    if(!equalsPackedArrayTester_t(&packed1, &packed2))
+    {
+        std::cout << "Equals failed for packed arrays which differ past their length" << std::endl;
+        return 0;
+    }
+
+    packed2.steps[1] = 4;
+    if(equalsPackedArrayTester_t(&packed1, &packed2))
+    {
+        std::cout << "Equals failed to find a different packed array element" << std::endl;
+        return 0;
+    }
+
+    return 1;
+}
+
+
+int testDeltaPacket(void)
+{
+    ThrottleSettings_t reference, settings, decoded;
+    testPacket_t pkt;
+
+    memset(&reference, 0, sizeof(reference));
+    reference.numCurvePoints = 3;
+    for(uint32_t i = 0; i < reference.numCurvePoints; i++)
+        reference.curvePoint[i].PWM = 1100 + i*400;
+
+    // The throttle is scaled into 8 bits, so use a value which decodes exactly
+    reference.curvePoint[2].throttle = 1.0f;
+    reference.lowPWM = 1100;
+    reference.highPWM = 1900;
+    settings = reference;
+
+    // Nothing changed: only the bitmap is sent
+    encodeDeltaThrottleSettingsPacketStructure(&pkt, &settings, &reference);
+    decoded = reference;
+    if((pkt.length != 1) || !decodeDeltaThrottleSettingsPacketStructure(&pkt, &decoded) || !equalsThrottleSettings_t(&decoded, &settings))
+    {
+        std::cout << "Delta packet with no changes failed" << std::endl;
+        return 0;
+    }
+
+    // The bitmap and one 16-bit field
+    settings.highPWM = 2000;
+    encodeDeltaThrottleSettingsPacketStructure(&pkt, &settings, &reference);
+    decoded = reference;
+    if((pkt.length != 3) || !decodeDeltaThrottleSettingsPacketStructure(&pkt, &decoded) || !equalsThrottleSettings_t(&decoded, &settings))
+    {
+        std::cout << "Delta packet with one change failed" << std::endl;
+        return 0;
+    }
+
+    // Any change to the curve sends all 3 points of 3 bytes
+    settings.curvePoint[1].PWM = 1234;
+    encodeDeltaThrottleSettingsPacketStructure(&pkt, &settings, &reference);
+    decoded = reference;
+    if((pkt.length != 12) || !decodeDeltaThrottleSettingsPacketStructure(&pkt, &decoded) || !equalsThrottleSettings_t(&decoded, &settings))
+    {
+        std::cout << "Delta packet with a changed curve point failed" << std::endl;
+        return 0;
+    }
+
+    // A longer curve also sends the bitfield group which holds its length
+    settings.numCurvePoints = 4;
+    settings.curvePoint[3].throttle = 1.0f;
+    settings.curvePoint[3].PWM = 2100;
+    encodeDeltaThrottleSettingsPacketStructure(&pkt, &settings, &reference);
+    decoded = reference;
+    if((pkt.length != 19) || !decodeDeltaThrottleSettingsPacketStructure(&pkt, &decoded) || !equalsThrottleSettings_t(&decoded, &settings))
+    {
+        std::cout << "Delta packet with a longer curve failed" << std::endl;
+        return 0;
+    }
+
+    // A delta packet is not a normal packet
+    if(decodeThrottleSettingsPacketStructure(&pkt, &decoded) && equalsThrottleSettings_t(&decoded, &settings))
+    {
+        std::cout << "Delta packet decoded as a normal packet" << std::endl;
+        return 0;
+    }
+
+    return 1;
+}
+
+
+int testHashFunction(void)
+{
+    ThrottleSettings_t settings1, settings2;
+    Board_t board1, board2;
+    Date_t date;
+
+    // The hash is the same on any host
+    date.year = 2020;
+    date.month = 5;
+    date.day = 12;
+    if(hashDate_t(&date) != 0x67A0F23E4ECA4483ULL)
+    {
+        std::cout << "Hash of date has the wrong value" << std::endl;
+        return 0;
+    }
+
+    // Curve points past the variable array length are not encoded, so they are not hashed
+    memset(&settings1, 0, sizeof(settings1));
+    settings1.numCurvePoints = 2;
+    settings1.curvePoint[0].PWM = 1000;
+    settings1.curvePoint[1].PWM = 2000;
+    settings2 = settings1;
+    settings2.curvePoint[5].PWM = 1234;
+    if(hashThrottleSettings_t(&settings1) != hashThrottleSettings_t(&settings2))
+    {
+        std::cout << "Hash of throttle settings depends on unused curve points" << std::endl;
+        return 0;
+    }
+
+    settings2.curvePoint[1].PWM = 2001;
+    if(hashThrottleSettings_t(&settings1) == hashThrottleSettings_t(&settings2))
+    {
+        std::cout << "Hash of throttle settings did not change with a curve point" << std::endl;
+        return 0;
+    }
+
+    // Strings are hashed up to their terminator
+    memset(&board1, 0, sizeof(board1));
+    board1.manufactureDate = date;
+    strcpy(board1.description, "abc");
+    board2 = board1;
+    board2.description[5] = 'x';
+    if(hashBoard_t(&board1) != hashBoard_t(&board2))
+    {
+        std::cout << "Hash of board depends on text after the description" << std::endl;
+        return 0;
+    }
+
+    board2.manufactureDate.day = 13;
+    if(hashBoard_t(&board1) == hashBoard_t(&board2))
+    {
+        std::cout << "Hash of board did not change with the date" << std::endl;
+        return 0;
+    }
+
+    return 1;
+}
+
+
 int fcompare(double input1, double input2, double epsilon)
 {
     if(fabs(input1 - input2) > epsilon)
@@ -1,6 +1,6 @@
 QT -= gui
 
-CONFIG += c++11 console
+CONFIG += c++17 console
 CONFIG -= app_bundle
 
 # The following define makes your compiler emit warnings if you use
@@ -15,14 +15,18 @@ DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+        DemolinkJson.cpp \
         DemolinkProtocol.cpp \
         Engine.cpp \
         GPS.cpp \
         TelemetryPacket.cpp \
+        base_json.cpp \
         base_types.cpp \
         bitfieldtest.cpp \
         fielddecode.cpp \
         fieldencode.cpp \
+        fieldhash.cpp \
+        fieldmap.cpp \
         floatspecial.cpp \
         globaldependson.cpp \
         globalenum.cpp \
@@ -38,15 +42,19 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 !isEmpty(target.path): INSTALLS += target
 
 HEADERS += \
+    DemolinkJson.hpp \
     DemolinkProtocol.hpp \
     Engine.hpp \
     EngineDefinitions.hpp \
     OtherDefinitions.hpp \
     TelemetryPacket.hpp \
+    base_json.hpp \
     base_types.hpp \
     bitfieldtest.hpp \
     fielddecode.hpp \
     fieldencode.hpp \
+    fieldhash.hpp \
+    fieldmap.hpp \
     floatspecial.hpp \
     globaldependson.hpp \
     linkcode.hpp \
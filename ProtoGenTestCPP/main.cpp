@@ -1,6 +1,8 @@
 #include <QDateTime>
 #include <iostream>
 #include <math.h>
+#include <new>
+#include <unordered_set>
 #include "bitfieldtest.hpp"
 #include "floatspecial.hpp"
 #include "GPS.hpp"
@@ -22,6 +24,7 @@ static int testConstantPacket(void);
 static int testTelemetryPacket(void);
 static int verifyTelemetryData(Telemetry_c telemetry);
 static int testThrottleSettingsPacket(void);
+static int testResumableDecode(void);
 static int testEngineSettingsPacket(void);
 static int testEngineCommandPacket(void);
 static int testGPSPacket(void);
@@ -34,6 +37,15 @@ static int testZeroLengthPacket(void);
 static int testBitfieldGroupPacket(void);
 static int testMultiDimensionPacket(void);
 static int testDefaultStringsPacket(void);
+static int testNoInitPacket(void);
+static int testVarintPacket(void);
+static int testPackedArrayPacket(void);
+static int testBoardStructure(void);
+static int testEqualsFunction(void);
+static int testJsonFunction(void);
+static int testMapFunction(void);
+static int testDeltaPacket(void);
+static int testHashFunction(void);
 
 static int fcompare(double input1, double input2, double epsilon);
 
@@ -74,6 +86,9 @@ int main(int argc, char *argv[])
     if(testThrottleSettingsPacket()==0)
         Return = 0;
 
+    if(testResumableDecode() == 0)
+        Return = 0;
+
     if(testEngineSettingsPacket()==0)
         Return = 0;
 
@@ -101,6 +116,33 @@ int main(int argc, char *argv[])
     if(testDefaultStringsPacket() == 0)
         Return = 0;
 
+    if(testNoInitPacket() == 0)
+        Return = 0;
+
+    if(testVarintPacket() == 0)
+        Return = 0;
+
+    if(testPackedArrayPacket() == 0)
+        Return = 0;
+
+    if(testBoardStructure() == 0)
+        Return = 0;
+
+    if(testEqualsFunction() == 0)
+        Return = 0;
+
+    if(testJsonFunction() == 0)
+        Return = 0;
+
+    if(testMapFunction() == 0)
+        Return = 0;
+
+    if(testDeltaPacket() == 0)
+        Return = 0;
+
+    if(testHashFunction() == 0)
+        Return = 0;
+
     if(Return == 1)
         std::cout << "All tests passed" << std::endl;
 
@@ -465,6 +507,142 @@ int testThrottleSettingsPacket(void)
 }
 
 
+int testResumableDecode(void)
+{
+    testPacket_c pkt;
+    ThrottleSettings_c settings;
+    ThrottleSettings_c expected;
+    ThrottleSettings_c::Decoder decoder;
+    int size, index, result;
+
+    settings.numCurvePoints = 5;
+    settings.enableCurve = 1;
+    settings.highPWM = 2000;
+    settings.lowPWM = 1000;
+    settings.defaultBitfield = 6;
+    for(uint32_t i = 0; i < settings.numCurvePoints; i++)
+    {
+        settings.curvePoint[i].PWM = settings.lowPWM + i*100;
+        settings.curvePoint[i].throttle = i*0.2f;
+    }
+
+    settings.encode(&pkt);
+
+    expected.decode(&pkt);
+
+    // Every fragment size, from one byte at a time to the whole packet at once
+    for(size = 1; size <= pkt.length; size++)
+    {
+        settings = ThrottleSettings_c();
+        settings.startDecoder(&decoder, pkt.length);
+
+        result = 0;
+        for(index = 0; (index < pkt.length) && (result == 0); index += size)
+        {
+            int length = pkt.length - index;
+            if(length > size)
+                length = size;
+
+            result = settings.feedDecoder(&decoder, pkt.data + index, length);
+        }
+
+        if((result != 1) || !settings.equals(&expected))
+        {
+            std::cout << "Resumable decode of throttle settings failed with fragments of " << size << " bytes" << std::endl;
+            return 0;
+        }
+    }
+
+    // The decoder waits for more data until the packet is complete
+    settings = ThrottleSettings_c();
+    settings.startDecoder(&decoder, pkt.length);
+    if(settings.feedDecoder(&decoder, pkt.data, pkt.length - 1) != 0)
+    {
+        std::cout << "Resumable decode of throttle settings finished early" << std::endl;
+        return 0;
+    }
+
+    // Too many curve points is bad data
+    pkt.data[0] = 0xF0;
+    settings.startDecoder(&decoder, pkt.length);
+    if(settings.feedDecoder(&decoder, pkt.data, pkt.length) != -1)
+    {
+        std::cout << "Resumable decode of throttle settings accepted bad data" << std::endl;
+        return 0;
+    }
+
+    // Default fields that are missing keep their default values
+    settings = ThrottleSettings_c();
+    settings.numCurvePoints = 0;
+    settings.encode(&pkt);
+    settings.startDecoder(&decoder, 4);
+    if( (settings.feedDecoder(&decoder, pkt.data, 2) != 0) ||
+        (settings.feedDecoder(&decoder, pkt.data + 2, 2) != 1) ||
+        (settings.lowPWM != 1100) ||
+        (settings.highPWM != 1900))
+    {
+        std::cout << "Resumable decode of throttle settings with defaults failed" << std::endl;
+        return 0;
+    }
+
+    // The satellites of a GPS packet are a variable length array of
+    // structures, which is decoded one element at a time
+    GPS_c gps;
+    GPS_c gpsexpected;
+    GPS_c::Decoder gpsdecoder;
+
+    if(sizeof(gpsdecoder.carry) >= (unsigned)(GPS_c::maxLength() - GPS_c::minLength()))
+    {
+        std::cout << "Resumable GPS decoder carries the whole satellite array" << std::endl;
+        return 0;
+    }
+
+    fillOutGPSTest(gps);
+    gps.encode(&pkt);
+
+    gpsexpected.decode(&pkt);
+
+    // Most fragment sizes split a satellite across fragments
+    for(size = 1; size <= pkt.length; size++)
+    {
+        gps = GPS_c();
+        gps.startDecoder(&gpsdecoder, pkt.length);
+
+        result = 0;
+        for(index = 0; (index < pkt.length) && (result == 0); index += size)
+        {
+            int length = pkt.length - index;
+            if(length > size)
+                length = size;
+
+            result = gps.feedDecoder(&gpsdecoder, pkt.data + index, length);
+        }
+
+        if((result != 1) || !gps.equals(&gpsexpected))
+        {
+            std::cout << "Resumable decode of GPS failed with fragments of " << size << " bytes" << std::endl;
+            return 0;
+        }
+    }
+
+    // A packet without satellites ends before the array
+    gps = GPS_c();
+    fillOutGPSTest(gps);
+    gps.numSvInfo = 0;
+    gps.encode(&pkt);
+    gps = GPS_c();
+    gps.startDecoder(&gpsdecoder, pkt.length);
+    if((gps.feedDecoder(&gpsdecoder, pkt.data, pkt.length) != 1) || (gps.numSvInfo != 0) || (gps.Week != 1234))
+    {
+        std::cout << "Resumable decode of GPS without satellites failed" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testResumableDecode
+
+
 
 int testEngineSettingsPacket(void)
 {
@@ -1170,6 +1348,632 @@ int testDefaultStringsPacket(void)
 }
 
 
+int testNoInitPacket(void)
+{
+    testPacket_c pkt;
+
+    // Construct the packet over memory that is not zero, the constructor must
+    // still set the members whose class has the noInit attribute
+    alignas(NoInitTester_c) unsigned char memory[sizeof(NoInitTester_c)];
+    memset(memory, 0xA5, sizeof(memory));
+    NoInitTester_c* test = new (memory) NoInitTester_c();
+
+    if( (test->count != 2) ||
+        (test->first.sensor != 3) || (test->first.value != 1.5f) ||
+        (test->others[0].sensor != 3) || (test->others[0].value != 1.5f) ||
+        (test->others[1].sensor != 3) || (test->others[1].value != 1.5f))
+    {
+        std::cout << "No init packet constructor did not set the readings" << std::endl;
+        return 0;
+    }
+
+    test->first.sensor = 7;
+    test->others[1].value = -2.25f;
+    test->encode(&pkt);
+
+    // A Reading_c on its own is not set by its constructor
+    Reading_c reading;
+    reading.initialize();
+
+    NoInitTester_c decoded;
+    if(!decoded.decode(&pkt) ||
+        (decoded.count != 2) ||
+        (decoded.first.sensor != 7) || (decoded.first.value != 1.5f) ||
+        (decoded.others[0].sensor != reading.sensor) || (decoded.others[0].value != reading.value) ||
+        (decoded.others[1].sensor != 3) || (decoded.others[1].value != -2.25f))
+    {
+        std::cout << "No init packet decoded to wrong data" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testNoInitPacket
+
+
+int testVarintPacket(void)
+{
+    VarintTester_c varint;
+    testPacket_c pkt;
+
+    varint.count = 300;
+    varint.offset = -3;
+    varint.minimum32 = INT32_MIN;
+    varint.maximum32 = INT32_MAX;
+    varint.large = 1ULL << 40;
+    varint.minimum64 = INT64_MIN;
+    varint.maximum64 = INT64_MAX;
+
+    // 2 + 1 + 5 + 5 + 6 + 10 + 10 bytes
+    if(varint.encodedSize() != 39)
+    {
+        std::cout << "Varint packet encoded size is wrong" << std::endl;
+        return 0;
+    }
+
+    varint.encode(&pkt);
+
+    if(pkt.length != 39)
+    {
+        std::cout << "Varint packet length is wrong" << std::endl;
+        return 0;
+    }
+
+    varint = VarintTester_c();
+    if(!varint.decode(&pkt))
+    {
+        std::cout << "Failed to decode varint packet" << std::endl;
+        return 0;
+    }
+
+    if( (varint.count != 300)            ||
+        (varint.offset != -3)            ||
+        (varint.minimum32 != INT32_MIN)  ||
+        (varint.maximum32 != INT32_MAX)  ||
+        (varint.large != (1ULL << 40))   ||
+        (varint.minimum64 != INT64_MIN)  ||
+        (varint.maximum64 != INT64_MAX))
+    {
+        std::cout << "Varint packet decoded wrong data" << std::endl;
+        return 0;
+    }
+
+    // Small numbers of either sign use one byte each
+    varint = VarintTester_c();
+    varint.offset = -64;
+    varint.large = 127;
+    varint.maximum64 = 63;
+    if(varint.encodedSize() != 7)
+    {
+        std::cout << "Varint packet minimum encoded size is wrong" << std::endl;
+        return 0;
+    }
+
+    varint.encode(&pkt);
+    varint = VarintTester_c();
+    if( (pkt.length != VarintTester_c::minLength()) ||
+        !varint.decode(&pkt) ||
+        (varint.offset != -64) ||
+        (varint.large != 127) ||
+        (varint.maximum64 != 63))
+    {
+        std::cout << "Varint packet with small numbers failed" << std::endl;
+        return 0;
+    }
+
+    return 1;
+}
+
+
+int testPackedArrayPacket(void)
+{
+    PackedArrayTester_c packed;
+    testPacket_c pkt;
+    const uint8_t expectedSamples[8] = {0x00, 0x00, 0x01, 0x80, 0x0F, 0xFF, 0x4D, 0x20};
+    const uint8_t expectedOffsets[2] = {0x87, 0xDE};
+
+    packed = PackedArrayTester_c();
+    packed.samples[0] = 0;
+    packed.samples[1] = 1;
+    packed.samples[2] = 2048;
+    packed.samples[3] = 4095;
+    packed.samples[4] = 1234;
+    packed.offsets[0] = -16;
+    packed.offsets[1] = -1;
+    packed.offsets[2] = 15;
+    packed.numSteps = 4;
+    packed.steps[0] = 7;
+    packed.steps[1] = 0;
+    packed.steps[2] = 5;
+    packed.steps[3] = 3;
+    packed.wide[0] = 0xFFFFFFFFFFULL;
+    packed.wide[1] = 1;
+    packed.wide[2] = 0x123456789AULL;
+
+    packed.encode(&pkt);
+
+    // 8 bytes of samples, 2 of offsets, 1 count, 2 of steps, and 15 of wide numbers
+    if(pkt.length != 28)
+    {
+        std::cout << "Packed array packet length is wrong" << std::endl;
+        return 0;
+    }
+
+    // Elements are packed most significant bits first, and signed elements keep their low bits
+    if((memcmp(pkt.data, expectedSamples, 8) != 0) || (memcmp(pkt.data + 8, expectedOffsets, 2) != 0))
+    {
+        std::cout << "Packed array packet encoded wrong data" << std::endl;
+        return 0;
+    }
+
+    packed = PackedArrayTester_c();
+    if(!packed.decode(&pkt))
+    {
+        std::cout << "Failed to decode packed array packet" << std::endl;
+        return 0;
+    }
+
+    if( (packed.samples[0] != 0) || (packed.samples[1] != 1) || (packed.samples[2] != 2048) ||
+        (packed.samples[3] != 4095) || (packed.samples[4] != 1234) ||
+        (packed.offsets[0] != -16) || (packed.offsets[1] != -1) || (packed.offsets[2] != 15) ||
+        (packed.numSteps != 4) ||
+        (packed.steps[0] != 7) || (packed.steps[1] != 0) || (packed.steps[2] != 5) || (packed.steps[3] != 3) ||
+        (packed.wide[0] != 0xFFFFFFFFFFULL) || (packed.wide[1] != 1) || (packed.wide[2] != 0x123456789AULL))
+    {
+        std::cout << "Packed array packet decoded wrong data" << std::endl;
+        return 0;
+    }
+
+    // No steps at all
+    packed.numSteps = 0;
+    packed.encode(&pkt);
+    packed = PackedArrayTester_c();
+    if( (pkt.length != PackedArrayTester_c::minLength()) ||
+        !packed.decode(&pkt) ||
+        (packed.numSteps != 0) ||
+        (packed.wide[2] != 0x123456789AULL))
+    {
+        std::cout << "Packed array packet with no steps failed" << std::endl;
+        return 0;
+    }
+
+    return 1;
+}
+
+
+int testBoardStructure(void)
+{
+    Board_c board;
+    uint8_t data[100];
+    int index, size;
+
+    board.manufactureDate.year = 2020;
+    board.manufactureDate.month = 5;
+    board.manufactureDate.day = 12;
+    board.calibratedDate.year = 2021;
+    board.calibratedDate.month = 1;
+    board.calibratedDate.day = 30;
+    board.serialNumber = 123456;
+    board.assemblyNumber = 7890;
+    board.isCalibrated = 1;
+    strcpy(board.description, "Demonstration board");
+
+    // Two dates of 4 bytes, 8 bytes of numbers, and the string with its terminator
+    if(board.encodedSize() != 36)
+    {
+        std::cout << "Board encoded size is wrong" << std::endl;
+        return 0;
+    }
+
+    index = 0;
+    board.encode(data, &index);
+    if(index != board.encodedSize())
+    {
+        std::cout << "Board encoded size does not match the encode" << std::endl;
+        return 0;
+    }
+
+    // Skip lands where the encode stopped, and fails if the data are cut short
+    size = index;
+    index = 0;
+    if(!Board_c::skip(data, &index, size) || (index != size))
+    {
+        std::cout << "Board skip failed" << std::endl;
+        return 0;
+    }
+
+    index = 0;
+    if(Board_c::skip(data, &index, size - 1))
+    {
+        std::cout << "Board skip of truncated data did not fail" << std::endl;
+        return 0;
+    }
+
+    board.description[0] = 0;
+    if(board.encodedSize() != Board_c::minLength())
+    {
+        std::cout << "Board encoded size with an empty description is wrong" << std::endl;
+        return 0;
+    }
+
+    memset(board.description, 'a', sizeof(board.description) - 1);
+    if(board.encodedSize() != Board_c::maxLength())
+    {
+        std::cout << "Board encoded size with a full description is wrong" << std::endl;
+        return 0;
+    }
+
+    return 1;
+}
+
+
+int testEqualsFunction(void)
+{
+    ThrottleSettings_c settings1, settings2;
+    Board_c board1, board2;
+    PackedArrayTester_c packed1, packed2;
+
+    settings1.numCurvePoints = 2;
+    settings1.curvePoint[0].throttle = 0.0f;
+    settings1.curvePoint[0].PWM = 1000;
+    settings1.curvePoint[1].throttle = 1.0f;
+    settings1.curvePoint[1].PWM = 2000;
+    settings1.lowPWM = 1000;
+    settings1.highPWM = 2000;
+    settings2 = settings1;
+
+    if(!settings1.equals(&settings2) || !settings1.compare("", &settings2).empty())
+    {
+        std::cout << "Equals failed for identical throttle settings" << std::endl;
+        return 0;
+    }
+
+    // The sign of zero does not count, exactly as in the comparison report
+    settings2.curvePoint[0].throttle = -0.0f;
+    if(!settings1.equals(&settings2) || !settings1.compare("", &settings2).empty())
+    {
+        std::cout << "Equals failed for throttle settings which differ only in the sign of zero" << std::endl;
+        return 0;
+    }
+
+    settings2.curvePoint[1].PWM = 2001;
+    if(settings1.equals(&settings2) || settings1.compare("", &settings2).empty())
+    {
+        std::cout << "Equals failed to find a different curve point" << std::endl;
+        return 0;
+    }
+
+    // Strings are compared up to their terminator
+    strcpy(board1.description, "abc");
+    board2 = board1;
+    board2.description[5] = 'x';
+    if(!board1.equals(&board2))
+    {
+        std::cout << "Equals failed for boards which differ after the description" << std::endl;
+        return 0;
+    }
+
+    board2.description[1] = 'x';
+    if(board1.equals(&board2))
+    {
+        std::cout << "Equals failed to find a different board description" << std::endl;
+        return 0;
+    }
+
+    packed1.numSteps = 2;
+    packed1.steps[1] = 5;
+    packed2 = packed1;
+    packed2.steps[4] = 1;
+    if(!packed1.equals(&packed2))
+    {
+        std::cout << "Equals failed for packed arrays which differ past their length" << std::endl;
+        return 0;
+    }
+
+    packed2.steps[1] = 4;
+    if(packed1.equals(&packed2))
+    {
+        std::cout << "Equals failed to find a different packed array element" << std::endl;
+        return 0;
+    }
+
+    return 1;
+}
+
+
+int testJsonFunction(void)
+{
+    ThrottleSettings_c settings, settings2;
+    Board_c board, board2;
+    VarintTester_c varint, varint2;
+    Date_c date;
+    char json[1000];
+    char small[20];
+    int length;
+
+    settings.numCurvePoints = 3;
+    settings.enableCurve = 1;
+    for(int i = 0; i < settings.numCurvePoints; i++)
+    {
+        settings.curvePoint[i].throttle = i*0.1f;
+        settings.curvePoint[i].PWM = 1000 + i*333;
+    }
+
+    length = settings.jsonEncode(json, sizeof(json));
+    if((length <= 0) || (length != (int)strlen(json)) || (length != settings.jsonEncode(nullptr, 0)))
+    {
+        std::cout << "JSON encode of throttle settings returned the wrong length" << std::endl;
+        return 0;
+    }
+
+    if((settings2.jsonDecode(json, length) != length) || !settings2.equals(&settings))
+    {
+        std::cout << "JSON decode of throttle settings failed: " << json << std::endl;
+        return 0;
+    }
+
+    // Truncated output is terminated, and still reports the full length
+    if((settings.jsonEncode(small, sizeof(small)) != length) || (strlen(small) != sizeof(small) - 1) || (strncmp(small, json, sizeof(small) - 1) != 0))
+    {
+        std::cout << "JSON encode of throttle settings into a small buffer failed" << std::endl;
+        return 0;
+    }
+
+    // Strings with characters that must be escaped
+    board.manufactureDate.year = 2020;
+    board.serialNumber = 4000000000u;
+    board.isCalibrated = 1;
+    strcpy(board.description, "a \"quoted\" \\ name\t");
+    length = board.jsonEncode(json, sizeof(json));
+    if((board2.jsonDecode(json, length) != length) || !board2.equals(&board))
+    {
+        std::cout << "JSON decode of board failed: " << json << std::endl;
+        return 0;
+    }
+
+    // 64-bit limits are exact
+    varint.minimum32 = INT32_MIN;
+    varint.maximum32 = INT32_MAX;
+    varint.large = UINT64_MAX;
+    varint.minimum64 = INT64_MIN;
+    varint.maximum64 = INT64_MAX;
+    length = varint.jsonEncode(json, sizeof(json));
+    if((varint2.jsonDecode(json, length) != length) || !varint2.equals(&varint))
+    {
+        std::cout << "JSON decode of varint tester failed: " << json << std::endl;
+        return 0;
+    }
+
+    // Members in any order, with white space and unknown members
+    const char text[] = " { \"day\" : 3, \"unknown\": [1, {\"a\": \"}\"}], \"year\":2021,\"month\":4 } ";
+    if((date.jsonDecode(text, (int)strlen(text)) <= 0) || (date.year != 2021) || (date.month != 4) || (date.day != 3))
+    {
+        std::cout << "JSON decode of date with unknown members failed" << std::endl;
+        return 0;
+    }
+
+    // Invalid text
+    const char bad[] = "{\"year\":2021,\"month\":}";
+    if(date.jsonDecode(bad, (int)strlen(bad)) != -1)
+    {
+        std::cout << "JSON decode of invalid text did not fail" << std::endl;
+        return 0;
+    }
+
+    return 1;
+}
+
+
+int testMapFunction(void)
+{
+    ThrottleSettings_c settings, settings2;
+    Board_c board, board2;
+    FieldMap map;
+    unsigned long long number = 0;
+    char text[100];
+
+    settings.numCurvePoints = 3;
+    settings.enableCurve = 1;
+    for(int i = 0; i < settings.numCurvePoints; i++)
+    {
+        settings.curvePoint[i].throttle = i*0.25f;
+        settings.curvePoint[i].PWM = 1000 + i*333;
+    }
+
+    // The string_view overloads, the keys have the prefix and the field names
+    settings.mapEncode("Throttle", map);
+    if(!fieldMapToUnsigned(map.find("Throttle:curvePoint[2]:PWM"), &number) || (number != 1666))
+    {
+        std::cout << "Map encode of throttle settings did not have the expected key" << std::endl;
+        return 0;
+    }
+
+    settings2.mapDecode("Throttle", map);
+    if(!settings2.equals(&settings))
+    {
+        std::cout << "Map decode of throttle settings failed" << std::endl;
+        return 0;
+    }
+
+    // The reused key overloads, the key is restored after every call
+    board.manufactureDate.year = 2020;
+    board.manufactureDate.month = 5;
+    board.manufactureDate.day = 12;
+    board.serialNumber = 4000000000u;
+    board.isCalibrated = 1;
+    strcpy(board.description, "map board");
+
+    std::string key("Board");
+    map.clear();
+    board.mapEncode(key, map);
+    if(key != "Board")
+    {
+        std::cout << "Map encode of board did not restore the key: " << key << std::endl;
+        return 0;
+    }
+
+    if(!fieldMapToUnsigned(map.find("Board:manufactureDate:year"), &number) || (number != 2020) ||
+       !fieldMapToString(map.find(key, ":description"), text, sizeof(text)) || (strcmp(text, board.description) != 0) || (key != "Board"))
+    {
+        std::cout << "Map encode of board did not have the expected keys" << std::endl;
+        return 0;
+    }
+
+    board2.mapDecode(key, map);
+    if((key != "Board") || !board2.equals(&board))
+    {
+        std::cout << "Map decode of board failed" << std::endl;
+        return 0;
+    }
+
+    // Nothing is found with the wrong prefix
+    settings2.numCurvePoints = 0;
+    settings2.mapDecode("Board", map);
+    if(settings2.numCurvePoints != 0)
+    {
+        std::cout << "Map decode of throttle settings found a key it should not have" << std::endl;
+        return 0;
+    }
+
+    return 1;
+}
+
+
+int testDeltaPacket(void)
+{
+    ThrottleSettings_c reference, settings, decoded;
+    testPacket_c pkt;
+
+    reference.numCurvePoints = 3;
+    for(uint32_t i = 0; i < reference.numCurvePoints; i++)
+        reference.curvePoint[i].PWM = 1100 + i*400;
+
+    // The throttle is scaled into 8 bits, so use a value which decodes exactly
+    reference.curvePoint[2].throttle = 1.0f;
+    reference.lowPWM = 1100;
+    reference.highPWM = 1900;
+    settings = reference;
+
+    // Nothing changed: only the bitmap is sent
+    settings.encodeDelta(&pkt, &reference);
+    decoded = reference;
+    if((pkt.length != 1) || !decoded.decodeDelta(&pkt) || !decoded.equals(&settings))
+    {
+        std::cout << "Delta packet with no changes failed" << std::endl;
+        return 0;
+    }
+
+    // The bitmap and one 16-bit field
+    settings.highPWM = 2000;
+    settings.encodeDelta(&pkt, &reference);
+    decoded = reference;
+    if((pkt.length != 3) || !decoded.decodeDelta(&pkt) || !decoded.equals(&settings))
+    {
+        std::cout << "Delta packet with one change failed" << std::endl;
+        return 0;
+    }
+
+    // Any change to the curve sends all 3 points of 3 bytes
+    settings.curvePoint[1].PWM = 1234;
+    settings.encodeDelta(&pkt, &reference);
+    decoded = reference;
+    if((pkt.length != 12) || !decoded.decodeDelta(&pkt) || !decoded.equals(&settings))
+    {
+        std::cout << "Delta packet with a changed curve point failed" << std::endl;
+        return 0;
+    }
+
+    // A longer curve also sends the bitfield group which holds its length
+    settings.numCurvePoints = 4;
+    settings.curvePoint[3].throttle = 1.0f;
+    settings.curvePoint[3].PWM = 2100;
+    settings.encodeDelta(&pkt, &reference);
+    decoded = reference;
+    if((pkt.length != 19) || !decoded.decodeDelta(&pkt) || !decoded.equals(&settings))
+    {
+        std::cout << "Delta packet with a longer curve failed" << std::endl;
+        return 0;
+    }
+
+    // A delta packet is not a normal packet
+    if(decoded.decode(&pkt) && decoded.equals(&settings))
+    {
+        std::cout << "Delta packet decoded as a normal packet" << std::endl;
+        return 0;
+    }
+
+    return 1;
+}
+
+
+int testHashFunction(void)
+{
+    ThrottleSettings_c settings1, settings2;
+    Board_c board1, board2;
+    Date_c date;
+
+    // The hash is the same on any host
+    date.year = 2020;
+    date.month = 5;
+    date.day = 12;
+    if(date.hash() != 0x67A0F23E4ECA4483ULL)
+    {
+        std::cout << "Hash of date has the wrong value" << std::endl;
+        return 0;
+    }
+
+    // Curve points past the variable array length are not encoded, so they are not hashed
+    settings1.numCurvePoints = 2;
+    settings1.curvePoint[0].PWM = 1000;
+    settings1.curvePoint[1].PWM = 2000;
+    settings2 = settings1;
+    settings2.curvePoint[5].PWM = 1234;
+    if(settings1.hash() != settings2.hash())
+    {
+        std::cout << "Hash of throttle settings depends on unused curve points" << std::endl;
+        return 0;
+    }
+
+    settings2.curvePoint[1].PWM = 2001;
+    if(settings1.hash() == settings2.hash())
+    {
+        std::cout << "Hash of throttle settings did not change with a curve point" << std::endl;
+        return 0;
+    }
+
+    // Strings are hashed up to their terminator
+    board1.manufactureDate = date;
+    strcpy(board1.description, "abc");
+    board2 = board1;
+    board2.description[5] = 'x';
+    if(board1.hash() != board2.hash())
+    {
+        std::cout << "Hash of board depends on text after the description" << std::endl;
+        return 0;
+    }
+
+    board2.manufactureDate.day = 13;
+    if(board1.hash() == board2.hash())
+    {
+        std::cout << "Hash of board did not change with the date" << std::endl;
+        return 0;
+    }
+
+    // Boards which are equal are one key of an unordered set
+    std::unordered_set<Board_c> boards;
+    board2.manufactureDate.day = 12;
+    boards.insert(board1);
+    boards.insert(board2);
+    if(boards.size() != 1)
+    {
+        std::cout << "Unordered set of boards has the wrong size" << std::endl;
+        return 0;
+    }
+
+    return 1;
+}
+
+
 int fcompare(double input1, double input2, double epsilon)
 {
     if(fabs(input1 - input2) > epsilon)
@@ -0,0 +1,161 @@
+#include "attributeindex.h"
+
+/*!
+ * Construct the keys from a list of names
+ * \param list is the list of attribute names.
+ */
+AttributeKeys::AttributeKeys(std::initializer_list<const char*> list) :
+    names(list.begin(), list.end()),
+    seed(0),
+    mask(0)
+{
+    buildTable();
+}
+
+
+/*!
+ * Construct the keys from the names of other keys plus some new names. This
+ * is used by elements which understand all the attributes of another kind
+ * of element, plus some more.
+ * \param base are the keys whose names are included first.
+ * \param list is the list of additional attribute names.
+ */
+AttributeKeys::AttributeKeys(const AttributeKeys& base, std::initializer_list<const char*> list) :
+    names(base.names),
+    seed(0),
+    mask(0)
+{
+    names.insert(names.end(), list.begin(), list.end());
+    buildTable();
+}
+
+
+/*!
+ * Build the hash table for the names. The table has at least twice as many
+ * slots as there are names, and the seed is searched until every name lands
+ * in its own slot, which makes the hash perfect for this set of names.
+ */
+void AttributeKeys::buildTable(void)
+{
+    std::size_t size = 8;
+    while(size < 2*names.size())
+        size *= 2;
+
+    for(;; size *= 2)
+    {
+        mask = (uint32_t)(size - 1);
+
+        // A handful of seeds is almost always enough, if not grow the table
+        for(seed = 0; seed < 64; seed++)
+        {
+            table.assign(size, -1);
+
+            std::size_t i = 0;
+            for(; i < names.size(); i++)
+            {
+                uint32_t slot = hash(names.at(i).c_str(), seed) & mask;
+
+                // A repeated name just keeps its first slot
+                if((table.at(slot) >= 0) && !XMLUtil::StringEqual(names.at(table.at(slot)).c_str(), names.at(i).c_str()))
+                    break;
+
+                if(table.at(slot) < 0)
+                    table[slot] = (int)i;
+            }
+
+            if(i >= names.size())
+                return;
+
+        }// for all seeds to try
+
+    }// for all table sizes
+
+}// AttributeKeys::buildTable
+
+
+/*!
+ * Compute the FNV-1a hash of a name. Attribute names are not case sensitive,
+ * so the hash is computed on the lower case characters.
+ * \param name is the null terminated name to hash.
+ * \param seed is mixed into the initial hash value.
+ * \return the hash.
+ */
+uint32_t AttributeKeys::hash(const char* name, uint32_t seed)
+{
+    uint32_t value = 2166136261u ^ (seed*0x9E3779B9u);
+
+    for(; *name != 0; name++)
+    {
+        char character = *name;
+
+        // The same conversion as XMLUtil::StringEqual()
+        if((character >= 'A') && (character <= 'Z'))
+            character += (char)('a' - 'A');
+
+        value ^= (uint8_t)character;
+        value *= 16777619u;
+    }
+
+    return value;
+}
+
+
+/*!
+ * Find the index of a name
+ * \param name is the name to find, which is not case sensitive.
+ * \return the index of the name, or -1 if the name is not one of the keys.
+ */
+int AttributeKeys::find(const char* name) const
+{
+    int index = table.at(hash(name, seed) & mask);
+
+    if((index >= 0) && XMLUtil::StringEqual(names.at(index).c_str(), name))
+        return index;
+    else
+        return -1;
+}
+
+
+/*!
+ * Index the attributes of an element in one pass.
+ * \param map is the first attribute of the element, can be null.
+ * \param attribkeys are the attribute names that this kind of element understands.
+ */
+AttributeIndex::AttributeIndex(const XMLAttribute* map, const AttributeKeys& attribkeys) :
+    keys(attribkeys),
+    known(attribkeys.size(), nullptr)
+{
+    for(const XMLAttribute* a = map; a != nullptr; a = a->Next())
+    {
+        int index = keys.find(a->Name());
+
+        if(index < 0)
+            unrecognized.push_back(a);
+        else if(known.at(index) == nullptr)
+            known[index] = a;
+    }
+}
+
+
+/*!
+ * Find an attribute by name
+ * \param name is the name of the attribute, which is not case sensitive.
+ * \return the first attribute with this name, or nullptr if there is none.
+ */
+const XMLAttribute* AttributeIndex::find(const char* name) const
+{
+    int index = keys.find(name);
+
+    if(index >= 0)
+        return known.at(index);
+
+    // Not one of the keys, the attribute might still be present
+    for(std::size_t i = 0; i < unrecognized.size(); i++)
+    {
+        if(XMLUtil::StringEqual(unrecognized.at(i)->Name(), name))
+            return unrecognized.at(i);
+    }
+
+    return nullptr;
+
+}// AttributeIndex::find
@@ -0,0 +1,75 @@
+#ifndef ATTRIBUTEINDEX_H
+#define ATTRIBUTEINDEX_H
+
+#include "protocolsupport.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <initializer_list>
+
+/*!
+ * The attribute keys are the names of the attributes that one kind of
+ * element (Data, Structure, Packet, Enum, ...) understands. The names are
+ * placed in a perfect hash table when the keys are constructed, so finding
+ * the index of a name costs one hash and one string comparison. Like the
+ * rest of the parser, names are not case sensitive. Each kind of
+ * element has one set of keys, shared by every object of that kind.
+ */
+class AttributeKeys
+{
+public:
+
+    //! Construct the keys from a list of names
+    AttributeKeys(std::initializer_list<const char*> names);
+
+    //! Construct the keys from the names of other keys plus some new names
+    AttributeKeys(const AttributeKeys& base, std::initializer_list<const char*> names);
+
+    //! Find the index of a name, or -1 if the name is not a key
+    int find(const char* name) const;
+
+    //! Get the number of keys
+    std::size_t size(void) const {return names.size();}
+
+private:
+
+    //! Build the perfect hash table for the names
+    void buildTable(void);
+
+    //! Compute the hash of a name
+    static uint32_t hash(const char* name, uint32_t seed);
+
+    std::vector<std::string> names;     //!< The names in the order they were given
+    std::vector<int> table;             //!< Index into names for each hash slot, -1 for an empty slot
+    uint32_t seed;                      //!< Hash seed which gives no collisions for these names
+    uint32_t mask;                      //!< Mask which converts a hash to a slot
+};
+
+
+/*!
+ * The attribute index reads the attributes of an element in one pass,
+ * placing each known attribute in the slot given by the element's keys and
+ * remembering the attributes that are not known, so that they can be warned
+ * about without a second pass.
+ */
+class AttributeIndex
+{
+public:
+
+    //! Index the attributes of an element
+    AttributeIndex(const XMLAttribute* map, const AttributeKeys& keys);
+
+    //! Find an attribute by name, returns nullptr if the element does not have it
+    const XMLAttribute* find(const char* name) const;
+
+    //! Get the attributes that are not in the keys, in the order they appear
+    const std::vector<const XMLAttribute*>& getUnrecognized(void) const {return unrecognized;}
+
+private:
+
+    const AttributeKeys& keys;                  //!< The keys used to index the attributes
+    std::vector<const XMLAttribute*> known;     //!< The attribute for each key, or nullptr
+    std::vector<const XMLAttribute*> unrecognized;//!< Attributes that are not in the keys
+};
+
+#endif // ATTRIBUTEINDEX_H
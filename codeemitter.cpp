@@ -0,0 +1,78 @@
+#include "codeemitter.h"
+#include "protocolfile.h"
+
+// One level of indentation, the same as ProtocolDocumentation::TAB_IN
+const std::string CodeEmitter::TAB_IN = "    ";
+
+/*!
+ * Construct an emitter which owns its buffer
+ * \param reserve is the number of bytes to reserve in the buffer.
+ */
+CodeEmitter::CodeEmitter(std::size_t reserve) :
+    buffer(owned),
+    start(0),
+    level(0)
+{
+    owned.reserve(reserve);
+}
+
+
+/*!
+ * Construct an emitter which appends directly to the contents of a file. The
+ * file is marked as dirty and as having non-trivial content, exactly as if
+ * ProtocolFile::write() had been called.
+ * \param file is the file which receives the text.
+ */
+CodeEmitter::CodeEmitter(ProtocolFile& file) :
+    buffer(file.getEmitterBuffer()),
+    start(buffer.size()),
+    level(0)
+{
+}
+
+
+/*!
+ * Append text, padded with trailing spaces so that it is at least width
+ * characters long. This is the same as appending spacedString(text, width).
+ * \param text is the text to append.
+ * \param width is the minimum number of characters to append.
+ * \return a reference to this emitter.
+ */
+CodeEmitter& CodeEmitter::appendPadded(const std::string& text, std::size_t width)
+{
+    buffer.append(text);
+
+    if(text.size() < width)
+        buffer.append(width - text.size(), ' ');
+
+    return *this;
+}
+
+
+/*!
+ * Make sure the emitted text ends such that there is exactly one blank line
+ * between it and anything that is added after this function. This only
+ * considers the text emitted by this emitter, so it does nothing if nothing
+ * has been emitted, just like ProtocolFile::makeLineSeparator(std::string&)
+ * does for an empty string.
+ */
+void CodeEmitter::makeLineSeparator(void)
+{
+    if(buffer.size() <= start)
+        return;
+
+    std::size_t last = buffer.size();
+
+    // Count the linefeeds at the end of the emitted text
+    while((last > start) && (buffer.at(last - 1) == '\n'))
+        last--;
+
+    std::size_t linefeeds = buffer.size() - last;
+
+    // Exactly two linefeeds, even if the emitted text is only linefeeds
+    if(linefeeds > 2)
+        buffer.erase(last + 2);
+    else
+        buffer.append(2 - linefeeds, '\n');
+
+}// CodeEmitter::makeLineSeparator
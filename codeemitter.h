@@ -0,0 +1,102 @@
+#ifndef CODEEMITTER_H
+#define CODEEMITTER_H
+
+#include <string>
+#include <cstddef>
+#include <charconv>
+#include <type_traits>
+
+class ProtocolFile;
+
+/*!
+ * The code emitter appends generated text to a buffer without creating the
+ * temporary strings that chains like `output += a + b + c` create. The buffer
+ * is either owned by the emitter, or is the contents of a ProtocolFile, in
+ * which case the text goes directly to the file. The emitter also tracks an
+ * indentation level, which is applied by line().
+ */
+class CodeEmitter
+{
+public:
+
+    //! Construct an emitter which owns its buffer
+    CodeEmitter(std::size_t reserve = 1024);
+
+    //! Construct an emitter which appends to the contents of a file
+    CodeEmitter(ProtocolFile& file);
+
+    //! Append any number of strings, characters, or integers
+    template<typename... Args>
+    CodeEmitter& append(const Args&... args)
+    {
+        (appendOne(args), ...);
+        return *this;
+    }
+
+    //! Append the indentation, any number of strings, characters, or integers, and a line feed
+    template<typename... Args>
+    CodeEmitter& line(const Args&... args)
+    {
+        for(int i = 0; i < level; i++)
+            buffer.append(TAB_IN);
+
+        (appendOne(args), ...);
+        buffer.push_back('\n');
+        return *this;
+    }
+
+    //! Append text, padded with trailing spaces to be at least width characters
+    CodeEmitter& appendPadded(const std::string& text, std::size_t width);
+
+    //! Append a character count times
+    CodeEmitter& appendRepeated(char character, std::size_t count) {buffer.append(count, character); return *this;}
+
+    //! Increase the indentation used by line()
+    void indent(void) {level++;}
+
+    //! Decrease the indentation used by line()
+    void unindent(void) {if(level > 0) level--;}
+
+    //! Make sure there is exactly one blank line at the end of the emitted text
+    void makeLineSeparator(void);
+
+    //! \return true if nothing has been emitted
+    bool empty(void) const {return buffer.size() <= start;}
+
+    //! \return the buffer, which includes anything that was in it before this emitter
+    const std::string& str(void) const {return buffer;}
+
+    //! \return the buffer, leaving it empty. Only use this if the emitter owns the buffer
+    std::string take(void) {std::string output; output.swap(buffer); start = 0; return output;}
+
+    //! The string used for one level of indentation
+    static const std::string TAB_IN;
+
+private:
+
+    //! The emitter is not copyable, it may refer to a file buffer
+    CodeEmitter(const CodeEmitter&) = delete;
+
+    //! The emitter is not copyable, it may refer to a file buffer
+    CodeEmitter& operator=(const CodeEmitter&) = delete;
+
+    void appendOne(const std::string& text) {buffer.append(text);}
+    void appendOne(const char* text) {buffer.append(text);}
+    void appendOne(char character) {buffer.push_back(character);}
+
+    //! Append an integer using to_chars, which does not allocate
+    template<typename T>
+    typename std::enable_if<std::is_integral<T>::value>::type appendOne(T value)
+    {
+        char text[24];
+        std::to_chars_result result = std::to_chars(text, text + sizeof(text), value);
+        buffer.append(text, result.ptr);
+    }
+
+    std::string owned;      //!< Buffer used when the emitter does not write to a file
+    std::string& buffer;    //!< The buffer that receives the text
+    std::size_t start;      //!< Size of the buffer when the emitter was constructed
+    int level;              //!< Indentation level used by line()
+};
+
+#endif // CODEEMITTER_H
@@ -4,12 +4,14 @@
 #include "protocolcode.h"
 #include "protocoldocumentation.h"
 #include "protocolparser.h"
+#include "shuntingyard.h"
 
 /*!
  * Constructor for encodable
  */
-Encodable::Encodable(ProtocolParser* parse, const std::string& Parent, ProtocolSupport supported) :
-    ProtocolDocumentation(parse, Parent, supported)
+Encodable::Encodable(ProtocolParser* parse, const std::string& Parent, const ProtocolSupport& supported) :
+    ProtocolDocumentation(parse, Parent, supported),
+    limitonencode(supported.limitonencode)
 {
 }
 
@@ -372,23 +374,318 @@ std::string Encodable::getEncodeArrayIterationCode(const std::string& spacing, b
             output += spacing + "for(_pg_i = 0; _pg_i < (unsigned)" + getEncodeFieldAccess(isStructureMember, variableArray) + " && _pg_i < " + array + "; _pg_i++)\n";
         }
 
+        output += getEncodeElementIterationCode(spacing + TAB_IN, isStructureMember);
+    }
+
+    return output;
+
+}// Encodable::getEncodeArrayIterationCode
+
+
+/*!
+ * Get the code that iterates over one element of the first dimension of the
+ * array, in a encode context. Only a 2d array needs this, to iterate its
+ * second dimension.
+ * \param spacing is the spacing that begins the array iteration line
+ * \param isStructureMember should be true if variable array limits are members of a structure
+ * \return the code for array iteration, which may be empty
+ */
+std::string Encodable::getEncodeElementIterationCode(const std::string& spacing, bool isStructureMember) const
+{
+    std::string output;
+
+    if(is2dArray())
+    {
+        if(variable2dArray.empty())
+        {
+            output += spacing + "for(_pg_j = 0; _pg_j < " + array2d + "; _pg_j++)\n";
+        }
+        else
+        {
+            output += spacing + "for(_pg_j = 0; _pg_j < (unsigned)" + getEncodeFieldAccess(isStructureMember, variable2dArray) + " && _pg_j < " + array2d + "; _pg_j++)\n";
+        }
+    }
+
+    return output;
+
+}// Encodable::getEncodeElementIterationCode
+
+
+/*!
+ * Get the number of array elements that are encoded, which is limited by the
+ * array size, just like the array iteration code of the encode.
+ * \param isStructureMember should be true if variable array limits are members of a structure
+ * \return the number of elements as an expression, "1" if this is not an array
+ */
+std::string Encodable::getEncodedArrayCount(bool isStructureMember) const
+{
+    if(!isArray())
+        return "1";
+
+    std::string count = getEncodedElementCount(isStructureMember);
+
+    if(is2dArray())
+    {
+        // The first dimension is multiplied by the second
+        if(variableArray.empty())
+            count = "(" + count + ")";
+
+        if(variable2dArray.empty())
+            count += "*(" + array2d + ")";
+        else
+        {
+            std::string variable = "(unsigned)" + getEncodeFieldAccess(isStructureMember, variable2dArray);
+            count += "*((" + variable + " < (unsigned)(" + array2d + ")) ? " + variable + " : (unsigned)(" + array2d + "))";
+        }
+    }
+
+    return count;
+
+}// Encodable::getEncodedArrayCount
+
+
+/*!
+ * Get the number of elements of the first dimension of the array that are
+ * encoded, which is limited by the array size. An element of a 2d array is
+ * one row of the second dimension.
+ * \param isStructureMember should be true if variable array limits are members of a structure
+ * \return the number of elements as an expression, "1" if this is not an array
+ */
+std::string Encodable::getEncodedElementCount(bool isStructureMember) const
+{
+    if(!isArray())
+        return "1";
+
+    if(variableArray.empty())
+        return array;
+
+    // The array size may be an enumeration, which is cast so both sides of the conditional have the same type
+    std::string variable = "(unsigned)" + getEncodeFieldAccess(isStructureMember, variableArray);
+    return "((" + variable + " < (unsigned)(" + array + ")) ? " + variable + " : (unsigned)(" + array + "))";
+
+}// Encodable::getEncodedElementCount
+
+
+/*!
+ * Get the maximum number of array elements as a number, for estimates made by
+ * the generator. Strings are not treated as arrays.
+ * \return the number of elements, 1 if this is not an array or if the array
+ *         size cannot be computed.
+ */
+int Encodable::getMaximumArrayCount(void) const
+{
+    bool ok = false;
+    int count = 1;
+
+    if(!isArray() || isString())
+        return count;
+
+    double number = ShuntingYard::computeInfix(parser->replaceEnumerationNameWithValue(array), &ok);
+    if(ok && (number >= 1))
+        count = (int)number;
+
+    if(is2dArray())
+    {
+        number = ShuntingYard::computeInfix(parser->replaceEnumerationNameWithValue(array2d), &ok);
+        if(ok && (number >= 1))
+            count *= (int)number;
+    }
+
+    return count;
+
+}// Encodable::getMaximumArrayCount
+
+
+/*!
+ * Get the string literal that starts this field in a JSON object, which is
+ * the separator and the quoted name, followed by the colon. The name is an
+ * identifier, so it does not need any escapes other than the quotes.
+ * \param first should be true if this is the first field of the object,
+ *        in which case the literal starts the object.
+ * \return the string literal, with its quotes, as it appears in the generated code
+ */
+std::string Encodable::getJsonKeyLiteral(bool first) const
+{
+    if(first)
+        return "\"{\\\"" + name + "\\\":\"";
+    else
+        return "\",\\\"" + name + "\\\":\"";
+
+}// Encodable::getJsonKeyLiteral
+
+
+/*!
+ * Get the string used to encode this field to JSON. The key is written first,
+ * and arrays are written as JSON arrays (of arrays), around the values from
+ * getJsonEncodeValueString().
+ * \param first should be true if this is the first field of the object.
+ * \return the string used to encode this field to JSON
+ */
+std::string Encodable::getJsonEncodeMemberString(bool first) const
+{
+    CodeEmitter output;
+    std::string key = getJsonKeyLiteral(first);
+
+    if(!isArray())
+        return getJsonEncodeValueString(TAB_IN, key);
+
+    // The array bracket goes inside the key literal
+    output.append(TAB_IN, "jsonText(_pg_json, _pg_size, _pg_index, ", key.substr(0, key.size() - 1), "[\");\n");
+
+    // The first line is the outer loop, the second (if any) is the inner loop
+    std::string loops = getEncodeArrayIterationCode(TAB_IN, true);
+    std::size_t split = loops.find('\n') + 1;
+
+    output.append(loops.substr(0, split));
+    output.append(TAB_IN, "{\n");
+
+    if(is2dArray())
+    {
+        output.append(TAB_IN, TAB_IN, "jsonText(_pg_json, _pg_size, _pg_index, (_pg_i == 0) ? \"[\" : \",[\");\n");
+        output.append(loops.substr(split));
+        output.append(TAB_IN, TAB_IN, "{\n");
+        output.append(getJsonEncodeValueString(TAB_IN + TAB_IN + TAB_IN, "(_pg_j == 0) ? \"\" : \",\""));
+        output.append(TAB_IN, TAB_IN, "}\n");
+        output.append(TAB_IN, TAB_IN, "jsonText(_pg_json, _pg_size, _pg_index, \"]\");\n");
+    }
+    else
+        output.append(getJsonEncodeValueString(TAB_IN + TAB_IN, "(_pg_i == 0) ? \"\" : \",\""));
+
+    output.append(TAB_IN, "}\n");
+    output.append(TAB_IN, "jsonText(_pg_json, _pg_size, _pg_index, \"]\");\n");
+
+    return output.take();
+
+}// Encodable::getJsonEncodeMemberString
+
+
+/*!
+ * Get the string used to decode this field from JSON, which is one branch of
+ * the key comparisons of the structure decode. Arrays are read as JSON arrays
+ * (of arrays); elements beyond the in-memory array are parsed but discarded.
+ * \return the string used to decode this field from JSON
+ */
+std::string Encodable::getJsonDecodeMemberString(void) const
+{
+    CodeEmitter output;
+    std::string spacing = TAB_IN + TAB_IN + TAB_IN;
+
+    // The key comparisons are inside the loop over the members of the object
+    output.append(TAB_IN, TAB_IN, "else if(_pg_key == \"", name, "\")\n");
+    output.append(TAB_IN, TAB_IN, "{\n");
+
+    if(!isArray())
+        output.append(getJsonDecodeValueString(spacing, std::string()));
+    else
+    {
+        std::string condition = "_pg_i < (unsigned)(" + array + ")";
+
+        output.append(spacing, "if(!jsonBegin(_pg_json, _pg_length, _pg_index, '['))\n");
+        output.append(spacing, TAB_IN, "return false;\n");
+        output.append(spacing, "for(_pg_i = 0; (_pg_next = jsonNext(_pg_json, _pg_length, _pg_index, _pg_i, ']')) > 0; _pg_i++)\n");
+        output.append(spacing, "{\n");
+
         if(is2dArray())
         {
-            if(variable2dArray.empty())
-            {
-                output += spacing + TAB_IN + "for(_pg_j = 0; _pg_j < " + array2d + "; _pg_j++)\n";
-            }
-            else
-            {
-                output += spacing + TAB_IN + "for(_pg_j = 0; _pg_j < (unsigned)" + getEncodeFieldAccess(isStructureMember, variable2dArray) + " && _pg_j < " + array2d + "; _pg_j++)\n";
-            }
+            condition = "(" + condition + ") && (_pg_j < (unsigned)(" + array2d + "))";
+
+            output.append(spacing, TAB_IN, "if(!jsonBegin(_pg_json, _pg_length, _pg_index, '['))\n");
+            output.append(spacing, TAB_IN, TAB_IN, "return false;\n");
+            output.append(spacing, TAB_IN, "for(_pg_j = 0; (_pg_next = jsonNext(_pg_json, _pg_length, _pg_index, _pg_j, ']')) > 0; _pg_j++)\n");
+            output.append(spacing, TAB_IN, "{\n");
+            output.append(getJsonDecodeValueString(spacing + TAB_IN + TAB_IN, condition));
+            output.append(spacing, TAB_IN, "}\n");
+            output.append(spacing, TAB_IN, "if(_pg_next < 0)\n");
+            output.append(spacing, TAB_IN, TAB_IN, "return false;\n");
         }
+        else
+            output.append(getJsonDecodeValueString(spacing + TAB_IN, condition));
 
+        output.append(spacing, "}\n");
+        output.append(spacing, "if(_pg_next < 0)\n");
+        output.append(spacing, TAB_IN, "return false;\n");
     }
 
-    return output;
+    output.append(TAB_IN, TAB_IN, "}\n");
 
-}// Encodable::getEncodeArrayIterationCode
+    return output.take();
+
+}// Encodable::getJsonDecodeMemberString
+
+
+/*!
+ * Get the condition that determines if this encodable is encoded, based on
+ * the dependsOn field.
+ * \param isStructureMember should be true if the dependsOn field is a member of a structure
+ * \return the condition, like "if(_pg_user->flag)", empty if there is no dependsOn
+ */
+std::string Encodable::getEncodeDependsOnCondition(bool isStructureMember) const
+{
+    if(dependsOn.empty())
+        return std::string();
+
+    std::string output = "if(" + getEncodeFieldAccess(isStructureMember, dependsOn);
+
+    if(!dependsOnValue.empty())
+        output += " " + dependsOnCompare + " " + dependsOnValue;
+
+    return output + ")";
+
+}// Encodable::getEncodeDependsOnCondition
+
+
+/*!
+ * Get the condition that is true if this encodable, as a member of a packet
+ * structure, differs from the same member of the reference structure of a
+ * delta encode. Integers are compared with `!=`, strings with strncmp, and
+ * everything else as memory. Floating point is compared as memory because
+ * `!=` would miss the change from 0.0 to -0.0, which encode differently.
+ * Padding in a structure can only cause an unchanged member to be sent. The
+ * fields that give the array lengths, or that this encodable depends on, are
+ * part of the condition because a change in them changes what the decoder
+ * reads. An encodable that overrides a previous one is sent when the member
+ * it encodes again changes, since the decoder takes the member from it.
+ * \return the condition, empty if this encodable has nothing to send
+ */
+std::string Encodable::getDeltaChangedCondition(void) const
+{
+    if((isNotInMemory() && !overridesPreviousEncodable()) || isNotEncoded() || isConstant())
+        return std::string();
+
+    std::string user;
+    std::string reference = "_pg_reference->";
+
+    // In C++ the current values are the members of this class
+    if(support.language == ProtocolSupport::c_language)
+        user = "_pg_user->";
+
+    std::string current = user + name;
+    std::string previous = reference + name;
+    CodeEmitter output;
+
+    const std::string dependencies[] = {variableArray, variable2dArray, dependsOn};
+    for(const std::string& dependency : dependencies)
+    {
+        if(!dependency.empty())
+            output.append("(", user, dependency, " != ", reference, dependency, ") || ");
+    }
+
+    if(isString())
+        output.append("(strncmp(", current, ", ", previous, ", ", array, ") != 0)");
+    else if(!isArray() && isPrimitive() && !isFloat())
+        output.append("(", current, " != ", previous, ")");
+    else if(!variableArray.empty() && variable2dArray.empty())
+    {
+        // Only the elements in use, the length itself was tested above
+        std::string count = "(((unsigned)" + user + variableArray + " < (unsigned)(" + array + ")) ? (unsigned)" + user + variableArray + " : (unsigned)(" + array + "))";
+        output.append("(memcmp(", current, ", ", previous, ", ", count, "*sizeof(", current, "[0])) != 0)");
+    }
+    else
+        output.append("(memcmp(&", current, ", &", previous, ", sizeof(", current, ")) != 0)");
+
+    return output.take();
+
+}// Encodable::getDeltaChangedCondition
 
 
 /*!
@@ -412,23 +709,41 @@ std::string Encodable::getDecodeArrayIterationCode(const std::string& spacing, b
             output += spacing + "for(_pg_i = 0; _pg_i < (unsigned)" + getDecodeFieldAccess(isStructureMember, variableArray) + " && _pg_i < " + array + "; _pg_i++)\n";
         }
 
-        if(is2dArray())
+        output += getDecodeElementIterationCode(spacing + TAB_IN, isStructureMember);
+    }
+
+    return output;
+
+}// Encodable::getDecodeArrayIterationCode
+
+
+/*!
+ * Get the code that iterates over one element of the first dimension of the
+ * array, in a decode context. Only a 2d array needs this, to iterate its
+ * second dimension.
+ * \param spacing is the spacing that begins the array iteration line
+ * \param isStructureMember should be true if variable array limits are members of a structure
+ * \return the code for array iteration, which may be empty
+ */
+std::string Encodable::getDecodeElementIterationCode(const std::string& spacing, bool isStructureMember) const
+{
+    std::string output;
+
+    if(is2dArray())
+    {
+        if(variable2dArray.empty())
         {
-            if(variable2dArray.empty())
-            {
-                output += spacing + TAB_IN + "for(_pg_j = 0; _pg_j < " + array2d + "; _pg_j++)\n";
-            }
-            else
-            {
-                output += spacing + TAB_IN + "for(_pg_j = 0; _pg_j < (unsigned)" + getDecodeFieldAccess(isStructureMember, variable2dArray) + " && _pg_j < " + array2d + "; _pg_j++)\n";
-            }
+            output += spacing + "for(_pg_j = 0; _pg_j < " + array2d + "; _pg_j++)\n";
+        }
+        else
+        {
+            output += spacing + "for(_pg_j = 0; _pg_j < (unsigned)" + getDecodeFieldAccess(isStructureMember, variable2dArray) + " && _pg_j < " + array2d + "; _pg_j++)\n";
         }
-
     }
 
     return output;
 
-}// Encodable::getDecodeArrayIterationCode
+}// Encodable::getDecodeElementIterationCode
 
 
 /*!
@@ -506,10 +821,12 @@ std::string Encodable::getRepeatsDocumentationDetails(void) const
  * \param Parent is the hierarchical name of the objec which owns the newly created object
  * \param supported describes what the protocol can support
  * \param field is the DOM element to parse (including its children)
- * \return a pointer to a newly allocated encodable. The caller is
- *         responsible for deleting this object.
+ * \param limitonencode is the limit on encode setting of the parent, which the
+ *        new object inherits unless its own attributes override it
+ * \return a pointer to a newly allocated encodable. The object is owned by
+ *         the arena of the parser, the caller must not delete it.
  */
-Encodable* Encodable::generateEncodable(ProtocolParser* parse, const std::string& parent, ProtocolSupport supported, const XMLElement* field)
+Encodable* Encodable::generateEncodable(ProtocolParser* parse, const std::string& parent, const ProtocolSupport& supported, const XMLElement* field, bool limitonencode)
 {
     Encodable* enc = NULL;
 
@@ -519,14 +836,15 @@ Encodable* Encodable::generateEncodable(ProtocolParser* parse, const std::string
     std::string tagname(field->Name());
 
     if(contains(tagname, "structure"))
-        enc = new ProtocolStructure(parse, parent, supported);
+        enc = parse->getArena().create<ProtocolStructure>(parse, parent, supported);
     else if(contains(tagname, "data"))
-        enc = new ProtocolField(parse, parent, supported);
+        enc = parse->getArena().create<ProtocolField>(parse, parent, supported);
     else if(contains(tagname, "code"))
-        enc = new ProtocolCode(parse, parent, supported);
+        enc = parse->getArena().create<ProtocolCode>(parse, parent, supported);
 
     if(enc != NULL)
     {
+        enc->limitonencode = limitonencode;
         enc->setElement(field);
         enc->parse();
     }
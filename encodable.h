@@ -4,18 +4,19 @@
 #include "protocolsupport.h"
 #include "encodedlength.h"
 #include "protocoldocumentation.h"
+#include "codeemitter.h"
 
 class Encodable : public ProtocolDocumentation
 {
 public:
 
     //! Constructor for basic encodable that sets protocol options
-    Encodable(ProtocolParser* parse, const std::string& parent, ProtocolSupport supported);
+    Encodable(ProtocolParser* parse, const std::string& parent, const ProtocolSupport& supported);
 
     virtual ~Encodable() {;}
 
     //! Construct a protocol field by parsing a DOM element
-    static Encodable* generateEncodable(ProtocolParser* parse, const std::string& parent, ProtocolSupport supported, const XMLElement* field);
+    static Encodable* generateEncodable(ProtocolParser* parse, const std::string& parent, const ProtocolSupport& supported, const XMLElement* field, bool limitonencode);
 
     //! Provide the pointer to a previous encodable in the list
     virtual void setPreviousEncodable(Encodable* prev) {(void)prev;}
@@ -38,12 +39,39 @@ public:
     //! Return the string that is used to decode this encoable
     virtual std::string getDecodeString(int* bitcount, bool isStructureMember, bool defaultEnabled = false) const = 0;
 
+    //! Return the string that adds the encoded size of this encodable, empty if the size is always the maximum
+    virtual std::string getEncodedSizeString(bool isStructureMember) const {(void)isStructureMember; return std::string();}
+
+    //! Return the string that skips this encodable in a byte array, empty if the size is always the maximum
+    virtual std::string getSkipString(bool isStructureMember) const {return getEncodedSizeString(isStructureMember);}
+
+    //! True if the array elements of this encodable can be decoded one at a time, by the steps of a resumable decoder
+    virtual bool isDecodedByElement(void) const {return false;}
+
+    //! Return the string that decodes the array element `_pg_i` of this encodable
+    virtual std::string getDecodeElementString(bool isStructureMember) const {(void)isStructureMember; return std::string();}
+
+    //! Return the string that skips one array element of this encodable in a byte array, empty if every element has the same size
+    virtual std::string getSkipElementString(bool isStructureMember) const {(void)isStructureMember; return std::string();}
+
+    //! Return the declaration of a local variable that holds this encodable, for the C++ language
+    virtual std::string getLocalDeclaration(void) const {return std::string();}
+
+    //! Output the code that is used to decode this encodable
+    virtual void emitDecodeString(CodeEmitter& output, int* bitcount, bool isStructureMember, bool defaultEnabled = false) const {output.append(getDecodeString(bitcount, isStructureMember, defaultEnabled));}
+
     //! Get the string used for verifying this field.
     virtual std::string getVerifyString(void) const {return std::string();}
 
     //! Return the string that sets this encodable to its initial value in code
     virtual std::string getSetInitialValueString(bool isStructureMember) const {(void)isStructureMember; return std::string();}
 
+    //! Return the string that sets this encodable to its initial value in the C++ initialize() function
+    virtual std::string getInitializeString(void) const {return std::string();}
+
+    //! True if this encodable is a C++ class whose constructor leaves its members to initialize()
+    virtual bool isNoInit(void) const {return false;}
+
     //! Return the strings that #define initial and variable values
     virtual std::string getInitialAndVerifyDefines(bool includeComment = true) const {(void)includeComment; return std::string();}
 
@@ -59,9 +87,18 @@ public:
     //! Get the string used for comparing this field.
     virtual std::string getComparisonString(void) const {return std::string();}
 
+    //! Get the string used for testing this field for equality.
+    virtual std::string getEqualsString(void) const {return std::string();}
+
+    //! Get the string used for combining this field into a hash.
+    virtual std::string getHashString(void) const {return std::string();}
+
     //! Get the string used for text printing this field.
     virtual std::string getTextPrintString(void) const {return std::string();}
 
+    //! Get the estimated number of characters text printed for this field, not counting the prename
+    virtual int getTextPrintLength(int* lines) const {(void)lines; return 0;}
+
     //! Get the string used for text reading this field.
     virtual std::string getTextReadString(void) const {return std::string();}
 
@@ -71,6 +108,18 @@ public:
     //! Get the string used to decode this field from a map
     virtual std::string getMapDecodeString(void) const {return std::string();}
 
+    //! Get the string used to encode this field to JSON
+    virtual std::string getJsonEncodeString(bool first) const {(void)first; return std::string();}
+
+    //! Get the string used to decode this field from JSON
+    virtual std::string getJsonDecodeString(void) const {return std::string();}
+
+    //! Get the string used to encode one value of this field to JSON
+    virtual std::string getJsonEncodeValueString(const std::string& spacing, const std::string& separator) const {(void)spacing; (void)separator; return std::string();}
+
+    //! Get the string used to decode one value of this field from JSON
+    virtual std::string getJsonDecodeValueString(const std::string& spacing, const std::string& condition) const {(void)spacing; (void)condition; return std::string();}
+
     //! Return the string that sets this encodable to its default value in code
     virtual std::string getSetToDefaultsString(bool isStructureMember) const {(void)isStructureMember; return std::string();}
 
@@ -92,6 +141,9 @@ public:
     //! Return the include directives needed for this encodable's print functions
     virtual void getPrintIncludeDirectives(std::vector<std::string>& list) const {(void)list;}
 
+    //! Return the include directives needed for this encodable's JSON functions
+    virtual void getJsonIncludeDirectives(std::vector<std::string>& list) const {(void)list;}
+
     //! Return the signature of this field in an encode function signature
     virtual std::string getEncodeSignature(void) const;
 
@@ -125,6 +177,36 @@ public:
     //! Get the array handling code for decoding context
     virtual std::string getDecodeArrayIterationCode(const std::string& spacing, bool isStructureMember) const;
 
+    //! Get the array handling code for one element of the first dimension, in encoding context
+    std::string getEncodeElementIterationCode(const std::string& spacing, bool isStructureMember) const;
+
+    //! Get the array handling code for one element of the first dimension, in decoding context
+    std::string getDecodeElementIterationCode(const std::string& spacing, bool isStructureMember) const;
+
+    //! Get the number of array elements that are encoded
+    std::string getEncodedArrayCount(bool isStructureMember) const;
+
+    //! Get the number of elements of the first array dimension that are encoded
+    std::string getEncodedElementCount(bool isStructureMember) const;
+
+    //! Get the maximum number of array elements as a number
+    int getMaximumArrayCount(void) const;
+
+    //! Get the string literal that starts this field in a JSON object
+    std::string getJsonKeyLiteral(bool first) const;
+
+    //! Get the string used to encode this field, including any array, to JSON
+    std::string getJsonEncodeMemberString(bool first) const;
+
+    //! Get the string used to decode this field, including any array, from JSON
+    std::string getJsonDecodeMemberString(void) const;
+
+    //! Get the condition that determines if this encodable is encoded
+    std::string getEncodeDependsOnCondition(bool isStructureMember) const;
+
+    //! Get the condition that is true if this encodable differs from the reference copy of a delta encode
+    std::string getDeltaChangedCondition(void) const;
+
     //! Return true if this encodable has documentation for markdown output
     virtual bool hasDocumentation(void) {return true;}
 
@@ -167,6 +249,9 @@ public:
     //! True if this encodable is a primitive bitfield
     virtual bool isBitfield(void) const {return false;}
 
+    //! True if this encodable is a floating point number in memory
+    virtual bool isFloat(void) const {return false;}
+
     //! True if this encodable has a default value
     virtual bool isDefault(void) const {return false;}
 
@@ -215,6 +300,9 @@ public:
     //! True if this encodable has a direct child that uses defaults
     virtual bool usesDefaults(void) const = 0;
 
+    //! True if this encodable, or any of its children, is encoded as a variable length integer
+    virtual bool usesVarint(void) const {return false;}
+
     //! True if this encodable overrides a previous encodable
     virtual bool overridesPreviousEncodable(void) const {return false;}
 
@@ -241,6 +329,7 @@ public:
     std::string dependsOnValue;  //!< String providing the details of the depends on value
     std::string dependsOnCompare;//!< Comparison to use for dependsOnValue
     EncodedLength encodedLength; //!< The lengths of the encodables
+    bool limitonencode;          //!< true to enforce verification limits on encode, which overrides the protocol option
 };
 
 #endif // ENCODABLE_H
@@ -5,7 +5,10 @@
 EncodedLength::EncodedLength() :
     minEncodedLength(),
     maxEncodedLength(),
-    nonDefaultEncodedLength()
+    nonDefaultEncodedLength(),
+    minSum(),
+    maxSum(),
+    nonDefaultSum()
 {
 }
 
@@ -18,6 +21,9 @@ void EncodedLength::clear(void)
     minEncodedLength.clear();
     maxEncodedLength.clear();
     nonDefaultEncodedLength.clear();
+    minSum.clear();
+    maxSum.clear();
+    nonDefaultSum.clear();
 }
 
 
@@ -57,7 +63,7 @@ void EncodedLength::addToLength(const std::string & length, bool isString, bool
     if(length.empty())
         return;
 
-    addToLengthString(maxEncodedLength, length);
+    addToLengthString(maxEncodedLength, maxSum, length);
 
     // Default fields do not add to the length of anything else
     if(isDefault)
@@ -65,23 +71,53 @@ void EncodedLength::addToLength(const std::string & length, bool isString, bool
 
     // Length of everthing except default, strings are 1 byte
     if(isString)
-        addToLengthString(nonDefaultEncodedLength, "1");
+        addToLengthString(nonDefaultEncodedLength, nonDefaultSum, "1");
     else
-        addToLengthString(nonDefaultEncodedLength, length);
+        addToLengthString(nonDefaultEncodedLength, nonDefaultSum, length);
 
     // If not variable or dependent, then add to minimum length
     if(!isVariable && !isDependent)
     {
         // Strings add a minimum length of 1 byte
         if(isString)
-            addToLengthString(minEncodedLength, "1");
+            addToLengthString(minEncodedLength, minSum, "1");
         else
-            addToLengthString(minEncodedLength, length);
+            addToLengthString(minEncodedLength, minSum, length);
     }
 
 }// EncodedLength::addToLength
 
 
+/*!
+ * Add the length strings of a field whose length depends on its value, like
+ * a variable length integer.
+ * \param maxLength is the longest the field can be.
+ * \param minLength is the shortest the field can be.
+ * \param isVariable is true if this length is for a variable length array
+ * \param isDependent is true if this length is for a field whose presence depends on another field
+ * \param isDefault is true if this length is for a default field.
+ */
+void EncodedLength::addRangeToLength(const std::string& maxLength, const std::string& minLength, bool isVariable, bool isDependent, bool isDefault)
+{
+    if(maxLength.empty())
+        return;
+
+    addToLengthString(maxEncodedLength, maxSum, maxLength);
+
+    // Default fields do not add to the length of anything else
+    if(isDefault)
+        return;
+
+    // Counting the maximum here makes the decoder check the actual length
+    addToLengthString(nonDefaultEncodedLength, nonDefaultSum, maxLength);
+
+    // If not variable or dependent, then add to minimum length
+    if(!isVariable && !isDependent)
+        addToLengthString(minEncodedLength, minSum, minLength);
+
+}// EncodedLength::addRangeToLength
+
+
 /*!
  * Add a grouping of length strings to this length
  * \param rightLength is the length strings to add.
@@ -92,12 +128,12 @@ void EncodedLength::addToLength(const std::string & length, bool isString, bool
  */
 void EncodedLength::addToLength(const EncodedLength& rightLength, const std::string& array, bool isVariable, bool isDependent, const std::string& array2d)
 {
-    addToLengthString(maxEncodedLength, rightLength.maxEncodedLength, array, array2d);
-    addToLengthString(nonDefaultEncodedLength, rightLength.nonDefaultEncodedLength, array, array2d);
+    addToLengthString(maxEncodedLength, maxSum, rightLength.maxEncodedLength, array, array2d);
+    addToLengthString(nonDefaultEncodedLength, nonDefaultSum, rightLength.nonDefaultEncodedLength, array, array2d);
 
     // If not variable or dependent, then add to minimum length
     if(!isVariable && !isDependent)
-        addToLengthString(minEncodedLength, rightLength.minEncodedLength, array, array2d);
+        addToLengthString(minEncodedLength, minSum, rightLength.minEncodedLength, array, array2d);
 }
 
 
@@ -120,10 +156,12 @@ void EncodedLength::add(EncodedLength* leftLength, const EncodedLength& rightLen
 /*!
  * Create a length string like "4 + 3 + N3D*2" by adding successive length strings
  * \param totalLength is the total length string
+ * \param sum is the structured form of totalLength, which is updated with it
  * \param length is the new length to add
  * \param array is the number of times to add it
+ * \param array2d is the second dimension of the array
  */
-void EncodedLength::addToLengthString(std::string & totalLength, std::string length, std::string array, std::string array2d)
+void EncodedLength::addToLengthString(std::string & totalLength, LengthSum& sum, std::string length, std::string array, std::string array2d)
 {
     bool ok;
     double number;
@@ -175,11 +213,23 @@ void EncodedLength::addToLengthString(std::string & totalLength, std::string len
 
 
     if(totalLength.empty())
+    {
         totalLength = length;
+        sum.parse(totalLength);
+    }
+    else if(sum.valid && sum.symbolic && (sum.text == totalLength) && (length.find_first_of("()-/^") == std::string::npos))
+    {
+        // The total can never be computed as a number, so collapsing the
+        // total string would only re-discover the terms we already have.
+        // Add the new terms to the structured sum instead of re-parsing.
+        sum.add(length);
+        totalLength = sum.text;
+    }
     else
     {
         // Add them up
         totalLength = collapseLengthString(totalLength + "+" + length);
+        sum.parse(totalLength);
 
     }// if totalLength previously had data
 
@@ -226,118 +276,20 @@ std::string EncodedLength::collapseLengthString(std::string totalLength, bool ke
             return totalLength;
     }
 
-    // Split according to the pluses
-    std::vector<std::string> list = split(totalLength, "+");
-    std::vector<std::string> others;
-
-    // Some of these groups are simple numbers, some of them are not. We are going to re-order to put the numbers together
-    number = 0;
-    for(std::size_t i = 0; i < list.size(); i++)
-    {
-        if(list.at(i).empty())
-            continue;
-
-        if(isNumber(list.at(i)))
-        {
-            number += std::stoi(list.at(i));
-        }
-        else
-        {
-            others.push_back(list.at(i));
-        }
-
-    }// for all the fragments
+    // Sum the terms, putting the numbers together and combining multiples of
+    // the same symbol, like "2*N3D+3*N3D" into "5*N3D"
+    LengthSum sum;
+    sum.addTerms(totalLength);
 
     // Handle the minus one here
     if(minusOne)
-        number--;
+        sum.addTerms("-1");
 
-    std::vector<std::vector<std::string>> pairlist;
-    for(std::size_t i = 0; i < others.size(); i++)
-    {
-        // Separate a string like "1*N3D" into "1" and "N3D"
-        pairlist.push_back(split(others.at(i), "*"));
-    }
-
-    others.clear();
-    std::string output;
-    for(std::size_t i = 0; i < pairlist.size(); i++)
-    {
-        // Each entry should have two elements and the first should be a number,
-        // if not then something weird happened, just put it back the way it was
-        if((pairlist.at(i).size() != 2) || !isNumber(pairlist.at(i).at(0)))
-        {
-            if(pairlist.at(i).size() != 0)
-            {
-                if(!output.empty())
-                    output += "+";
-
-                output += join(pairlist.at(i), "*");
-            }
-            continue;
-        }
-
-        int counter = std::stoi(pairlist.at(i).at(0));
-
-        // Now go through all entries after this one to find anyone that is common
-        for(std::size_t j = i + 1; j < pairlist.size(); j++)
-        {
-            // if its not a number, then we can't do anything with it,
-            // we'll catch it in the outer loop when we get to it
-            if((pairlist.at(j).size() != 2) || !isNumber(pairlist.at(j).at(0)))
-                continue;
-
-            // If the comparison is exactly the same, then we can add this one up
-            if(pairlist.at(i).at(1) == pairlist.at(j).at(1))
-            {
-                // These two are multiples of the same thing
-                counter += std::stoi(pairlist.at(j).at(0));
-
-                // Clear this element, no contribution in the future.
-                pairlist[j].clear();
-            }
-        }
-
-        // finally include this in the output
-        if(counter != 0)
-        {
-            if(!output.empty())
-                output += "+";
-
-            output += std::to_string(counter) + "*" + pairlist.at(i).at(1);
-        }
-    }
-
-    // A negative number outputs the "-" by default
-    if(number < 0)
-        output += std::to_string(number);
-    else
-    {
-        if(number != 0)
-        {
-            if(output.empty())
-                output = std::to_string(number);
-            else
-                output += "+" + std::to_string(number);
-        }
-    }
+    std::string output = sum.toString();
 
     if((keepZero) && output.empty())
         output = "0";
 
-    // It might be that we can compute a value now, give it a try
-    dnumber = ShuntingYard::computeInfix(output, &ok);
-    if(ok)
-    {
-        // round to nearest integer
-        if(dnumber >= 0)
-            number = (int)(dnumber + 0.5);
-        else
-            number = (int)(dnumber - 0.5);
-
-        output = std::to_string(number);
-    }
-
     return output;
 
 }// EncodedLength::collapseLengthString
@@ -355,6 +307,19 @@ std::string EncodedLength::subtractOneFromLengthString(std::string totalLength,
 }
 
 
+/*!
+ * Determine if a length string contains a character which the ShuntingYard
+ * cannot compute, such as the letters of an enumeration name.
+ * \param text is the text to check
+ * \return true if text can never be computed as a number
+ */
+bool EncodedLength::isSymbolic(const std::string& text)
+{
+    // Spaces are ignored; "pi", "e", and the "0x" and "0b" prefixes are numbers
+    return (text.find_first_not_of("0123456789.+-*/^() xXbBpie") != std::string::npos);
+}
+
+
 /*!
  * Determine if a segment of text contains only decimal digits
  * \param text is the text to check
@@ -369,3 +334,170 @@ bool EncodedLength::isNumber(const std::string& text)
     // Only decimal digits and minus signs are OK
     return (text.find_first_not_of("-0123456789") == std::string::npos);
 }
+
+
+EncodedLength::LengthSum::LengthSum(void) :
+    valid(false),
+    symbolic(false),
+    text(),
+    constant(0),
+    terms()
+{
+}
+
+
+/*!
+ * Clear the sum
+ */
+void EncodedLength::LengthSum::clear(void)
+{
+    valid = symbolic = false;
+    text.clear();
+    constant = 0;
+    terms.clear();
+}
+
+
+/*!
+ * Parse a length string into terms. The sum is only valid if the string has
+ * no parenthesis, subtraction, division, or exponentiation, which are the
+ * cases where collapseLengthString() does not simply sum terms.
+ * \param lengthText is the length string to parse.
+ */
+void EncodedLength::LengthSum::parse(const std::string& lengthText)
+{
+    clear();
+    text = lengthText;
+    valid = (text.find_first_of("()-/^") == std::string::npos);
+
+    if(valid)
+        addTerms(text);
+}
+
+
+/*!
+ * Add the terms of a length string to this sum, and update the text of the
+ * sum. The length string must not have parenthesis, subtraction, division, or
+ * exponentiation.
+ * \param lengthText is the length string to add.
+ */
+void EncodedLength::LengthSum::add(const std::string& lengthText)
+{
+    addTerms(lengthText);
+    text = toString();
+}
+
+
+/*!
+ * Add the terms of a length string to this sum, without updating the text of
+ * the sum. Numbers are added to the constant, and multiples of the same symbol
+ * are combined. Any other term is kept verbatim. This is how
+ * collapseLengthString() sums its terms.
+ * \param lengthText is the length string to add, without parenthesis.
+ */
+void EncodedLength::LengthSum::addTerms(const std::string& lengthText)
+{
+    std::vector<std::string> list = split(lengthText, "+");
+
+    for(std::size_t i = 0; i < list.size(); i++)
+    {
+        if(list.at(i).empty())
+            continue;
+
+        if(EncodedLength::isNumber(list.at(i)))
+        {
+            constant += std::stoi(list.at(i));
+            continue;
+        }
+
+        // Separate a string like "1*N3D" into "1" and "N3D"
+        std::vector<std::string> pair = split(list.at(i), "*");
+
+        if((pair.size() != 2) || !EncodedLength::isNumber(pair.at(0)))
+        {
+            // Not a multiple of a symbol, keep it the way it was
+            terms.push_back(Term{join(pair, "*"), 0, false});
+            continue;
+        }
+
+        std::size_t j = 0;
+        for(; j < terms.size(); j++)
+        {
+            if(terms.at(j).multiple && (terms.at(j).symbol == pair.at(1)))
+                break;
+        }
+
+        if(j < terms.size())
+            terms[j].coefficient += std::stoi(pair.at(0));
+        else
+            terms.push_back(Term{pair.at(1), std::stoi(pair.at(0)), true});
+
+    }// for all the fragments
+
+    // Multiples that add up to nothing disappear from the string, and do not
+    // keep their place if they show up again
+    symbolic = false;
+    for(std::size_t j = 0; j < terms.size(); )
+    {
+        if(terms.at(j).multiple && (terms.at(j).coefficient == 0))
+            terms.erase(terms.begin() + j);
+        else
+        {
+            if(EncodedLength::isSymbolic(terms.at(j).symbol))
+                symbolic = true;
+
+            j++;
+        }
+    }
+
+}// EncodedLength::LengthSum::addTerms
+
+
+/*!
+ * Output the sum as a string, in the same form as collapseLengthString()
+ * \return the length string
+ */
+std::string EncodedLength::LengthSum::toString(void) const
+{
+    std::string output;
+
+    for(std::size_t i = 0; i < terms.size(); i++)
+    {
+        if(!output.empty())
+            output += "+";
+
+        if(terms.at(i).multiple)
+            output += std::to_string(terms.at(i).coefficient) + "*";
+
+        output += terms.at(i).symbol;
+    }
+
+    // A negative number outputs the "-" by default
+    if(constant < 0)
+        output += std::to_string(constant);
+    else if(constant != 0)
+    {
+        if(output.empty())
+            output = std::to_string(constant);
+        else
+            output += "+" + std::to_string(constant);
+    }
+
+    if(!symbolic)
+    {
+        // It might be that we can compute a value now, give it a try
+        bool ok;
+        double dnumber = ShuntingYard::computeInfix(output, &ok);
+        if(ok)
+        {
+            // round to nearest integer
+            if(dnumber >= 0)
+                output = std::to_string((int)(dnumber + 0.5));
+            else
+                output = std::to_string((int)(dnumber - 0.5));
+        }
+    }
+
+    return output;
+
+}// EncodedLength::LengthSum::toString
@@ -2,6 +2,7 @@
 #define ENCODEDLENGTH_H
 
 #include <string>
+#include <vector>
 
 class EncodedLength
 {
@@ -11,6 +12,9 @@ public:
     //! Add successive length strings
     void addToLength(const std::string & length, bool isString = false, bool isVariable = false, bool  isDependent = false, bool isDefault = false);
 
+    //! Add the length strings of a field whose length depends on its value
+    void addRangeToLength(const std::string& maxLength, const std::string& minLength, bool isVariable = false, bool isDependent = false, bool isDefault = false);
+
     //! Add a grouping of length strings
     void addToLength(const EncodedLength& rightLength, const std::string& array = std::string(), bool isVariable = false, bool isDependent = false, const std::string& array2d = std::string());
 
@@ -43,8 +47,71 @@ public:
 
 private:
 
+    /*!
+     * A length kept as a structured sum of a constant and symbolic terms,
+     * like "2*N3D+sizeof(x)+7". The terms are kept in the order they first
+     * appeared, which is the order collapseLengthString() outputs them.
+     */
+    class LengthSum
+    {
+    public:
+        LengthSum(void);
+
+        //! Parse a length string into terms
+        void parse(const std::string& text);
+
+        //! Add the terms of a length string to this sum
+        void add(const std::string& text);
+
+        //! Add the terms of a length string to this sum, without updating text
+        void addTerms(const std::string& text);
+
+        //! Output the sum as a string, which is what collapseLengthString() returns
+        std::string toString(void) const;
+
+        //! Clear the sum
+        void clear(void);
+
+        //! True if the sum can be trusted to represent its string
+        bool valid;
+
+        //! True if the sum has a term that can never be computed as a number
+        bool symbolic;
+
+        //! The string this sum was last parsed from, or output to
+        std::string text;
+
+    private:
+
+        //! One term of the sum
+        struct Term
+        {
+            std::string symbol; //!< The symbol, or the entire term if it is not a multiple of a symbol
+            int coefficient;    //!< The multiple of the symbol
+            bool multiple;      //!< True if the term is coefficient*symbol, false if symbol is kept verbatim
+        };
+
+        //! The constant part of the sum
+        int constant;
+
+        //! The terms in the order they first appeared
+        std::vector<Term> terms;
+    };
+
     //! Create a length string like "4 + 3 + N3D*2" by adding successive length strings
-    static void addToLengthString(std::string& totalLength, std::string length, std::string array = std::string(), std::string array2d = std::string());
+    static void addToLengthString(std::string& totalLength, LengthSum& sum, std::string length, std::string array = std::string(), std::string array2d = std::string());
+
+    //! Determine if a length string contains something that can never be computed as a number
+    static bool isSymbolic(const std::string& text);
+
+    //! Structured form of minEncodedLength
+    LengthSum minSum;
+
+    //! Structured form of maxEncodedLength
+    LengthSum maxSum;
+
+    //! Structured form of nonDefaultEncodedLength
+    LengthSum nonDefaultSum;
 
     //! Determine if text is a number for our cases
     static bool isNumber(const std::string& text);
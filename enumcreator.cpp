@@ -5,14 +5,15 @@
 #include <math.h>
 #include <algorithm>
 
-EnumElement::EnumElement(ProtocolParser *parse, EnumCreator *creator, const std::string& parent, ProtocolSupport supported) :
+EnumElement::EnumElement(ProtocolParser *parse, EnumCreator *creator, const std::string& parent, const ProtocolSupport& supported) :
     ProtocolDocumentation(parse, parent, supported),
     hidden(false),
     ignoresPrefix(false),
     ignoresLookup(false),
     parentEnum(creator)
 {
-    attriblist = {"name", "title", "lookupName", "value", "comment", "hidden", "ignorePrefix", "ignoreLookup"};
+    static const AttributeKeys elementattributes({"name", "title", "lookupName", "value", "comment", "hidden", "ignorePrefix", "ignoreLookup"});
+    attriblist = &elementattributes;
 }
 
 void EnumElement::checkAgainstKeywords()
@@ -37,7 +38,7 @@ void EnumElement::parse(bool nocode)
     if(e == nullptr)
         return;
 
-    const XMLAttribute* map = e->FirstAttribute();
+    AttributeIndex map(e->FirstAttribute(), *attriblist);
 
     testAndWarnAttributes(map);
 
@@ -86,7 +87,7 @@ std::string EnumElement::getDeclaration() const
 }
 
 //! Create an empty enumeration list
-EnumCreator::EnumCreator(ProtocolParser* parse, const std::string& parent, ProtocolSupport supported) :
+EnumCreator::EnumCreator(ProtocolParser* parse, const std::string& parent, const ProtocolSupport& supported) :
     ProtocolDocumentation(parse, parent, supported),
     minbitwidth(0),
     maxvalue(0),
@@ -97,23 +98,10 @@ EnumCreator::EnumCreator(ProtocolParser* parse, const std::string& parent, Proto
     lookupComment(false),
     isglobal(false)
 {
-    attriblist = {"name", "title", "comment", "description", "hidden", "neverOmit", "lookup", "lookupTitle", "lookupComment", "prefix", "file", "translate"};
+    static const AttributeKeys enumattributes({"name", "title", "comment", "description", "hidden", "neverOmit", "lookup", "lookupTitle", "lookupComment", "prefix", "file", "translate"});
+    attriblist = &enumattributes;
 }
 
-EnumCreator::~EnumCreator(void)
-{
-    // Delete all the objects in the list
-    for(std::size_t i = 0; i < documentList.size(); i++)
-    {
-        if(documentList.at(i) != nullptr)
-        {
-            delete documentList.at(i);
-            documentList.at(i) = nullptr;
-        }
-    }
-}
-
-
 void EnumCreator::clear(void)
 {
     file.clear();
@@ -133,17 +121,7 @@ void EnumCreator::clear(void)
     prefix.clear();
     translate.clear();
 
-    // Delete all the objects in the list
-    for(std::size_t i = 0; i < documentList.size(); i++)
-    {
-        if(documentList.at(i) != nullptr)
-        {
-            delete documentList.at(i);
-            documentList.at(i) = nullptr;
-        }
-    }
-
-    // clear the list
+    // clear the list, the objects are owned by the arena of the parser
     documentList.clear();
 }
 
@@ -172,7 +150,7 @@ void EnumCreator::parse(bool nocode)
 
     clear();
 
-    const XMLAttribute* map = e->FirstAttribute();
+    AttributeIndex map(e->FirstAttribute(), *attriblist);
 
     // We use name as part of our debug outputs, so its good to have it first.
     name = ProtocolParser::getAttribute("name", map);
@@ -15,7 +15,7 @@ class EnumElement : public ProtocolDocumentation
 public:
 
     //! Cronstruct an enumeration element
-    EnumElement(ProtocolParser* parse, EnumCreator* creator, const std::string& Parent, ProtocolSupport supported);
+    EnumElement(ProtocolParser* parse, EnumCreator* creator, const std::string& Parent, const ProtocolSupport& supported);
 
     //! Parse an enumeration element
     void parse(bool nocode = false) override;
@@ -64,9 +64,7 @@ class EnumCreator : public ProtocolDocumentation
 {
 public:
     //! Construct the enumeration object
-    EnumCreator(ProtocolParser* parse, const std::string& parent, ProtocolSupport supported);
-
-    ~EnumCreator(void);
+    EnumCreator(ProtocolParser* parse, const std::string& parent, const ProtocolSupport& supported);
 
     //! Empty the enumeration list
     void clear(void);
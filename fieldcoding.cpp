@@ -1,14 +1,11 @@
 #include "fieldcoding.h"
 #include "protocolparser.h"
+#include "codeemitter.h"
 
 
-FieldCoding::FieldCoding(ProtocolSupport sup) :
+FieldCoding::FieldCoding(const ProtocolSupport& sup) :
     ProtocolScaling(sup)
 {
-    // we use 64-bit integers for floating point
-    if(!support.int64)
-        support.float64 = false;
-
     if(support.int64)
     {
         typeNames    = {"uint64_t", "int64_t", "uint64_t", "int64_t", "uint64_t", "int64_t", "uint64_t", "int64_t"};
@@ -29,7 +26,8 @@ FieldCoding::FieldCoding(ProtocolSupport sup) :
     typeSizes.insert(typeSizes.end(), temp3.begin(), temp3.end());
     typeUnsigneds.insert(typeUnsigneds.end(), temp4.begin(), temp4.end());
 
-    if(support.float64)
+    // we use 64-bit integers for floating point
+    if(support.int64 && support.float64)
     {
         typeNames.push_back("double");
         typeSigNames.push_back("float64");
@@ -152,6 +150,9 @@ void pgstrncpy(char* dst, const char* src, int maxLength);
 //! Encode a null terminated string on a byte stream
 void stringToBytes(const char* string, uint8_t* bytes, int* index, int maxLength, int fixedLength);
 
+//! Determine the number of bytes used to encode a null terminated string
+int stringEncodedLength(const char* string, int maxLength, int fixedLength);
+
 //! Copy an array of bytes to a byte stream without changing the order.
 void bytesToBeBytes(const uint8_t* data, uint8_t* bytes, int* index, int num);
 
@@ -194,6 +195,17 @@ void bytesToLeBytes(const uint8_t* data, uint8_t* bytes, int* index, int num);)"
 
     }// for all output byte counts
 
+    header.makeLineSeparator();
+    header.write(varintEncodePrototypes(32));
+
+    if(support.int64)
+    {
+        header.makeLineSeparator();
+        header.write("#ifdef UINT64_MAX\n");
+        header.write(varintEncodePrototypes(64));
+        header.write("#endif // UINT64_MAX\n");
+    }
+
     header.makeLineSeparator();
 
     return header.flush();
@@ -274,6 +286,38 @@ void stringToBytes(const char* string, uint8_t* bytes, int* index, int maxLength
 }// stringToBytes
 
 
+/*!
+ * Determine the number of bytes that stringToBytes() would encode, without
+ * encoding the string.
+ * \param string is the null terminated string to size.
+ * \param maxLength is the maximum number of bytes that can be encoded. A null
+ *        terminator is always included in the encoding.
+ * \param fixedLength should be 1 if the number of bytes encoded is always
+ *        exactly equal to maxLength.
+ * \return the number of bytes that stringToBytes() would encode.
+ */
+int stringEncodedLength(const char* string, int maxLength, int fixedLength)
+{
+    int i;
+
+    // Reserve the last byte for null termination
+    for(i = 0; i < maxLength - 1; i++)
+    {
+        if(string[i] == 0)
+            break;
+    }
+
+    // Count the null termination
+    i++;
+
+    if(fixedLength && (i < maxLength))
+        i = maxLength;
+
+    return i;
+
+}// stringEncodedLength
+
+
 /*!
  * Copy an array of bytes to a byte stream without changing the order.
  * \param data is the array of bytes to copy.
@@ -359,6 +403,17 @@ void bytesToLeBytes(const uint8_t* data, uint8_t* bytes, int* index, int num)
 
     }
 
+    source.makeLineSeparator();
+    source.write(varintEncodeFunctions(32));
+
+    if(support.int64)
+    {
+        source.makeLineSeparator();
+        source.write("#ifdef UINT64_MAX\n");
+        source.write(varintEncodeFunctions(64));
+        source.write("#endif // UINT64_MAX\n");
+    }
+
     source.makeLineSeparator();
 
     return source.flush();
@@ -608,6 +663,137 @@ std::string FieldCoding::integerEncodeFunction(int type, bool bigendian)
 }// FieldCoding::integerEncodeFunction
 
 
+/*!
+ * Generate the prototypes of the functions which encode integers as variable
+ * length integers, and which compute their encoded length.
+ * \param bits is the width of the integers, 32 or 64.
+ * \return the prototypes, with their brief comments.
+ */
+std::string FieldCoding::varintEncodePrototypes(int bits)
+{
+    std::string width = std::to_string(bits);
+    CodeEmitter output;
+
+    output.append("//! Encode an unsigned ", width, "-bit integer on a byte stream as a variable length integer\n");
+    output.append("void varuint", width, "ToBytes(uint", width, "_t number, uint8_t* bytes, int* index);\n");
+    output.append("\n");
+    output.append("//! Encode a signed ", width, "-bit integer on a byte stream as a zigzag variable length integer\n");
+    output.append("void varint", width, "ToBytes(int", width, "_t number, uint8_t* bytes, int* index);\n");
+    output.append("\n");
+    output.append("//! Determine the number of bytes used to encode an unsigned ", width, "-bit variable length integer\n");
+    output.append("int varuint", width, "EncodedLength(uint", width, "_t number);\n");
+    output.append("\n");
+    output.append("//! Determine the number of bytes used to encode a signed ", width, "-bit zigzag variable length integer\n");
+    output.append("int varint", width, "EncodedLength(int", width, "_t number);\n");
+
+    return output.take();
+
+}// FieldCoding::varintEncodePrototypes
+
+
+/*!
+ * Generate the functions which encode integers as variable length integers,
+ * and which compute their encoded length. Signed integers are zigzag encoded
+ * first, so that numbers of small magnitude use few bytes whatever their sign.
+ * \param bits is the width of the integers, 32 or 64.
+ * \return the functions, with their comments.
+ */
+std::string FieldCoding::varintEncodeFunctions(int bits)
+{
+    std::string width = std::to_string(bits);
+    std::string maxbytes = std::to_string((bits + 6)/7);
+    std::string unsignedtype = "uint" + width + "_t";
+    CodeEmitter output;
+
+    output.append("/*!\n");
+    output.append(" * Encode an unsigned ", width, "-bit integer on a byte stream as a variable length\n");
+    output.append(" * integer. Each byte carries seven bits of the number, least significant\n");
+    output.append(" * first, and its most significant bit is set if more bytes follow.\n");
+    output.append(" * \\param number is the value to encode.\n");
+    output.append(" * \\param bytes is a pointer to the byte stream which receives the encoded data.\n");
+    output.append(" * \\param index gives the location of the first byte in the byte stream, and\n");
+    output.append(" *        will be incremented by the number of bytes encoded (1 to ", maxbytes, ") when\n");
+    output.append(" *        this function is complete.\n");
+    output.append(" */\n");
+    output.append("void varuint", width, "ToBytes(", unsignedtype, " number, uint8_t* bytes, int* index)\n");
+    output.append("{\n");
+    output.append("    // increment byte pointer for starting point\n");
+    output.append("    bytes += (*index);\n");
+    output.append("\n");
+    output.append("    while(number >= 0x80)\n");
+    output.append("    {\n");
+    output.append("        *(bytes++) = (uint8_t)(number | 0x80);\n");
+    output.append("        number = number >> 7;\n");
+    output.append("        (*index)++;\n");
+    output.append("    }\n");
+    output.append("\n");
+    output.append("    *bytes = (uint8_t)(number);\n");
+    output.append("    (*index)++;\n");
+    output.append("\n");
+    output.append("}// varuint", width, "ToBytes\n");
+    output.append("\n\n");
+
+    output.append("/*!\n");
+    output.append(" * Encode a signed ", width, "-bit integer on a byte stream as a zigzag variable\n");
+    output.append(" * length integer. Zigzag encoding moves the sign to the least significant bit,\n");
+    output.append(" * so 0, -1, 1, -2, 2 are encoded as the unsigned numbers 0, 1, 2, 3, 4.\n");
+    output.append(" * \\param number is the value to encode.\n");
+    output.append(" * \\param bytes is a pointer to the byte stream which receives the encoded data.\n");
+    output.append(" * \\param index gives the location of the first byte in the byte stream, and\n");
+    output.append(" *        will be incremented by the number of bytes encoded (1 to ", maxbytes, ") when\n");
+    output.append(" *        this function is complete.\n");
+    output.append(" */\n");
+    output.append("void varint", width, "ToBytes(int", width, "_t number, uint8_t* bytes, int* index)\n");
+    output.append("{\n");
+    output.append("    if(number < 0)\n");
+    output.append("        varuint", width, "ToBytes(~((", unsignedtype, ")number << 1), bytes, index);\n");
+    output.append("    else\n");
+    output.append("        varuint", width, "ToBytes((", unsignedtype, ")number << 1, bytes, index);\n");
+    output.append("\n");
+    output.append("}// varint", width, "ToBytes\n");
+    output.append("\n\n");
+
+    output.append("/*!\n");
+    output.append(" * Determine the number of bytes that varuint", width, "ToBytes() would encode,\n");
+    output.append(" * without encoding the number.\n");
+    output.append(" * \\param number is the value to size.\n");
+    output.append(" * \\return the number of bytes, from 1 to ", maxbytes, ".\n");
+    output.append(" */\n");
+    output.append("int varuint", width, "EncodedLength(", unsignedtype, " number)\n");
+    output.append("{\n");
+    output.append("    int length = 1;\n");
+    output.append("\n");
+    output.append("    while(number >= 0x80)\n");
+    output.append("    {\n");
+    output.append("        number = number >> 7;\n");
+    output.append("        length++;\n");
+    output.append("    }\n");
+    output.append("\n");
+    output.append("    return length;\n");
+    output.append("\n");
+    output.append("}// varuint", width, "EncodedLength\n");
+    output.append("\n\n");
+
+    output.append("/*!\n");
+    output.append(" * Determine the number of bytes that varint", width, "ToBytes() would encode,\n");
+    output.append(" * without encoding the number.\n");
+    output.append(" * \\param number is the value to size.\n");
+    output.append(" * \\return the number of bytes, from 1 to ", maxbytes, ".\n");
+    output.append(" */\n");
+    output.append("int varint", width, "EncodedLength(int", width, "_t number)\n");
+    output.append("{\n");
+    output.append("    if(number < 0)\n");
+    output.append("        return varuint", width, "EncodedLength(~((", unsignedtype, ")number << 1));\n");
+    output.append("    else\n");
+    output.append("        return varuint", width, "EncodedLength((", unsignedtype, ")number << 1);\n");
+    output.append("\n");
+    output.append("}// varint", width, "EncodedLength\n");
+
+    return output.take();
+
+}// FieldCoding::varintEncodeFunctions
+
+
 /*!
  * Generate the header file for protocols caling
  * \return true if the file is generated.
@@ -657,6 +843,12 @@ sign extension.)");
 header.write(R"(//! Decode a null terminated string from a byte stream
 void stringFromBytes(char* string, const uint8_t* bytes, int* index, int maxLength, int fixedLength);
 
+//! Skip over a null terminated string in a byte stream without decoding it
+void stringSkipBytes(const uint8_t* bytes, int* index, int maxLength, int fixedLength);
+
+//! Skip over a variable length integer in a byte stream without decoding it
+void varintSkipBytes(const uint8_t* bytes, int* index, int maxLength);
+
 //! Copy an array of bytes from a byte stream without changing the order.
 void bytesFromBeBytes(uint8_t* data, const uint8_t* bytes, int* index, int num);
 
@@ -698,6 +890,17 @@ void bytesFromLeBytes(uint8_t* data, const uint8_t* bytes, int* index, int num);
 
     }// for all input types
 
+    header.makeLineSeparator();
+    header.write(varintDecodePrototypes(32));
+
+    if(support.int64)
+    {
+        header.makeLineSeparator();
+        header.write("#ifdef UINT64_MAX\n");
+        header.write(varintDecodePrototypes(64));
+        header.write("#endif // UINT64_MAX\n");
+    }
+
     header.makeLineSeparator();
 
     return header.flush();
@@ -757,6 +960,68 @@ void stringFromBytes(char* string, const uint8_t* bytes, int* index, int maxLeng
 }// stringFromBytes
 
 
+/*!
+ * Skip over a null terminated string in a byte stream, advancing the index
+ * exactly as stringFromBytes() would, without copying the string.
+ * \param bytes is the byte stream that holds the string.
+ * \param index gives the location of the first byte of the string in the byte
+ *        stream, and will be incremented by the number of bytes in the string.
+ * \param maxLength is the maximum number of bytes in the string, including
+ *        the null terminator.
+ * \param fixedLength should be 1 if the number of bytes in the string is
+ *        always exactly equal to maxLength.
+ */
+void stringSkipBytes(const uint8_t* bytes, int* index, int maxLength, int fixedLength)
+{
+    int i;
+
+    // increment byte pointer for starting point
+    bytes += *index;
+
+    for(i = 0; i < maxLength - 1; i++)
+    {
+        if(bytes[i] == 0)
+            break;
+    }
+
+    // Include the null terminator
+    i++;
+
+    if(fixedLength)
+        (*index) += maxLength;
+    else
+        (*index) += i;
+
+}// stringSkipBytes
+
+
+/*!
+ * Skip over a variable length integer in a byte stream without decoding it.
+ * \param bytes is a pointer to the byte stream that contains the integer.
+ * \param index gives the location of the first byte of the integer in the
+ *        byte stream, and will be incremented by the number of bytes in the
+ *        integer.
+ * \param maxLength is the maximum number of bytes in the integer.
+ */
+void varintSkipBytes(const uint8_t* bytes, int* index, int maxLength)
+{
+    int i;
+
+    // increment byte pointer for starting point
+    bytes += *index;
+
+    // The last byte ends the integer whatever its most significant bit
+    for(i = 0; i < maxLength - 1; i++)
+    {
+        if(bytes[i] < 0x80)
+            break;
+    }
+
+    (*index) += i + 1;
+
+}// varintSkipBytes
+
+
 /*!
  * Copy an array of bytes from a byte stream without changing the order.
  * \param data receives the copied bytes
@@ -840,6 +1105,17 @@ void bytesFromLeBytes(uint8_t* data, const uint8_t* bytes, int* index, int num)
 
     }// for all input types
 
+    source.makeLineSeparator();
+    source.write(varintDecodeFunctions(32));
+
+    if(support.int64)
+    {
+        source.makeLineSeparator();
+        source.write("#ifdef UINT64_MAX\n");
+        source.write(varintDecodeFunctions(64));
+        source.write("#endif // UINT64_MAX\n");
+    }
+
     source.makeLineSeparator();
 
     return source.flush();
@@ -1118,3 +1394,112 @@ std::string FieldCoding::integerDecodeFunction(int type, bool bigendian)
 
 }// FieldCoding::integerDecodeFunction
 
+
+/*!
+ * Generate the prototypes of the functions which decode variable length integers.
+ * \param bits is the width of the integers, 32 or 64.
+ * \return the prototypes, with their brief comments.
+ */
+std::string FieldCoding::varintDecodePrototypes(int bits)
+{
+    std::string width = std::to_string(bits);
+    CodeEmitter output;
+
+    output.append("//! Decode an unsigned ", width, "-bit variable length integer from a byte stream\n");
+    output.append("uint", width, "_t varuint", width, "FromBytes(const uint8_t* bytes, int* index);\n");
+    output.append("\n");
+    output.append("//! Decode a signed ", width, "-bit zigzag variable length integer from a byte stream\n");
+    output.append("int", width, "_t varint", width, "FromBytes(const uint8_t* bytes, int* index);\n");
+
+    return output.take();
+
+}// FieldCoding::varintDecodePrototypes
+
+
+/*!
+ * Generate the functions which decode variable length integers. The decode
+ * is unrolled, so each byte is tested once, and the common case of a small
+ * number returns after the first byte.
+ * \param bits is the width of the integers, 32 or 64.
+ * \return the functions, with their comments.
+ */
+std::string FieldCoding::varintDecodeFunctions(int bits)
+{
+    std::string width = std::to_string(bits);
+    int maxbytes = (bits + 6)/7;
+    std::string unsignedtype = "uint" + width + "_t";
+    CodeEmitter output;
+
+    output.append("/*!\n");
+    output.append(" * Decode an unsigned ", width, "-bit variable length integer from a byte stream.\n");
+    output.append(" * Each byte carries seven bits of the number, least significant first, and\n");
+    output.append(" * its most significant bit is set if more bytes follow. No more than ", std::to_string(maxbytes), " bytes\n");
+    output.append(" * are decoded, the last byte ends the number whatever its most significant bit.\n");
+    output.append(" * \\param bytes is a pointer to the byte stream to decode.\n");
+    output.append(" * \\param index gives the location of the first byte in the byte stream, and\n");
+    output.append(" *        will be incremented by the number of bytes decoded when this\n");
+    output.append(" *        function is complete.\n");
+    output.append(" * \\return the decoded number.\n");
+    output.append(" */\n");
+    output.append(unsignedtype, " varuint", width, "FromBytes(const uint8_t* bytes, int* index)\n");
+    output.append("{\n");
+    output.append("    ", unsignedtype, " number;\n");
+    output.append("\n");
+    output.append("    // increment byte pointer for starting point\n");
+    output.append("    bytes += (*index);\n");
+    output.append("\n");
+    output.append("    number = bytes[0] & 0x7F;\n");
+    output.append("    if(bytes[0] < 0x80)\n");
+    output.append("    {\n");
+    output.append("        (*index) += 1;\n");
+    output.append("        return number;\n");
+    output.append("    }\n");
+
+    for(int i = 1; i < maxbytes - 1; i++)
+    {
+        std::string byte = "bytes[" + std::to_string(i) + "]";
+
+        output.append("\n");
+        output.append("    number |= (", unsignedtype, ")(", byte, " & 0x7F) << ", std::to_string(7*i), ";\n");
+        output.append("    if(", byte, " < 0x80)\n");
+        output.append("    {\n");
+        output.append("        (*index) += ", std::to_string(i + 1), ";\n");
+        output.append("        return number;\n");
+        output.append("    }\n");
+    }
+
+    output.append("\n");
+    output.append("    // The bits of the last byte beyond the width of the number are ignored\n");
+    output.append("    number |= (", unsignedtype, ")bytes[", std::to_string(maxbytes - 1), "] << ", std::to_string(7*(maxbytes - 1)), ";\n");
+    output.append("    (*index) += ", std::to_string(maxbytes), ";\n");
+    output.append("\n");
+    output.append("    return number;\n");
+    output.append("\n");
+    output.append("}// varuint", width, "FromBytes\n");
+    output.append("\n\n");
+
+    output.append("/*!\n");
+    output.append(" * Decode a signed ", width, "-bit zigzag variable length integer from a byte\n");
+    output.append(" * stream. Zigzag encoding moves the sign to the least significant bit, so the\n");
+    output.append(" * unsigned numbers 0, 1, 2, 3, 4 are decoded as 0, -1, 1, -2, 2.\n");
+    output.append(" * \\param bytes is a pointer to the byte stream to decode.\n");
+    output.append(" * \\param index gives the location of the first byte in the byte stream, and\n");
+    output.append(" *        will be incremented by the number of bytes decoded when this\n");
+    output.append(" *        function is complete.\n");
+    output.append(" * \\return the decoded number.\n");
+    output.append(" */\n");
+    output.append("int", width, "_t varint", width, "FromBytes(const uint8_t* bytes, int* index)\n");
+    output.append("{\n");
+    output.append("    ", unsignedtype, " number = varuint", width, "FromBytes(bytes, index);\n");
+    output.append("\n");
+    output.append("    if(number & 1)\n");
+    output.append("        return -(int", width, "_t)(number >> 1) - 1;\n");
+    output.append("    else\n");
+    output.append("        return (int", width, "_t)(number >> 1);\n");
+    output.append("\n");
+    output.append("}// varint", width, "FromBytes\n");
+
+    return output.take();
+
+}// FieldCoding::varintDecodeFunctions
+
@@ -7,7 +7,7 @@ class FieldCoding : public ProtocolScaling
 {
 public:
 
-    FieldCoding(ProtocolSupport sup);
+    FieldCoding(const ProtocolSupport& sup);
 
     //! Perform the generation, writing out the files
     bool generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList);
@@ -68,6 +68,18 @@ protected:
     //! Generate the integer decode function
     std::string integerDecodeFunction(int type, bool bigendian);
 
+    //! Generate the prototypes of the variable length integer encode functions
+    std::string varintEncodePrototypes(int bits);
+
+    //! Generate the variable length integer encode functions
+    std::string varintEncodeFunctions(int bits);
+
+    //! Generate the prototypes of the variable length integer decode functions
+    std::string varintDecodePrototypes(int bits);
+
+    //! Generate the variable length integer decode functions
+    std::string varintDecodeFunctions(int bits);
+
     //! List of built in type names
     std::vector<std::string> typeNames;
 
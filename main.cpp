@@ -115,6 +115,12 @@ int main(int argc, char *argv[])
     if(!docs.empty())
         parser.setDocsPath(ProtocolFile::sanitizePath(docs));
 
+    // Make dependency file
+    std::string depfile = liststartsWith(arguments, "-depfile");
+    depfile = depfile.substr(depfile.find(" ") + 1);
+    if(!depfile.empty())
+        parser.setDependencyFile(depfile);
+
     // Process the optional arguments
     parser.disableDoxygen(!contains(arguments, "-yes-doxygen"));
     parser.disableMarkdown(contains(arguments, "-no-markdown"));
@@ -127,6 +133,9 @@ int main(int argc, char *argv[])
     parser.setLaTeXSupport(contains(arguments, "-latex"));
     parser.disableCSS(contains(arguments, "-no-css"));
     parser.enableTableOfContents(contains(arguments, "-table-of-contents"));
+    parser.enableIncremental(contains(arguments, "-incremental"));
+    parser.enableProfile(contains(arguments, "-profile"));
+    parser.enableBench(contains(arguments, "-bench"));
 
     if(contains(arguments, "-lang-c"))
         parser.setLanguageOverride(ProtocolSupport::c_language);
@@ -268,6 +277,18 @@ Usage: ProtoGen inputfile.xml <outputpath> <otherinputfiles.xml> -options
                        language specifier in the protocol file.
   -translate <macro> : Set macro as the name of the global translation macro
                        for string lookups in emitted code.
+  -incremental       : Skip the code output for modules whose inputs have not
+                       changed since the last run.
+  -depfile <file>    : Output a make dependency file listing all xml inputs.
+                       The target of the rule is <file> itself, which is
+                       rewritten on every run.
+
+  -profile           : Print the time and memory used by each phase of the
+                       generation, and write a Chrome trace file.
+
+  -bench             : Output a module which times the encode and decode of
+                       every packet and structure.
+
   -version           : Prints just the version information.
 
 )===";
@@ -0,0 +1,78 @@
+#include "protocolarena.h"
+
+/*!
+ * Construct an empty arena. No memory is allocated until the first object is
+ * created.
+ * \param size is the size in bytes of each memory block.
+ */
+ProtocolArena::ProtocolArena(std::size_t size) :
+    blocksize(size),
+    blockused(0),
+    lastblocksize(0)
+{
+}
+
+
+/*!
+ * Destroy all the objects in the arena and release the memory
+ */
+ProtocolArena::~ProtocolArena()
+{
+    clear();
+}
+
+
+/*!
+ * Destroy all the objects in the arena, in the reverse order of their
+ * creation, and release the memory blocks.
+ */
+void ProtocolArena::clear(void)
+{
+    // An object's destructor could create more objects, so don't use iterators
+    while(!destructors.empty())
+    {
+        Destructor destructor = destructors.back();
+        destructors.pop_back();
+        destructor.function(destructor.object);
+    }
+
+    for(std::size_t i = 0; i < blocks.size(); i++)
+        ::operator delete(blocks.at(i));
+
+    blocks.clear();
+    blockused = lastblocksize = 0;
+
+}// ProtocolArena::clear
+
+
+/*!
+ * Get memory for a new object from the current block. If the current block
+ * does not have room a new block is allocated. Objects larger than the block
+ * size get a block of their own.
+ * \param size is the number of bytes needed.
+ * \param alignment is the required alignment of the memory.
+ * \return a pointer to the memory, which will not be released until the arena is cleared.
+ */
+void* ProtocolArena::allocate(std::size_t size, std::size_t alignment)
+{
+    if(!blocks.empty())
+    {
+        std::size_t address = reinterpret_cast<std::size_t>(blocks.back() + blockused);
+        std::size_t padding = (alignment - (address % alignment)) % alignment;
+
+        if(blockused + padding + size <= lastblocksize)
+        {
+            void* memory = blocks.back() + blockused + padding;
+            blockused += padding + size;
+            return memory;
+        }
+    }
+
+    // operator new returns memory aligned for any fundamental type
+    lastblocksize = (size > blocksize) ? size : blocksize;
+    blocks.push_back(static_cast<char*>(::operator new(lastblocksize)));
+    blockused = size;
+
+    return blocks.back();
+
+}// ProtocolArena::allocate
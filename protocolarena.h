@@ -0,0 +1,71 @@
+#ifndef PROTOCOLARENA_H
+#define PROTOCOLARENA_H
+
+#include <vector>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+/*!
+ * The protocol arena owns the objects of the parsed protocol model. Objects
+ * are constructed in large blocks of memory which are only released when the
+ * arena is cleared or destroyed. The objects are destroyed in the reverse
+ * order of their creation, so teardown is deterministic, and nobody else
+ * should ever delete an object created by the arena.
+ */
+class ProtocolArena
+{
+public:
+
+    //! Construct an empty arena
+    ProtocolArena(std::size_t size = 64*1024);
+
+    //! Destroy all the objects in the arena and release the memory
+    ~ProtocolArena();
+
+    //! Construct a new object in the arena
+    template<class T, typename... Args>
+    T* create(Args&&... args)
+    {
+        T* object = new(allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+
+        if(!std::is_trivially_destructible<T>::value)
+            destructors.push_back(Destructor{object, &destroy<T>});
+
+        return object;
+    }
+
+    //! Destroy all the objects in the arena and release the memory
+    void clear(void);
+
+private:
+
+    //! The arena is not copyable, it owns its objects
+    ProtocolArena(const ProtocolArena&) = delete;
+
+    //! The arena is not copyable, it owns its objects
+    ProtocolArena& operator=(const ProtocolArena&) = delete;
+
+    //! Get memory from the current block, allocating a new block if needed
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    //! Call the destructor of an object in the arena
+    template<class T>
+    static void destroy(void* object) {static_cast<T*>(object)->~T();}
+
+    //! Information needed to destroy one object
+    struct Destructor
+    {
+        void* object;                   //!< The object to destroy
+        void (*function)(void* object); //!< The function which destroys the object
+    };
+
+    std::vector<Destructor> destructors;//!< Destructors of the objects in the order they were created
+    std::vector<char*> blocks;          //!< Memory blocks in the order they were allocated
+    std::size_t blocksize;              //!< Size in bytes of a normal memory block
+    std::size_t blockused;              //!< Number of bytes used in the last block
+    std::size_t lastblocksize;          //!< Size in bytes of the last block
+};
+
+#endif // PROTOCOLARENA_H
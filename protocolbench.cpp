@@ -0,0 +1,211 @@
+#include "protocolbench.h"
+#include "protocolpacket.h"
+#include "protocolstructuremodule.h"
+
+ProtocolBench::ProtocolBench(const ProtocolSupport& protocolsupport) :
+    header(protocolsupport),
+    source(protocolsupport),
+    support(protocolsupport)
+{}
+
+
+/*!
+ * Perform the generation, writing out the files. The modules must have been
+ * parsed already.
+ * \param structures are the global structures, which may include packets that
+ *        are used by other packets; those are timed as packets.
+ * \param packets are the packets.
+ * \param protocolHeader is the name of the main protocol header file.
+ * \param fileNameList is appended with the names of the files written.
+ * \param filePathList is appended with the paths of the files written.
+ * \return true if the files were written.
+ */
+bool ProtocolBench::generate(const std::vector<ProtocolStructureModule*>& structures, const std::vector<ProtocolPacket*>& packets, const std::string& protocolHeader, std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList)
+{
+    std::vector<const ProtocolStructureModule*> modules;
+
+    for(std::size_t i = 0; i < structures.size(); i++)
+    {
+        if(dynamic_cast<const ProtocolPacket*>(structures.at(i)) == nullptr)
+            modules.push_back(structures.at(i));
+    }
+
+    modules.insert(modules.end(), packets.begin(), packets.end());
+
+    if(generateHeader(protocolHeader))
+    {
+        fileNameList.push_back(header.fileName());
+        filePathList.push_back(header.filePath());
+
+        if(generateSource(modules))
+        {
+            fileNameList.push_back(source.fileName());
+            filePathList.push_back(source.filePath());
+
+            return true;
+        }
+    }
+
+    return false;
+
+}// ProtocolBench::generate
+
+
+/*!
+ * Generate the header file, which declares the clock hook and the function
+ * that runs the benchmark.
+ * \param protocolHeader is the name of the main protocol header file.
+ * \return true if the file was written.
+ */
+bool ProtocolBench::generateHeader(const std::string& protocolHeader)
+{
+    std::string module = support.protoName + "Bench";
+
+    header.setModuleNameAndPath(module, support.outputpath);
+
+    header.setFileComment("\\brief Encode and decode benchmark for the " + support.protoName + " protocol\n\n\
+Times the encode and decode of every packet and structure, starting from\n\
+their initial values constrained by their verify limits. Packets and\n\
+structures with variable length content are timed again with that content\n\
+at its maximum length. The results are printed in nanoseconds per encode or\n\
+decode, and in megabytes per second. Define " + toUpper(module) + "_PRINTF to\n\
+replace printf, and " + toUpper(module) + "_NO_DEFAULT_CLOCK if the C library\n\
+clock() is not available.");
+
+    header.makeLineSeparator();
+    header.writeIncludeDirective(protocolHeader);
+    header.makeLineSeparator();
+
+    header.write("//! Clock used to time the benchmark, returns a monotonic time in nanoseconds\n");
+    header.write("typedef uint64_t (*" + support.protoName + "BenchClock_t)(void);\n");
+    header.makeLineSeparator();
+    header.write("//! Time the encode and decode of every packet and structure in the " + support.protoName + " protocol\n");
+    header.write("void run" + module + "(" + support.pointerType + " pkt, int maxdata, uint32_t iterations, " + support.protoName + "BenchClock_t timer);\n");
+    header.makeLineSeparator();
+
+    return header.flush();
+
+}// ProtocolBench::generateHeader
+
+
+/*!
+ * Generate the source file, which has the bench function of each packet and
+ * structure, and the function that calls them.
+ * \param modules are the packets and structures to time.
+ * \return true if the file was written.
+ */
+bool ProtocolBench::generateSource(const std::vector<const ProtocolStructureModule*>& modules)
+{
+    std::string module = support.protoName + "Bench";
+    std::string macro = toUpper(module);
+    std::string report = "report" + module;
+    std::string clock = "default" + support.protoName + "BenchClock";
+
+    source.setModuleNameAndPath(module, support.outputpath);
+
+    std::vector<std::string> list;
+    for(std::size_t i = 0; i < modules.size(); i++)
+        modules.at(i)->getBenchIncludeDirectives(list);
+
+    removeDuplicates(list);
+
+    source.writeIncludeDirective("string.h", std::string(), true, false);
+
+    if(support.language == ProtocolSupport::cpp_language)
+        source.writeIncludeDirective("vector", std::string(), true, false);
+
+    source.writeIncludeDirectives(list);
+    source.makeLineSeparator();
+
+    source.write("#ifndef " + macro + "_PRINTF\n");
+    source.write("#include <stdio.h>\n");
+    source.write("#define " + macro + "_PRINTF printf\n");
+    source.write("#endif\n");
+    source.makeLineSeparator();
+
+    source.write("#ifndef " + macro + "_NO_DEFAULT_CLOCK\n");
+    source.write("#include <time.h>\n");
+    source.write("\n");
+    source.write("//! Clock for the benchmark when the caller does not provide one, based on clock()\n");
+    source.write("static uint64_t " + clock + "(void)\n");
+    source.write("{\n");
+    source.write("    return (uint64_t)((double)clock()*(1.0e9/CLOCKS_PER_SEC));\n");
+    source.write("}\n");
+    source.write("#endif\n");
+    source.makeLineSeparator();
+
+    source.write("/*!\n");
+    source.write(" * Print the time of one packet or structure\n");
+    source.write(" * \\param name is the name of the packet or structure.\n");
+    source.write(" * \\param iterations is the number of encodes and decodes that were timed.\n");
+    source.write(" * \\param encodetime is the time of all the encodes in nanoseconds.\n");
+    source.write(" * \\param decodetime is the time of all the decodes in nanoseconds.\n");
+    source.write(" * \\param length is the number of encoded bytes.\n");
+    source.write(" */\n");
+    source.write("static void " + report + "(const char* name, uint32_t iterations, uint64_t encodetime, uint64_t decodetime, int length)\n");
+    source.write("{\n");
+    source.write("    double encodens = (double)encodetime/iterations;\n");
+    source.write("    double decodens = (double)decodetime/iterations;\n");
+    source.write("\n");
+    source.write("    // Bytes per nanosecond is gigabytes per second\n");
+    source.write("    double encoderate = (encodens > 0) ? 1000.0*length/encodens : 0.0;\n");
+    source.write("    double decoderate = (decodens > 0) ? 1000.0*length/decodens : 0.0;\n");
+    source.write("\n");
+    source.write("    " + macro + "_PRINTF(\"%-40s %8d %12.1f %12.1f %10.1f %10.1f\\n\", name, length, encodens, decodens, encoderate, decoderate);\n");
+    source.write("\n");
+    source.write("}// " + report + "\n");
+    source.makeLineSeparator();
+
+    std::string calls;
+
+    for(std::size_t i = 0; i < modules.size(); i++)
+    {
+        std::string body = modules.at(i)->getBenchFunctionBody();
+
+        if(body.empty())
+            continue;
+
+        source.makeLineSeparator();
+        source.write(body);
+        source.makeLineSeparator();
+
+        calls += "    " + modules.at(i)->getBenchFunctionName() + "(pkt, maxdata, iterations, timer);\n";
+    }
+
+    source.makeLineSeparator();
+    source.write("/*!\n");
+    source.write(" * Time the encode and decode of every packet and structure in the " + support.protoName + " protocol\n");
+    source.write(" * \\param pkt is used for encoding and decoding packets.\n");
+    source.write(" * \\param maxdata is the number of data bytes that pkt can hold, packets\n");
+    source.write(" *        which could be longer are skipped.\n");
+    source.write(" * \\param iterations is the number of times to encode and decode each one.\n");
+    source.write(" * \\param timer returns a monotonic time in nanoseconds, NULL to use clock().\n");
+    source.write(" */\n");
+    source.write("void run" + module + "(" + support.pointerType + " pkt, int maxdata, uint32_t iterations, " + support.protoName + "BenchClock_t timer)\n");
+    source.write("{\n");
+    source.write("    if(iterations == 0)\n");
+    source.write("        iterations = 1;\n");
+    source.write("\n");
+    source.write("    #ifndef " + macro + "_NO_DEFAULT_CLOCK\n");
+    source.write("    if(timer == NULL)\n");
+    source.write("        timer = " + clock + ";\n");
+    source.write("    #endif\n");
+    source.write("\n");
+    source.write("    if(timer == NULL)\n");
+    source.write("        return;\n");
+    source.write("\n");
+    source.write("    " + macro + "_PRINTF(\"%-40s %8s %12s %12s %10s %10s\\n\", \"Name\", \"Bytes\", \"Encode (ns)\", \"Decode (ns)\", \"Enc MB/s\", \"Dec MB/s\");\n");
+
+    if(!calls.empty())
+    {
+        source.write("\n");
+        source.write(calls);
+    }
+
+    source.write("\n");
+    source.write("}// run" + module + "\n");
+    source.makeLineSeparator();
+
+    return source.flush();
+
+}// ProtocolBench::generateSource
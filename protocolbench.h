@@ -0,0 +1,44 @@
+#ifndef PROTOCOLBENCH_H
+#define PROTOCOLBENCH_H
+
+/*!
+ * \file
+ * Generate the encode and decode benchmark module for a protocol
+ */
+
+#include "protocolfile.h"
+#include "protocolsupport.h"
+#include <string>
+#include <vector>
+
+class ProtocolStructureModule;
+class ProtocolPacket;
+
+/*!
+ * The bench module times the encode and decode of every packet and global
+ * structure of the protocol. Each packet and structure supplies its own
+ * bench function, this class collects them into a module with a single entry
+ * point, which takes a clock hook so the benchmark can run on a target.
+ */
+class ProtocolBench
+{
+public:
+    ProtocolBench(const ProtocolSupport& protocolsupport);
+
+    //! Perform the generation, writing out the files
+    bool generate(const std::vector<ProtocolStructureModule*>& structures, const std::vector<ProtocolPacket*>& packets, const std::string& protocolHeader, std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList);
+
+protected:
+
+    //! Generate the header file
+    bool generateHeader(const std::string& protocolHeader);
+
+    //! Generate the source file
+    bool generateSource(const std::vector<const ProtocolStructureModule*>& modules);
+
+    ProtocolHeaderFile header;
+    ProtocolSourceFile source;
+    const ProtocolSupport& support;
+};
+
+#endif // PROTOCOLBENCH_H
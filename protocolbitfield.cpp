@@ -1,8 +1,10 @@
 #include "protocolbitfield.h"
+#include "protocoldocumentation.h"
+#include "codeemitter.h"
 #include <iomanip>
 #include <sstream>
 
-void ProtocolBitfield::generatetest(ProtocolSupport support)
+void ProtocolBitfield::generatetest(const ProtocolSupport& support)
 {
     if(!support.bitfieldtest)
         return;
@@ -576,3 +578,133 @@ std::string ProtocolBitfield::getComplexEncodeString(const std::string& spacing,
     return output;
 
 }// ProtocolBitfield::getEncodeString
+
+
+/*!
+ * Get the encode string for an array of bitfields packed end to end. The bits
+ * of each element are shifted into an accumulator, which writes out each byte
+ * as soon as it is complete; so the array is encoded in one pass, without
+ * computing the bit position of each element. The last byte is padded with
+ * zeroes. Bits are encoded most significant first, like other bitfields.
+ * \param spacing is the spacing at the start of the block of code
+ * \param loop is the array iteration code, which should be indented one
+ *        level deeper than spacing
+ * \param elementspacing is the spacing of the code for each element
+ * \param argument is the string describing each element of the array
+ * \param numbits is the number of bits of each element, which must be no
+ *        more than 57
+ * \return the string that is the encoding code
+ */
+std::string ProtocolBitfield::getPackedEncodeString(const std::string& spacing, const std::string& loop, const std::string& elementspacing, const std::string& argument, int numbits)
+{
+    const std::string& tab = ProtocolDocumentation::TAB_IN;
+    CodeEmitter output;
+    std::string type = getPackedAccumulatorType(numbits);
+
+    output.append(spacing, "{\n");
+    output.append(spacing, tab, type, " _pg_packed = 0;\n");
+    output.append(spacing, tab, "int _pg_packedbits = 0;\n");
+    output.append("\n");
+    output.append(loop);
+    output.append(elementspacing, "{\n");
+    output.append(elementspacing, tab, "_pg_packed = (_pg_packed << ", std::to_string(numbits), ") | ((", type, ")(", argument, ") & ", getPackedMask(numbits), ");\n");
+    output.append(elementspacing, tab, "_pg_packedbits += ", std::to_string(numbits), ";\n");
+    output.append(elementspacing, tab, "while(_pg_packedbits >= 8)\n");
+    output.append(elementspacing, tab, "{\n");
+    output.append(elementspacing, tab, tab, "_pg_packedbits -= 8;\n");
+    output.append(elementspacing, tab, tab, "_pg_data[_pg_byteindex++] = (uint8_t)(_pg_packed >> _pg_packedbits);\n");
+    output.append(elementspacing, tab, "}\n");
+    output.append(elementspacing, "}\n");
+    output.append("\n");
+    output.append(spacing, tab, "// The last byte is padded with zeroes\n");
+    output.append(spacing, tab, "if(_pg_packedbits > 0)\n");
+    output.append(spacing, tab, tab, "_pg_data[_pg_byteindex++] = (uint8_t)(_pg_packed << (8 - _pg_packedbits));\n");
+    output.append(spacing, "}\n");
+
+    return output.take();
+
+}// ProtocolBitfield::getPackedEncodeString
+
+
+/*!
+ * Get the decode string for an array of bitfields packed end to end. Each
+ * byte is shifted into an accumulator only when the next element needs it,
+ * so the bytes decoded are exactly the bytes encoded.
+ * \param spacing is the spacing at the start of the block of code
+ * \param loop is the array iteration code, which should be indented one
+ *        level deeper than spacing
+ * \param elementspacing is the spacing of the code for each element
+ * \param argument is the string describing each element of the array
+ * \param cast is the string used to cast to the arguments type. This can be empty
+ * \param numbits is the number of bits of each element, which must be no
+ *        more than 57
+ * \param isSigned should be true to sign extend each element
+ * \return the string that is the decoding code
+ */
+std::string ProtocolBitfield::getPackedDecodeString(const std::string& spacing, const std::string& loop, const std::string& elementspacing, const std::string& argument, const std::string& cast, int numbits, bool isSigned)
+{
+    const std::string& tab = ProtocolDocumentation::TAB_IN;
+    CodeEmitter output;
+    std::string type = getPackedAccumulatorType(numbits);
+    std::string value = "((_pg_packed >> _pg_packedbits) & " + getPackedMask(numbits) + ")";
+
+    // Sign extend by flipping the sign bit and then subtracting it
+    if(isSigned)
+    {
+        std::string signedtype = type.substr(1);
+        value = "((" + signedtype + ")(" + value + " ^ ((" + type + ")1 << " + std::to_string(numbits - 1) + ")) - ((" + signedtype + ")1 << " + std::to_string(numbits - 1) + "))";
+    }
+
+    output.append(spacing, "{\n");
+    output.append(spacing, tab, type, " _pg_packed = 0;\n");
+    output.append(spacing, tab, "int _pg_packedbits = 0;\n");
+    output.append("\n");
+    output.append(loop);
+    output.append(elementspacing, "{\n");
+    output.append(elementspacing, tab, "while(_pg_packedbits < ", std::to_string(numbits), ")\n");
+    output.append(elementspacing, tab, "{\n");
+    output.append(elementspacing, tab, tab, "_pg_packed = (_pg_packed << 8) | _pg_data[_pg_byteindex++];\n");
+    output.append(elementspacing, tab, tab, "_pg_packedbits += 8;\n");
+    output.append(elementspacing, tab, "}\n");
+    output.append(elementspacing, tab, "_pg_packedbits -= ", std::to_string(numbits), ";\n");
+    output.append(elementspacing, tab, argument, " = ", cast, value, ";\n");
+    output.append(elementspacing, "}\n");
+    output.append(spacing, "}\n");
+
+    return output.take();
+
+}// ProtocolBitfield::getPackedDecodeString
+
+
+/*!
+ * Get the type of the accumulator used to pack or unpack an array of
+ * bitfields. The accumulator holds one element plus up to 7 bits of the
+ * byte in progress.
+ * \param numbits is the number of bits of each element
+ * \return "uint32_t" or "uint64_t"
+ */
+std::string ProtocolBitfield::getPackedAccumulatorType(int numbits)
+{
+    if(numbits + 7 <= 32)
+        return "uint32_t";
+    else
+        return "uint64_t";
+}
+
+
+/*!
+ * Get the mask of the bits of one element of a packed array of bitfields
+ * \param numbits is the number of bits of each element
+ * \return the mask as a hexadecimal constant
+ */
+std::string ProtocolBitfield::getPackedMask(int numbits)
+{
+    std::stringstream stream;
+    stream << std::hex;
+    stream << maxvalueoffield(numbits);
+
+    if(numbits > 32)
+        return "0x" + toUpper(stream.str()) + "ull";
+    else
+        return "0x" + toUpper(stream.str());
+}
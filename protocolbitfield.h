@@ -18,7 +18,7 @@ class ProtocolBitfield
 public:
 
     //! Perform the test generation, writing out the files
-    static void generatetest(ProtocolSupport support);
+    static void generatetest(const ProtocolSupport& support);
 
     //! Compute the maximum value of a field
     static uint64_t maxvalueoffield(int numbits);
@@ -32,6 +32,12 @@ public:
     //! Get the inner string that does a simple bitfield decode
     static std::string getInnerDecodeString(const std::string& dataname, const std::string& dataindex, int bitcount, int numbits);
 
+    //! Get the encode string for an array of bitfields packed end to end
+    static std::string getPackedEncodeString(const std::string& spacing, const std::string& loop, const std::string& elementspacing, const std::string& argument, int numbits);
+
+    //! Get the decode string for an array of bitfields packed end to end
+    static std::string getPackedDecodeString(const std::string& spacing, const std::string& loop, const std::string& elementspacing, const std::string& argument, const std::string& cast, int numbits, bool isSigned);
+
 private:
 
     //! Get the encode string for a complex bitfield (crossing byte boundaries)
@@ -40,6 +46,12 @@ private:
     //! Get the encode string for a complex bitfield (crossing byte boundaries)
     static std::string getComplexDecodeString(const std::string& spacing, const std::string& argument, const std::string& dataname, const std::string& dataindex, int bitcount, int numbits);
 
+    //! Get the type of the accumulator used to pack or unpack an array of bitfields
+    static std::string getPackedAccumulatorType(int numbits);
+
+    //! Get the mask of the bits of one element of a packed array of bitfields
+    static std::string getPackedMask(int numbits);
+
 };
 
 #endif // PROTOCOLBITFIELD_H
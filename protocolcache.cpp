@@ -0,0 +1,486 @@
+#include "protocolcache.h"
+#include "protocolparser.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+/*!
+ * Construct an empty protocol cache
+ */
+ProtocolCache::ProtocolCache(void)
+{
+}
+
+
+/*!
+ * Load the cache from a previous run. If the file does not exist, or cannot be
+ * read, then the cache is empty and every module will output its code.
+ * \param fileName is the path and name of the cache file
+ */
+void ProtocolCache::load(const std::string& fileName)
+{
+    previous.clear();
+
+    std::fstream file(fileName, std::ios_base::in);
+
+    if(!file.is_open())
+        return;
+
+    std::string line;
+    Module* module = nullptr;
+
+    // The first line identifies the version of ProtoGen that wrote the cache
+    if(!std::getline(file, line) || (line != "ProtoGen " + ProtocolParser::genVersion))
+    {
+        file.close();
+        return;
+    }
+
+    while(std::getline(file, line))
+    {
+        if(startsWith(line, "module ", true))
+        {
+            std::vector<std::string> list = split(line, " ");
+
+            if(list.size() != 3)
+            {
+                module = nullptr;
+                continue;
+            }
+
+            module = &previous[list.at(1)];
+            module->key = list.at(2);
+        }
+        else if(module == nullptr)
+            continue;
+        else if(startsWith(line, "dependency ", true))
+            module->dependencies.insert(line.substr(11));
+        else if(startsWith(line, "file ", true))
+            module->files.push_back(line.substr(5));
+
+    }// for all lines in the file
+
+    file.close();
+
+}// ProtocolCache::load
+
+
+/*!
+ * Save the cache so the next run can determine which modules have changed
+ * \param fileName is the path and name of the cache file
+ */
+void ProtocolCache::save(const std::string& fileName) const
+{
+    std::fstream file(fileName, std::ios_base::out);
+
+    if(!file.is_open())
+    {
+        std::cerr << "warning: failed to write cache file " << fileName << std::endl;
+        return;
+    }
+
+    file << "ProtoGen " << ProtocolParser::genVersion << "\n";
+
+    for(const auto& [id, module] : modules)
+    {
+        file << "module " << id << " " << computeKey(id, modules) << "\n";
+
+        for(const std::string& dependency : module.dependencies)
+            file << "dependency " << dependency << "\n";
+
+        // Only the files that were actually written are of interest
+        for(const std::string& name : module.files)
+        {
+            if(std::filesystem::exists(name))
+                file << "file " << name << "\n";
+        }
+    }
+
+    file.close();
+
+}// ProtocolCache::save
+
+
+/*!
+ * Compute the hash of everything that is common to all modules. This includes
+ * the protocol options, the file layout of every top level tag, and every
+ * enumeration (since enumeration values are searched globally by all modules).
+ * Any change to these inputs will cause all modules to output their code.
+ * \param docs is the list of xml documents that were parsed
+ * \param options is the text of the protocol options
+ */
+void ProtocolCache::setCommonInputs(const std::vector<const XMLDocument*>& docs, const std::string& options)
+{
+    // These attributes determine which files a module writes to
+    static const std::vector<std::string> layout = {"name", "file", "deffile", "verifyfile", "comparefile", "printfile", "mapfile", "jsonfile", "redefine", "useInOtherPackets", "hidden", "neverOmit"};
+
+    uint64_t value = hash(ProtocolParser::genVersion);
+    value = hash(options, value);
+
+    for(const XMLDocument* doc : docs)
+    {
+        const XMLElement* root = doc->RootElement();
+
+        if(root == nullptr)
+            continue;
+
+        // The file level options
+        for(const XMLAttribute* a = root->FirstAttribute(); a != nullptr; a = a->Next())
+            value = hash(std::string(a->Name()) + "=" + a->Value(), value);
+
+        // The names and locations of all the top level modules
+        for(const XMLElement* element = root->FirstChildElement(); element != nullptr; element = element->NextSiblingElement())
+        {
+            value = hash(toLower(trimm(element->Name())), value);
+
+            for(const std::string& name : layout)
+                value = hash(name + "=" + ProtocolParser::getAttribute(name, element->FirstAttribute()), value);
+        }
+
+        hashEnumerations(root, value);
+
+    }// for all documents
+
+    common = hashToString(value);
+
+}// ProtocolCache::setCommonInputs
+
+
+/*!
+ * Add a top level module to the cache. The module is identified by its kind
+ * and name.
+ * \param kind is the kind of module, "enum", "structure", or "packet"
+ * \param element is the DOM element of the module
+ */
+void ProtocolCache::addModule(const std::string& kind, const XMLElement* element)
+{
+    std::string id = kind + ":" + ProtocolParser::getAttribute("name", element->FirstAttribute());
+
+    // Handle duplicate names, which are legal (but not smart)
+    if(modules.find(id) != modules.end())
+    {
+        int count = 2;
+        while(modules.find(id + "#" + std::to_string(count)) != modules.end())
+            count++;
+
+        id += "#" + std::to_string(count);
+    }
+
+    Module& module = modules[id];
+    module.element = element;
+    module.inputhash = hashElement(element);
+
+    identifiers[element] = id;
+
+}// ProtocolCache::addModule
+
+
+/*!
+ * Determine which modules can skip their code output. A module can skip its
+ * output if its key (computed using the dependencies from the previous run)
+ * matches the previous key, all of its files exist, and none of its files
+ * are shared with a module that must output its code.
+ * \param alwaysWritten is the list of file paths and names that are always
+ *        written, any module that uses these files must output its code.
+ */
+void ProtocolCache::findUnchangedModules(const std::vector<std::string>& alwaysWritten)
+{
+    // Map from file name to modules that write to that file
+    std::map<std::string, std::vector<std::string>> users;
+
+    for(auto& [id, module] : modules)
+    {
+        module.unchanged = false;
+
+        auto prev = previous.find(id);
+        if(prev == previous.end())
+            continue;
+
+        if(prev->second.key != computeKey(id, previous))
+            continue;
+
+        module.unchanged = true;
+
+        for(const std::string& name : prev->second.files)
+        {
+            users[name].push_back(id);
+
+            if(contains(alwaysWritten, name, true) || !std::filesystem::exists(name))
+                module.unchanged = false;
+        }
+
+    }// for all modules
+
+    // Changed modules force any module they share a file with to output its
+    // code, which may in turn force other modules to output code
+    bool changed = true;
+    while(changed)
+    {
+        changed = false;
+
+        for(auto& [id, module] : modules)
+        {
+            if(module.unchanged)
+                continue;
+
+            auto prev = previous.find(id);
+            if(prev == previous.end())
+                continue;
+
+            for(const std::string& name : prev->second.files)
+            {
+                for(const std::string& user : users[name])
+                {
+                    if(modules[user].unchanged)
+                    {
+                        modules[user].unchanged = false;
+                        changed = true;
+                    }
+                }
+            }
+        }
+
+    }// while modules are changing
+
+}// ProtocolCache::findUnchangedModules
+
+
+/*!
+ * Determine if a module can skip its code output
+ * \param element is the DOM element of the module
+ * \return true if the module outputs from the previous run are still valid
+ */
+bool ProtocolCache::isUnchanged(const XMLElement* element) const
+{
+    auto module = modules.find(lookUpModule(element));
+
+    if(module == modules.end())
+        return false;
+
+    return module->second.unchanged;
+}
+
+
+/*!
+ * Set the module whose dependencies are being recorded
+ * \param element is the DOM element of the module, or null to stop recording
+ */
+void ProtocolCache::setCurrentModule(const XMLElement* element)
+{
+    current = lookUpModule(element);
+}
+
+
+/*!
+ * Record a dependency of the current module. The dependency is the top level
+ * module which contains element.
+ * \param element is the DOM element that the current module depends on
+ */
+void ProtocolCache::addDependency(const XMLElement* element)
+{
+    if(current.empty())
+        return;
+
+    for(const XMLNode* node = element; node != nullptr; node = node->Parent())
+    {
+        std::string id = lookUpModule(node->ToElement());
+
+        if(id.empty())
+            continue;
+
+        if(id != current)
+            modules[current].dependencies.insert(id);
+
+        return;
+    }
+
+}// ProtocolCache::addDependency
+
+
+/*!
+ * Record the files that a module can write to. If the module did not output
+ * its code the files and dependencies from the previous run are retained.
+ * \param element is the DOM element of the module
+ * \param files is the list of file paths and names
+ */
+void ProtocolCache::setFiles(const XMLElement* element, const std::vector<std::string>& files)
+{
+    auto module = modules.find(lookUpModule(element));
+
+    if(module == modules.end())
+        return;
+
+    if(module->second.unchanged)
+    {
+        auto prev = previous.find(module->first);
+        if(prev != previous.end())
+        {
+            module->second.files = prev->second.files;
+            module->second.dependencies.insert(prev->second.dependencies.begin(), prev->second.dependencies.end());
+            return;
+        }
+    }
+
+    module->second.files.clear();
+    for(const std::string& name : files)
+    {
+        if(!name.empty() && !contains(module->second.files, name, true))
+            module->second.files.push_back(name);
+    }
+
+}// ProtocolCache::setFiles
+
+
+/*!
+ * \return the number of modules that can skip their code output
+ */
+int ProtocolCache::numUnchangedModules(void) const
+{
+    int count = 0;
+
+    for(const auto& [id, module] : modules)
+    {
+        if(module.unchanged)
+            count++;
+    }
+
+    return count;
+}
+
+
+/*!
+ * Compute the key for a module. The key includes the common inputs, the xml
+ * of the module, and the xml of every module it depends on (recursively).
+ * \param id is the identifier of the module
+ * \param dependencysource gives the dependencies of each module
+ * \return the key as a hexadecimal string
+ */
+std::string ProtocolCache::computeKey(const std::string& id, const std::map<std::string, Module>& dependencysource) const
+{
+    std::set<std::string> visited;
+    std::vector<std::string> stack(1, id);
+
+    // Find all the dependencies, recursively
+    while(!stack.empty())
+    {
+        std::string next = stack.back();
+        stack.pop_back();
+
+        if(!visited.insert(next).second)
+            continue;
+
+        auto source = dependencysource.find(next);
+        if(source != dependencysource.end())
+            stack.insert(stack.end(), source->second.dependencies.begin(), source->second.dependencies.end());
+    }
+
+    uint64_t value = hash(common);
+
+    // Note that std::set is sorted, so the order is repeatable
+    for(const std::string& name : visited)
+    {
+        auto module = modules.find(name);
+
+        if(module == modules.end())
+            value = hash(name + " missing", value);
+        else
+            value = hash(name + " " + module->second.inputhash, value);
+    }
+
+    return hashToString(value);
+
+}// ProtocolCache::computeKey
+
+
+/*!
+ * Find the identifier of a module from its DOM element
+ * \param element is the DOM element of the module
+ * \return the identifier of the module, or an empty string if element is not a module
+ */
+std::string ProtocolCache::lookUpModule(const XMLElement* element) const
+{
+    auto id = identifiers.find(element);
+
+    if(id == identifiers.end())
+        return std::string();
+    else
+        return id->second;
+}
+
+
+/*!
+ * Hash the xml of an element and all of its children
+ * \param element is the DOM element to hash
+ * \return the hash as a hexadecimal string
+ */
+std::string ProtocolCache::hashElement(const XMLElement* element)
+{
+    XMLPrinter printer(nullptr, true);
+
+    element->Accept(&printer);
+
+    return hashToString(hash(printer.CStr()));
+}
+
+
+/*!
+ * Hash the enumerations in an element and all of its children
+ * \param element is the DOM element to search for enumerations
+ * \param value is the hash which is updated by every enumeration found
+ */
+void ProtocolCache::hashEnumerations(const XMLElement* element, uint64_t& value)
+{
+    for(const XMLElement* child = element->FirstChildElement(); child != nullptr; child = child->NextSiblingElement())
+    {
+        std::string nodename = toLower(trimm(child->Name()));
+
+        if((nodename == "enum") || (nodename == "enumeration"))
+            value = hash(hashElement(child), value);
+        else
+            hashEnumerations(child, value);
+    }
+}
+
+
+/*!
+ * Compute the 64-bit FNV-1a hash of a string
+ * \param text is the string to hash
+ * \param seed is the starting hash value, which can be used to chain hashes together
+ * \return the hash value
+ */
+uint64_t ProtocolCache::hash(const std::string& text, uint64_t seed)
+{
+    uint64_t value = seed;
+
+    for(const char& c : text)
+    {
+        value ^= (uint8_t)c;
+        value *= 1099511628211ULL;
+    }
+
+    // Separate successive strings so that "ab"+"c" does not equal "a"+"bc"
+    value ^= 0xFF;
+    value *= 1099511628211ULL;
+
+    return value;
+}
+
+
+/*!
+ * Convert a hash to a hexadecimal string
+ * \param value is the hash to convert
+ * \return the 16 character hexadecimal string
+ */
+std::string ProtocolCache::hashToString(uint64_t value)
+{
+    static const char digits[] = "0123456789abcdef";
+    std::string text(16, '0');
+
+    for(int i = 15; i >= 0; i--)
+    {
+        text[i] = digits[value & 0x0F];
+        value >>= 4;
+    }
+
+    return text;
+}
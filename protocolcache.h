@@ -0,0 +1,99 @@
+#ifndef PROTOCOLCACHE_H
+#define PROTOCOLCACHE_H
+
+#include "protocolsupport.h"
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+#include <cstdint>
+
+/*!
+ * The protocol cache remembers, for each global Enum, Structure, and Packet,
+ * a hash of the inputs that produced its code outputs, and the list of files
+ * that it wrote to. On subsequent runs modules whose inputs have not changed
+ * (and which do not share an output file with a module whose inputs have
+ * changed) can skip the code output.
+ */
+class ProtocolCache
+{
+public:
+
+    //! Construct an empty cache
+    ProtocolCache(void);
+
+    //! Load the cache from a previous run
+    void load(const std::string& fileName);
+
+    //! Save the cache for the next run
+    void save(const std::string& fileName) const;
+
+    //! Compute the hash of everything that is common to all modules
+    void setCommonInputs(const std::vector<const XMLDocument*>& docs, const std::string& options);
+
+    //! Add a top level module to the cache
+    void addModule(const std::string& kind, const XMLElement* element);
+
+    //! Determine which modules can skip their code output
+    void findUnchangedModules(const std::vector<std::string>& alwaysWritten);
+
+    //! Determine if a module can skip its code output
+    bool isUnchanged(const XMLElement* element) const;
+
+    //! Set the module whose dependencies are being recorded
+    void setCurrentModule(const XMLElement* element);
+
+    //! Record a dependency of the current module
+    void addDependency(const XMLElement* element);
+
+    //! Record the files written by a module
+    void setFiles(const XMLElement* element, const std::vector<std::string>& files);
+
+    //! Get the number of modules in the cache
+    int numModules(void) const {return (int)modules.size();}
+
+    //! Get the number of modules that can skip their code output
+    int numUnchangedModules(void) const;
+
+    //! Compute the 64-bit FNV-1a hash of a string
+    static uint64_t hash(const std::string& text, uint64_t seed = 14695981039346656037ULL);
+
+    //! Convert a hash to a hexadecimal string
+    static std::string hashToString(uint64_t value);
+
+private:
+
+    //! Information about one module in the cache
+    class Module
+    {
+    public:
+        Module(void) : element(nullptr), unchanged(false) {}
+
+        const XMLElement* element;          //!< The DOM element of the module, null if from the previous run
+        std::string inputhash;              //!< Hash of the xml of the module
+        std::string key;                    //!< Hash of all the inputs of the module
+        std::set<std::string> dependencies; //!< Identifiers of the modules this module depends on
+        std::vector<std::string> files;     //!< Path and name of all files written by the module
+        bool unchanged;                     //!< True if the module can skip its code output
+    };
+
+    //! Compute the key for a module, given its dependencies
+    std::string computeKey(const std::string& id, const std::map<std::string, Module>& dependencysource) const;
+
+    //! Find the identifier of a module from its DOM element
+    std::string lookUpModule(const XMLElement* element) const;
+
+    //! Hash the xml of an element and all of its children
+    static std::string hashElement(const XMLElement* element);
+
+    //! Hash the enumerations in an element and all of its children
+    static void hashEnumerations(const XMLElement* element, uint64_t& value);
+
+    std::string common;                     //!< Hash of the inputs common to all modules
+    std::string current;                    //!< Identifier of the module whose dependencies are being recorded
+    std::map<std::string, Module> modules;  //!< Modules from this run
+    std::map<std::string, Module> previous; //!< Modules from the previous run
+    std::map<const XMLElement*, std::string> identifiers;//!< Map from DOM element to module identifier
+};
+
+#endif // PROTOCOLCACHE_H
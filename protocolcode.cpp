@@ -7,10 +7,11 @@
  * \param parent is the hierarchical name of the owning object
  * \param supported indicates what the protocol can support
  */
-ProtocolCode::ProtocolCode(ProtocolParser* parse, std::string parent, ProtocolSupport supported):
+ProtocolCode::ProtocolCode(ProtocolParser* parse, std::string parent, const ProtocolSupport& supported):
     Encodable(parse, parent, supported)
 {
-    attriblist = {"name", "encode", "decode", "encode_c", "decode_c", "encode_cpp", "decode_cpp", "encode_python", "decode_python", "comment", "include"};
+    static const AttributeKeys codeattributes({"name", "encode", "decode", "encode_c", "decode_c", "encode_cpp", "decode_cpp", "encode_python", "decode_python", "comment", "include"});
+    attriblist = &codeattributes;
 }
 
 
@@ -41,7 +42,7 @@ void ProtocolCode::parse(bool nocode)
     if(e == nullptr)
         return;
 
-    const XMLAttribute* map = e->FirstAttribute();
+    AttributeIndex map(e->FirstAttribute(), *attriblist);
 
     // We use name as part of our debug outputs, so its good to have it first.
     name = ProtocolParser::getAttribute("name", map, "_unknown");
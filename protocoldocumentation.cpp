@@ -13,14 +13,16 @@ std::vector<std::string> ProtocolDocumentation::keywords = {"auto", "double", "i
 std::vector<std::string> ProtocolDocumentation::variablenames = {"_pg_user", "_pg_user1", "_pg_user2", "_pg_data", "_pg_i", "_pg_j", "_pg_byteindex", "_pg_bytecount", "_pg_numBytes", "_pg_bitfieldbytes", "_pg_tempbitfield", "_pg_templongbitfield", "_pg_bitfieldindex", "_pg_good", "_pg_struct1", "_pg_struct2", "_pg_prename", "_pg_report"};
 
 //! Construct the document object, with details about the overall protocol
-ProtocolDocumentation::ProtocolDocumentation(ProtocolParser* parse, std::string Parent, ProtocolSupport supported) :
+ProtocolDocumentation::ProtocolDocumentation(ProtocolParser* parse, std::string Parent, const ProtocolSupport& supported) :
     support(supported),
     parser(parse),
     parent(Parent),
     e(nullptr),
-    attriblist({"name", "title", "comment", "file", "paragraph"}),
+    attriblist(nullptr),
     outlineLevel(0)
 {
+    static const AttributeKeys documentattributes({"name", "title", "comment", "file", "paragraph"});
+    attriblist = &documentattributes;
 }
 
 
@@ -34,7 +36,7 @@ void ProtocolDocumentation::parse(bool nocode)
 
     // We have two features we care about in the documentation, "name" which
     // gives the paragraph, and "comment" which gives the documentation to add
-    const XMLAttribute* map = e->FirstAttribute();
+    AttributeIndex map(e->FirstAttribute(), *attriblist);
 
     name = ProtocolParser::getAttribute("name", map);
     title = ProtocolParser::getAttribute("title", map);
@@ -161,24 +163,19 @@ void ProtocolDocumentation::emitWarning(const std::string& sourcefile, const std
 
 
 /*!
- * Test the list of attributes and warn if any of them are unrecognized
- * \param map is the list of attributes
- * \param subname is the optional name of a sub-element for which this test is done
+ * Warn about any attributes which are unrecognized. The index found them
+ * when it read the attributes, so this does not search the attributes again.
+ * \param map is the index of the attributes, built with attriblist
  */
-void ProtocolDocumentation::testAndWarnAttributes(const XMLAttribute* map) const
+void ProtocolDocumentation::testAndWarnAttributes(const AttributeIndex& map) const
 {
     // The only thing we check for is unrecognized attributes
     if(support.disableunrecognized)
         return;
 
     /// TODO: test for repeated attributes
-    for(const XMLAttribute* a = map; a != nullptr; a = a->Next())
-    {
-        // Check to see if the attribute is not in the list of known attributes
-        if((contains(attriblist, a->Name()) == false))
-            emitWarning("Unrecognized attribute", a);
-
-    }// for all attributes
+    for(std::size_t i = 0; i < map.getUnrecognized().size(); i++)
+        emitWarning("Unrecognized attribute", map.getUnrecognized().at(i));
 
 }// ProtocolDocumentation::testAndWarnAttributes
 
@@ -189,9 +186,9 @@ void ProtocolDocumentation::testAndWarnAttributes(const XMLAttribute* map) const
  * \param Parent is the name of the parent object that owns the created objects
  * \param support is the protocol support object that gives protocol options
  * \param e is the DOM element which may have documentation children
- * \param list receives the list of allocated objects.
+ * \param list receives the list of allocated objects, which are owned by the arena of the parser.
  */
-void ProtocolDocumentation::getChildDocuments(ProtocolParser* parse, const std::string& Parent, ProtocolSupport support, const XMLElement* e, std::vector<ProtocolDocumentation*>& list)
+void ProtocolDocumentation::getChildDocuments(ProtocolParser* parse, const std::string& Parent, const ProtocolSupport& support, const XMLElement* e, std::vector<ProtocolDocumentation*>& list)
 {
     // The list of documentation that goes inside this packet
     std::vector<const XMLElement*> documents = ProtocolParser::childElementsByTagName(e, "Document");
@@ -200,7 +197,7 @@ void ProtocolDocumentation::getChildDocuments(ProtocolParser* parse, const std::
     for(std::size_t i = 0; i < documents.size(); i++)
     {
         // Create the document and parse its xml
-        ProtocolDocumentation* doc = new ProtocolDocumentation(parse, Parent, support);
+        ProtocolDocumentation* doc = parse->getArena().create<ProtocolDocumentation>(parse, Parent, support);
 
         doc->setElement(documents.at(i));
         doc->parse();
@@ -4,6 +4,7 @@
 #include <vector>
 #include <string>
 #include "protocolsupport.h"
+#include "attributeindex.h"
 
 class ProtocolParser;
 
@@ -12,7 +13,7 @@ class ProtocolDocumentation
 public:
 
     //! Construct the document object
-    ProtocolDocumentation(ProtocolParser* parse, std::string Parent, ProtocolSupport supported);
+    ProtocolDocumentation(ProtocolParser* parse, std::string Parent, const ProtocolSupport& supported);
 
     //! Virtual destructor
     virtual ~ProtocolDocumentation(void) {;}
@@ -47,11 +48,11 @@ public:
     //! Output a warning for an attribute to stderr
     static void emitWarning(const std::string& sourcefile, const std::string& hierarchicalName, const std::string& warning, const XMLAttribute* a);
 
-    //! Test the list of attributes and warn if any of them are unrecognized or repeated
-    void testAndWarnAttributes(const XMLAttribute* map) const;
+    //! Warn about the attributes which the index did not recognize
+    void testAndWarnAttributes(const AttributeIndex& map) const;
 
     //! Helper function to create a list of ProtocolDocumentation objects
-    static void getChildDocuments(ProtocolParser* parse, const std::string& parent, ProtocolSupport support, const XMLElement* e, std::vector<ProtocolDocumentation*>& list);
+    static void getChildDocuments(ProtocolParser* parse, const std::string& parent, const ProtocolSupport& support, const XMLElement* e, std::vector<ProtocolDocumentation*>& list);
 
 public:
 
@@ -64,12 +65,12 @@ public:
 
 protected:
 
-    ProtocolSupport support;    //!< Information about what is supported
+    const ProtocolSupport& support;//!< Information about what is supported, shared by all objects
     ProtocolParser* parser;     //!< The parser object
     std::string parent;         //!< The parent name of this encodable
     const XMLElement* e;        //!< The DOM element which is the source of this object's data
 
-    std::vector<std::string> attriblist;//!< List of all attributes that we understand
+    const AttributeKeys* attriblist;//!< All attributes that we understand, shared by all objects of a kind
 
     static std::vector<std::string> keywords;     //!< keywords for the C language
     static std::vector<std::string> variablenames;//!< variables used by protogen
@@ -12,7 +12,7 @@
 #include <limits>
 #include <iostream>
 
-TypeData::TypeData(ProtocolSupport sup) :
+TypeData::TypeData(const ProtocolSupport& sup) :
     isBool(false),
     isStruct(false),
     isSigned(false),
@@ -25,7 +25,7 @@ TypeData::TypeData(ProtocolSupport sup) :
     bits(8),
     sigbits(0),
     enummax(0),
-    support(sup)
+    support(&sup)
 {
 }
 
@@ -44,6 +44,8 @@ void TypeData::clear(void)
     isString = false;
     isFixedString = false;
     isNull = false;
+    isVarint = false;
+    isPacked = false;
     bits = 8;
     sigbits = 0;
     enummax = 0;
@@ -64,7 +66,7 @@ std::string TypeData::toTypeString(const std::string& structName) const
         typeName = "char";
     else if(isBitfield)
     {
-        if((bits > 32) && (support.longbitfield))
+        if((bits > 32) && (support->longbitfield))
             typeName = "uint64_t";
         else
             typeName = "unsigned";
@@ -78,9 +80,9 @@ std::string TypeData::toTypeString(const std::string& structName) const
         typeName = trimm(structName);
 
         // Make sure it ends with the suffix;
-        if(!endsWith(typeName, support.typeSuffix))
+        if(!endsWith(typeName, support->typeSuffix))
         {
-            typeName += support.typeSuffix;
+            typeName += support->typeSuffix;
         }
     }
     else
@@ -470,7 +472,7 @@ double TypeData::extractDouble(const std::string& string, bool* ok)
  * \param parent is the hierarchical name of the parent object
  * \param supported indicates what the protocol can support
  */
-ProtocolField::ProtocolField(ProtocolParser* parse, std::string parent, ProtocolSupport supported):
+ProtocolField::ProtocolField(ProtocolParser* parse, std::string parent, const ProtocolSupport& supported):
     Encodable(parse, parent, supported),
     encodedMin(0),
     encodedMax(0),
@@ -491,38 +493,39 @@ ProtocolField::ProtocolField(ProtocolParser* parse, std::string parent, Protocol
     neverOmit(false),
     mapOptions(MAP_BOTH)
 {
-    attriblist = {"name",
-                  "title",
-                  "inMemoryType",
-                  "encodedType",
-                  "struct",
-                  "max",
-                  "min",
-                  "scaler",
-                  "printscaler",
-                  "array",
-                  "variableArray",
-                  "array2d",
-                  "variable2dArray",
-                  "dependsOn",
-                  "dependsOnValue",
-                  "dependsOnCompare",
-                  "enum",
-                  "default",
-                  "constant",
-                  "checkConstant",
-                  "comment",
-                  "Units",
-                  "Range",
-                  "Notes",
-                  "bitfieldGroup",
-                  "hidden",
-                  "neverOmit",
-                  "initialValue",
-                  "verifyMinValue",
-                  "verifyMaxValue",
-                  "map",
-                  "limitOnEncode"};
+    static const AttributeKeys fieldattributes({"name",
+                                                "title",
+                                                "inMemoryType",
+                                                "encodedType",
+                                                "struct",
+                                                "max",
+                                                "min",
+                                                "scaler",
+                                                "printscaler",
+                                                "array",
+                                                "variableArray",
+                                                "array2d",
+                                                "variable2dArray",
+                                                "dependsOn",
+                                                "dependsOnValue",
+                                                "dependsOnCompare",
+                                                "enum",
+                                                "default",
+                                                "constant",
+                                                "checkConstant",
+                                                "comment",
+                                                "Units",
+                                                "Range",
+                                                "Notes",
+                                                "bitfieldGroup",
+                                                "hidden",
+                                                "neverOmit",
+                                                "initialValue",
+                                                "verifyMinValue",
+                                                "verifyMaxValue",
+                                                "map",
+                                                "limitOnEncode"});
+    attriblist = &fieldattributes;
 }
 
 
@@ -865,6 +868,19 @@ void ProtocolField::extractType(TypeData& data, const std::string& typeString, b
 
         data.bits = 8;
     }
+    else if(startsWith(type, "var"))
+    {
+        // "varint" is zigzag encoded, "varuint" is not. The number of bits is
+        // the width of the coding functions, which is changed to 64 later if
+        // the in memory type needs it
+        data.isSigned = !startsWith(type, "varu");
+        data.bits = 32;
+
+        if(inMemory)
+            emitWarning("variable length integers are only for encoded types, 32 bit integer assumed");
+        else
+            data.isVarint = true;
+    }
     else
     {
         // Get the number of bits, between 1 and 32 inclusive
@@ -1069,7 +1085,7 @@ void ProtocolField::parse(bool nocode)
     if(e == nullptr)
         return;
 
-    const XMLAttribute* map = e->FirstAttribute();
+    AttributeIndex map(e->FirstAttribute(), *attriblist);
 
     // We use name as part of our debug outputs, so its good to have it first.
     name = ProtocolParser::getAttribute("name", map);
@@ -1079,9 +1095,9 @@ void ProtocolField::parse(bool nocode)
 
     // This will propagate to any of the children we create
     if(ProtocolParser::isFieldSet("limitOnEncode", map))
-        support.limitonencode = true;
+        limitonencode = true;
     else if(ProtocolParser::isFieldClear("limitOnEncode", map))
-        support.limitonencode = false;
+        limitonencode = false;
 
     title = ProtocolParser::getAttribute("title", map);
     memoryTypeString = ProtocolParser::getAttribute("inMemoryType", map);
@@ -1234,6 +1250,35 @@ void ProtocolField::parse(bool nocode)
         }
     }
 
+    if(encodedType.isVarint)
+    {
+        if(inMemoryType.isStruct || inMemoryType.isString || inMemoryType.isFloat || inMemoryType.isBitfield)
+        {
+            emitWarning("variable length integers need an integer in memory type, fixed length encoding used");
+            encodedType.isVarint = false;
+        }
+        else if(inMemoryType.isNull && !array.empty())
+        {
+            emitWarning("variable length integers cannot encode reserved arrays, fixed length encoding used");
+            encodedType.isVarint = inMemoryType.isVarint = false;
+        }
+        else
+        {
+            // The encoding covers the whole range of the in memory type
+            if((inMemoryType.bits > 32) && support.int64)
+                encodedType.bits = 64;
+
+            if(!maxString.empty() || !minString.empty() || !scalerString.empty())
+            {
+                emitWarning("min, max, and scaler do not apply to variable length integers");
+                maxString.clear();
+                minString.clear();
+                scalerString.clear();
+            }
+        }
+
+    }// if variable length integer encoding
+
     if(inMemoryType.isEnum)
     {
         if(inMemoryType.enumName.empty())
@@ -1324,6 +1369,40 @@ void ProtocolField::parse(bool nocode)
         }
     }
 
+    // An array of bitfields is packed end to end in the encoding, and is an
+    // array of integers in memory
+    if(encodedType.isBitfield && !array.empty() && !inMemoryType.isNull && !inMemoryType.isFloat)
+    {
+        if((encodedType.bits > 57) || ((encodedType.bits > 25) && !support.int64))
+            emitWarning("packed bitfield arrays are limited to 57 bits, or 25 bits without 64-bit integers");
+        else
+        {
+            if(inMemoryType.isBitfield)
+            {
+                // The smallest integer that holds the bitfield
+                inMemoryType.isBitfield = false;
+                inMemoryType.bits = 8*((inMemoryType.bits + 7)/8);
+                if(inMemoryType.bits == 24)
+                    inMemoryType.bits = 32;
+                else if(inMemoryType.bits > 32)
+                    inMemoryType.bits = 64;
+            }
+
+            if(!maxString.empty() || !minString.empty() || !scalerString.empty())
+            {
+                emitWarning("min, max, and scaler do not apply to packed bitfield arrays");
+                maxString.clear();
+                minString.clear();
+                scalerString.clear();
+            }
+
+            // Signed elements are sign extended when decoded
+            encodedType.isBitfield = false;
+            encodedType.isPacked = true;
+            encodedType.isSigned = inMemoryType.isSigned;
+        }
+    }
+
     // It is possible for the in memory type to not be a bit field, but the
     // encoding could be. The most common case for this would be an in-memory
     // enumeration in which the maximum enumeration fits in fewer than 8 bits
@@ -1771,6 +1850,20 @@ void ProtocolField::parse(bool nocode)
         limitMaxStringForComment = getNumberString(limitMaxValue);
         limitMinStringForComment = getNumberString(limitMinValue);
     }
+    else if(encodedType.isVarint && !inMemoryType.isNull && !inMemoryType.isBool && !inMemoryType.isEnum &&
+            (inMemoryType.isSigned == encodedType.isSigned) && (inMemoryType.bits < encodedType.bits))
+    {
+        // A variable length integer only carries the range of the in memory type
+        limitMinValue = (double)inMemoryType.getMinimumIntegerValue();
+        limitMaxValue = (double)inMemoryType.getMaximumIntegerValue();
+
+        if(limitMinValue >= 0)
+            limitMinStringForComment = limitMinString = std::to_string((uint64_t)round(limitMinValue));
+        else
+            limitMinStringForComment = limitMinString = std::to_string((int64_t)round(limitMinValue));
+
+        limitMaxStringForComment = limitMaxString = std::to_string((uint64_t)round(limitMaxValue));
+    }
     else
     {
         limitMinValue = (double)encodedType.getMinimumIntegerValue();
@@ -1981,6 +2074,48 @@ void ProtocolField::computeEncodedLength(void)
                 encodedLength.addToLength("getMinLengthOf" + typeName + "()"         , false, false,                    !dependsOn.empty(), (!defaultString.empty()) || overridesPrevious);
         }
     }
+    else if(encodedType.isPacked)
+    {
+        std::string count = array;
+        if(is2dArray())
+            count = "(" + array + ")*(" + array2d + ")";
+
+        // The packed bits are rounded up to whole bytes. This must not be
+        // left to the length string, which does not do integer division
+        bool ok;
+        double number = ShuntingYard::computeInfix(parser->replaceEnumerationNameWithValue(count), &ok);
+
+        std::string lengthString;
+        if(ok)
+            lengthString = std::to_string(((int64_t)round(number)*encodedType.bits + 7)/8);
+        else
+            lengthString = "((" + count + ")*" + std::to_string(encodedType.bits) + " + 7)/8";
+
+        encodedLength.addToLength(lengthString, false, !variableArray.empty() || !variable2dArray.empty(), !dependsOn.empty(), (!defaultString.empty()) || overridesPrevious);
+
+    }
+    else if(encodedType.isVarint)
+    {
+        // Seven bits per byte, at least one byte
+        std::string maxLength = std::to_string((encodedType.bits + 6) / 7);
+        std::string minLength = "1";
+
+        // Remember that we could be encoding an array
+        if(isArray())
+        {
+            maxLength += "*" + array;
+            minLength += "*" + array;
+        }
+
+        if(is2dArray())
+        {
+            maxLength += "*" + array2d;
+            minLength += "*" + array2d;
+        }
+
+        encodedLength.addRangeToLength(maxLength, minLength, !variableArray.empty() || !variable2dArray.empty(), !dependsOn.empty(), (!defaultString.empty()) || overridesPrevious);
+
+    }
     else
     {
         std::string lengthString = std::to_string(encodedType.bits / 8);
@@ -2232,6 +2367,24 @@ void ProtocolField::getPrintIncludeDirectives(std::vector<std::string>& list) co
 }// ProtocolField::getPrintIncludeDirectives
 
 
+/*!
+ * Return the include directives needed for this encodable's JSON functions
+ * \param list is push_backed with any directives this encodable requires.
+ */
+void ProtocolField::getJsonIncludeDirectives(std::vector<std::string>& list) const
+{
+    if(inMemoryType.isStruct)
+    {
+        const ProtocolStructureModule* struc = parser->lookUpStructure(typeName);
+
+        if(struc != NULL)
+            struc->getJsonIncludeDirectives(list);
+
+    }// if struct
+
+}// ProtocolField::getJsonIncludeDirectives
+
+
 /*!
  * Return the signature of this field in an encode function signature
  * \return The encode signature of this field
@@ -2431,7 +2584,7 @@ void ProtocolField::getDocumentationDetails(std::vector<int>& outline, std::stri
         }
         else
         {
-            if(encodedType.isBitfield)
+            if(encodedType.isBitfield || encodedType.isPacked)
                 encodings.push_back("B" + std::to_string(encodedType.bits));
             else if(encodedType.isFloat)
             {
@@ -2440,6 +2593,13 @@ void ProtocolField::getDocumentationDetails(std::vector<int>& outline, std::stri
                 else
                     encodings.push_back("F" + std::to_string(encodedType.bits));
             }
+            else if(encodedType.isVarint)
+            {
+                if(encodedType.isSigned)
+                    encodings.push_back("VI" + std::to_string(encodedType.bits));
+                else
+                    encodings.push_back("VU" + std::to_string(encodedType.bits));
+            }
             else if(encodedType.isSigned)
                 encodings.push_back("I" + std::to_string(encodedType.bits));
             else
@@ -2468,7 +2628,12 @@ void ProtocolField::getDocumentationDetails(std::vector<int>& outline, std::stri
         if(!description.empty() && !endsWith(description, "."))
             description += ".";
 
-        if(support.limitonencode && (!verifyMinStringForDisplay.empty() || !verifyMaxStringForDisplay.empty()))
+        if(encodedType.isVarint)
+            description += "<br>Variable length integer of 1 to " + std::to_string((encodedType.bits + 6)/7) + " bytes.";
+        else if(encodedType.isPacked)
+            description += "<br>Array elements are packed end to end, the last byte is padded with zeroes.";
+
+        if(limitonencode && (!verifyMinStringForDisplay.empty() || !verifyMaxStringForDisplay.empty()))
         {
             if(!verifyMinStringForDisplay.empty() && !verifyMaxStringForDisplay.empty())
                 description += "<br>Value is limited on encode from " + verifyMinStringForDisplay + " to " + verifyMaxStringForDisplay + ".";
@@ -2558,164 +2723,492 @@ std::string ProtocolField::getEncodeString(int* bitcount, bool isStructureMember
 
 
 /*!
- * Get the next lines(s) of source coded needed to decode this field
- * \param bitcount points to the running count of bits in a bitfields and should persist between calls
- * \param isStructureMember should be true if the left hand side is a
- *        member of a user structure, else the left hand side is a pointer
- *        to the inMemoryType
- * \param defaultEnabled should be true to handle defaults
- * \return The string to add to the source file that encodes this field.
+ * Get the next line(s) of source code needed to add the encoded size of this
+ * field to "_pg_byteindex", without encoding or decoding it. This follows the
+ * encode: variable arrays are limited by the array size, dependsOn fields are
+ * only counted if present, and strings are counted up to their null terminator.
+ * \param isStructureMember should be true if the field is accessed as a
+ *        member of a user structure
+ * \param skip should be true to size the field from the encoded bytes in
+ *        "_pg_data", which are limited by "_pg_numbytes", rather than from
+ *        the user data.
+ * \return The string to add to the source file, which is empty if the encoded
+ *         size of this field is always its maximum encoded length.
  */
-std::string ProtocolField::getDecodeString(int* bitcount, bool isStructureMember, bool defaultEnabled) const
+std::string ProtocolField::getLengthString(bool isStructureMember, bool skip) const
 {
-    std::string output;
+    CodeEmitter output;
+    std::string spacing = TAB_IN;
 
-    if(encodedType.isBitfield)
-        output += getDecodeStringForBitfield(bitcount, isStructureMember, defaultEnabled);
-    else if(inMemoryType.isString)
-        output += getDecodeStringForString(isStructureMember, defaultEnabled);
-    else if(inMemoryType.isStruct)
-        output += getDecodeStringForStructure(isStructureMember);
-    else
-        output += getDecodeStringForField(isStructureMember, defaultEnabled);
+    // Bitfields are never variable, and null fields are not encoded
+    if(encodedType.isNull || encodedType.isBitfield)
+        return output.take();
 
-    return output;
-}
+    if(inMemoryType.isString)
+    {
+        // Fixed strings are always the full array, the encode ignores dependsOn for strings
+        if(inMemoryType.isFixedString)
+            return output.take();
 
+        std::string constantstring = getConstantString();
 
-//! True if this encodable has verification data
-bool ProtocolField::hasVerify(void) const
-{
-    if(inMemoryType.isStruct)
-    {
-        const ProtocolStructure* struc = parser->lookUpStructure(typeName);
-        if(struc)
-            return struc->hasVerify();
+        // The scan is limited to one byte past the data, so a string which is not terminated within the data overruns it
+        if(skip)
+            output.append(spacing, "stringSkipBytes(_pg_data, &_pg_byteindex, ", array, " < (_pg_numbytes - _pg_byteindex + 1) ? ", array, " : (_pg_numbytes - _pg_byteindex + 1), 0);\n");
+        else if(constantstring.empty())
+            output.append(spacing, "_pg_byteindex += stringEncodedLength(", getEncodeFieldAccess(isStructureMember), ", ", array, ", 0);\n");
         else
-            return false;
+            output.append(spacing, "_pg_byteindex += stringEncodedLength(", constantstring, ", ", array, ", 0);\n");
+
+        return output.take();
     }
-    else
+
+    if(encodedType.isVarint)
     {
-        if(verifyMaxString.empty() && verifyMinString.empty())
-            return false;
-        else
-            return true;
-    }
+        if(!dependsOn.empty())
+        {
+            output.append(spacing, getEncodeDependsOnCondition(isStructureMember), "\n");
+            output.append(spacing, "{\n");
+            spacing += TAB_IN;
+        }
 
-}// ProtocolField::hasVerify
+        // Each element is sized by its value
+        output.append(getEncodeArrayIterationCode(spacing, isStructureMember));
 
+        if(isArray())
+        {
+            spacing += TAB_IN;
+            if(is2dArray())
+                spacing += TAB_IN;
+        }
 
-//! True if this encodable has initialization data
-bool ProtocolField::hasInit(void) const
-{
-    if(inMemoryType.isStruct)
-    {
-        const ProtocolStructure* struc = parser->lookUpStructure(typeName);
-        if(struc)
-            return struc->hasInit();
+        if(skip)
+            output.append(getSkipValueString(spacing));
         else
-            return false;
+            output.append(spacing, "_pg_byteindex += var", encodedType.toSigString(), "EncodedLength(", getVarintArgument(isStructureMember), ");\n");
+
+        if(!dependsOn.empty())
+            output.append(TAB_IN, "}\n");
+
+        return output.take();
     }
-    else
+
+    if(encodedType.isPacked)
     {
-        if(initialValueString.empty())
-            return false;
-        else
-            return true;
-    }
+        // Fixed size, and always present
+        if(variableArray.empty() && variable2dArray.empty() && dependsOn.empty())
+            return output.take();
 
-}// ProtocolField::hasInit
+        if(!dependsOn.empty())
+        {
+            output.append(spacing, getEncodeDependsOnCondition(isStructureMember), "\n");
+            output.append(spacing, "{\n");
+            spacing += TAB_IN;
+        }
 
+        // Packed bits are rounded up to whole bytes
+        output.append(spacing, "_pg_byteindex += (int)(((", getEncodedArrayCount(isStructureMember), ")*", std::to_string(encodedType.bits), " + 7)/8);\n");
 
-/*!
- * Get the string used for verifying this field. If there is no verification data the string will be empty.
- * \return the string used for verifying this field, which may be blank
- */
-std::string ProtocolField::getVerifyString(void) const
-{
-    if(!hasVerify())
-        return std::string();
+        if(!dependsOn.empty())
+            output.append(TAB_IN, "}\n");
 
-    // No verify for null or string
-    if(inMemoryType.isNull || inMemoryType.isString)
-        return std::string();
+        return output.take();
+    }
 
-    std::string access;
-    std::string spacing = TAB_IN;
-    std::string arrayspacing;
-    std::string output;
+    std::string length;
 
-    if(!comment.empty())
-        output += spacing + "// " + comment + "\n";
+    if(inMemoryType.isStruct)
+    {
+        const ProtocolStructure* struc = parser->lookUpStructure(typeName);
 
-    output += getEncodeArrayIterationCode(spacing, true);
+        // A structure whose size varies must be asked for the size of each element
+        if((struc == nullptr) || !struc->hasFixedEncodedLength(&length))
+            length.clear();
+    }
+    else
+        length = std::to_string(encodedType.bits / 8);
 
-    if(inMemoryType.isStruct)
+    // Fixed size, and always present
+    if(!length.empty() && variableArray.empty() && variable2dArray.empty() && dependsOn.empty())
+        return output.take();
+
+    if(!dependsOn.empty())
     {
-        if(support.language == ProtocolSupport::c_language)
-            access = "&_pg_user->" + name;
+        output.append(spacing, getEncodeDependsOnCondition(isStructureMember), "\n");
+        output.append(spacing, "{\n");
+        spacing += TAB_IN;
+    }
+
+    if(!length.empty())
+    {
+        if(isArray())
+            output.append(spacing, "_pg_byteindex += (int)(", getEncodedArrayCount(isStructureMember), ")*(", length, ");\n");
         else
-            access = name;  // in this case, name is already pointer, so we don't need "&"
+            output.append(spacing, "_pg_byteindex += ", length, ";\n");
+    }
+    else
+    {
+        // Each element of the structure array is asked for its size
+        output.append(getEncodeArrayIterationCode(spacing, isStructureMember));
 
         if(isArray())
         {
-            arrayspacing += TAB_IN;
-
-            if(support.language == ProtocolSupport::c_language)
-                access = "&_pg_user->" + name + "[_pg_i]";
-            else
-                access = name + "[_pg_i]";
-
-            // Handle 2D array
+            spacing += TAB_IN;
             if(is2dArray())
-            {
-                access += "[_pg_j]";
-                arrayspacing += TAB_IN;
-            }
+                spacing += TAB_IN;
         }
 
-        // This calls the verify function
-        if(support.language == ProtocolSupport::c_language)
+        std::string access = getEncodeFieldAccess(isStructureMember);
+        const ProtocolStructure* struc = parser->lookUpStructure(typeName);
+
+        if(skip)
+            output.append(getSkipValueString(spacing));
+        else if(support.language == ProtocolSupport::c_language)
         {
-            output += spacing + arrayspacing + "if(!verify" + typeName + "(" + access + "))\n";
-            output += spacing + arrayspacing + TAB_IN + "_pg_good = 0;\n";
+            if((struc != nullptr) && (struc->getNumberOfEncodeParameters() == 0))
+                output.append(spacing, "_pg_byteindex += getEncodedSizeOf", typeName, "();\n");
+            else
+                output.append(spacing, "_pg_byteindex += getEncodedSizeOf", typeName, "(", access, ");\n");
         }
         else
         {
-            output += spacing + arrayspacing + "if(!" + access + ".verify())\n";
-            output += spacing + arrayspacing + TAB_IN + "_pg_good = false;\n";
+            // Redefined structures encode differently, so they are sized differently, see getEncodeStringForStructure()
+            if((struc != nullptr) && (typeName != struc->getStructName()))
+            {
+                if(isStructureMember || isArray())
+                    output.append(spacing, "_pg_byteindex += (static_cast<const ", typeName, "*>(&", access, "))->encodedSize();\n");
+                else
+                    output.append(spacing, "_pg_byteindex += (static_cast<const ", typeName, "*>(", access, "))->encodedSize();\n");
+            }
+            else if(isStructureMember || isArray())
+                output.append(spacing, "_pg_byteindex += ", access, ".encodedSize();\n");
+            else
+                output.append(spacing, "_pg_byteindex += ", access, "->encodedSize();\n");
         }
+    }
 
-    }// if struct being verified
+    if(!dependsOn.empty())
+        output.append(TAB_IN, "}\n");
+
+    return output.take();
+
+}// ProtocolField::getLengthString
+
+
+/*!
+ * Get the line(s) of source code needed to skip one value of this field in
+ * "_pg_data", which is a variable length integer or a structure whose size
+ * varies. The skip is limited by "_pg_numbytes".
+ * \param spacing is the spacing that begins each line.
+ * \return The string to add to the source file.
+ */
+std::string ProtocolField::getSkipValueString(const std::string& spacing) const
+{
+    CodeEmitter output;
+
+    if(encodedType.isVarint)
+    {
+        // The scan is limited to one byte past the data, like the string scan
+        std::string maxbytes = std::to_string((encodedType.bits + 6) / 7);
+        output.append(spacing, "varintSkipBytes(_pg_data, &_pg_byteindex, ", maxbytes, " < (_pg_numbytes - _pg_byteindex + 1) ? ", maxbytes, " : (_pg_numbytes - _pg_byteindex + 1));\n");
+    }
     else
     {
-        std::string failedvalue = "false";
-        if(support.language == ProtocolSupport::c_language)
-            failedvalue = "0";
-
+        // The structure checks its own size against the data
         if(support.language == ProtocolSupport::c_language)
-            access = "_pg_user->" + name;
+            output.append(spacing, "if(skip", typeName, "(_pg_data, &_pg_byteindex, _pg_numbytes) == 0)\n");
         else
-            access = name;
+            output.append(spacing, "if(!", typeName, "::skip(_pg_data, &_pg_byteindex, _pg_numbytes))\n");
 
-        if(isArray())
-        {
-            arrayspacing += TAB_IN;
+        output.append(spacing, TAB_IN, "return ", getReturnCode(false), ";\n");
+    }
 
-            if(support.language == ProtocolSupport::c_language)
-                access = "_pg_user->" + name + "[_pg_i]";
-            else
-                access = name + "[_pg_i]";
+    return output.take();
 
-            // Handle 2D array
-            if(is2dArray())
-            {
-                access += "[_pg_j]";
-                arrayspacing += TAB_IN;
-            }
-        }
+}// ProtocolField::getSkipValueString
 
-        if(!verifyMinString.empty())
+
+/*!
+ * Determine if the array elements of this field can be decoded one at a time,
+ * each as a step of a resumable decoder, so that the decoder only needs to
+ * keep the bytes of one element. Strings are decoded whole, packed bits do
+ * not start on a byte boundary, and defaults need the whole field to tell if
+ * it is present.
+ * \return true if this field is an array whose elements can be decoded one at a time.
+ */
+bool ProtocolField::isDecodedByElement(void) const
+{
+    if(!isArray() || encodedType.isNull || inMemoryType.isNull || inMemoryType.isString || encodedType.isBitfield || encodedType.isPacked)
+        return false;
+
+    return !isDefault() && !overridesPrevious;
+
+}// ProtocolField::isDecodedByElement
+
+
+/*!
+ * Get the next line(s) of source code needed to decode the array element
+ * "_pg_i" of this field. An element of a 2d array is a row of the second
+ * dimension. The element count and the dependsOn of the field are left to the
+ * caller, which only decodes the elements that are present.
+ * \param isStructureMember should be true if the left hand side is a
+ *        member of a user structure, else the left hand side is a pointer
+ *        to the inMemoryType
+ * \return The string to add to the source file, empty if isDecodedByElement() is false.
+ */
+std::string ProtocolField::getDecodeElementString(bool isStructureMember) const
+{
+    if(!isDecodedByElement())
+        return std::string();
+
+    if(inMemoryType.isStruct)
+        return getDecodeStringForStructure(isStructureMember, true);
+
+    CodeEmitter output(256);
+    emitDecodeStringForField(output, isStructureMember, false, true);
+    return output.take();
+
+}// ProtocolField::getDecodeElementString
+
+
+/*!
+ * Get the next line(s) of source code needed to skip one array element of
+ * this field in "_pg_data", which is limited by "_pg_numbytes".
+ * \param isStructureMember should be true if variable array limits are members of a structure
+ * \return The string to add to the source file, which is empty if every
+ *         element has the same encoded size.
+ */
+std::string ProtocolField::getSkipElementString(bool isStructureMember) const
+{
+    CodeEmitter output;
+    std::string spacing = TAB_IN;
+    std::string length;
+
+    if(!isDecodedByElement())
+        return output.take();
+
+    if(inMemoryType.isStruct)
+    {
+        const ProtocolStructure* struc = parser->lookUpStructure(typeName);
+
+        // A structure whose size varies must be asked for the size of each element
+        if((struc == nullptr) || !struc->hasFixedEncodedLength(&length))
+            length.clear();
+    }
+    else if(!encodedType.isVarint)
+        length = std::to_string(encodedType.bits / 8);
+
+    // Every element has the same size
+    if(!length.empty() && variable2dArray.empty())
+        return output.take();
+
+    // An element of a 2d array is a row of the second dimension
+    output.append(getEncodeElementIterationCode(spacing, isStructureMember));
+
+    if(is2dArray())
+        spacing += TAB_IN;
+
+    if(length.empty())
+        output.append(getSkipValueString(spacing));
+    else
+        output.append(spacing, "_pg_byteindex += ", length, ";\n");
+
+    return output.take();
+
+}// ProtocolField::getSkipElementString
+
+
+/*!
+ * Get the declaration of a local variable that holds this field, used in the
+ * C++ language where fields are accessed by their bare names.
+ * \return the declaration, with a line feed, or an empty string if this field
+ *         is not a primitive in memory.
+ */
+std::string ProtocolField::getLocalDeclaration(void) const
+{
+    if(isNotInMemory() || isArray() || !isPrimitive())
+        return std::string();
+
+    if(inMemoryType.isEnum)
+        return TAB_IN + typeName + " " + name + " = (" + typeName + ")0;\n";
+    else
+        return TAB_IN + typeName + " " + name + " = 0;\n";
+
+}// ProtocolField::getLocalDeclaration
+
+
+/*!
+ * Get the next lines(s) of source coded needed to decode this field
+ * \param bitcount points to the running count of bits in a bitfields and should persist between calls
+ * \param isStructureMember should be true if the left hand side is a
+ *        member of a user structure, else the left hand side is a pointer
+ *        to the inMemoryType
+ * \param defaultEnabled should be true to handle defaults
+ * \return The string to add to the source file that encodes this field.
+ */
+std::string ProtocolField::getDecodeString(int* bitcount, bool isStructureMember, bool defaultEnabled) const
+{
+    CodeEmitter output(256);
+    emitDecodeString(output, bitcount, isStructureMember, defaultEnabled);
+    return output.take();
+}
+
+
+/*!
+ * Output the next lines(s) of source coded needed to decode this field
+ * \param output receives the source code that decodes this field.
+ * \param bitcount points to the running count of bits in a bitfields and should persist between calls
+ * \param isStructureMember should be true if the left hand side is a
+ *        member of a user structure, else the left hand side is a pointer
+ *        to the inMemoryType
+ * \param defaultEnabled should be true to handle defaults
+ */
+void ProtocolField::emitDecodeString(CodeEmitter& output, int* bitcount, bool isStructureMember, bool defaultEnabled) const
+{
+    if(encodedType.isBitfield)
+        output.append(getDecodeStringForBitfield(bitcount, isStructureMember, defaultEnabled));
+    else if(inMemoryType.isString)
+        output.append(getDecodeStringForString(isStructureMember, defaultEnabled));
+    else if(inMemoryType.isStruct)
+        output.append(getDecodeStringForStructure(isStructureMember, false));
+    else
+        emitDecodeStringForField(output, isStructureMember, defaultEnabled, false);
+}
+
+
+//! True if this encodable has verification data
+bool ProtocolField::hasVerify(void) const
+{
+    if(inMemoryType.isStruct)
+    {
+        const ProtocolStructure* struc = parser->lookUpStructure(typeName);
+        if(struc)
+            return struc->hasVerify();
+        else
+            return false;
+    }
+    else
+    {
+        if(verifyMaxString.empty() && verifyMinString.empty())
+            return false;
+        else
+            return true;
+    }
+
+}// ProtocolField::hasVerify
+
+
+//! True if this encodable has initialization data
+bool ProtocolField::hasInit(void) const
+{
+    if(inMemoryType.isStruct)
+    {
+        const ProtocolStructure* struc = parser->lookUpStructure(typeName);
+        if(struc)
+            return struc->hasInit();
+        else
+            return false;
+    }
+    else
+    {
+        if(initialValueString.empty())
+            return false;
+        else
+            return true;
+    }
+
+}// ProtocolField::hasInit
+
+
+/*!
+ * Get the string used for verifying this field. If there is no verification data the string will be empty.
+ * \return the string used for verifying this field, which may be blank
+ */
+std::string ProtocolField::getVerifyString(void) const
+{
+    if(!hasVerify())
+        return std::string();
+
+    // No verify for null or string
+    if(inMemoryType.isNull || inMemoryType.isString)
+        return std::string();
+
+    std::string access;
+    std::string spacing = TAB_IN;
+    std::string arrayspacing;
+    std::string output;
+
+    if(!comment.empty())
+        output += spacing + "// " + comment + "\n";
+
+    output += getEncodeArrayIterationCode(spacing, true);
+
+    if(inMemoryType.isStruct)
+    {
+        if(support.language == ProtocolSupport::c_language)
+            access = "&_pg_user->" + name;
+        else
+            access = name;  // in this case, name is already pointer, so we don't need "&"
+
+        if(isArray())
+        {
+            arrayspacing += TAB_IN;
+
+            if(support.language == ProtocolSupport::c_language)
+                access = "&_pg_user->" + name + "[_pg_i]";
+            else
+                access = name + "[_pg_i]";
+
+            // Handle 2D array
+            if(is2dArray())
+            {
+                access += "[_pg_j]";
+                arrayspacing += TAB_IN;
+            }
+        }
+
+        // This calls the verify function
+        if(support.language == ProtocolSupport::c_language)
+        {
+            output += spacing + arrayspacing + "if(!verify" + typeName + "(" + access + "))\n";
+            output += spacing + arrayspacing + TAB_IN + "_pg_good = 0;\n";
+        }
+        else
+        {
+            output += spacing + arrayspacing + "if(!" + access + ".verify())\n";
+            output += spacing + arrayspacing + TAB_IN + "_pg_good = false;\n";
+        }
+
+    }// if struct being verified
+    else
+    {
+        std::string failedvalue = "false";
+        if(support.language == ProtocolSupport::c_language)
+            failedvalue = "0";
+
+        if(support.language == ProtocolSupport::c_language)
+            access = "_pg_user->" + name;
+        else
+            access = name;
+
+        if(isArray())
+        {
+            arrayspacing += TAB_IN;
+
+            if(support.language == ProtocolSupport::c_language)
+                access = "_pg_user->" + name + "[_pg_i]";
+            else
+                access = name + "[_pg_i]";
+
+            // Handle 2D array
+            if(is2dArray())
+            {
+                access += "[_pg_j]";
+                arrayspacing += TAB_IN;
+            }
+        }
+
+        if(!verifyMinString.empty())
         {
             output += spacing + arrayspacing + "if(" + access + " < " + inMemoryType.applyTypeToConstant(verifyMinString) + ")\n";
             output += spacing + arrayspacing + "{\n";
@@ -2932,7 +3425,198 @@ std::string ProtocolField::getComparisonString(void) const
 
 
 /*!
- * Get the string used for text printing this field.
+ * Get the string used for testing this field for equality. The test returns
+ * false on the first difference, and agrees with the comparison report: two
+ * structures are equal if their comparison report would be empty.
+ * \return the string used to test this field, which may be empty
+ */
+std::string ProtocolField::getEqualsString(void) const
+{
+    CodeEmitter output;
+
+    // No comparison if nothing is in memory or if not encoded. A field which
+    // overrides a previous field refers to the same memory, already compared.
+    if(inMemoryType.isNull || encodedType.isNull || overridesPrevious)
+        return output.take();
+
+    std::string access1, access2, variable1, variable2d1;
+    if(support.language == ProtocolSupport::c_language)
+    {
+        access1 = "_pg_user1->" + name;
+        access2 = "_pg_user2->" + name;
+        variable1 = "_pg_user1->" + variableArray;
+        variable2d1 = "_pg_user1->" + variable2dArray;
+    }
+    else
+    {
+        access1 = name;
+        access2 = "_pg_user->" + name;
+        variable1 = variableArray;
+        variable2d1 = variable2dArray;
+    }
+
+    if(inMemoryType.isString)
+    {
+        output.append(TAB_IN, "if(strncmp(", access1, ", ", access2, ", ", array, ") != 0)\n");
+        output.append(TAB_IN, TAB_IN, "return false;\n");
+        return output.take();
+    }
+
+    if(!isArray())
+    {
+        if(inMemoryType.isStruct)
+        {
+            if(support.language == ProtocolSupport::c_language)
+                output.append(TAB_IN, "if(!equals", typeName, "(&", access1, ", &", access2, "))\n");
+            else
+                output.append(TAB_IN, "if(!", access1, ".equals(&", access2, "))\n");
+        }
+        else
+            output.append(TAB_IN, "if(", access1, " != ", access2, ")\n");
+
+        output.append(TAB_IN, TAB_IN, "return false;\n");
+        return output.take();
+    }
+
+    // Variable array lengths are fields of the structure which are tested on
+    // their own, so the lengths from _pg_user1 can be used for both
+
+    // Arrays of integers are contiguous, and can be compared as memory.
+    // Floating point cannot, because the comparison report uses the floating
+    // point rules for zero and NaN
+    if(!inMemoryType.isStruct && !inMemoryType.isFloat && (variable2dArray.empty()))
+    {
+        if(variableArray.empty())
+            output.append(TAB_IN, "if(memcmp(", access1, ", ", access2, ", sizeof(", access1, ")) != 0)\n");
+        else
+        {
+            std::string count = "(((unsigned)" + variable1 + " < (unsigned)(" + array + ")) ? (unsigned)" + variable1 + " : (unsigned)(" + array + "))";
+            output.append(TAB_IN, "if(memcmp(", access1, ", ", access2, ", ", count, "*sizeof(", access1, "[0])) != 0)\n");
+        }
+
+        output.append(TAB_IN, TAB_IN, "return false;\n");
+        return output.take();
+    }
+
+    std::string spacing = TAB_IN;
+
+    if(variableArray.empty())
+        output.append(spacing, "for(_pg_i = 0; _pg_i < ", array, "; _pg_i++)\n");
+    else
+        output.append(spacing, "for(_pg_i = 0; (_pg_i < ", array, ") && (_pg_i < (unsigned)", variable1, "); _pg_i++)\n");
+
+    spacing += TAB_IN;
+    access1 += "[_pg_i]";
+    access2 += "[_pg_i]";
+
+    if(is2dArray())
+    {
+        if(variable2dArray.empty())
+            output.append(spacing, "for(_pg_j = 0; _pg_j < ", array2d, "; _pg_j++)\n");
+        else
+            output.append(spacing, "for(_pg_j = 0; (_pg_j < ", array2d, ") && (_pg_j < (unsigned)", variable2d1, "); _pg_j++)\n");
+
+        spacing += TAB_IN;
+        access1 += "[_pg_j]";
+        access2 += "[_pg_j]";
+    }
+
+    if(inMemoryType.isStruct)
+    {
+        if(support.language == ProtocolSupport::c_language)
+            output.append(spacing, "if(!equals", typeName, "(&", access1, ", &", access2, "))\n");
+        else
+            output.append(spacing, "if(!", access1, ".equals(&", access2, "))\n");
+    }
+    else
+        output.append(spacing, "if(", access1, " != ", access2, ")\n");
+
+    output.append(spacing, TAB_IN, "return false;\n");
+
+    return output.take();
+
+}// ProtocolField::getEqualsString
+
+
+/*!
+ * Get the string used for combining this field into a hash. Like the encode,
+ * variable length arrays are limited by their length, and a field that depends
+ * on another field is only hashed if it is present. Fields which are equal
+ * according to getEqualsString() always hash the same.
+ * \return the string used to hash this field, which may be empty
+ */
+std::string ProtocolField::getHashString(void) const
+{
+    CodeEmitter output;
+    std::string spacing = TAB_IN;
+
+    // No hash if nothing is in memory or if not encoded. A field which
+    // overrides a previous field refers to the same memory, already hashed.
+    if(inMemoryType.isNull || encodedType.isNull || overridesPrevious)
+        return output.take();
+
+    // The field itself, without any array access
+    std::string field = name;
+    if(support.language == ProtocolSupport::c_language)
+        field = "_pg_user->" + name;
+
+    // Strings cannot use dependsOn
+    if(inMemoryType.isString)
+    {
+        output.append(spacing, "_pg_hash = mixHashString(_pg_hash, ", field, ", ", array, ");\n");
+        return output.take();
+    }
+
+    if(!dependsOn.empty())
+    {
+        output.append(spacing, getEncodeDependsOnCondition(true), "\n");
+        output.append(spacing, "{\n");
+        spacing += TAB_IN;
+    }
+
+    if(isArray() && !is2dArray() && !inMemoryType.isStruct && !inMemoryType.isFloat && !inMemoryType.isBool && !inMemoryType.isEnum && (inMemoryType.bits == 8))
+    {
+        // Arrays of bytes are hashed as a block
+        output.append(spacing, "_pg_hash = mixHashBytes(_pg_hash, (const uint8_t*)", field, ", ", getEncodedArrayCount(true), ");\n");
+    }
+    else
+    {
+        output.append(getEncodeArrayIterationCode(spacing, true));
+
+        if(isArray())
+        {
+            spacing += TAB_IN;
+            if(is2dArray())
+                spacing += TAB_IN;
+        }
+
+        std::string access = getEncodeFieldAccess(true);
+
+        if(inMemoryType.isStruct)
+        {
+            if(support.language == ProtocolSupport::c_language)
+                output.append(spacing, "_pg_hash = mixHash(_pg_hash, hash", typeName, "(", access, "));\n");
+            else
+                output.append(spacing, "_pg_hash = mixHash(_pg_hash, ", access, ".hash());\n");
+        }
+        else if(inMemoryType.isFloat)
+            output.append(spacing, "_pg_hash = mixHashFloat(_pg_hash, ", access, ");\n");
+        else
+            output.append(spacing, "_pg_hash = mixHash(_pg_hash, (uint64_t)", access, ");\n");
+    }
+
+    if(!dependsOn.empty())
+        output.append(TAB_IN, "}\n");
+
+    return output.take();
+
+}// ProtocolField::getHashString
+
+
+/*!
+ * Get the string used for text printing this field. The text is appended to
+ * the report, and sub-structures extend the prename in place, so that no
+ * temporary strings are made.
  * \return the string used to print this field as text, which may be empty
  */
 std::string ProtocolField::getTextPrintString(void) const
@@ -2945,22 +3629,44 @@ std::string ProtocolField::getTextPrintString(void) const
 
     if(inMemoryType.isString)
     {
-        output += TAB_IN + "_pg_report += _pg_prename + \":" + name + " '\" + std::string(" + getEncodeFieldAccess(true) + ") + \"'\\n\";\n";
+        output += TAB_IN + "_pg_report.append(_pg_prename).append(\":" + name + " '\").append(" + getEncodeFieldAccess(true) + ").append(\"'\\n\");\n";
     }
     else
     {
         std::string spacing = TAB_IN;
 
         output += getEncodeArrayIterationCode(spacing, true);
+
         if(isArray())
         {
             spacing += TAB_IN;
             if(is2dArray())
                 spacing += TAB_IN;
+
+            output += spacing.substr(TAB_IN.size()) + "{\n";
         }
 
         if(inMemoryType.isStruct)
         {
+            // The structure name, and array indices, are added to the prename for the structure print
+            output += spacing + "_pg_prename.append(\":" + name;
+
+            if(isArray())
+            {
+                output += "[\");\n";
+                output += spacing + "appendUnsigned(_pg_prename, _pg_i);\n";
+
+                if(is2dArray())
+                {
+                    output += spacing + "_pg_prename.append(\"][\");\n";
+                    output += spacing + "appendUnsigned(_pg_prename, _pg_j);\n";
+                }
+
+                output += spacing + "_pg_prename.append(\"]\");\n";
+            }
+            else
+                output += "\");\n";
+
             if(support.language == ProtocolSupport::c_language)
             {
                 // In case of a structure redefines
@@ -2969,46 +3675,55 @@ std::string ProtocolField::getTextPrintString(void) const
                 if(mystruct != nullptr)
                     signame = mystruct->getStructName();
 
-                output += spacing + "_pg_report += textPrint" + signame + "(_pg_prename + \":" + name + "\"";
+                output += spacing + "textPrint" + signame + "(_pg_report, _pg_prename, " + getEncodeFieldAccess(true) + ");\n";
             }
             else
-                output += spacing + "_pg_report += " + getEncodeFieldAccess(true) + ".textPrint(_pg_prename + \":" + name + "\"";
-
-            if(isArray())
-                output += " + \"[\" + std::to_string(_pg_i) + \"]\"";
-
-            if(is2dArray())
-                output += " + \"[\" + std::to_string(_pg_j) + \"]\"";
+                output += spacing + getEncodeFieldAccess(true) + ".textPrint(_pg_report, _pg_prename);\n";
 
-            if(support.language == ProtocolSupport::c_language)
-                output += ", " + getEncodeFieldAccess(true);
-
-            output += ");\n";
+            output += spacing + "_pg_prename.resize(_pg_length);\n";
         }
         else
         {
             // The _pg_report includes the _pg_prename and the name
-            output += spacing + "_pg_report += _pg_prename + \":" + name + "\"";
+            output += spacing + "_pg_report.append(_pg_prename).append(\":" + name;
 
             // The _pg_report needs to include the array indices
             if(isArray())
-                output += " + \"[\" + std::to_string(_pg_i) + \"]\"";
+            {
+                output += "[\");\n";
+                output += spacing + "appendUnsigned(_pg_report, _pg_i);\n";
 
-            if(is2dArray())
-                output += " + \"[\" + std::to_string(_pg_j) + \"]\"";
+                if(is2dArray())
+                {
+                    output += spacing + "_pg_report.append(\"][\");\n";
+                    output += spacing + "appendUnsigned(_pg_report, _pg_j);\n";
+                }
+
+                output += spacing + "_pg_report.append(\"] '\");\n";
+            }
+            else
+                output += " '\");\n";
 
-            // And finally the values go into the _pg_report
+            // And finally the values go into the _pg_report, with enough precision to read them back
             if(!printScalerString.empty())
-                output += " + \" '\" +  to_formatted_string(" + getEncodeFieldAccess(true) + printScalerString + ", 16) + \"'\\n\";\n";
+                output += spacing + "appendDouble(_pg_report, " + getEncodeFieldAccess(true) + printScalerString + ", 16);\n";
             else if(inMemoryType.isFloat && (inMemoryType.bits > 32))
-                output += " + \" '\" +  to_formatted_string(" + getEncodeFieldAccess(true) + ", 16) + \"'\\n\";\n";
+                output += spacing + "appendDouble(_pg_report, " + getEncodeFieldAccess(true) + ", 16);\n";
             else if(inMemoryType.isFloat)
-                output += " + \" '\" +  to_formatted_string(" + getEncodeFieldAccess(true) + ", 7) + \"'\\n\";\n";
+                output += spacing + "appendDouble(_pg_report, " + getEncodeFieldAccess(true) + ", 7);\n";
+            else if(inMemoryType.isSigned)
+                output += spacing + "appendSigned(_pg_report, (long long)" + getEncodeFieldAccess(true) + ");\n";
             else
-                output += " + \" '\" + std::to_string(" + getEncodeFieldAccess(true) + ") + \"'\\n\";\n";
+                output += spacing + "appendUnsigned(_pg_report, (unsigned long long)" + getEncodeFieldAccess(true) + ");\n";
+
+            output += spacing + "_pg_report.append(\"'\\n\");\n";
 
         }// else not a struct
 
+        // Close the block under the for loop(s)
+        if(isArray())
+            output += spacing.substr(TAB_IN.size()) + "}\n";
+
     }// else numeric output
 
     return output;
@@ -3017,7 +3732,75 @@ std::string ProtocolField::getTextPrintString(void) const
 
 
 /*!
- * Get the string used for text reading this field.
+ * Get the estimated number of characters text printed for this field, which
+ * is used to reserve the report before it is printed.
+ * \param lines is incremented by the number of lines printed, each of which
+ *        also includes the prename.
+ * \return the number of characters printed, not counting the prename
+ */
+int ProtocolField::getTextPrintLength(int* lines) const
+{
+    int length;
+    int count = 1;
+
+    // No print if nothing is in memory or if not encoded
+    if(inMemoryType.isNull || encodedType.isNull)
+        return 0;
+
+    if(inMemoryType.isString)
+    {
+        bool ok = false;
+        double number = ShuntingYard::computeInfix(parser->replaceEnumerationNameWithValue(array), &ok);
+
+        (*lines)++;
+
+        // The name, the separators, and the string
+        if(ok && (number > 0))
+            return (int)name.size() + 5 + (int)number;
+        else
+            return (int)name.size() + 5 + 16;
+    }
+
+    count = getMaximumArrayCount();
+
+    // Each line has the name, the array indices, and the separators
+    length = (int)name.size() + 5;
+    if(isArray())
+        length += 4;
+    if(is2dArray())
+        length += 4;
+
+    if(inMemoryType.isStruct)
+    {
+        int sublines = 0;
+        int sublength = 0;
+
+        const ProtocolStructure* mystruct = parser->lookUpStructure(typeName);
+        if(mystruct != nullptr)
+            sublength = mystruct->getTextPrintContentsLength(&sublines);
+
+        (*lines) += count*sublines;
+        return count*(sublength + sublines*length);
+    }
+
+    // The printed number, which for floating point has the precision printed
+    if(!printScalerString.empty() || (inMemoryType.isFloat && (inMemoryType.bits > 32)))
+        length += 23;
+    else if(inMemoryType.isFloat)
+        length += 14;
+    else
+        length += (inMemoryType.bits + 2)/3 + 1;
+
+    (*lines) += count;
+    return count*length;
+
+}// ProtocolField::getTextPrintLength
+
+
+/*!
+ * Get the string used for text reading this field. The key of the field is
+ * formed by extending the prename in place, and restoring it afterwards, so
+ * that no temporary strings are made.
  * \return the string used to read this field as text, which may be empty
  */
 std::string ProtocolField::getTextReadString(void) const
@@ -3030,8 +3813,9 @@ std::string ProtocolField::getTextReadString(void) const
 
     if(inMemoryType.isString)
     {
-        // Notice the use of the "pg" copy function, which is just like strncpy but without the security vulnerabilities
-        output += TAB_IN + "pgstrncpy(" + getDecodeFieldAccess(true) + ", extractText(_pg_prename + \":" + name + "\", _pg_source, &_pg_fieldcount).c_str(), " + array + ");\n";
+        output += TAB_IN + "_pg_prename.append(\":" + name + "\");\n";
+        output += TAB_IN + "textToString(extractText(_pg_prename, _pg_index, &_pg_fieldcount), " + getDecodeFieldAccess(true) + ", " + array + ");\n";
+        output += TAB_IN + "_pg_prename.resize(_pg_length);\n";
     }
     else
     {
@@ -3051,6 +3835,25 @@ std::string ProtocolField::getTextReadString(void) const
             spacing += TAB_IN;
         }
 
+        // The name, and array indices, are added to the prename to form the key
+        output += spacing + "_pg_prename.append(\":" + name;
+
+        if(isArray())
+        {
+            output += "[\");\n";
+            output += spacing + "appendUnsigned(_pg_prename, _pg_i);\n";
+
+            if(is2dArray())
+            {
+                output += spacing + "_pg_prename.append(\"][\");\n";
+                output += spacing + "appendUnsigned(_pg_prename, _pg_j);\n";
+            }
+
+            output += spacing + "_pg_prename.append(\"]\");\n";
+        }
+        else
+            output += "\");\n";
+
         if(inMemoryType.isStruct)
         {
             if(support.language == ProtocolSupport::c_language)
@@ -3061,62 +3864,41 @@ std::string ProtocolField::getTextReadString(void) const
                 if(mystruct != nullptr)
                     signame = mystruct->getStructName();
 
-                output += spacing + "_pg_fieldcount += textRead" + signame + "(_pg_prename + \":" + name + "\"";
+                // Structure read, we need to pass the address of the structure, not the object
+                output += spacing + "_pg_fieldcount += textRead" + signame + "(_pg_prename, _pg_index, " + getDecodeFieldAccess(true) + ");\n";
             }
             else
-                output += spacing + "_pg_fieldcount += " + getDecodeFieldAccess(true) + ".textRead(_pg_prename + \":" + name + "\"";
-
-            if(isArray())
-                output += " + \"[\" + std::to_string(_pg_i) + \"]\"";
-
-            if(is2dArray())
-                output += " + \"[\" + std::to_string(_pg_j) + \"]\"";
+                output += spacing + "_pg_fieldcount += " + getDecodeFieldAccess(true) + ".textRead(_pg_prename, _pg_index);\n";
 
-            // Structure read, we need to pass the address of the structure, not the object
-            if(support.language == ProtocolSupport::c_language)
-                output += ", _pg_source, " + getDecodeFieldAccess(true) + ");\n";
-            else
-                output += ", _pg_source);\n";
+            output += spacing + "_pg_prename.resize(_pg_length);\n";
         }
         else
         {
             // First get the text
-            output += spacing + "_pg_text = extractText(_pg_prename + \":" + name + "\"";
+            output += spacing + "_pg_text = extractText(_pg_prename, _pg_index, &_pg_fieldcount);\n";
+            output += spacing + "_pg_prename.resize(_pg_length);\n";
 
-            // The array indices are part of the key text
-            if(isArray())
+            // Convert the text and get a result if the conversion succeeds. Integers are
+            // converted at full width so that enumerations and bitfields take the value
+            if(!readScalerString.empty())
             {
-                output += " + \"[\" + std::to_string(_pg_i) + \"]\"";
-
-                if(is2dArray())
-                    output += " + \"[\" + std::to_string(_pg_j) + \"]\"";
+                output += spacing + "if(textToDouble(_pg_text, &_pg_double))\n";
+                output += spacing + TAB_IN + getDecodeFieldAccess(true) + " = (" + typeName + ")(_pg_double" + readScalerString + ");\n";
             }
-
-            output += ", _pg_source, &_pg_fieldcount);\n";
-
-            // Check the text and get a result if it is not empty
-            output += spacing + "if(!_pg_text.empty())\n";
-
-            // Prefer std::strtox instead of std::stox because the former does not throw and exception and we can tell it to automatically interpret the base
-            if(!readScalerString.empty())
-                output += spacing + TAB_IN + getDecodeFieldAccess(true) + " = (" + typeName + ")(std::strtod(_pg_text.c_str(), 0)" + readScalerString + ");\n";
-            else if(inMemoryType.isFloat && (inMemoryType.bits > 32))
-                output += spacing + TAB_IN + getDecodeFieldAccess(true) + " = std::strtod(_pg_text.c_str(), 0);\n";
             else if(inMemoryType.isFloat)
-                output += spacing + TAB_IN + getDecodeFieldAccess(true) + " = std::strtof(_pg_text.c_str(), 0);\n";
+            {
+                output += spacing + "if(textToDouble(_pg_text, &_pg_double))\n";
+                output += spacing + TAB_IN + getDecodeFieldAccess(true) + " = (" + typeName + ")_pg_double;\n";
+            }
             else if(inMemoryType.isSigned)
             {
-                if(inMemoryType.bits > 32)
-                    output += spacing + TAB_IN + getDecodeFieldAccess(true) + " = (" + typeName + ")(std::strtoll(_pg_text.c_str(), 0, 0));\n";
-                else
-                    output += spacing + TAB_IN + getDecodeFieldAccess(true) + " = (" + typeName + ")(std::strtol(_pg_text.c_str(), 0, 0));\n";
+                output += spacing + "if(textToSigned(_pg_text, &_pg_signed))\n";
+                output += spacing + TAB_IN + getDecodeFieldAccess(true) + " = (" + typeName + ")_pg_signed;\n";
             }
             else
             {
-                if(inMemoryType.bits > 32)
-                    output += spacing + TAB_IN + getDecodeFieldAccess(true) + " = (" + typeName + ")(std::strtoull(_pg_text.c_str(), 0, 0));\n";
-                else
-                    output += spacing + TAB_IN + getDecodeFieldAccess(true) + " = (" + typeName + ")(std::strtoul(_pg_text.c_str(), 0, 0));\n";
+                output += spacing + "if(textToUnsigned(_pg_text, &_pg_unsigned))\n";
+                output += spacing + TAB_IN + getDecodeFieldAccess(true) + " = (" + typeName + ")_pg_unsigned;\n";
             }
 
         }// else not a struct
@@ -3159,8 +3941,62 @@ std::string ProtocolField::getMapEncodeString(void) const
 
     if(inMemoryType.isString)
     {
-        output += TAB_IN + "_pg_map[_pg_prename + \":" + name + "\"] = QString(" + getEncodeFieldAccess(true) + ");\n";
+        if(support.stdMap)
+            output += TAB_IN + "_pg_map.set(_pg_key, \":" + name + "\", std::string(" + getEncodeFieldAccess(true) + "));\n";
+        else
+            output += TAB_IN + "_pg_map[_pg_prename + \":" + name + "\"] = QString(" + getEncodeFieldAccess(true) + ");\n";
     }
+    else if(support.stdMap)
+    {
+        std::string spacing = TAB_IN;
+        std::string indices = getStdMapIndices();
+
+        output += getEncodeArrayIterationCode(spacing, true);
+        if(isArray())
+        {
+            spacing += TAB_IN;
+            if(is2dArray())
+                spacing += TAB_IN;
+        }
+
+        if(inMemoryType.isStruct)
+        {
+            // The brace lines up with the innermost for loop
+            std::string brace = spacing.substr(0, spacing.length() - TAB_IN.length());
+
+            if(isArray())
+                output += brace + "{\n";
+
+            output += spacing + "_pg_length = FieldMap::appendKey(_pg_key, \":" + name + "\"" + indices + ");\n";
+
+            if(support.language == ProtocolSupport::c_language)
+                output += spacing + "mapEncode" + getFunctionStructName() + "(_pg_key, _pg_map, " + getEncodeFieldAccess(true) + ");\n";
+            else
+                output += spacing + getEncodeFieldAccess(true) + ".mapEncode(_pg_key, _pg_map);\n";
+
+            output += spacing + "_pg_key.resize(_pg_length);\n";
+
+            if(isArray())
+                output += brace + "}\n";
+
+        }// data type is a struct
+        else
+        {
+            // Numbers are stored as numbers, in the widest type of their kind
+            std::string value;
+
+            if(inMemoryType.isFloat || !printScalerString.empty())
+                value = "(double)" + getEncodeFieldAccess(true) + printScalerString;
+            else if(inMemoryType.isSigned && !inMemoryType.isBool)
+                value = "(long long)" + getEncodeFieldAccess(true);
+            else
+                value = "(unsigned long long)" + getEncodeFieldAccess(true);
+
+            output += spacing + "_pg_map.set(_pg_key, \":" + name + "\"" + indices + ", " + value + ");\n";
+
+        }// else not a struct
+
+    }// else if numeric output without Qt
     else
     {
         std::string spacing = TAB_IN;
@@ -3253,7 +4089,7 @@ std::string ProtocolField::getMapDecodeString(void) const
     if(!comment.empty())
         output += TAB_IN + "// " + comment + "\n";
 
-    if(inMemoryType.isString)
+    if(inMemoryType.isString && !support.stdMap)
     {
         key = "_pg_prename + \":" + name + "\"";
 
@@ -3262,6 +4098,10 @@ std::string ProtocolField::getMapDecodeString(void) const
         output += TAB_IN + "if (_pg_map.contains(key))\n";
         output += TAB_IN + TAB_IN + "qstrncpy(" + getDecodeFieldAccess(true) + ", _pg_map[key].toString().toLatin1().constData(), " + array + ");\n";
     }
+    else if(inMemoryType.isString && support.stdMap)
+    {
+        output += TAB_IN + "fieldMapToString(_pg_map.find(_pg_key, \":" + name + "\"), " + getDecodeFieldAccess(true) + ", " + array + ");\n";
+    }
     else
     {
         std::string spacing = TAB_IN;
@@ -3280,7 +4120,19 @@ std::string ProtocolField::getMapDecodeString(void) const
             spacing += TAB_IN;
         }
 
-        if(inMemoryType.isStruct)
+        if(inMemoryType.isStruct && support.stdMap)
+        {
+            output += spacing + "_pg_length = FieldMap::appendKey(_pg_key, \":" + name + "\"" + getStdMapIndices() + ");\n";
+
+            if(support.language == ProtocolSupport::c_language)
+                output += spacing + "mapDecode" + getFunctionStructName() + "(_pg_key, _pg_map, " + getDecodeFieldAccess(true) + ");\n";
+            else
+                output += spacing + getDecodeFieldAccess(true) + ".mapDecode(_pg_key, _pg_map);\n";
+
+            output += spacing + "_pg_key.resize(_pg_length);\n";
+
+        }// data type is a struct without Qt
+        else if(inMemoryType.isStruct)
         {
             if(support.language == ProtocolSupport::c_language)
             {
@@ -3295,77 +4147,298 @@ std::string ProtocolField::getMapDecodeString(void) const
             else
                 output += spacing + getDecodeFieldAccess(true) + ".mapDecode(_pg_prename + \":" + name + "\"";
 
-            if(isArray())
-                output += " + \"[\" + QString::number(_pg_i) + \"]\"";
-            if(is2dArray())
-                output += " + \"[\" + QString::number(_pg_j) + \"]\"";
+            if(isArray())
+                output += " + \"[\" + QString::number(_pg_i) + \"]\"";
+            if(is2dArray())
+                output += " + \"[\" + QString::number(_pg_j) + \"]\"";
+
+            if(support.language == ProtocolSupport::c_language)
+                output += ", _pg_map, " + getDecodeFieldAccess(true) + ");\n";
+            else
+                output += ", _pg_map);\n";
+
+        }// data type is a struct
+        else if(support.stdMap)
+        {
+            std::string conversion = "fieldMapToUnsigned";
+            std::string number = "_pg_unsigned";
+
+            if(inMemoryType.isFloat || !printScalerString.empty())
+            {
+                conversion = "fieldMapToDouble";
+                number = "_pg_double";
+            }
+            else if(inMemoryType.isSigned && !inMemoryType.isBool)
+            {
+                conversion = "fieldMapToSigned";
+                number = "_pg_signed";
+            }
+
+            // The field keeps its value if the key is missing, or is not a number
+            output += spacing + "if(" + conversion + "(_pg_map.find(_pg_key, \":" + name + "\"" + getStdMapIndices() + "), &" + number + "))\n";
+            if(inMemoryType.isFloat && !printScalerString.empty())
+                output += spacing + TAB_IN + getDecodeFieldAccess(true) + " = (" + typeName + ")(" + number + readScalerString + ");\n";
+            else
+                output += spacing + TAB_IN + getDecodeFieldAccess(true) + " = (" + typeName + ")" + number + ";\n";
+
+        }// else if not a struct, without Qt
+        else
+        {
+            key = "_pg_prename + \":" + name + "\"";
+
+            if(isArray())
+                key += " + \"[\" + QString::number(_pg_i) + \"]\"";
+            if(is2dArray())
+                key += " + \"[\" + QString::number(_pg_j) + \"]\"";
+
+            output += spacing + "key = " + key + ";\n";
+
+            decode = "_pg_map[key]";
+
+            if(inMemoryType.isFloat || !printScalerString.empty())
+                decode += ".toDouble";
+            else if (inMemoryType.isSigned)
+            {
+                if(inMemoryType.bits > 32)
+                    decode += ".toLongLong";
+                else
+                    decode += ".toInt";
+            }
+            else
+            {
+                if(inMemoryType.bits > 32)
+                    decode += ".toULongLong";
+                else
+                    decode += ".toUInt";
+            }
+
+            /* Generate code to load the data from the map:
+             * 1. Check that the given key exists
+             * 2. Check that the provided value decodes properly (for the given data type)
+             * 3. Load out the value from the map if 1. and 2. pass
+             */
+
+            output += spacing + "if(_pg_map.contains(key))\n";
+            output += spacing + "{\n";
+            output += spacing + TAB_IN + decode + "(&ok);\n";
+            output += spacing + TAB_IN + "if(ok)\n";
+            output += spacing + TAB_IN + TAB_IN + getDecodeFieldAccess(true) + " = (" + typeName + ")" + decode + "()";
+            if(inMemoryType.isFloat && !printScalerString.empty())
+                output += readScalerString;
+            output += ";\n";
+            output += spacing + "}\n";
+
+        }// else not a struct
+
+        // Close the block under the for loop(s)
+        if(isArray())
+        {
+            spacing = spacing.substr(0, spacing.length() - TAB_IN.length());
+            output += spacing + "}\n";
+        }
+
+    }// else numeric output
+
+    return output;
+
+}// ProtocolField::getMapDecodeString
+
+
+/*!
+ * Get the string used for JSON encoding this field, which writes the key and
+ * the value(s) directly into the caller's buffer.
+ * \param first should be true if this is the first field of the object.
+ * \return the string used to encode this field, which may be empty
+ */
+std::string ProtocolField::getJsonEncodeString(bool first) const
+{
+    // No JSON if nothing is in memory or if not encoded, just like print
+    if(inMemoryType.isNull || encodedType.isNull)
+        return std::string();
+
+    CodeEmitter output;
+
+    if(!comment.empty())
+        output.append(TAB_IN, "// ", comment, "\n");
+
+    if(inMemoryType.isString)
+        output.append(TAB_IN, "jsonString(_pg_json, _pg_size, _pg_index, ", getJsonKeyLiteral(first), ", ", getEncodeFieldAccess(true), ", ", array, ");\n");
+    else
+        output.append(getJsonEncodeMemberString(first));
+
+    return output.take();
+
+}// ProtocolField::getJsonEncodeString
+
+
+/*!
+ * Get the string used for JSON decoding this field, which is one branch of
+ * the key comparisons of the structure decode.
+ * \return the string used to decode this field, which may be empty
+ */
+std::string ProtocolField::getJsonDecodeString(void) const
+{
+    // No JSON if nothing is in memory or if not encoded, just like print
+    if(inMemoryType.isNull || encodedType.isNull)
+        return std::string();
+
+    if(!inMemoryType.isString)
+        return getJsonDecodeMemberString();
+
+    CodeEmitter output;
+
+    output.append(TAB_IN, TAB_IN, "else if(_pg_key == \"", name, "\")\n");
+    output.append(TAB_IN, TAB_IN, "{\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "if(!jsonToString(_pg_json, _pg_length, _pg_index, ", getDecodeFieldAccess(true), ", ", array, "))\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, TAB_IN, "return false;\n");
+    output.append(TAB_IN, TAB_IN, "}\n");
+
+    return output.take();
+
+}// ProtocolField::getJsonDecodeString
+
+
+/*!
+ * Get the string used for JSON encoding one value of this field. Numbers are
+ * written with the same scaling as the text print.
+ * \param spacing is the indentation of the code.
+ * \param separator is the string literal (or expression) written before the value.
+ * \return the string used to encode the value
+ */
+std::string ProtocolField::getJsonEncodeValueString(const std::string& spacing, const std::string& separator) const
+{
+    CodeEmitter output;
+    std::string arguments = "(_pg_json, _pg_size, _pg_index, " + separator + ", ";
+    std::string access = getEncodeFieldAccess(true);
+
+    if(inMemoryType.isStruct)
+    {
+        output.append(spacing, "jsonText(_pg_json, _pg_size, _pg_index, ", separator, ");\n");
+
+        if(support.language == ProtocolSupport::c_language)
+            output.append(spacing, "jsonEncode", getFunctionStructName(), "(_pg_json, _pg_size, _pg_index, ", access, ");\n");
+        else
+            output.append(spacing, access, ".jsonEncode(_pg_json, _pg_size, _pg_index);\n");
+    }
+    else if(!printScalerString.empty())
+        output.append(spacing, "jsonDouble", arguments, "(double)", access, printScalerString, ");\n");
+    else if(inMemoryType.isFloat && (inMemoryType.bits > 32))
+        output.append(spacing, "jsonDouble", arguments, access, ");\n");
+    else if(inMemoryType.isFloat)
+        output.append(spacing, "jsonFloat", arguments, access, ");\n");
+    else if(inMemoryType.isBool)
+        output.append(spacing, "jsonBool", arguments, "(", access, ") != 0);\n");
+    else if(inMemoryType.isSigned)
+        output.append(spacing, "jsonSigned", arguments, "(long long)", access, ");\n");
+    else
+        output.append(spacing, "jsonUnsigned", arguments, "(unsigned long long)", access, ");\n");
+
+    return output.take();
+
+}// ProtocolField::getJsonEncodeValueString
+
+
+/*!
+ * Get the string used for JSON decoding one value of this field. Numbers are
+ * read with the same scaling as the text read.
+ * \param spacing is the indentation of the code.
+ * \param condition determines if the value is stored, empty to always store it.
+ * \return the string used to decode the value
+ */
+std::string ProtocolField::getJsonDecodeValueString(const std::string& spacing, const std::string& condition) const
+{
+    CodeEmitter output;
+    std::string access = getDecodeFieldAccess(true);
+    std::string number;
+
+    if(inMemoryType.isStruct)
+    {
+        std::string call;
+
+        if(support.language == ProtocolSupport::c_language)
+            call = "jsonDecode" + getFunctionStructName() + "(_pg_json, _pg_length, _pg_index, " + access + ")";
+        else
+            call = access + ".jsonDecode(_pg_json, _pg_length, _pg_index)";
+
+        // Structures beyond the end of the array are skipped
+        if(condition.empty())
+            output.append(spacing, "if(!", call, ")\n");
+        else
+            output.append(spacing, "if((", condition, ") ? !", call, " : !jsonSkip(_pg_json, _pg_length, _pg_index))\n");
+
+        output.append(spacing, TAB_IN, "return false;\n");
 
-            if(support.language == ProtocolSupport::c_language)
-                output += ", _pg_map, " + getDecodeFieldAccess(true) + ");\n";
-            else
-                output += ", _pg_map);\n";
+        return output.take();
+    }
 
-        }// data type is a struct
+    // Integers are converted at full width so that enumerations and bitfields take the value
+    if(!readScalerString.empty() || inMemoryType.isFloat)
+    {
+        output.append(spacing, "if(!jsonToDouble(_pg_json, _pg_length, _pg_index, &_pg_double))\n");
+        if(readScalerString.empty())
+            number = "_pg_double";
         else
-        {
-            key = "_pg_prename + \":" + name + "\"";
+            number = "(_pg_double" + readScalerString + ")";
+    }
+    else if(inMemoryType.isSigned)
+    {
+        output.append(spacing, "if(!jsonToSigned(_pg_json, _pg_length, _pg_index, &_pg_signed))\n");
+        number = "_pg_signed";
+    }
+    else
+    {
+        output.append(spacing, "if(!jsonToUnsigned(_pg_json, _pg_length, _pg_index, &_pg_unsigned))\n");
+        number = "_pg_unsigned";
+    }
 
-            if(isArray())
-                key += " + \"[\" + QString::number(_pg_i) + \"]\"";
-            if(is2dArray())
-                key += " + \"[\" + QString::number(_pg_j) + \"]\"";
+    output.append(spacing, TAB_IN, "return false;\n");
 
-            output += spacing + "key = " + key + ";\n";
+    if(condition.empty())
+        output.append(spacing, access, " = (", typeName, ")", number, ";\n");
+    else
+    {
+        output.append(spacing, "if(", condition, ")\n");
+        output.append(spacing, TAB_IN, access, " = (", typeName, ")", number, ";\n");
+    }
 
-            decode = "_pg_map[key]";
+    return output.take();
 
-            if(inMemoryType.isFloat || !printScalerString.empty())
-                decode += ".toDouble";
-            else if (inMemoryType.isSigned)
-            {
-                if(inMemoryType.bits > 32)
-                    decode += ".toLongLong";
-                else
-                    decode += ".toInt";
-            }
-            else
-            {
-                if(inMemoryType.bits > 32)
-                    decode += ".toULongLong";
-                else
-                    decode += ".toUInt";
-            }
+}// ProtocolField::getJsonDecodeValueString
 
-            /* Generate code to load the data from the map:
-             * 1. Check that the given key exists
-             * 2. Check that the provided value decodes properly (for the given data type)
-             * 3. Load out the value from the map if 1. and 2. pass
-             */
 
-            output += spacing + "if(_pg_map.contains(key))\n";
-            output += spacing + "{\n";
-            output += spacing + TAB_IN + decode + "(&ok);\n";
-            output += spacing + TAB_IN + "if(ok)\n";
-            output += spacing + TAB_IN + TAB_IN + getDecodeFieldAccess(true) + " = (" + typeName + ")" + decode + "()";
-            if(inMemoryType.isFloat && !printScalerString.empty())
-                output += readScalerString;
-            output += ";\n";
-            output += spacing + "}\n";
+/*!
+ * Get the array indices passed to the FieldMap functions when the map output
+ * does not use Qt.
+ * \return the indices, including a leading comma, which may be empty
+ */
+std::string ProtocolField::getStdMapIndices(void) const
+{
+    if(is2dArray())
+        return ", _pg_i, _pg_j";
+    else if(isArray())
+        return ", _pg_i";
+    else
+        return std::string();
 
-        }// else not a struct
+}// ProtocolField::getStdMapIndices
 
-        // Close the block under the for loop(s)
-        if(isArray())
-        {
-            spacing = spacing.substr(0, spacing.length() - TAB_IN.length());
-            output += spacing + "}\n";
-        }
 
-    }// else numeric output
+/*!
+ * Get the name of the structure of this field, as used in the names of its
+ * functions, which may be different from the type name if the structure
+ * redefines another structure.
+ * \return the structure name
+ */
+std::string ProtocolField::getFunctionStructName(void) const
+{
+    const ProtocolStructure* mystruct = parser->lookUpStructure(typeName);
 
-    return output;
+    if(mystruct != nullptr)
+        return mystruct->getStructName();
+    else
+        return typeName;
 
-}// ProtocolField::getMapDecodeString
+}// ProtocolField::getFunctionStructName
 
 
 /*!
@@ -3436,78 +4509,181 @@ std::string ProtocolField::getSetInitialValueString(bool isStructureMember) cons
         }
         else
         {
-            // Try the user's value first
-            std::string initial = initialValueString;
+            std::string initial = getCppInitialValue();
+
+            // C++ initializer list
+            if(inMemoryType.isString)
+                output += TAB_IN + name + "(" + initial + "),\n";
+            else if(is2dArray())
+                output += TAB_IN + name + "{{" + initial + "}},\n";
+            else if(isArray())
+                output += TAB_IN + name + "{" + initial + "},\n";
+            else
+                output += TAB_IN + name + "(" + initial + "),\n";
+        }
+    }
+
+    return output;
+
+}// ProtocolField::getSetInitialValueString
 
-            // If there isn't one, use the default value
-            if(initial.empty())
-                initial = defaultString;
 
-            // If there isn't one, use the constant value
-            if(initial.empty())
-                initial = constantString;
+/*!
+ * Get the initial value of this field in the C++ language, which is the
+ * first of the initial value, the default value, the constant value, the
+ * verify minimum value, or zero (respecting the encoded limits).
+ * \return the initial value, strings include their quotes
+ */
+std::string ProtocolField::getCppInitialValue(void) const
+{
+    // Try the user's value first
+    std::string initial = initialValueString;
+
+    // If there isn't one, use the default value
+    if(initial.empty())
+        initial = defaultString;
 
-            // If there isn't one, use the verify min value
-            if(initial.empty())
-                initial = verifyMinString;
+    // If there isn't one, use the constant value
+    if(initial.empty())
+        initial = constantString;
 
-            // In C++ we explicitly initialize all members.
-            if(initial.empty())
+    // If there isn't one, use the verify min value
+    if(initial.empty())
+        initial = verifyMinString;
+
+    // In C++ we explicitly initialize all members.
+    if(initial.empty())
+    {
+        if(!inMemoryType.isString)
+        {
+            if(inMemoryType.isEnum)
             {
-                if(!inMemoryType.isString)
-                {
-                    if(inMemoryType.isEnum)
-                    {
-                        const EnumCreator* creator = parser->lookUpEnumeration(inMemoryType.enumName);
-                        if(creator == nullptr)
-                            initial = "(" + inMemoryType.enumName + ")0";
-                        else
-                            initial = creator->getFirstEnumerationName();
-                    }
-                    else
-                    {
-                        // Zero seems like the best choice, but we can do a
-                        // little better, if for example we have a minimum
-                        // encoded value we should initialize to
-                        // respect those values
-                        if(limitMaxValue < 0)
-                            initial = limitMaxString;
-                        else if(limitMinValue > 0)
-                            initial = limitMinString;
-                        else
-                            initial = "0";
+                const EnumCreator* creator = parser->lookUpEnumeration(inMemoryType.enumName);
+                if(creator == nullptr)
+                    initial = "(" + inMemoryType.enumName + ")0";
+                else
+                    initial = creator->getFirstEnumerationName();
+            }
+            else
+            {
+                // Zero seems like the best choice, but we can do a
+                // little better, if for example we have a minimum
+                // encoded value we should initialize to
+                // respect those values
+                if(limitMaxValue < 0)
+                    initial = limitMaxString;
+                else if(limitMinValue > 0)
+                    initial = limitMinString;
+                else
+                    initial = "0";
 
-                    }// else if we are not an enumeration
+            }// else if we are not an enumeration
 
-                }// If we are not a string
+        }// If we are not a string
 
-            }// If we have no user provided initial value
+    }// If we have no user provided initial value
 
-            initial = inMemoryType.applyTypeToConstant(initial);
+    initial = inMemoryType.applyTypeToConstant(initial);
 
-            // C++ initializer list
-            if(inMemoryType.isString)
+    if(inMemoryType.isString)
+    {
+        // initial is a string literal, so include the quotes. Except for
+        // a special case. If initial ends in "()" then we assume its a
+        // function or macro call
+        if(!endsWith(trimm(initial), "()"))
+            initial = "\"" + initial + "\"";
+    }
+
+    return initial;
+
+}// ProtocolField::getCppInitialValue
+
+
+/*!
+ * Get the code which sets this field to its initial value in the C++
+ * initialize() function. This gives the same result as the constructor of a
+ * class which does not have the noInit attribute.
+ * \return the code to put in the source file
+ */
+std::string ProtocolField::getInitializeString(void) const
+{
+    CodeEmitter output;
+
+    if((support.language != ProtocolSupport::cpp_language) || inMemoryType.isNull || isNotInMemory())
+        return output.take();
+
+    if(inMemoryType.isStruct)
+    {
+        std::string spacing = TAB_IN;
+        std::string access = name;
+
+        // Every element is set, not just those that would be encoded
+        if(isArray())
+        {
+            output.append(spacing, "for(_pg_i = 0; _pg_i < ", array, "; _pg_i++)\n");
+            spacing += TAB_IN;
+            access += "[_pg_i]";
+
+            if(is2dArray())
             {
-                // initial is a string literal, so include the quotes. Except for
-                // a special case. If initial ends in "()" then we assume its a
-                // function or macro call
-                if(!endsWith(trimm(initial), "()"))
-                    initial = "\"" + initial + "\"";
+                output.append(spacing, "for(_pg_j = 0; _pg_j < ", array2d, "; _pg_j++)\n");
+                spacing += TAB_IN;
+                access += "[_pg_j]";
+            }
+        }
 
-                output += TAB_IN + name + "(" + initial + "),\n";
+        if(isNoInit())
+            output.append(spacing, access, ".initialize();\n");
+        else
+            output.append(spacing, access, " = ", typeName, "();\n");
+    }
+    else
+    {
+        std::string initial = getCppInitialValue();
+
+        if(inMemoryType.isString)
+        {
+            output.append(TAB_IN, "strncpy(", name, ", ", initial, ", sizeof(", name, "));\n");
+            output.append(TAB_IN, name, "[sizeof(", name, ") - 1] = 0;\n");
+        }
+        else if(isArray())
+        {
+            // The initializer list of the constructor sets the first element, and zeroes the rest
+            output.append(TAB_IN, "memset(", name, ", 0, sizeof(", name, "));\n");
+
+            if(initial == "0")
+            {
+                // memset() already did it
             }
             else if(is2dArray())
-                output += TAB_IN + name + "{{" + initial + "}},\n";
-            else if(isArray())
-                output += TAB_IN + name + "{" + initial + "},\n";
+                output.append(TAB_IN, name, "[0][0] = ", initial, ";\n");
             else
-                output += TAB_IN + name + "(" + initial + "),\n";
+                output.append(TAB_IN, name, "[0] = ", initial, ";\n");
         }
+        else
+            output.append(TAB_IN, name, " = ", initial, ";\n");
     }
 
-    return output;
+    return output.take();
 
-}// ProtocolField::getSetInitialValueString
+}// ProtocolField::getInitializeString
+
+
+/*!
+ * Determine if this field is a structure whose C++ constructor leaves its
+ * members to be set by the initialize() function
+ * \return true if the structure of this field has the initialize() function
+ */
+bool ProtocolField::isNoInit(void) const
+{
+    if(!inMemoryType.isStruct || isNotInMemory())
+        return false;
+
+    const ProtocolStructureModule* struc = parser->lookUpStructure(typeName);
+
+    return (struc != nullptr) && struc->isNoInit();
+
+}// ProtocolField::isNoInit
 
 
 /*!
@@ -3768,14 +4944,14 @@ std::string ProtocolField::getDBCSignalString(std::string prename, int* bitcount
                             // Min and max values
                             output += " [";
 
-                            if((support.limitonencode == false) || verifyMinString.empty() || (hasVerifyMinValue && (verifyMinValue <= limitMinValue)))
+                            if((limitonencode == false) || verifyMinString.empty() || (hasVerifyMinValue && (verifyMinValue <= limitMinValue)))
                                 output += limitMinStringForComment;
                             else
                                 output += verifyMinString;
 
                             output += "|";
 
-                            if((support.limitonencode == false) || verifyMaxString.empty() || (hasVerifyMaxValue && (verifyMaxValue >= limitMaxValue)))
+                            if((limitonencode == false) || verifyMaxString.empty() || (hasVerifyMaxValue && (verifyMaxValue >= limitMaxValue)))
                                 output += limitMaxStringForComment;
                             else
                                 output += verifyMaxString;
@@ -4188,7 +5364,7 @@ std::string ProtocolField::getLimitedArgument(std::string argument) const
     if(isFloatScaling() || isIntegerScaling() || (encodedType.isFloat && (encodedType.bits < 32)))
     {
         // However the user may want tighter limits
-        if(support.limitonencode && (!verifyMinString.empty() || !verifyMaxString.empty()))
+        if(limitonencode && (!verifyMinString.empty() || !verifyMaxString.empty()))
         {
             bool skipmin = verifyMinString.empty();
             bool skipmax = verifyMaxString.empty();
@@ -4222,7 +5398,7 @@ std::string ProtocolField::getLimitedArgument(std::string argument) const
         bool skipmax = true;
 
         // In this case we don't have the scaling functions, so we may need to apply a limit, even if the user didn't ask for it
-        if(!hasVerifyMaxValue && !verifyMaxString.empty() && support.limitonencode)
+        if(!hasVerifyMaxValue && !verifyMaxString.empty() && limitonencode)
         {
             // In this case we cannot vet the user's verify string, we just have to use it
             maxstring = verifyMaxString;
@@ -4231,7 +5407,7 @@ std::string ProtocolField::getLimitedArgument(std::string argument) const
         }// if we cannot evaluate the verify value
         else
         {
-            if(hasVerifyMaxValue && support.limitonencode && (verifyMaxValue < limitMaxValue))
+            if(hasVerifyMaxValue && limitonencode && (verifyMaxValue < limitMaxValue))
             {
                 maxvalue = verifyMaxValue;
                 maxstring = verifyMaxString;
@@ -4244,7 +5420,7 @@ std::string ProtocolField::getLimitedArgument(std::string argument) const
         }// else if we can evaluate the verify value
 
         // In this case we don't have the scaling functions, so we may need to apply a limit, even if the user didn't ask for it
-        if(!hasVerifyMinValue && !verifyMinString.empty() && support.limitonencode)
+        if(!hasVerifyMinValue && !verifyMinString.empty() && limitonencode)
         {
             // In this case we cannot vet the user's verify string, we just have to use it
             minstring = verifyMinString;
@@ -4253,7 +5429,7 @@ std::string ProtocolField::getLimitedArgument(std::string argument) const
         }// if we cannot evaluate the verify value
         else
         {
-            if(hasVerifyMinValue && support.limitonencode && (verifyMinValue > limitMinValue))
+            if(hasVerifyMinValue && limitonencode && (verifyMinValue > limitMinValue))
             {
                 minvalue = verifyMinValue;
                 minstring = verifyMinString;
@@ -4305,7 +5481,7 @@ std::string ProtocolField::getEncodeStringForBitfield(int* bitcount, bool isStru
 
     // Commenting indicating the range of the field
     if(!inMemoryType.isNull && !inMemoryType.isBool && constantstring.empty() && (encodedType.bits > 1) && !inMemoryType.isEnum)
-        output += TAB_IN + getRangeComment(support.limitonencode);
+        output += TAB_IN + getRangeComment(limitonencode);
 
     if(constantstring.empty())
         argument = getLimitedArgument(getEncodeFieldAccess(isStructureMember));
@@ -4870,9 +6046,11 @@ std::string ProtocolField::getEncodeStringForStructure(bool isStructureMember) c
  * \param isStructureMember should be true if the left hand side is a
  *        member of a user structure, else the left hand side is a pointer
  *        to the inMemoryType
+ * \param element should be true to decode only the array element "_pg_i",
+ *        without the dependsOn of the field
  * \return The string to add to the source file to that decodes this field
  */
-std::string ProtocolField::getDecodeStringForStructure(bool isStructureMember) const
+std::string ProtocolField::getDecodeStringForStructure(bool isStructureMember, bool element) const
 {
     std::string output;
     std::string access;
@@ -4884,7 +6062,7 @@ std::string ProtocolField::getDecodeStringForStructure(bool isStructureMember) c
     if(!comment.empty())
         output += "    // " + comment + "\n";
 
-    if(!dependsOn.empty())
+    if(!dependsOn.empty() && !element)
     {
         output += spacing + "if(" + getDecodeFieldAccess(isStructureMember, dependsOn);
 
@@ -4896,12 +6074,16 @@ std::string ProtocolField::getDecodeStringForStructure(bool isStructureMember) c
     }
 
     // The array iteration code
-    output += getDecodeArrayIterationCode(spacing, isStructureMember);
+    if(element)
+        output += getDecodeElementIterationCode(spacing, isStructureMember);
+    else
+        output += getDecodeArrayIterationCode(spacing, isStructureMember);
 
     // Spacing for arrays
     if(isArray())
     {
-        spacing += TAB_IN;
+        if(!element)
+            spacing += TAB_IN;
         if(is2dArray())
             spacing += TAB_IN;
     }
@@ -4938,7 +6120,7 @@ std::string ProtocolField::getDecodeStringForStructure(bool isStructureMember) c
         output += spacing + TAB_IN + "return false;\n";
     }
 
-    if(!dependsOn.empty())
+    if(!dependsOn.empty() && !element)
         output += TAB_IN + "}\n";
 
     return output;
@@ -5011,7 +6193,7 @@ std::string ProtocolField::getEncodeStringForField(bool isStructureMember) const
 
     // Additional commenting to describe the scaling
     if(!inMemoryType.isNull && !inMemoryType.isBool && constantstring.empty())
-        output += spacing + getRangeComment(support.limitonencode);
+        output += spacing + getRangeComment(limitonencode);
 
     int length = encodedType.bits / 8;
     lengthString = std::to_string(length);
@@ -5049,6 +6231,29 @@ std::string ProtocolField::getEncodeStringForField(bool isStructureMember) const
     std::string arrayspacing;
     std::string argument = getEncodeFieldAccess(isStructureMember);
 
+    if(encodedType.isPacked)
+    {
+        std::string elementspacing = spacing + TAB_IN;
+        if(is2dArray())
+            elementspacing += TAB_IN;
+
+        // Argument may need to be limited. Constant encode overrides the argument
+        if(!constantstring.empty())
+            argument = constantstring;
+        else if(inMemoryType.isBool)
+            argument = "(" + argument + " == true) ? 1 : 0";
+        else
+            argument = getLimitedArgument(argument);
+
+        output += ProtocolBitfield::getPackedEncodeString(spacing, getEncodeArrayIterationCode(spacing + TAB_IN, isStructureMember), elementspacing, argument, encodedType.bits);
+
+        if(!dependsOn.empty())
+            output += TAB_IN + "}\n";
+
+        return output;
+
+    }// if packed array of bitfields
+
     // The array iteration code
     output += getEncodeArrayIterationCode(spacing, isStructureMember);
 
@@ -5066,7 +6271,13 @@ std::string ProtocolField::getEncodeStringForField(bool isStructureMember) const
     else
         argument = constantstring;
 
-    if(encodedType.isFloat)
+    if(encodedType.isVarint)
+    {
+        // "varuint32ToBytes(" for example
+        output += spacing + arrayspacing + "var" + encodedType.toSigString() + "ToBytes(" + getVarintArgument(isStructureMember) + ", _pg_data, &_pg_byteindex);\n";
+
+    }// If the encoded type is a variable length integer
+    else if(encodedType.isFloat)
     {
         // In this case we are encoding as a floating point. Typically we
         // would not scale here, but there are cases where scaling is
@@ -5211,6 +6422,34 @@ std::string ProtocolField::getEncodeStringForField(bool isStructureMember) const
 }// ProtocolField::getEncodeStringForField
 
 
+/*!
+ * Get the argument passed to the functions which encode this field as a
+ * variable length integer, or which compute its encoded length. The argument
+ * is limited and cast exactly as a fixed length integer encoding would be.
+ * \param isStructureMember should be true if the field is accessed as a
+ *        member of a user structure
+ * \return the argument, including any cast.
+ */
+std::string ProtocolField::getVarintArgument(bool isStructureMember) const
+{
+    std::string constantstring = getConstantString();
+
+    // Cast the constant string, just in case
+    if(!constantstring.empty())
+        return "(" + encodedType.toTypeString() + ")(" + constantstring + ")";
+
+    std::string argument = getLimitedArgument(getEncodeFieldAccess(isStructureMember));
+
+    if(inMemoryType.isBool)
+        return "(" + argument + " == true) ? 1 : 0";
+    else if((inMemoryType.bits > encodedType.bits) || (inMemoryType.isSigned != encodedType.isSigned))
+        return "(" + encodedType.toTypeString() + ")(" + argument + ")";
+    else
+        return argument;
+
+}// ProtocolField::getVarintArgument
+
+
 /*!
  * Check to see if we should be doing floating point scaling on this field.
  * This means the encode operation is going to call a function like
@@ -5288,7 +6527,25 @@ bool ProtocolField::isIntegerScaling(void) const
  */
 std::string ProtocolField::getDecodeStringForField(bool isStructureMember, bool defaultEnabled) const
 {
-    std::string output;
+    CodeEmitter output(256);
+    emitDecodeStringForField(output, isStructureMember, defaultEnabled, false);
+    return output.take();
+}
+
+
+/*!
+ * Output the next lines(s) of source coded needed to decode this field, which
+ * is not a bitfield or a string
+ * \param output receives the source code that decodes this field.
+ * \param isStructureMember should be true if the left hand side is a
+ *        member of a user structure, else the left hand side is a pointer
+ *        to the inMemoryType
+ * \param defaultEnabled should be true to enable default handling
+ * \param element should be true to decode only the array element "_pg_i",
+ *        without the dependsOn of the field
+ */
+void ProtocolField::emitDecodeStringForField(CodeEmitter& output, bool isStructureMember, bool defaultEnabled, bool element) const
+{
     std::string endian;
     std::string spacing = TAB_IN;
     std::string arrayspacing;
@@ -5297,7 +6554,7 @@ std::string ProtocolField::getDecodeStringForField(bool isStructureMember, bool
     std::string constantstring = getConstantString();
 
     if(encodedType.isNull)
-        return output;
+        return;
 
     argument = getDecodeFieldAccess(isStructureMember);
 
@@ -5318,6 +6575,12 @@ std::string ProtocolField::getDecodeStringForField(bool isStructureMember, bool
     // What is the length in bytes of this field, remember that we could be encoding an array
     std::string lengthString = std::to_string(length);
 
+    // A variable length integer is at least one byte
+    if(encodedType.isVarint)
+        lengthString = "1";
+    else if(encodedType.isPacked)
+        lengthString = std::to_string(encodedType.bits);
+
     if(isArray())
     {
         if(variableArray.empty())
@@ -5334,90 +6597,125 @@ std::string ProtocolField::getDecodeStringForField(bool isStructureMember, bool
         }
     }
 
-    if(!dependsOn.empty())
+    // Packed bits are rounded up to whole bytes
+    if(encodedType.isPacked)
+        lengthString = "(" + lengthString + " + 7)/8";
+
+    if(!dependsOn.empty() && !element)
     {
-        output += spacing + "if(" + getDecodeFieldAccess(isStructureMember, dependsOn);
+        output.append(spacing, "if(", getDecodeFieldAccess(isStructureMember, dependsOn));
 
         if(!dependsOnValue.empty())
-            output += " " + dependsOnCompare + " " + dependsOnValue;
+            output.append(" ", dependsOnCompare, " ", dependsOnValue);
 
-        output += ")\n" + spacing + "{\n";
+        output.append(")\n", spacing, "{\n");
         spacing += TAB_IN;
     }
 
     // If this field has a default value, or overrides a previous value
     if(defaultEnabled && (!defaultString.empty() || overridesPrevious))
     {
-        output += spacing + "if(_pg_byteindex + " + lengthString + " > _pg_numbytes)\n";
-        output += spacing + TAB_IN + "return " + getReturnCode(true) + ";\n";
-        output += "\n";
+        output.append(spacing, "if(_pg_byteindex + ", lengthString, " > _pg_numbytes)\n");
+        output.append(spacing, TAB_IN, "return ", getReturnCode(true), ";\n");
+        output.append("\n");
     }
 
     if(!comment.empty())
-        output += spacing + "// " + comment + "\n";
+        output.append(spacing, "// ", comment, "\n");
 
     // Commenting indicating the range of the field
     if(!inMemoryType.isNull && !inMemoryType.isBool)
-        output += spacing + getRangeComment();
+        output.append(spacing, getRangeComment());
 
     if(!inMemoryType.isNull && checkConstant)
-        output += spacing + "// Decoded value must be " + constantstring + "\n";
+        output.append(spacing, "// Decoded value must be ", constantstring, "\n");
 
     if(inMemoryType.isNull)
     {
         if(checkConstant && array.empty())
         {
-            output += spacing + "if (";
+            output.append(spacing, "if (");
 
-            if(encodedType.isFloat)
+            if(encodedType.isVarint)
+                output.append("var", encodedType.toSigString(), "FromBytes(_pg_data, &_pg_byteindex)");
+            else if(encodedType.isFloat)
             {
                 if(encodedType.bits == 16)
-                    output += "float16From" + endian + "Bytes(_pg_data, &_pg_byteindex, " + std::to_string(encodedType.sigbits) + ")";
+                    output.append("float16From", endian, "Bytes(_pg_data, &_pg_byteindex, ", encodedType.sigbits, ")");
                 else if(encodedType.bits == 24)
-                    output += "float24From" + endian + "Bytes(_pg_data, &_pg_byteindex, " + std::to_string(encodedType.sigbits) + ")";
+                    output.append("float24From", endian, "Bytes(_pg_data, &_pg_byteindex, ", encodedType.sigbits, ")");
                 else if((inMemoryType.bits > 32) && support.float64)
-                    output += "float64From" + endian + "Bytes(_pg_data, &_pg_byteindex)";
+                    output.append("float64From", endian, "Bytes(_pg_data, &_pg_byteindex)");
                 else
-                    output += "float32From" + endian + "Bytes(_pg_data, &_pg_byteindex)";
+                    output.append("float32From", endian, "Bytes(_pg_data, &_pg_byteindex)");
             }
             else
             {
                 if(encodedType.isSigned)
-                    output += "int";
+                    output.append("int");
                 else
-                    output += "uint";
+                    output.append("uint");
 
-                output += std::to_string(encodedType.bits) + "From" + endian + "Bytes(_pg_data, &_pg_byteindex)";
+                output.append(encodedType.bits, "From", endian, "Bytes(_pg_data, &_pg_byteindex)");
             }
 
-            output += " != (" + encodedType.toTypeString() + ") " + constantstring + ")\n";
-            output += spacing + TAB_IN + "return " + getReturnCode(false) + ";\n";
+            output.append(" != (", encodedType.toTypeString(), ") ", constantstring, ")\n");
+            output.append(spacing, TAB_IN, "return ", getReturnCode(false), ";\n");
 
         }// If constant value must be checked
         else
         {
             // Skip over reserved space
             if(comment.empty())
-                output += spacing + "// Skip over reserved space\n";
+                output.append(spacing, "// Skip over reserved space\n");
 
-            output += spacing + "_pg_byteindex += " + lengthString + ";\n";
+            if(encodedType.isVarint)
+                output.append(spacing, "varintSkipBytes(_pg_data, &_pg_byteindex, ", (encodedType.bits + 6) / 7, ");\n");
+            else
+                output.append(spacing, "_pg_byteindex += ", lengthString, ";\n");
 
         }// else constant value is not checked
 
     }// If nothing in-memory
+    else if(encodedType.isPacked)
+    {
+        std::string elementspacing = spacing + TAB_IN;
+        if(is2dArray())
+            elementspacing += TAB_IN;
+
+        output.append(ProtocolBitfield::getPackedDecodeString(spacing, getDecodeArrayIterationCode(spacing + TAB_IN, isStructureMember), elementspacing, argument, "(" + typeName + ")", encodedType.bits, inMemoryType.isSigned));
+
+    }// else if packed array of bitfields
     else
     {
-        output += getDecodeArrayIterationCode(spacing, isStructureMember);
+        if(element)
+            output.append(getDecodeElementIterationCode(spacing, isStructureMember));
+        else
+            output.append(getDecodeArrayIterationCode(spacing, isStructureMember));
 
         // Array spacing
         if(isArray())
         {
-            arrayspacing += TAB_IN;
+            if(!element)
+                arrayspacing += TAB_IN;
             if(is2dArray())
                 arrayspacing += TAB_IN;
          }
 
-        if(encodedType.isFloat)
+        if(encodedType.isVarint)
+        {
+            // "varuint32FromBytes(_pg_data, &_pg_byteindex)" for example
+            std::string function = "var" + encodedType.toSigString() + "FromBytes(_pg_data, &_pg_byteindex)";
+
+            if(inMemoryType.isBool)
+                function = "(" + function + ") ? true : false";
+            else if((inMemoryType.bits != encodedType.bits) || inMemoryType.isEnum)
+                function = "(" + typeName + ")" + function;
+
+            output.append(spacing, arrayspacing, argument, " = ", function, ";\n");
+
+        }// if variable length integer
+        else if(encodedType.isFloat)
         {
             // In this case we are encoding as a floating point. Typically we
             // would not scale here, but there are cases where scaling is
@@ -5429,86 +6727,86 @@ std::string ProtocolField::getDecodeStringForField(bool isStructureMember, bool
             if(scaler != 1.0)
                 scalestring = "(" + getNumberString(1.0, inMemoryType.bits) + "/" + getNumberString(scaler, inMemoryType.bits) + ")*" ;
 
-            output += spacing + arrayspacing + argument + " = " + scalestring + "float" + std::to_string(encodedType.bits) + "From" + endian + "Bytes(_pg_data, &_pg_byteindex";
+            output.append(spacing, arrayspacing, argument, " = ", scalestring, "float", encodedType.bits, "From", endian, "Bytes(_pg_data, &_pg_byteindex");
 
             if((encodedType.bits == 16) || (encodedType.bits == 24))
-                output += ", " + std::to_string(encodedType.sigbits);
+                output.append(", ", encodedType.sigbits);
 
-            output += ");\n";
+            output.append(");\n");
 
         }// if float
         else if(isFloatScaling())
         {
-            output += spacing + arrayspacing + argument + " = ";
+            output.append(spacing, arrayspacing, argument, " = ");
 
             // The cast if the in memory type is not floating
             if(!inMemoryType.isFloat)
-                output += "(" + inMemoryType.toTypeString() + ")";
+                output.append("(", inMemoryType.toTypeString(), ")");
 
             if((inMemoryType.bits > 32) && support.float64)
-                output += "float64";
+                output.append("float64");
             else
-                output += "float32";
+                output.append("float32");
 
             // The scaling decode function
-            output += "ScaledFrom" + std::to_string(length);
+            output.append("ScaledFrom", length);
 
             // Signed or unsigned
             if(encodedType.isSigned)
-                output += "Signed";
+                output.append("Signed");
             else
-                output += "Unsigned";
+                output.append("Unsigned");
 
-            output += endian + "Bytes(_pg_data, &_pg_byteindex";
+            output.append(endian, "Bytes(_pg_data, &_pg_byteindex");
 
             // Signature changes for signed versus unsigned
             if(!encodedType.isSigned)
-                output += ", " + getNumberString(encodedMin, inMemoryType.bits);
+                output.append(", ", getNumberString(encodedMin, inMemoryType.bits));
 
             // Notice how the scaling value is the inverse for the decode function
-            output += ", " + getNumberString(1.0, inMemoryType.bits) + "/" + getNumberString(scaler, inMemoryType.bits);
+            output.append(", ", getNumberString(1.0, inMemoryType.bits), "/", getNumberString(scaler, inMemoryType.bits));
 
-            output += ");\n";
+            output.append(");\n");
 
         }// if float scaling to integer
         else if(isIntegerScaling())
         {
-            output += spacing + arrayspacing + argument + " = ";
+            output.append(spacing, arrayspacing, argument, " = ");
 
             // If the scaler is 1, add the minimum value in directly - save the cost of division
             if(scaler == 1.0)
             {
                 // Might need a cast
                 if((inMemoryType.isSigned != encodedType.isSigned) || (inMemoryType.bits < encodedType.bits))
-                    output += "(" + inMemoryType.toTypeString() + ")";
+                    output.append("(", inMemoryType.toTypeString(), ")");
 
                 // "int32FromBeBytes(data, &_pg_byteindex)" for example
-                output += "(" + encodedType.toSigString() + "From" + endian + "Bytes(_pg_data, &_pg_byteindex) + " + std::to_string((int64_t)round(encodedMin)) + ");\n";
+                output.append("(", encodedType.toSigString(), "From", endian, "Bytes(_pg_data, &_pg_byteindex) + ", (int64_t)round(encodedMin), ");\n");
             }
             else
             {
                 // "uint32" or "int16" for example
-                output += inMemoryType.toSigString();
+                output.append(inMemoryType.toSigString());
 
                 // Scaled from a number of bytes
-                output += "ScaledFrom" + std::to_string(length);
+                output.append("ScaledFrom", length);
 
                 // Signed or unsigned
                 if(encodedType.isSigned)
-                    output += "Signed";
+                    output.append("Signed");
                 else
-                    output += "Unsigned";
+                    output.append("Unsigned");
 
                 // In an endian order
-                output += endian + "Bytes(_pg_data, &_pg_byteindex";
+                output.append(endian, "Bytes(_pg_data, &_pg_byteindex");
 
                 // Signature changes for signed versus unsigned
                 if(!encodedType.isSigned)
-                    output += ", " + std::to_string((int64_t)round(encodedMin));
+                    output.append(", ", (int64_t)round(encodedMin));
 
-                output += ", " + std::to_string((int64_t)round(scaler));
+                output.append(", ", (int64_t)round(scaler));
 
-                output += ");\n";
+                output.append(");\n");
             }
 
         }// else if integer scaling to integer
@@ -5535,7 +6833,7 @@ std::string ProtocolField::getDecodeStringForField(bool isStructureMember, bool
                 function = "(" + typeName + ")" + function;
             }
 
-            output += spacing + arrayspacing + argument + " = " + function + ";\n";
+            output.append(spacing, arrayspacing, argument, " = ", function, ";\n");
 
         }// else not floating point scaled
 
@@ -5544,17 +6842,15 @@ std::string ProtocolField::getDecodeStringForField(bool isStructureMember, bool
     // Handle the check constant case, the null case was handled above
     if(!inMemoryType.isNull && checkConstant)
     {
-        output += spacing + arrayspacing + "if (" + argument + " != " + constantstring + ")\n";
-        output += spacing + arrayspacing + TAB_IN + "return " + getReturnCode(false) + ";\n";
+        output.append(spacing, arrayspacing, "if (", argument, " != ", constantstring, ")\n");
+        output.append(spacing, arrayspacing, TAB_IN, "return ", getReturnCode(false), ";\n");
     }
 
     // Close the depends on block
-    if(!dependsOn.empty())
-        output += TAB_IN + "}\n";
-
-    return output;
+    if(!dependsOn.empty() && !element)
+        output.append(TAB_IN, "}\n");
 
-}// ProtocolField::getDecodeStringForField
+}// ProtocolField::emitDecodeStringForField
 
 
 /*!
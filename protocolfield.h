@@ -10,7 +10,7 @@ class TypeData
 public:
 
     //! Construct empty type data
-    TypeData(ProtocolSupport sup);
+    TypeData(const ProtocolSupport& sup);
 
     //! Reset all members to default except the protocol support
     void clear(void);
@@ -25,6 +25,8 @@ public:
     bool isString;      //!< true if type is a variable length string
     bool isFixedString; //!< true if type is a fixed length string
     bool isNull;        //!< true if type is null, i.e not in memory OR not encoded
+    bool isVarint;      //!< true if type is a variable length integer, only for encoded types
+    bool isPacked;      //!< true if type is an array of bitfields packed end to end, only for encoded types
     int bits;           //!< number of bits used by type
     int sigbits;        //!< number of bits for the significand of a float16 or float24
     int enummax;        //!< maximum value of the enumeration if isEnum is true
@@ -59,7 +61,8 @@ public:
 
 private:
 
-    ProtocolSupport support;
+    //! Protocol wide support details, a pointer so that type data can be assigned
+    const ProtocolSupport* support;
 };
 
 
@@ -112,7 +115,7 @@ public:
     };
 
     //! Construct a field, setting the protocol name and name prefix
-    ProtocolField(ProtocolParser* parse, std::string parent, ProtocolSupport supported);
+    ProtocolField(ProtocolParser* parse, std::string parent, const ProtocolSupport& supported);
 
     //! Provide the pointer to a previous encodable in the list
     void setPreviousEncodable(Encodable* prev) override;
@@ -156,6 +159,9 @@ public:
     //! True if this encoable is a primitive bitfield
     bool isBitfield(void) const override {return (encodedType.isBitfield && !isNotEncoded());}
 
+    //! True if this encodable is a floating point number in memory
+    bool isFloat(void) const override {return inMemoryType.isFloat;}
+
     //! True if this encodable has a default value
     bool isDefault(void) const override {return !defaultString.empty();}
 
@@ -183,6 +189,9 @@ public:
     //! Return the include directives needed for this encodable's print functions
     void getPrintIncludeDirectives(std::vector<std::string>& list) const override;
 
+    //! Return the include directives needed for this encodable's JSON functions
+    void getJsonIncludeDirectives(std::vector<std::string>& list) const override;
+
     //! Return the signature of this field in an encode function signature
     std::string getEncodeSignature(void) const override;
 
@@ -207,6 +216,27 @@ public:
     //! Return the string that is used to decode this encoable
     std::string getDecodeString(int* bitcount, bool isStructureMember, bool defaultEnabled = false) const override;
 
+    //! Return the string that adds the encoded size of this field, empty if the size is always the maximum
+    std::string getEncodedSizeString(bool isStructureMember) const override {return getLengthString(isStructureMember, false);}
+
+    //! Return the string that skips this field in a byte array, empty if the size is always the maximum
+    std::string getSkipString(bool isStructureMember) const override {return getLengthString(isStructureMember, true);}
+
+    //! True if the array elements of this field can be decoded one at a time, by the steps of a resumable decoder
+    bool isDecodedByElement(void) const override;
+
+    //! Return the string that decodes the array element `_pg_i` of this field
+    std::string getDecodeElementString(bool isStructureMember) const override;
+
+    //! Return the string that skips one array element of this field in a byte array, empty if every element has the same size
+    std::string getSkipElementString(bool isStructureMember) const override;
+
+    //! Return the declaration of a local variable that holds this field, for the C++ language
+    std::string getLocalDeclaration(void) const override;
+
+    //! Output the string that is used to decode this field
+    void emitDecodeString(CodeEmitter& output, int* bitcount, bool isStructureMember, bool defaultEnabled = false) const override;
+
     //! Return the string that sets this encodable to its default value in code
     std::string getSetToDefaultsString(bool isStructureMember) const override;
 
@@ -216,9 +246,18 @@ public:
     //! Get the string used for comparing this field.
     std::string getComparisonString(void) const override;
 
+    //! Get the string used for testing this field for equality.
+    std::string getEqualsString(void) const override;
+
+    //! Get the string used for combining this field into a hash.
+    std::string getHashString(void) const override;
+
     //! Get the string used for text printing this field.
     std::string getTextPrintString(void) const override;
 
+    //! Get the estimated number of characters text printed for this field, not counting the prename
+    int getTextPrintLength(int* lines) const override;
+
     //! Get the string used for text reading this field.
     std::string getTextReadString(void) const override;
 
@@ -228,9 +267,36 @@ public:
     //! Get the string used for map decoding this field
     std::string getMapDecodeString(void) const override;
 
+    //! Get the string used for JSON encoding this field
+    std::string getJsonEncodeString(bool first) const override;
+
+    //! Get the string used for JSON decoding this field
+    std::string getJsonDecodeString(void) const override;
+
+    //! Get the string used for JSON encoding one value of this field
+    std::string getJsonEncodeValueString(const std::string& spacing, const std::string& separator) const override;
+
+    //! Get the string used for JSON decoding one value of this field
+    std::string getJsonDecodeValueString(const std::string& spacing, const std::string& condition) const override;
+
+    //! Get the array indices passed to the FieldMap functions
+    std::string getStdMapIndices(void) const;
+
+    //! Get the name of the structure of this field, as used in the names of its functions
+    std::string getFunctionStructName(void) const;
+
     //! Return the string that sets this encodable to its initial value in code
     std::string getSetInitialValueString(bool isStructureMember) const override;
 
+    //! Return the string that sets this encodable to its initial value in the C++ initialize() function
+    std::string getInitializeString(void) const override;
+
+    //! True if this field is a structure whose constructor leaves its members to initialize()
+    bool isNoInit(void) const override;
+
+    //! Get the initial value of this field in the C++ language
+    std::string getCppInitialValue(void) const;
+
     //! Return the string that sets this encodable to specific value in code
     std::string getSetToValueString(bool isStructureMember, std::string value) const;
 
@@ -303,6 +369,9 @@ public:
     //! True if this encodable has a direct child that uses defaults
     bool usesDefaults(void) const override {return (isDefault() && !isNotEncoded());}
 
+    //! True if this encodable is encoded as a variable length integer
+    bool usesVarint(void) const override {return (encodedType.isVarint && !isNotEncoded());}
+
 protected:
 
     //! Minimum encoded value (as a number), used by scaling routines for unsigned encodings
@@ -462,6 +531,15 @@ protected:
     //! Get the next lines(s, bool isStructureMember) of source coded needed to encode a field, which is not a bitfield or a string
     std::string getEncodeStringForField(bool isStructureMember) const;
 
+    //! Get the argument of the functions which encode or size this field as a variable length integer
+    std::string getVarintArgument(bool isStructureMember) const;
+
+    //! Get the source needed to add the encoded size of this field, or to skip it
+    std::string getLengthString(bool isStructureMember, bool skip) const;
+
+    //! Get the source needed to skip one value of this field, which is a variable length integer or a structure
+    std::string getSkipValueString(const std::string& spacing) const;
+
     //! Get the next lines(s, bool isStructureMember) of source coded needed to decode a bitfield field
     std::string getDecodeStringForBitfield(int* bitcount, bool isStructureMember, bool defaultEnabled) const;
 
@@ -469,11 +547,14 @@ protected:
     std::string getDecodeStringForString(bool isStructureMember, bool defaultEnabled) const;
 
     //! Get the next lines of source needed to decode a string field
-    std::string getDecodeStringForStructure(bool isStructureMember) const;
+    std::string getDecodeStringForStructure(bool isStructureMember, bool element) const;
 
     //! Get the next lines(s, bool isStructureMember) of source coded needed to decode a field, which is not a bitfield or a string
     std::string getDecodeStringForField(bool isStructureMember, bool defaultEnabled) const;
 
+    //! Output the next lines of source needed to decode a field, which is not a bitfield or a string
+    void emitDecodeStringForField(CodeEmitter& output, bool isStructureMember, bool defaultEnabled, bool element) const;
+
     //! Get the source needed to close out a string of bitfields in the encode function.
     std::string getCloseBitfieldString(int* bitcount) const;
 
@@ -0,0 +1,191 @@
+#include "protocolfieldhash.h"
+
+ProtocolFieldHash::ProtocolFieldHash(const ProtocolSupport& protocolsupport) :
+    header(protocolsupport),
+    source(protocolsupport),
+    support(protocolsupport)
+{}
+
+//! Perform the generation, writing out the files
+bool ProtocolFieldHash::generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList)
+{
+    if(generateHeader())
+    {
+        fileNameList.push_back(header.fileName());
+        filePathList.push_back(header.filePath());
+
+        if(generateSource())
+        {
+            fileNameList.push_back(source.fileName());
+            filePathList.push_back(source.filePath());
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//! Generate the header file
+bool ProtocolFieldHash::generateHeader(void)
+{
+    header.setModuleNameAndPath("fieldhash", support.outputpath, support.language);
+
+// Raw string magic here
+header.setFileComment(R"(\brief Functions used by the hash functions to combine fields into a hash
+
+The hash uses the round, merge, and avalanche steps of xxHash64. Numbers
+are combined by value, and bytes are assembled in little endian order, so
+the hash does not depend on the byte order of the machine. This is not a
+cryptographic hash.)");
+
+header.makeLineSeparator();
+
+// Raw string magic here
+header.write(R"(//! Combine a value into a hash
+uint64_t mixHash(uint64_t hash, uint64_t value);
+
+//! Finish a hash so that every bit of it depends on every bit of its input
+uint64_t finishHash(uint64_t hash);
+
+//! Combine bytes into a hash
+uint64_t mixHashBytes(uint64_t hash, const uint8_t* bytes, unsigned length);
+
+//! Combine a string into a hash
+uint64_t mixHashString(uint64_t hash, const char* text, unsigned maxLength);
+
+//! Combine a floating point number into a hash
+uint64_t mixHashFloat(uint64_t hash, double value);)");
+
+header.makeLineSeparator();
+
+return header.flush();
+
+}// ProtocolFieldHash::generateHeader
+
+
+//! Generate the source file
+bool ProtocolFieldHash::generateSource(void)
+{
+    source.setModuleNameAndPath("fieldhash", support.outputpath, support.language);
+    source.writeIncludeDirective("string.h", std::string(), true, false);
+    source.makeLineSeparator();
+
+    // Raw string magic here
+source.write(R"(/*!
+ * Combine a value into a hash, using the round and merge steps of xxHash64
+ * \param hash is the hash so far
+ * \param value is the value to combine into the hash
+ * \return the new hash
+ */
+uint64_t mixHash(uint64_t hash, uint64_t value)
+{
+    value *= 0xC2B2AE3D27D4EB4Full;
+    value = (value << 31) | (value >> 33);
+    value *= 0x9E3779B185EBCA87ull;
+    hash ^= value;
+    return ((hash << 27) | (hash >> 37))*0x9E3779B185EBCA87ull + 0x85EBCA77C2B2AE63ull;
+
+}// mixHash
+
+
+/*!
+ * Finish a hash using the avalanche of xxHash64, so that every bit of the
+ * hash depends on every bit of its input
+ * \param hash is the hash to finish
+ * \return the finished hash
+ */
+uint64_t finishHash(uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= 0xC2B2AE3D27D4EB4Full;
+    hash ^= hash >> 29;
+    hash *= 0x165667B19E3779F9ull;
+    hash ^= hash >> 32;
+    return hash;
+
+}// finishHash
+
+
+/*!
+ * Combine bytes into a hash, 8 at a time. The bytes are assembled in little
+ * endian order, so the hash does not depend on the byte order of the machine.
+ * The number of bytes is combined last, so that trailing zeroes count.
+ * \param hash is the hash so far
+ * \param bytes are the bytes to combine into the hash
+ * \param length is the number of bytes
+ * \return the new hash
+ */
+uint64_t mixHashBytes(uint64_t hash, const uint8_t* bytes, unsigned length)
+{
+    uint64_t value = 0;
+    unsigned i, shift = 0;
+
+    for(i = 0; i < length; i++)
+    {
+        value |= ((uint64_t)bytes[i]) << shift;
+        shift += 8;
+
+        if(shift >= 64)
+        {
+            hash = mixHash(hash, value);
+            value = 0;
+            shift = 0;
+        }
+    }
+
+    if(shift > 0)
+        hash = mixHash(hash, value);
+
+    return mixHash(hash, length);
+
+}// mixHashBytes
+
+
+/*!
+ * Combine a string into a hash. The string ends at its null terminator, or
+ * at its maximum length, which is where strncmp() stops comparing it.
+ * \param hash is the hash so far
+ * \param text is the string to combine into the hash
+ * \param maxLength is the size of the string storage
+ * \return the new hash
+ */
+uint64_t mixHashString(uint64_t hash, const char* text, unsigned maxLength)
+{
+    unsigned length = 0;
+
+    while((length < maxLength) && (text[length] != 0))
+        length++;
+
+    return mixHashBytes(hash, (const uint8_t*)text, length);
+
+}// mixHashString
+
+
+/*!
+ * Combine a floating point number into a hash, using its bits
+ * \param hash is the hash so far
+ * \param value is the number to combine into the hash
+ * \return the new hash
+ */
+uint64_t mixHashFloat(uint64_t hash, double value)
+{
+    uint64_t bits = 0;
+
+    // Positive and negative zero are equal, so they must hash the same
+    if(value == 0)
+        value = 0;
+
+    memcpy(&bits, &value, (sizeof(value) < sizeof(bits)) ? sizeof(value) : sizeof(bits));
+
+    return mixHash(hash, bits);
+
+}// mixHashFloat
+)");
+
+    source.makeLineSeparator();
+
+    return source.flush();
+
+}// ProtocolFieldHash::generateSource
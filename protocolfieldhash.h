@@ -0,0 +1,41 @@
+#ifndef PROTOCOLFIELDHASH_H
+#define PROTOCOLFIELDHASH_H
+
+/*!
+ * \file
+ * Auto magically generate the functions used by the hash functions to combine
+ * fields into a hash.
+ */
+
+#include "protocolfile.h"
+#include "protocolsupport.h"
+#include <string>
+#include <vector>
+
+/*!
+ * The field hash module has the functions that the generated hash functions
+ * use to combine numbers, bytes, strings, and floating point numbers into a
+ * 64-bit hash. It is output if any structure or packet has a hash function.
+ */
+class ProtocolFieldHash
+{
+public:
+    ProtocolFieldHash(const ProtocolSupport& protocolsupport);
+
+    //! Perform the generation, writing out the files
+    bool generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList);
+
+protected:
+
+    //! Generate the header file
+    bool generateHeader(void);
+
+    //! Generate the source file
+    bool generateSource(void);
+
+    ProtocolHeaderFile header;
+    ProtocolSourceFile source;
+    const ProtocolSupport& support;
+};
+
+#endif // PROTOCOLFIELDHASH_H
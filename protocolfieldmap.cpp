@@ -0,0 +1,572 @@
+#include "protocolfieldmap.h"
+
+ProtocolFieldMap::ProtocolFieldMap(const ProtocolSupport& protocolsupport) :
+    header(protocolsupport),
+    source(protocolsupport),
+    support(protocolsupport)
+{}
+
+//! Perform the generation, writing out the files
+bool ProtocolFieldMap::generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList)
+{
+    if(support.stdMap && generateHeader())
+    {
+        fileNameList.push_back(header.fileName());
+        filePathList.push_back(header.filePath());
+
+        if(generateSource())
+        {
+            fileNameList.push_back(source.fileName());
+            filePathList.push_back(source.filePath());
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//! Generate the header file
+bool ProtocolFieldMap::generateHeader(void)
+{
+    // The map is always C++, even for a C protocol
+    header.setModuleNameAndPath("fieldmap", support.outputpath, ProtocolSupport::cpp_language);
+
+// Raw string magic here
+header.setFileComment(R"(\brief Key:value map used by the mapEncode and mapDecode functions
+
+The map is a flat hash table with linear probing, keyed by strings, whose
+values are numbers or strings held in a std::variant. Numbers are stored
+as numbers, they are never converted to text. Finding a key does not
+allocate, and clearing the map keeps its storage; so encoding the same
+structure into a cleared map again does not allocate either.
+
+The keys are formed by appending ":name" for each field, and "[index]"
+for each array dimension, to a caller supplied prefix. The generated map
+functions extend and restore a single key string in place, rather than
+building a new key for each field.
+
+This module requires C++17.)");
+
+header.makeLineSeparator();
+header.writeIncludeDirective("cstddef", std::string(), true, false);
+header.writeIncludeDirective("cstdint", std::string(), true, false);
+header.writeIncludeDirective("string", std::string(), true, false);
+header.writeIncludeDirective("string_view", std::string(), true, false);
+header.writeIncludeDirective("variant", std::string(), true, false);
+header.writeIncludeDirective("vector", std::string(), true, false);
+header.makeLineSeparator();
+
+// Raw string magic here
+header.write(R"(//! A value in a FieldMap: a signed, unsigned, or floating point number, or a string
+typedef std::variant<long long, unsigned long long, double, std::string> FieldMapValue;
+
+/*!
+ * Key:value map used by the generated mapEncode and mapDecode functions.
+ * Entries can be added or changed, but not removed, except by clearing the
+ * whole map.
+ */
+class FieldMap
+{
+public:
+
+    //! Construct the map with room for capacity entries before it grows
+    FieldMap(std::size_t capacity = 64);
+
+    //! Remove all the entries, keeping the storage
+    void clear(void);
+
+    //! \return the number of entries in the map
+    std::size_t size(void) const {return count;}
+
+    //! \return true if the map has no entries
+    bool empty(void) const {return count == 0;}
+
+    //! Set the value of a key, adding the key if it is not in the map
+    void set(std::string_view key, FieldMapValue value);
+
+    //! Set the value of the key prefix + name, prefix is restored before returning
+    void set(std::string& prefix, std::string_view name, FieldMapValue value);
+
+    //! Set the value of the key prefix + name[index], prefix is restored before returning
+    void set(std::string& prefix, std::string_view name, unsigned index, FieldMapValue value);
+
+    //! Set the value of the key prefix + name[index][index2], prefix is restored before returning
+    void set(std::string& prefix, std::string_view name, unsigned index, unsigned index2, FieldMapValue value);
+
+    //! Find the value of a key, returning NULL if the key is not in the map
+    const FieldMapValue* find(std::string_view key) const;
+
+    //! Find the value of the key prefix + name, prefix is restored before returning
+    const FieldMapValue* find(std::string& prefix, std::string_view name) const;
+
+    //! Find the value of the key prefix + name[index], prefix is restored before returning
+    const FieldMapValue* find(std::string& prefix, std::string_view name, unsigned index) const;
+
+    //! Find the value of the key prefix + name[index][index2], prefix is restored before returning
+    const FieldMapValue* find(std::string& prefix, std::string_view name, unsigned index, unsigned index2) const;
+
+    //! Call function(key, value) for every entry of the map, in no particular order
+    template<typename Function> void visit(Function function) const
+    {
+        for(const Slot& slot : slots)
+        {
+            if(slot.used)
+                function(std::string_view(slot.key), slot.value);
+        }
+    }
+
+    //! Append name to a key, returning the previous length of the key
+    static std::size_t appendKey(std::string& key, std::string_view name);
+
+    //! Append name[index] to a key, returning the previous length of the key
+    static std::size_t appendKey(std::string& key, std::string_view name, unsigned index);
+
+    //! Append name[index][index2] to a key, returning the previous length of the key
+    static std::size_t appendKey(std::string& key, std::string_view name, unsigned index, unsigned index2);
+
+private:
+
+    //! One entry of the hash table
+    struct Slot
+    {
+        std::string key;
+        FieldMapValue value;
+        uint64_t hash = 0;
+        bool used = false;
+    };
+
+    //! Compute the hash of a key
+    static uint64_t hashKey(std::string_view key);
+
+    //! Double the size of the hash table
+    void grow(void);
+
+    //! The hash table, whose size is always a power of 2
+    std::vector<Slot> slots;
+
+    //! The number of used slots
+    std::size_t count;
+};
+
+//! Get a signed number from a map value, which must be a number
+bool fieldMapToSigned(const FieldMapValue* value, long long* number);
+
+//! Get an unsigned number from a map value, which must be a number
+bool fieldMapToUnsigned(const FieldMapValue* value, unsigned long long* number);
+
+//! Get a floating point number from a map value, which must be a number
+bool fieldMapToDouble(const FieldMapValue* value, double* number);
+
+//! Copy a string from a map value, which must be a string
+bool fieldMapToString(const FieldMapValue* value, char* text, std::size_t size);)");
+
+header.makeLineSeparator();
+
+return header.flush();
+
+}// ProtocolFieldMap::generateHeader
+
+
+//! Generate the source file
+bool ProtocolFieldMap::generateSource(void)
+{
+    source.setModuleNameAndPath("fieldmap", support.outputpath, ProtocolSupport::cpp_language);
+    source.writeIncludeDirective("charconv", std::string(), true, false);
+    source.writeIncludeDirective("cstring", std::string(), true, false);
+    source.makeLineSeparator();
+
+    // Raw string magic here
+source.write(R"===(/*!
+ * Construct the map
+ * \param capacity is the number of entries the map can hold before it grows.
+ */
+FieldMap::FieldMap(std::size_t capacity) :
+    count(0)
+{
+    std::size_t size = 16;
+
+    // The table is never more than 3/4 full
+    while(size*3 < capacity*4)
+        size <<= 1;
+
+    slots.resize(size);
+
+}// FieldMap::FieldMap
+
+
+/*!
+ * Remove all the entries of the map. The keys and values keep their storage,
+ * so adding the same keys again does not allocate.
+ */
+void FieldMap::clear(void)
+{
+    for(Slot& slot : slots)
+        slot.used = false;
+
+    count = 0;
+
+}// FieldMap::clear
+
+
+/*!
+ * Compute the 64-bit FNV-1a hash of a key
+ * \param key is the key to hash.
+ * \return the hash of the key.
+ */
+uint64_t FieldMap::hashKey(std::string_view key)
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    for(char c : key)
+    {
+        hash ^= (unsigned char)c;
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+
+}// FieldMap::hashKey
+
+
+/*!
+ * Double the size of the hash table, moving every entry to its new slot
+ */
+void FieldMap::grow(void)
+{
+    std::vector<Slot> old(slots.size()*2);
+    std::size_t mask = old.size() - 1;
+
+    old.swap(slots);
+
+    for(Slot& slot : old)
+    {
+        if(!slot.used)
+            continue;
+
+        std::size_t i = (std::size_t)slot.hash & mask;
+
+        while(slots[i].used)
+            i = (i + 1) & mask;
+
+        slots[i] = std::move(slot);
+    }
+
+}// FieldMap::grow
+
+
+/*!
+ * Set the value of a key, adding the key if it is not in the map
+ * \param key is the key to set.
+ * \param value is the new value of the key.
+ */
+void FieldMap::set(std::string_view key, FieldMapValue value)
+{
+    if((count + 1)*4 > slots.size()*3)
+        grow();
+
+    uint64_t hash = hashKey(key);
+    std::size_t mask = slots.size() - 1;
+
+    for(std::size_t i = (std::size_t)hash & mask; ; i = (i + 1) & mask)
+    {
+        Slot& slot = slots[i];
+
+        if(!slot.used)
+        {
+            slot.key.assign(key.data(), key.size());
+            slot.value = std::move(value);
+            slot.hash = hash;
+            slot.used = true;
+            count++;
+            return;
+        }
+
+        if((slot.hash == hash) && (slot.key == key))
+        {
+            slot.value = std::move(value);
+            return;
+        }
+    }
+
+}// FieldMap::set
+
+
+/*!
+ * Set the value of the key prefix + name
+ * \param prefix is the start of the key, it is restored before returning.
+ * \param name is appended to prefix to form the key.
+ * \param value is the new value of the key.
+ */
+void FieldMap::set(std::string& prefix, std::string_view name, FieldMapValue value)
+{
+    std::size_t length = appendKey(prefix, name);
+    set(std::string_view(prefix), std::move(value));
+    prefix.resize(length);
+
+}// FieldMap::set
+
+
+/*!
+ * Set the value of the key prefix + name[index]
+ * \param prefix is the start of the key, it is restored before returning.
+ * \param name is appended to prefix to form the key.
+ * \param index is the array index appended to the key.
+ * \param value is the new value of the key.
+ */
+void FieldMap::set(std::string& prefix, std::string_view name, unsigned index, FieldMapValue value)
+{
+    std::size_t length = appendKey(prefix, name, index);
+    set(std::string_view(prefix), std::move(value));
+    prefix.resize(length);
+
+}// FieldMap::set
+
+
+/*!
+ * Set the value of the key prefix + name[index][index2]
+ * \param prefix is the start of the key, it is restored before returning.
+ * \param name is appended to prefix to form the key.
+ * \param index is the first array index appended to the key.
+ * \param index2 is the second array index appended to the key.
+ * \param value is the new value of the key.
+ */
+void FieldMap::set(std::string& prefix, std::string_view name, unsigned index, unsigned index2, FieldMapValue value)
+{
+    std::size_t length = appendKey(prefix, name, index, index2);
+    set(std::string_view(prefix), std::move(value));
+    prefix.resize(length);
+
+}// FieldMap::set
+
+
+/*!
+ * Find the value of a key
+ * \param key is the key to find.
+ * \return a pointer to the value of the key, or NULL if the key is not in the map.
+ */
+const FieldMapValue* FieldMap::find(std::string_view key) const
+{
+    uint64_t hash = hashKey(key);
+    std::size_t mask = slots.size() - 1;
+
+    // The table always has an unused slot, which ends the search
+    for(std::size_t i = (std::size_t)hash & mask; slots[i].used; i = (i + 1) & mask)
+    {
+        if((slots[i].hash == hash) && (slots[i].key == key))
+            return &slots[i].value;
+    }
+
+    return nullptr;
+
+}// FieldMap::find
+
+
+/*!
+ * Find the value of the key prefix + name
+ * \param prefix is the start of the key, it is restored before returning.
+ * \param name is appended to prefix to form the key.
+ * \return a pointer to the value of the key, or NULL if the key is not in the map.
+ */
+const FieldMapValue* FieldMap::find(std::string& prefix, std::string_view name) const
+{
+    std::size_t length = appendKey(prefix, name);
+    const FieldMapValue* value = find(std::string_view(prefix));
+    prefix.resize(length);
+    return value;
+
+}// FieldMap::find
+
+
+/*!
+ * Find the value of the key prefix + name[index]
+ * \param prefix is the start of the key, it is restored before returning.
+ * \param name is appended to prefix to form the key.
+ * \param index is the array index appended to the key.
+ * \return a pointer to the value of the key, or NULL if the key is not in the map.
+ */
+const FieldMapValue* FieldMap::find(std::string& prefix, std::string_view name, unsigned index) const
+{
+    std::size_t length = appendKey(prefix, name, index);
+    const FieldMapValue* value = find(std::string_view(prefix));
+    prefix.resize(length);
+    return value;
+
+}// FieldMap::find
+
+
+/*!
+ * Find the value of the key prefix + name[index][index2]
+ * \param prefix is the start of the key, it is restored before returning.
+ * \param name is appended to prefix to form the key.
+ * \param index is the first array index appended to the key.
+ * \param index2 is the second array index appended to the key.
+ * \return a pointer to the value of the key, or NULL if the key is not in the map.
+ */
+const FieldMapValue* FieldMap::find(std::string& prefix, std::string_view name, unsigned index, unsigned index2) const
+{
+    std::size_t length = appendKey(prefix, name, index, index2);
+    const FieldMapValue* value = find(std::string_view(prefix));
+    prefix.resize(length);
+    return value;
+
+}// FieldMap::find
+
+
+/*!
+ * Append a name to a key
+ * \param key is appended with name.
+ * \param name is the name to append.
+ * \return the length of key before the name was appended.
+ */
+std::size_t FieldMap::appendKey(std::string& key, std::string_view name)
+{
+    std::size_t length = key.size();
+    key.append(name);
+    return length;
+
+}// FieldMap::appendKey
+
+
+/*!
+ * Append a name and an array index to a key
+ * \param key is appended with name[index].
+ * \param name is the name to append.
+ * \param index is the array index to append.
+ * \return the length of key before the name was appended.
+ */
+std::size_t FieldMap::appendKey(std::string& key, std::string_view name, unsigned index)
+{
+    char digits[16];
+    std::size_t length = key.size();
+
+    key.append(name).append(1, '[');
+    key.append(digits, std::to_chars(digits, digits + sizeof(digits), index).ptr).append(1, ']');
+    return length;
+
+}// FieldMap::appendKey
+
+
+/*!
+ * Append a name and two array indices to a key
+ * \param key is appended with name[index][index2].
+ * \param name is the name to append.
+ * \param index is the first array index to append.
+ * \param index2 is the second array index to append.
+ * \return the length of key before the name was appended.
+ */
+std::size_t FieldMap::appendKey(std::string& key, std::string_view name, unsigned index, unsigned index2)
+{
+    char digits[16];
+    std::size_t length = appendKey(key, name, index);
+
+    key.append(1, '[');
+    key.append(digits, std::to_chars(digits, digits + sizeof(digits), index2).ptr).append(1, ']');
+    return length;
+
+}// FieldMap::appendKey
+
+
+/*!
+ * Get a signed number from a map value
+ * \param value is the map value, which can be NULL.
+ * \param number receives the number, if the value is a number.
+ * \return true if number was set.
+ */
+bool fieldMapToSigned(const FieldMapValue* value, long long* number)
+{
+    if(value == nullptr)
+        return false;
+    else if(const long long* s = std::get_if<long long>(value))
+        (*number) = *s;
+    else if(const unsigned long long* u = std::get_if<unsigned long long>(value))
+        (*number) = (long long)(*u);
+    else if(const double* d = std::get_if<double>(value))
+        (*number) = (long long)(*d);
+    else
+        return false;
+
+    return true;
+
+}// fieldMapToSigned
+
+
+/*!
+ * Get an unsigned number from a map value
+ * \param value is the map value, which can be NULL.
+ * \param number receives the number, if the value is a number.
+ * \return true if number was set.
+ */
+bool fieldMapToUnsigned(const FieldMapValue* value, unsigned long long* number)
+{
+    if(value == nullptr)
+        return false;
+    else if(const unsigned long long* u = std::get_if<unsigned long long>(value))
+        (*number) = *u;
+    else if(const long long* s = std::get_if<long long>(value))
+        (*number) = (unsigned long long)(*s);
+    else if(const double* d = std::get_if<double>(value))
+        (*number) = (unsigned long long)(*d);
+    else
+        return false;
+
+    return true;
+
+}// fieldMapToUnsigned
+
+
+/*!
+ * Get a floating point number from a map value
+ * \param value is the map value, which can be NULL.
+ * \param number receives the number, if the value is a number.
+ * \return true if number was set.
+ */
+bool fieldMapToDouble(const FieldMapValue* value, double* number)
+{
+    if(value == nullptr)
+        return false;
+    else if(const double* d = std::get_if<double>(value))
+        (*number) = *d;
+    else if(const long long* s = std::get_if<long long>(value))
+        (*number) = (double)(*s);
+    else if(const unsigned long long* u = std::get_if<unsigned long long>(value))
+        (*number) = (double)(*u);
+    else
+        return false;
+
+    return true;
+
+}// fieldMapToDouble
+
+
+/*!
+ * Copy a string from a map value
+ * \param value is the map value, which can be NULL.
+ * \param text receives the string, if the value is a string. text is always
+ *        null terminated, and is truncated if needed.
+ * \param size is the number of bytes text can hold, including the terminator.
+ * \return true if text was set.
+ */
+bool fieldMapToString(const FieldMapValue* value, char* text, std::size_t size)
+{
+    const std::string* string = (value == nullptr) ? nullptr : std::get_if<std::string>(value);
+
+    if((string == nullptr) || (size == 0))
+        return false;
+
+    std::size_t length = (string->size() < size) ? string->size() : size - 1;
+
+    memcpy(text, string->data(), length);
+    text[length] = '\0';
+
+    return true;
+
+}// fieldMapToString
+)===");
+
+    source.makeLineSeparator();
+
+    return source.flush();
+
+}// ProtocolFieldMap::generateSource
@@ -0,0 +1,41 @@
+#ifndef PROTOCOLFIELDMAP_H
+#define PROTOCOLFIELDMAP_H
+
+/*!
+ * \file
+ * Auto magically generate the key:value map used by the map functions when
+ * Qt is not used.
+ */
+
+#include "protocolfile.h"
+#include "protocolsupport.h"
+#include <string>
+#include <vector>
+
+/*!
+ * The field map module is a flat (open addressing) hash map from string keys
+ * to numeric or string values, which the generated mapEncode and mapDecode
+ * functions use in place of Qt's QVariantMap when the protocol sets `stdMap`.
+ */
+class ProtocolFieldMap
+{
+public:
+    ProtocolFieldMap(const ProtocolSupport& protocolsupport);
+
+    //! Perform the generation, writing out the files
+    bool generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList);
+
+protected:
+
+    //! Generate the header file
+    bool generateHeader(void);
+
+    //! Generate the source file
+    bool generateSource(void);
+
+    ProtocolHeaderFile header;
+    ProtocolSourceFile source;
+    const ProtocolSupport& support;
+};
+
+#endif // PROTOCOLFIELDMAP_H
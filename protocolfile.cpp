@@ -12,8 +12,9 @@ std::string ProtocolFile::tempprefix = "temporarydeleteme_";
  * \param supported are the Protocol-wide options.
  * \param temp should be true for this file to be a temp file
  */
-ProtocolFile::ProtocolFile(const std::string& moduleName, ProtocolSupport supported, bool temp) :
+ProtocolFile::ProtocolFile(const std::string& moduleName, const ProtocolSupport& supported, bool temp) :
     support(supported),
+    language(supported.language),
     module(moduleName),
     dirty(false),
     appending(false),
@@ -27,8 +28,9 @@ ProtocolFile::ProtocolFile(const std::string& moduleName, ProtocolSupport suppor
  * or a file will not be created
  * \param supported are the Protocol-wide options.
  */
-ProtocolFile::ProtocolFile(ProtocolSupport supported) :
+ProtocolFile::ProtocolFile(const ProtocolSupport& supported) :
     support(supported),
+    language(supported.language),
     dirty(false),
     appending(false),
     temporary(true),
@@ -39,7 +41,7 @@ ProtocolFile::ProtocolFile(ProtocolSupport supported) :
 
 void ProtocolFile::setModuleNameAndPath(std::string name, std::string filepath)
 {
-    setModuleNameAndPath(std::string(), name, filepath, support.language);
+    setModuleNameAndPath(std::string(), name, filepath, language);
 }
 
 void ProtocolFile::setModuleNameAndPath(std::string name, std::string filepath, ProtocolSupport::LanguageType languageoverride)
@@ -49,7 +51,7 @@ void ProtocolFile::setModuleNameAndPath(std::string name, std::string filepath,
 
 void ProtocolFile::setModuleNameAndPath(std::string prefix, std::string name, std::string filepath)
 {
-    setModuleNameAndPath(prefix, name, filepath, support.language);
+    setModuleNameAndPath(prefix, name, filepath, language);
 }
 
 void ProtocolFile::setModuleNameAndPath(std::string prefix, std::string name, std::string filepath, ProtocolSupport::LanguageType languageoverride)
@@ -57,7 +59,7 @@ void ProtocolFile::setModuleNameAndPath(std::string prefix, std::string name, st
     // Remove any contents we currently have
     clear();
 
-    support.language = languageoverride;
+    language = languageoverride;
 
     // Clean it all up
     separateModuleNameAndPath(name, filepath);
@@ -232,7 +234,7 @@ void ProtocolFile::writeIncludeDirective(const std::string& include, const std::
     // Technically things other than .h* could be included, but not by ProtoGen
     if(!contains(directive, ".h") && autoextension)
     {
-        if(support.language == ProtocolSupport::cpp_language)
+        if(language == ProtocolSupport::cpp_language)
             directive += ".hpp";
         else
             directive += ".h";
@@ -620,7 +622,7 @@ void ProtocolHeaderFile::extractExtension(std::string& name)
     // A header file extension must start with ".h" (.h, .hpp, .hxx, etc.)
     if(!contains(extension, ".h"))
     {
-        if(support.language == ProtocolSupport::cpp_language)
+        if(language == ProtocolSupport::cpp_language)
             extension = ".hpp";
         else
             extension = ".h";
@@ -692,7 +694,7 @@ std::string ProtocolHeaderFile::getClosingStatement(void)
 {
     std::string close;
 
-    if(support.language == ProtocolSupport::c_language)
+    if(language == ProtocolSupport::c_language)
     {
         // close the __cplusplus
         close += "#ifdef __cplusplus\n";
@@ -759,14 +761,14 @@ void ProtocolHeaderFile::prepareToAppend(void)
         write("#ifndef " + define + "\n");
         write("#define " + define + "\n");
 
-        if(support.language == ProtocolSupport::c_language)
+        if(language == ProtocolSupport::c_language)
         {
             write("\n// Language target is C, C++ compilers: don't mangle us\n");
             write("#ifdef __cplusplus\n");
             write("extern \"C\" {\n");
             write("#endif\n\n");
         }
-        else if(support.language == ProtocolSupport::cpp_language)
+        else if(language == ProtocolSupport::cpp_language)
         {
             write("\n// Language target is C++\n\n");
         }
@@ -777,10 +779,10 @@ void ProtocolHeaderFile::prepareToAppend(void)
         write(" */\n");
         write("\n");
 
-        if((support.language == ProtocolSupport::c_language) || (support.language == ProtocolSupport::cpp_language))
+        if((language == ProtocolSupport::c_language) || (language == ProtocolSupport::cpp_language))
             writeIncludeDirective("stdint.h", "", true);
 
-        if(support.supportbool && (support.language == ProtocolSupport::c_language))
+        if(support.supportbool && (language == ProtocolSupport::c_language))
             writeIncludeDirective("stdbool.h", "", true);
 
         makeLineSeparator();
@@ -797,7 +799,7 @@ void ProtocolSourceFile::extractExtension(std::string& name)
 {
     ProtocolFile::extractExtension(name);
 
-    if(support.language == ProtocolSupport::cpp_language)
+    if(language == ProtocolSupport::cpp_language)
     {
         // We cannot allow the .c extension for c++
         if(extension.empty() || endsWith(extension, ".c"))
@@ -9,10 +9,10 @@ class ProtocolFile
 {
 public:
     //! Construct the protocol file
-    ProtocolFile(const std::string& moduleName, ProtocolSupport supported, bool temporary = true);
+    ProtocolFile(const std::string& moduleName, const ProtocolSupport& supported, bool temporary = true);
 
     //! Construct the protocol file
-    ProtocolFile(ProtocolSupport supported);
+    ProtocolFile(const ProtocolSupport& supported);
 
     //! Destructor that performs the actual file write
     virtual ~ProtocolFile();
@@ -94,6 +94,12 @@ public:
 
 protected:
 
+    //! The code emitter appends directly to our contents
+    friend class CodeEmitter;
+
+    //! Get the contents for a code emitter to append to, marking the file as dirty and non-trivial
+    std::string& getEmitterBuffer(void) {hasNontrivialContent = dirty = true; return contents;}
+
     //! Append to the current contents of the file
     void writeInternal(const std::string& text);
 
@@ -107,7 +113,10 @@ protected:
     std::string fileNameAndPathOnDisk(void) const;
 
     //! Protocol wide support details
-    ProtocolSupport support;
+    const ProtocolSupport& support;
+
+    //! The language of this file, which can be different than the protocol language
+    ProtocolSupport::LanguageType language;
 
     //! The file extension
     std::string extension;
@@ -141,7 +150,7 @@ class ProtocolHeaderFile : public ProtocolFile
 public:
 
     //! Construct the protocol header file
-    ProtocolHeaderFile(ProtocolSupport supported) : ProtocolFile(supported){}
+    ProtocolHeaderFile(const ProtocolSupport& supported) : ProtocolFile(supported){}
 
     //! Destructor that performs the actual file write
     ~ProtocolHeaderFile() override;
@@ -173,7 +182,7 @@ class ProtocolSourceFile : public ProtocolFile
 public:
 
     //! Construct the protocol header file
-    ProtocolSourceFile(ProtocolSupport supported) : ProtocolFile(supported){}
+    ProtocolSourceFile(const ProtocolSupport& supported) : ProtocolFile(supported){}
 
     //! Destructor that performs the actual file write
     ~ProtocolSourceFile() override;
@@ -1,6 +1,6 @@
 #include "protocolfloatspecial.h"
 
-ProtocolFloatSpecial::ProtocolFloatSpecial(ProtocolSupport protocolsupport) :
+ProtocolFloatSpecial::ProtocolFloatSpecial(const ProtocolSupport& protocolsupport) :
     header(protocolsupport),
     source(protocolsupport),
     support(protocolsupport)
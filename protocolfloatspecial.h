@@ -14,7 +14,7 @@
 class ProtocolFloatSpecial
 {
 public:
-    ProtocolFloatSpecial(ProtocolSupport protocolsupport);
+    ProtocolFloatSpecial(const ProtocolSupport& protocolsupport);
 
     //! Perform the generation, writing out the files
     bool generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList);
@@ -29,7 +29,7 @@ protected:
 
     ProtocolHeaderFile header;
     ProtocolSourceFile source;
-    ProtocolSupport support;
+    const ProtocolSupport& support;
 };
 
 #endif // PROTOCOLFLOATSPECIAL_H
@@ -15,20 +15,21 @@
  * \param bigendian should be true to encode multi-byte fields with the most
  *        significant byte first.
  */
-ProtocolPacket::ProtocolPacket(ProtocolParser* parse, ProtocolSupport supported) :
+ProtocolPacket::ProtocolPacket(ProtocolParser* parse, const ProtocolSupport& supported) :
     ProtocolStructureModule(parse, supported),
     useInOtherPackets(false),
     parameterFunctions(false),
     structureFunctions(true),
+    resumable(false),
+    delta(false),
     dbctxon(false),
     dbcrxon(false)
 {
     // These are attributes on top of the normal structureModule that we support
-    std::vector<std::string> newattribs({"structureInterface", "parameterInterface", "ID", "useInOtherPackets"});
+    static const AttributeKeys packetattributes(*attriblist, {"structureInterface", "parameterInterface", "ID", "useInOtherPackets", "resumable", "delta"});
 
-    // Now append the new attributes onto our old list
-    // Now append the new attributes onto our old list
-    attriblist.insert(attriblist.end(), newattribs.begin(), newattribs.end());
+    // Now use the new attributes plus our old list
+    attriblist = &packetattributes;
 }
 
 
@@ -47,20 +48,12 @@ void ProtocolPacket::clear(void)
     useInOtherPackets = false;
     parameterFunctions = false;
     structureFunctions = true;
+    resumable = false;
+    delta = false;
     dbctxon = false;
     dbcrxon = false;
 
-    // Delete all the objects in the list
-    for(std::size_t i = 0; i < documentList.size(); i++)
-    {
-        if(documentList[i] != nullptr)
-        {
-            delete documentList[i];
-            documentList[i] = nullptr;
-        }
-    }
-
-    // clear the list
+    // clear the list, the objects are owned by the arena of the parser
     documentList.clear();
 
     // Note that data set during constructor are not changed
@@ -88,7 +81,7 @@ void ProtocolPacket::parse(bool nocode)
     // re-implementation of ProtocolStructureModule with different rules.
     ProtocolStructure::parse(nocode);
 
-    const XMLAttribute* map = e->FirstAttribute();
+    AttributeIndex map(e->FirstAttribute(), *attriblist);
 
     std::string moduleName = ProtocolParser::getAttribute("file", map);
     std::string defheadermodulename = ProtocolParser::getAttribute("deffile", map);
@@ -96,6 +89,7 @@ void ProtocolPacket::parse(bool nocode)
     std::string comparemodulename = ProtocolParser::getAttribute("comparefile", map);
     std::string printmodulename = ProtocolParser::getAttribute("printfile", map);
     std::string mapmodulename = ProtocolParser::getAttribute("mapfile", map);
+    std::string jsonmodulename = ProtocolParser::getAttribute("jsonfile", map);
 
     encode = !ProtocolParser::isFieldClear(ProtocolParser::getAttribute("encode", map));
     decode = !ProtocolParser::isFieldClear(ProtocolParser::getAttribute("decode", map));
@@ -109,33 +103,39 @@ void ProtocolPacket::parse(bool nocode)
     // It is possible to suppress the globally specified compare output
     if(ProtocolParser::isFieldClear(ProtocolParser::getAttribute("compare", map)))
     {
-        support.compare = compare = false;
+        compare = false;
         comparemodulename.clear();
-        support.globalCompareName.clear();
     }
-    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("compare", map)))
+    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("compare", map)) || !support.globalCompareName.empty() || support.compare)
         compare = true;
 
     // It is possible to suppress the globally specified print output
     if(ProtocolParser::isFieldClear(ProtocolParser::getAttribute("print", map)))
     {
-        support.print = print = false;
+        print = false;
         printmodulename.clear();
-        support.globalPrintName.clear();
     }
-    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("print", map)))
+    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("print", map)) || !support.globalPrintName.empty() || support.print)
         print = true;
 
     // It is possible to suppress the globally specified map output
     if(ProtocolParser::isFieldClear(ProtocolParser::getAttribute("map", map)))
     {
-        support.mapEncode = mapEncode = false;
+        mapEncode = false;
         mapmodulename.clear();
-        support.globalMapName.clear();
     }
-    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("map", map)))
+    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("map", map)) || !support.globalMapName.empty() || support.mapEncode)
         mapEncode = true;
 
+    // It is possible to suppress the globally specified JSON output
+    if(ProtocolParser::isFieldClear(ProtocolParser::getAttribute("json", map)))
+    {
+        json = false;
+        jsonmodulename.clear();
+    }
+    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("json", map)) || !support.globalJsonName.empty() || support.json)
+        json = true;
+
     useInOtherPackets = ProtocolParser::isFieldSet("useInOtherPackets", map);
     std::string redefinename = ProtocolParser::getAttribute("redefine", map);
 
@@ -201,6 +201,55 @@ void ProtocolPacket::parse(bool nocode)
             parameterFunctions = true;
     }
 
+    // The resumable decoder can be turned on for all packets, and suppressed for this one
+    if(ProtocolParser::isFieldClear(ProtocolParser::getAttribute("resumable", map)))
+        resumable = false;
+    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("resumable", map)) || support.resumable)
+        resumable = true;
+
+    // The resumable decoder is part of the structure interface, and needs something to decode
+    if(!decode || !structureFunctions || (getNumberOfDecodeParameters() <= 0))
+        resumable = false;
+
+    // The delta encoding can be turned on for all packets, and suppressed for this one
+    if(ProtocolParser::isFieldClear(ProtocolParser::getAttribute("delta", map)))
+        delta = false;
+    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("delta", map)) || support.delta)
+        delta = true;
+
+    // The delta encoding is part of the structure interface, and needs something to send
+    if((!encode && !decode) || !structureFunctions || (getNumberOfEncodeParameters() <= 0) || (getNumberOfDeltaBits() <= 0))
+        delta = false;
+
+    // It is possible to suppress the globally specified hash output
+    if(ProtocolParser::isFieldClear(ProtocolParser::getAttribute("hash", map)))
+        hash = false;
+    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("hash", map)) || support.hash)
+        hash = true;
+
+    // It is possible to suppress the globally specified encoded size output
+    if(ProtocolParser::isFieldClear(ProtocolParser::getAttribute("encodedSize", map)))
+        encodedSize = false;
+    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("encodedSize", map)) || support.encodedSize)
+        encodedSize = true;
+
+    // It is possible to suppress the globally specified skip output
+    if(ProtocolParser::isFieldClear(ProtocolParser::getAttribute("skip", map)))
+        skipEncoded = false;
+    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("skip", map)) || support.skip)
+        skipEncoded = true;
+
+    // The resumable decoder skips the steps it does not need with the skip functions of the children
+    if(resumable)
+        skipEncoded = true;
+
+    // The hash is a function of the structure, which parameter packets do not have
+    if(!structureFunctions && !useInOtherPackets)
+        hash = false;
+
+    // The C++ constructor can leave the members to be set by initialize()
+    noinit = ProtocolParser::isFieldSet(ProtocolParser::getAttribute("noInit", map));
+
     if(!redefinename.empty())
     {
         if(redefinename == name)
@@ -238,7 +287,14 @@ void ProtocolPacket::parse(bool nocode)
     // Most of the file setup work. This will also declare the structure if
     // warranted (note the details of the structure declaration will reflect
     // back to this class via virtual functions).
-    setupFiles(moduleName, defheadermodulename, verifymodulename, comparemodulename, printmodulename, mapmodulename, structureFunctions, false);
+    setupFiles(moduleName, defheadermodulename, verifymodulename, comparemodulename, printmodulename, mapmodulename, jsonmodulename, structureFunctions, false);
+
+    // The file names are known now, which is all that other modules need from us
+    if(unchanged)
+    {
+        discardFiles();
+        return;
+    }
 
     // The functions that include structures which are children of this
     // packet. These need to be declared before the main functions
@@ -327,6 +383,15 @@ void ProtocolPacket::parse(bool nocode)
             mapSource->flush();
     }
 
+    if(json)
+    {
+        if(jsonHeader != nullptr)
+            jsonHeader->flush();
+
+        if(jsonSource != nullptr)
+            jsonSource->flush();
+    }
+
 }// ProtocolPacket::parse
 
 
@@ -419,6 +484,22 @@ std::string ProtocolPacket::getClassDeclaration_CPP(void) const
             ProtocolFile::makeLineSeparator(output);
         }
 
+        if(resumable)
+        {
+            ProtocolFile::makeLineSeparator(output);
+            output += getResumableDecoderDeclaration(TAB_IN);
+            ProtocolFile::makeLineSeparator(output);
+            output += getResumableDecoderPrototypes(TAB_IN);
+            ProtocolFile::makeLineSeparator(output);
+        }
+
+        if(delta)
+        {
+            ProtocolFile::makeLineSeparator(output);
+            output += getDeltaPrototypes(TAB_IN);
+            ProtocolFile::makeLineSeparator(output);
+        }
+
     }// if structure packet functions
 
     // Packet version of compare function
@@ -455,10 +536,20 @@ std::string ProtocolPacket::getClassDeclaration_CPP(void) const
             ProtocolFile::makeLineSeparator(output);
             output += ProtocolStructure::getDecodeFunctionPrototype(TAB_IN, false);
             ProtocolFile::makeLineSeparator(output);
+            output += ProtocolStructure::getSkipFunctionPrototype(TAB_IN, false);
+            ProtocolFile::makeLineSeparator(output);
         }
 
     }// If structure functions that will be accessed by others
 
+    // The exact encoded size, so buffers can be sized before encoding
+    if(encode && encodedSize && (useInOtherPackets || structureFunctions))
+    {
+        ProtocolFile::makeLineSeparator(output);
+        output += ProtocolStructure::getEncodedSizeFunctionPrototype(TAB_IN, false);
+        ProtocolFile::makeLineSeparator(output);
+    }
+
     // There are cool utility functions: verify, print, read, mapencde,
     // mapdecode, and compare. All of these have forms that come from
     // ProtocolStructure. Thse functions are only output for the base class,
@@ -499,6 +590,22 @@ std::string ProtocolPacket::getClassDeclaration_CPP(void) const
             ProtocolFile::makeLineSeparator(output);
         }
 
+        if(json)
+        {
+            ProtocolFile::makeLineSeparator(output);
+            output += ProtocolStructure::getJsonEncodeFunctionPrototype(TAB_IN, false);
+            ProtocolFile::makeLineSeparator(output);
+            output += ProtocolStructure::getJsonDecodeFunctionPrototype(TAB_IN, false);
+            ProtocolFile::makeLineSeparator(output);
+        }
+
+        if(hash)
+        {
+            ProtocolFile::makeLineSeparator(output);
+            output += ProtocolStructure::getHashFunctionPrototype(TAB_IN, false);
+            ProtocolFile::makeLineSeparator(output);
+        }
+
         ProtocolFile::makeLineSeparator(output);
 
         // Finally the local members of this class. Notice that if we only have
@@ -621,7 +728,8 @@ void ProtocolPacket::createTopLevelInitializeFunction(void)
         if((support.language == ProtocolSupport::c_language) || ((getNumberInMemory() > 0) && (useInOtherPackets || structureFunctions)))
         {
             verifySource->makeLineSeparator();
-            verifySource->write(getSetToInitialValueFunctionBody(false));
+            CodeEmitter initoutput(*verifySource);
+            emitSetToInitialValueFunctionBody(initoutput, false);
             verifySource->makeLineSeparator();
             verifySource->write(getSecondSetToInitialValueFunctionBody(false));
             verifySource->makeLineSeparator();
@@ -651,7 +759,8 @@ void ProtocolPacket::createTopLevelStructureFunctions(void)
             }
 
             source.makeLineSeparator();
-            source.write(getEncodeFunctionBody(false));
+            CodeEmitter encodeoutput(source);
+            emitEncodeFunctionBody(encodeoutput, false);
         }
 
         if(decode)
@@ -661,10 +770,16 @@ void ProtocolPacket::createTopLevelStructureFunctions(void)
             {
                 header.makeLineSeparator();
                 header.write(getDecodeFunctionPrototype(std::string(), false));
+                header.makeLineSeparator();
+                header.write(getSkipFunctionPrototype(std::string(), false));
             }
 
             source.makeLineSeparator();
-            source.write(getDecodeFunctionBody(false));
+            CodeEmitter decodeoutput(source);
+            emitDecodeFunctionBody(decodeoutput, false);
+            source.makeLineSeparator();
+            CodeEmitter skipoutput(source);
+            emitSkipFunctionBody(skipoutput, false);
         }
 
         header.makeLineSeparator();
@@ -672,11 +787,75 @@ void ProtocolPacket::createTopLevelStructureFunctions(void)
 
     }// if we are not suppressing the encode and decode functions
 
+    // The exact encoded size, so buffers can be sized before encoding
+    if(encode && encodedSize && (useInOtherPackets || structureFunctions))
+    {
+        // In C++ this is part of the class declaration
+        if(support.language == ProtocolSupport::c_language)
+        {
+            header.makeLineSeparator();
+            header.write(getEncodedSizeFunctionPrototype(std::string(), false));
+        }
+
+        source.makeLineSeparator();
+        CodeEmitter sizeoutput(source);
+        emitEncodedSizeFunctionBody(sizeoutput, false);
+        header.makeLineSeparator();
+        source.makeLineSeparator();
+    }
+
     createTopLevelStructureHelperFunctions();
 
 }// ProtocolPacket::createTopLevelStructureFunctions
 
 
+/*!
+ * Determine if the encode and decode of this packet can be timed by the
+ * bench module, which uses the structure packet functions.
+ * \return true if the bench module can time this packet
+ */
+bool ProtocolPacket::isBenchable(void) const
+{
+    return structureFunctions && ProtocolStructureModule::isBenchable();
+}
+
+
+/*!
+ * Return the function that times the encode and decode of this packet,
+ * using the packet provided by the caller of the bench module.
+ * \return the function, or an empty string if this packet cannot be timed
+ */
+std::string ProtocolPacket::getBenchFunctionBody(void) const
+{
+    if(!isBenchable())
+        return std::string();
+
+    // Packets with more than one identifier are encoded with the first one
+    std::string id;
+    if(ids.size() > 1)
+        id = ", " + ids.at(0);
+
+    // The caller's packet may not be large enough for every packet
+    if(support.language == ProtocolSupport::c_language)
+    {
+        return createBenchFunction("packet", std::string(),
+                                   "encode" + support.prefix + name + support.packetStructureSuffix + "(pkt, &user" + id + ");",
+                                   "decode" + support.prefix + name + support.packetStructureSuffix + "(pkt, &user);",
+                                   "get" + support.protoName + "PacketSize(pkt)",
+                                   "get" + support.prefix + name + "MinDataLength()",
+                                   "get" + support.prefix + name + "MaxDataLength()");
+    }
+    else
+    {
+        return createBenchFunction("packet", std::string(), "user.encode(pkt" + id + ");", "user.decode(pkt);",
+                                   "get" + support.protoName + "PacketSize(pkt)",
+                                   typeName + "::minLength()",
+                                   typeName + "::maxLength()");
+    }
+
+}// ProtocolPacket::getBenchFunctionBody
+
+
 /*!
  * Create the functions for encoding and decoding the packet to/from a structure
  */
@@ -706,6 +885,22 @@ void ProtocolPacket::createStructurePacketFunctions(void)
             header.write(getStructurePacketDecodePrototype(std::string()));
         }
 
+        if(resumable)
+        {
+            // The state and functions of the resumable decoder
+            header.makeLineSeparator();
+            header.write(getResumableDecoderDeclaration(std::string()));
+            header.makeLineSeparator();
+            header.write(getResumableDecoderPrototypes(std::string()));
+        }
+
+        if(delta)
+        {
+            // The functions of the delta encoding
+            header.makeLineSeparator();
+            header.write(getDeltaPrototypes(std::string()));
+        }
+
         if(compare && compareHeader != nullptr)
         {
             compareHeader->makeLineSeparator();
@@ -739,7 +934,32 @@ void ProtocolPacket::createStructurePacketFunctions(void)
     {
         // The source function for the decode function
         source.makeLineSeparator();
-        source.write(getStructurePacketDecodeBody());
+        CodeEmitter decodeoutput(source);
+        emitStructurePacketDecodeBody(decodeoutput);
+    }
+
+    if(resumable)
+    {
+        // The functions of the resumable decoder
+        if(support.language == ProtocolSupport::c_language)
+            source.writeIncludeDirective("string.h", std::string(), true, false);
+        else
+            source.writeIncludeDirective("cstring", std::string(), true, false);
+
+        source.makeLineSeparator();
+        source.write(getResumableDecoderBody());
+    }
+
+    if(delta)
+    {
+        // The functions of the delta encoding
+        if(support.language == ProtocolSupport::c_language)
+            source.writeIncludeDirective("string.h", std::string(), true, false);
+        else
+            source.writeIncludeDirective("cstring", std::string(), true, false);
+
+        source.makeLineSeparator();
+        source.write(getDeltaBody());
     }
 
     if(compare && (compareSource != nullptr))
@@ -901,18 +1121,28 @@ void ProtocolPacket::createStructurePacketFunctions(void)
             printSource->write(TAB_IN + "}\n");
         }
 
+        if(numDecodes > 0)
+        {
+            int lines = 1;
+            int length = getTextPrintContentsLength(&lines) + 32;
+
+            printSource->makeLineSeparator();
+            printSource->write(TAB_IN + "// The estimated size of the report, every line of which includes the prename\n");
+            printSource->write(TAB_IN + "_pg_report.reserve(" + std::to_string(length) + " + " + std::to_string(lines) + "*_pg_prename.size());\n");
+        }
+
         printSource->makeLineSeparator();
         printSource->write(TAB_IN + "// Print the packet size\n");
-        printSource->write(TAB_IN + "_pg_report += _pg_prename + \" packet size is \" + std::to_string(get" + support.protoName + "PacketSize(_pg_pkt)) + \"\\n\";\n");
+        printSource->write(TAB_IN + "_pg_report.append(_pg_prename).append(\" packet size is \").append(std::to_string(get" + support.protoName + "PacketSize(_pg_pkt))).append(\"\\n\");\n");
 
         if(numDecodes > 0)
         {
             printSource->makeLineSeparator();
 
             if(support.language == ProtocolSupport::c_language)
-                printSource->write(TAB_IN + "_pg_report += textPrint" + structName + "(_pg_prename, &_pg_user);\n");
+                printSource->write(TAB_IN + "textPrint" + structName + "(_pg_report, _pg_prename, &_pg_user);\n");
             else
-                printSource->write(TAB_IN + "_pg_report += _pg_user.textPrint(_pg_prename);\n");
+                printSource->write(TAB_IN + "_pg_user.textPrint(_pg_report, _pg_prename);\n");
         }
 
         printSource->makeLineSeparator();
@@ -1149,15 +1379,13 @@ std::string ProtocolPacket::getStructurePacketDecodePrototype(const std::string&
 
 
 /*!
- * Get the body for the structure packet decode function
- * \return The body of the function that decodes this packet from a structure or class.
+ * Output the body for the structure packet decode function
+ * \param output receives the body of the function that decodes this packet from a structure or class.
  */
-std::string ProtocolPacket::getStructurePacketDecodeBody(void) const
+void ProtocolPacket::emitStructurePacketDecodeBody(CodeEmitter& output) const
 {
-    std::string output;
-
     if(!decode)
-        return output;
+        return;
 
     // The string that gets the identifier for the packet, if there is only one
     std::string id;
@@ -1172,89 +1400,76 @@ std::string ProtocolPacket::getStructurePacketDecodeBody(void) const
     // Check if there is anything that is encoded, if not, we use a different form of the function
     if(getNumberOfEncodes() > 0)
     {
-        output += "/*!\n";
-        output += " * \\brief " + getPacketDecodeBriefComment() + "\n";
-        output += " *\n";
-        output += ProtocolParser::outputLongComment(" * ", comment) + "\n";
-        output += " * \\param _pg_pkt points to the packet being decoded by this function\n";
+        output.line("/*!");
+        output.line(" * \\brief ", getPacketDecodeBriefComment());
+        output.line(" *");
+        output.line(ProtocolParser::outputLongComment(" * ", comment));
+        output.line(" * \\param _pg_pkt points to the packet being decoded by this function");
         if((getNumberOfDecodeParameters() > 0) && (support.language == ProtocolSupport::c_language))
-            output += " * \\param _pg_user receives the data decoded from the packet\n";
-        output += " * \\return " + getReturnCode(false) + " is returned if the packet ID or size is wrong, else " + getReturnCode(true) + "\n";
-        output += " */\n";
-        output += getStructurePacketDecodeSignature(true) + "\n";
-        output += "{\n";
-        output += TAB_IN + "int _pg_numbytes;\n";
-        output += TAB_IN + "int _pg_byteindex = 0;\n";
-        output += TAB_IN + "const uint8_t* _pg_data;\n";
+            output.line(" * \\param _pg_user receives the data decoded from the packet");
+        output.line(" * \\return ", getReturnCode(false), " is returned if the packet ID or size is wrong, else ", getReturnCode(true));
+        output.line(" */");
+        output.line(getStructurePacketDecodeSignature(true));
+        output.line("{");
+        output.indent();
+        output.line("int _pg_numbytes;");
+        output.line("int _pg_byteindex = 0;");
+        output.line("const uint8_t* _pg_data;");
 
         if(usestempdecodebitfields)
-            output += TAB_IN + "unsigned int _pg_tempbitfield = 0;\n";
+            output.line("unsigned int _pg_tempbitfield = 0;");
 
         if(usestempdecodelongbitfields)
-            output += TAB_IN + "uint64_t _pg_templongbitfield = 0;\n";
+            output.line("uint64_t _pg_templongbitfield = 0;");
 
         if(numbitfieldgroupbytes > 0)
         {
-            output += TAB_IN + "int _pg_bitfieldindex = 0;\n";
-            output += TAB_IN + "uint8_t _pg_bitfieldbytes[" + std::to_string(numbitfieldgroupbytes) + "];\n";
+            output.line("int _pg_bitfieldindex = 0;");
+            output.line("uint8_t _pg_bitfieldbytes[", numbitfieldgroupbytes, "];");
         }
 
         if(needsDecodeIterator)
-            output += TAB_IN + "unsigned _pg_i = 0;\n";
+            output.line("unsigned _pg_i = 0;");
         if(needs2ndDecodeIterator)
-            output += TAB_IN + "unsigned _pg_j = 0;\n";
-        output += "\n";
+            output.line("unsigned _pg_j = 0;");
+        output.append("\n");
 
-        if(ids.size() <= 1)
-        {
-            output += TAB_IN + "// Verify the packet identifier\n";
-            output += TAB_IN + "if(get"+ support.protoName + "PacketID(_pg_pkt) != " + id + ")\n";
-        }
-        else
-        {
-            output += TAB_IN + "// Verify the packet identifier, multiple options exist\n";
-            output += TAB_IN + "uint32_t _pg_packetid = get"+ support.protoName + "PacketID(_pg_pkt);\n";
-            output += TAB_IN + "if( _pg_packetid != " + ids.at(0);
-            for(std::size_t i = 1; i < ids.size(); i++)
-                output += " &&\n" + TAB_IN + TAB_IN + "_pg_packetid != " + ids.at(i);
-            output += " )\n";
-        }
-        output += TAB_IN + TAB_IN + "return " + getReturnCode(false) + ";\n";
-        output += "\n";
-        output += TAB_IN + "// Verify the packet size\n";
-        output += TAB_IN + "_pg_numbytes = get" + support.protoName + "PacketSize(_pg_pkt);\n";
+        emitPacketIdentifierCheck(output, id);
+        output.append("\n");
+        output.line("// Verify the packet size");
+        output.line("_pg_numbytes = get", support.protoName, "PacketSize(_pg_pkt);");
         if(support.language == ProtocolSupport::c_language)
-            output += TAB_IN + "if(_pg_numbytes < get" + support.prefix + name + "MinDataLength())\n";
+            output.line("if(_pg_numbytes < get", support.prefix, name, "MinDataLength())");
         else
-            output += TAB_IN + "if(_pg_numbytes < minLength())\n";
-        output += TAB_IN + TAB_IN + "return " + getReturnCode(false) + ";\n";
-        output += "\n";
-        output += TAB_IN + "// The raw data from the packet\n";
-        output += TAB_IN + "_pg_data = get" + support.protoName + "PacketDataConst(_pg_pkt);\n";
-        output += "\n";
+            output.line("if(_pg_numbytes < minLength())");
+        output.line(TAB_IN, "return ", getReturnCode(false), ";");
+        output.append("\n");
+        output.line("// The raw data from the packet");
+        output.line("_pg_data = get", support.protoName, "PacketDataConst(_pg_pkt);");
+        output.append("\n");
         if(defaults)
         {
-            output += TAB_IN + "// this packet has default fields, make sure they are set\n";
+            output.line("// this packet has default fields, make sure they are set");
 
             for(std::size_t i = 0; i < encodables.size(); i++)
-                output += encodables[i]->getSetToDefaultsString(true);
+                output.append(encodables[i]->getSetToDefaultsString(true));
 
         }// if defaults are used in this packet
 
-        ProtocolFile::makeLineSeparator(output);
+        output.makeLineSeparator();
 
         // Keep our own track of the bitcount so we know what to do when we close the bitfield
         int bitcount = 0;
         std::size_t i;
         for(i = 0; i < encodables.size(); i++)
         {
-            ProtocolFile::makeLineSeparator(output);
+            output.makeLineSeparator();
 
             // Encode just the nondefaults here
             if(encodables[i]->isDefault())
                 break;
 
-            output += encodables[i]->getDecodeString(&bitcount, true, true);
+            encodables[i]->emitDecodeString(output, &bitcount, true, true);
         }
 
         // Before we write out the decodes for default fields we need to check
@@ -1262,161 +1477,1311 @@ std::string ProtocolPacket::getStructurePacketDecodeBody(void) const
         // or dependent fields
         if((encodedLength.minEncodedLength != encodedLength.nonDefaultEncodedLength) && (i > 0))
         {
-            ProtocolFile::makeLineSeparator(output);
-            output += TAB_IN + "// Used variable length arrays or dependent fields, check actual length\n";
-            output += TAB_IN + "if(_pg_numbytes < _pg_byteindex)\n";
-            output += TAB_IN + TAB_IN + "return " + getReturnCode(false) + ";\n";
+            output.makeLineSeparator();
+            output.line("// Used variable length arrays or dependent fields, check actual length");
+            output.line("if(_pg_numbytes < _pg_byteindex)");
+            output.line(TAB_IN, "return ", getReturnCode(false), ";");
         }
 
         // Now finish the fields (if any defaults)
         for(; i < encodables.size(); i++)
         {
-            ProtocolFile::makeLineSeparator(output);
-            output += encodables[i]->getDecodeString(&bitcount, true, true);
+            output.makeLineSeparator();
+            encodables[i]->emitDecodeString(output, &bitcount, true, true);
         }
 
-        ProtocolFile::makeLineSeparator(output);
-        output += TAB_IN + "return " + getReturnCode(true) + ";\n";
+        output.makeLineSeparator();
+        output.line("return ", getReturnCode(true), ";");
+        output.unindent();
 
     }// if fields to decode
     else
     {
-        output += "/*!\n";
-        output += " * \\brief " + getPacketDecodeBriefComment() + "\n";
-        output += " *\n";
-        output += ProtocolParser::outputLongComment(" * ", comment) + "\n";
-        output += " * \\param _pg_pkt points to the packet being decoded by this function\n";
-        output += " * \\return " + getReturnCode(false) + " is returned if the packet ID is wrong, else " + getReturnCode(true) + "\n";
-        output += " */\n";
-        output += getStructurePacketDecodeSignature(true) + "\n";
-        output += "{\n";
-        if(ids.size() <= 1)
-        {
-            output += TAB_IN + "// Verify the packet identifier\n";
-            output += TAB_IN + "if(get"+ support.protoName + "PacketID(_pg_pkt) != " + id + ")\n";
-        }
-        else
-        {
-            output += TAB_IN + "// Verify the packet identifier, multiple options exist\n";
-            output += TAB_IN + "uint32_t _pg_packetid = get"+ support.protoName + "PacketID(_pg_pkt);\n";
-            output += TAB_IN + "if( _pg_packetid != " + ids.at(0);
-            for(std::size_t i = 1; i < ids.size(); i++)
-                output += " &&\n" + TAB_IN + TAB_IN + "_pg_packetid != " + ids.at(i);
-            output += " )\n";
-        }
-        output += TAB_IN + TAB_IN + "return " + getReturnCode(false) + ";\n";
-        output += TAB_IN + "else\n";
-        output += TAB_IN + TAB_IN + "return " + getReturnCode(true) + ";\n";
+        output.line("/*!");
+        output.line(" * \\brief ", getPacketDecodeBriefComment());
+        output.line(" *");
+        output.line(ProtocolParser::outputLongComment(" * ", comment));
+        output.line(" * \\param _pg_pkt points to the packet being decoded by this function");
+        output.line(" * \\return ", getReturnCode(false), " is returned if the packet ID is wrong, else ", getReturnCode(true));
+        output.line(" */");
+        output.line(getStructurePacketDecodeSignature(true));
+        output.line("{");
+        output.indent();
+        emitPacketIdentifierCheck(output, id);
+        output.line("else");
+        output.line(TAB_IN, "return ", getReturnCode(true), ";");
+        output.unindent();
 
     }// else if no fields to decode
 
-    ProtocolFile::makeLineSeparator(output);
+    output.makeLineSeparator();
     if(support.language == ProtocolSupport::c_language)
-        output += "}// decode" + support.prefix + name + support.packetStructureSuffix + "\n";
+        output.line("}// decode", support.prefix, name, support.packetStructureSuffix);
     else
-        output += "}// " + typeName + "::decode\n";
+        output.line("}// ", typeName, "::decode");
 
-    return output;
+}// ProtocolPacket::emitStructurePacketDecodeBody
+
+
+/*!
+ * Output the code that verifies the identifier of a packet being decoded,
+ * returning a failure if the identifier is wrong.
+ * \param output receives the code, indented by one level.
+ * \param id is the function that gets the identifier, used if the packet has only one identifier.
+ */
+void ProtocolPacket::emitPacketIdentifierCheck(CodeEmitter& output, const std::string& id) const
+{
+    if(ids.size() <= 1)
+    {
+        output.line("// Verify the packet identifier");
+        output.line("if(get", support.protoName, "PacketID(_pg_pkt) != ", id, ")");
+    }
+    else
+    {
+        output.line("// Verify the packet identifier, multiple options exist");
+        output.line("uint32_t _pg_packetid = get", support.protoName, "PacketID(_pg_pkt);");
+        output.append(TAB_IN, "if( _pg_packetid != ", ids.at(0));
+        for(std::size_t i = 1; i < ids.size(); i++)
+            output.append(" &&\n", TAB_IN, TAB_IN, "_pg_packetid != ", ids.at(i));
+        output.append(" )\n");
+    }
+    output.line(TAB_IN, "return ", getReturnCode(false), ";");
 
-}// ProtocolPacket::getStructurePacketDecodeBody
+}// ProtocolPacket::emitPacketIdentifierCheck
 
 
 /*!
- * Create the functions for encoding and decoding the packet to/from parameters
+ * Get the steps of the resumable decoder and of the delta encoding. Each step
+ * is a single encodable, except for a run of bitfields which is one step,
+ * because each bitfield depends on the bit count of the one before it.
+ * \param steps receives the index of the first encodable of each step. The
+ *        last entry is the number of encodables, so step i ends where step
+ *        i+1 begins.
  */
-void ProtocolPacket::createPacketFunctions(void)
+void ProtocolPacket::getEncodableSteps(std::vector<std::size_t>& steps) const
 {
-    // The prototypes in the header file are only needed for C,
-    // in C++ these prototypes are part of the class declaration.
-    if(support.language == ProtocolSupport::c_language)
+    steps.clear();
+
+    for(std::size_t i = 0; i < encodables.size(); i++)
     {
-        if(encode)
-        {
-            // The prototype for the packet encode function
-            header.makeLineSeparator();
-            header.write(getParameterPacketEncodePrototype(std::string()));
-        }
+        steps.push_back(i);
 
-        if(decode)
+        if(encodables.at(i)->isBitfield())
         {
-            // The prototype for the packet decode function
-            header.makeLineSeparator();
-            header.write(getParameterPacketDecodePrototype(std::string()));
+            while(((i + 1) < encodables.size()) && encodables.at(i + 1)->isBitfield())
+                i++;
         }
     }
 
-    if(encode)
-    {
-        source.makeLineSeparator();
-        source.write(getParameterPacketEncodeBody());
-    }
+    steps.push_back(encodables.size());
 
-    if(decode)
-    {
-        source.makeLineSeparator();
-        source.write(getParameterPacketDecodeBody());
+}// ProtocolPacket::getEncodableSteps
 
-    }// if decode function enabled
 
-}// createPacketFunctions
+/*!
+ * Determine if a step of the resumable decoder is an array which is decoded
+ * one element at a time, each element as a step of its own, so that the carry
+ * buffer of the decoder only needs to hold one element.
+ * \param steps are the steps from getEncodableSteps().
+ * \param step is the index of the step.
+ * \return true if the step is decoded one element at a time.
+ */
+bool ProtocolPacket::isElementStep(const std::vector<std::size_t>& steps, std::size_t step) const
+{
+    // A run of bitfields is always one step
+    if(steps.at(step + 1) - steps.at(step) != 1)
+        return false;
+
+    return encodables.at(steps.at(step))->isDecodedByElement();
+
+}// ProtocolPacket::isElementStep
 
 
 /*!
- * Get the signature of the packet encode function, without semicolon or
- * comments or line feed, for the prototype or actual function.
- * \param insource should be true to indicate this signature is in source code
- *        (i.e. not a prototype) which determines if the "_pg_" decoration is
- *        used as well as c++ access specifiers.
- * \return the encode signature
+ * Determine if any step of the resumable decoder is an array which is decoded
+ * one element at a time, in which case the decoder keeps the element index.
+ * \return true if any step is decoded one element at a time.
  */
-std::string ProtocolPacket::getParameterPacketEncodeSignature(bool insource) const
+bool ProtocolPacket::hasElementSteps(void) const
 {
-    std::string output;
-    std::string pg;
+    std::vector<std::size_t> steps;
+    getEncodableSteps(steps);
 
-    if(insource)
-        pg = "_pg_";
-
-    if(support.language == ProtocolSupport::c_language)
+    for(std::size_t i = 0; i + 1 < steps.size(); i++)
     {
-        output = "void encode" + support.prefix + name + support.packetParameterSuffix + "(" + support.pointerType + " " + pg + "pkt";
+        if(isElementStep(steps, i))
+            return true;
     }
-    else
-    {
-        // C++ class member, this function should be "static" as it does not depend on any variables in the class
-        if(!insource)
-            output += "static ";
 
-        output += "void ";
+    return false;
 
-        // In the source the function needs the class scope
-        if(insource)
-            output += typeName + "::";
+}// ProtocolPacket::hasElementSteps
 
-        output += "encode(" + support.pointerType + " " + pg + "pkt";
-    }
 
-    output += getDataEncodeParameterList();
+/*!
+ * Get the largest encoded length of one element of an array which the
+ * resumable decoder decodes one element at a time. This is the largest
+ * length of the array divided by the number of elements of its first
+ * dimension, an element of a 2d array is a row of the second dimension.
+ * \param encodable is the array.
+ * \return the length, as a number if it can be computed, else as an expression.
+ */
+std::string ProtocolPacket::getElementStepLength(const Encodable* encodable) const
+{
+    std::string length = "(" + encodable->encodedLength.maxEncodedLength + ")/(" + encodable->array + ")";
 
-    if(ids.size() <= 1)
-        output += ")";
+    bool ok = false;
+    double value = ShuntingYard::computeInfix(parser->replaceEnumerationNameWithValue(length), &ok);
+
+    if(ok)
+        return std::to_string((int)value);
     else
-        output += ", uint32_t " + pg + "id)";
+        return length;
 
-    return output;
-}
+}// ProtocolPacket::getElementStepLength
 
 
 /*!
- * Get the prototype for the parameter packet encode function
- * \param spacing is the offset for each line
- * \return the prototype including semicolon and line fees
+ * Get the declaration of the state of the resumable decoder. The state holds
+ * the step being decoded, the bytes decoded so far, and the bytes of a step
+ * which arrived in more than one fragment. The carry buffer is sized for the
+ * largest step, and an array is decoded one element at a time, so it is much
+ * smaller than the packet when the packet has many fields or long arrays.
+ * \param spacing is the offset for each line.
+ * \return the declaration, a typedef structure for C, or a nested structure for C++.
  */
-std::string ProtocolPacket::getParameterPacketEncodePrototype(const std::string& spacing) const
+std::string ProtocolPacket::getResumableDecoderDeclaration(const std::string& spacing) const
 {
-    std::string output;
+    std::vector<std::size_t> steps;
+    getEncodableSteps(steps);
 
-    if(!encode)
+    // The largest step determines the size of the carry buffer, lengths
+    // which cannot be computed here are left for the compiler to compare
+    std::string carry;
+    std::vector<std::string> uncomputed;
+    double maxcarry = 0;
+    bool elements = false;
+    for(std::size_t i = 0; i + 1 < steps.size(); i++)
+    {
+        std::string max;
+
+        if(isElementStep(steps, i))
+        {
+            elements = true;
+            max = getElementStepLength(encodables.at(steps.at(i)));
+        }
+        else
+        {
+            EncodedLength length;
+            for(std::size_t j = steps.at(i); j < steps.at(i + 1); j++)
+                length.addToLength(encodables.at(j)->encodedLength);
+
+            max = length.maxEncodedLength;
+        }
+
+        if(max.empty())
+            continue;
+
+        bool ok = false;
+        double value = ShuntingYard::computeInfix(parser->replaceEnumerationNameWithValue(max), &ok);
+
+        if(!ok)
+            uncomputed.push_back(max);
+        else if(carry.empty() || (value > maxcarry))
+        {
+            carry = max;
+            maxcarry = value;
+        }
+    }
+
+    if(carry.empty())
+        carry = "1";
+
+    for(const std::string& max : uncomputed)
+        carry = "((" + carry + ") > (" + max + ") ? (" + carry + ") : (" + max + "))";
+
+    CodeEmitter output;
+
+    if(support.language == ProtocolSupport::c_language)
+    {
+        output.append(spacing, "//! State of a resumable decode of a ", name, " packet, which receives the packet data in fragments\n");
+        output.append(spacing, "typedef struct\n");
+        output.append(spacing, "{\n");
+    }
+    else
+    {
+        output.append(spacing, "//! State of a resumable decode, which receives the packet data in fragments\n");
+        output.append(spacing, "struct Decoder\n");
+        output.append(spacing, "{\n");
+    }
+
+    output.append(spacing, TAB_IN, "int step;      //!< Index of the next step to decode\n");
+    if(elements)
+        output.append(spacing, TAB_IN, "unsigned element; //!< Index of the next array element of the step to decode\n");
+    output.append(spacing, TAB_IN, "int byteindex; //!< Number of bytes of packet data decoded so far\n");
+    output.append(spacing, TAB_IN, "int numbytes;  //!< Number of bytes of packet data\n");
+    output.append(spacing, TAB_IN, "int numcarry;  //!< Number of bytes in carry\n");
+    output.append(spacing, TAB_IN, "uint8_t carry[", carry, "]; //!< Bytes of a step which arrived in more than one fragment\n");
+
+    if(support.language == ProtocolSupport::c_language)
+        output.append(spacing, "}", support.prefix, name, "Decoder", support.typeSuffix, ";\n");
+    else
+        output.append(spacing, "};\n");
+
+    return output.take();
+
+}// ProtocolPacket::getResumableDecoderDeclaration
+
+
+/*!
+ * Get the prototypes of the public functions of the resumable decoder.
+ * \param spacing is the offset for each line.
+ * \return the prototypes of the start and feed functions.
+ */
+std::string ProtocolPacket::getResumableDecoderPrototypes(const std::string& spacing) const
+{
+    CodeEmitter output;
+
+    if(support.language == ProtocolSupport::c_language)
+    {
+        std::string decoder = support.prefix + name + "Decoder";
+
+        output.append(spacing, "//! Start a resumable decode of a ", name, " packet\n");
+        output.append(spacing, "void start", decoder, "(", decoder, support.typeSuffix, "* decoder, int numbytes, ", structName, "* user);\n");
+        output.append("\n");
+        output.append(spacing, "//! Decode as much of a ", name, " packet as a fragment of its data allows\n");
+        output.append(spacing, "int feed", decoder, "(", decoder, support.typeSuffix, "* decoder, const uint8_t* data, int numbytes, ", structName, "* user);\n");
+    }
+    else
+    {
+        output.append(spacing, "//! Start a resumable decode of this packet\n");
+        output.append(spacing, "void startDecoder(Decoder* decoder, int numbytes);\n");
+        output.append("\n");
+        output.append(spacing, "//! Decode as much of this packet as a fragment of its data allows\n");
+        output.append(spacing, "int feedDecoder(Decoder* decoder, const uint8_t* data, int numbytes);\n");
+        output.append("\n");
+
+        if(hasElementSteps())
+        {
+            output.append(spacing, "//! Determine the number of array elements of one step of the resumable decoder\n");
+            output.append(spacing, "unsigned countStepElements(int step) const;\n");
+            output.append("\n");
+            output.append(spacing, "//! Determine the number of bytes of one step of the resumable decoder\n");
+            output.append(spacing, "bool skipStep(int step, unsigned element, const uint8_t* data, int* bytecount, int numbytes) const;\n");
+            output.append("\n");
+            output.append(spacing, "//! Decode one step of the resumable decoder\n");
+            output.append(spacing, "bool decodeStep(int step, unsigned element, const uint8_t* data, int numbytes);\n");
+        }
+        else
+        {
+            output.append(spacing, "//! Determine the number of bytes of one step of the resumable decoder\n");
+            output.append(spacing, "bool skipStep(int step, const uint8_t* data, int* bytecount, int numbytes) const;\n");
+            output.append("\n");
+            output.append(spacing, "//! Decode one step of the resumable decoder\n");
+            output.append(spacing, "bool decodeStep(int step, const uint8_t* data, int numbytes);\n");
+        }
+    }
+
+    return output.take();
+
+}// ProtocolPacket::getResumableDecoderPrototypes
+
+
+/*!
+ * Indent every line of generated code which is not blank by one level.
+ * \param code is the code to indent.
+ * \return the indented code.
+ */
+static std::string indentCode(const std::string& code)
+{
+    CodeEmitter output;
+    bool linestart = true;
+
+    for(std::size_t i = 0; i < code.size(); i++)
+    {
+        if(linestart && (code.at(i) != '\n'))
+            output.append(ProtocolDocumentation::TAB_IN);
+
+        output.append(code.at(i));
+        linestart = (code.at(i) == '\n');
+    }
+
+    return output.take();
+}
+
+
+/*!
+ * Get the functions of the resumable decoder. The decoder works in steps,
+ * each step is one field (or one run of bitfields). An array is decoded one
+ * element at a time, the decoder keeps the index of the element along with
+ * the step. A step is first skipped to learn its length, which needs only the
+ * fields that were decoded in earlier steps. If all the bytes of the step are
+ * available it is decoded, directly from the fragment if possible, else from
+ * the carry buffer of the decoder. Each field is therefore decoded exactly once.
+ * \return the functions, including comments.
+ */
+std::string ProtocolPacket::getResumableDecoderBody(void) const
+{
+    std::vector<std::size_t> steps;
+    getEncodableSteps(steps);
+
+    bool elements = hasElementSteps();
+
+    std::size_t numsteps = steps.size() - 1;
+
+    // The steps from here on can be missing from the packet, in which case they keep their defaults
+    std::size_t firstdefault = numsteps;
+    for(std::size_t i = 0; i < numsteps; i++)
+    {
+        if(encodables.at(steps.at(i))->isDefault())
+        {
+            firstdefault = i;
+            break;
+        }
+    }
+
+    std::string countcode;
+    std::string skipcode;
+    std::string decodecode;
+
+    for(std::size_t i = 0; i < numsteps; i++)
+    {
+        EncodedLength fixedlength;
+        std::string skip;
+        std::string decode;
+
+        if(isElementStep(steps, i))
+        {
+            const Encodable* encodable = encodables.at(steps.at(i));
+
+            // The number of elements, which are only present if the dependsOn condition "if(...)" is true
+            std::string count = encodable->getEncodedElementCount(true);
+            std::string condition = encodable->getEncodeDependsOnCondition(true);
+            if(!condition.empty())
+                count = condition.substr(2) + " ? " + count + " : 0";
+
+            countcode += TAB_IN + "case " + std::to_string(i) + ":\n";
+            countcode += TAB_IN + TAB_IN + "return " + count + ";\n";
+            countcode += "\n";
+
+            skip = encodable->getSkipElementString(true);
+
+            if(skip.empty())
+                skip = TAB_IN + "_pg_byteindex += " + getElementStepLength(encodable) + ";\n";
+
+            decode = encodable->getDecodeElementString(true);
+
+            if(skip.find("_pg_i") != std::string::npos)
+                skip = TAB_IN + "_pg_i = _pg_element;\n" + skip;
+
+            if(decode.find("_pg_i") != std::string::npos)
+                decode = TAB_IN + "_pg_i = _pg_element;\n" + decode;
+        }
+        else
+        {
+            if(encodables.at(steps.at(i))->isBitfield())
+            {
+                for(std::size_t j = steps.at(i); j < steps.at(i + 1); j++)
+                    fixedlength.addToLength(encodables.at(j)->encodedLength);
+            }
+            else
+            {
+                skip = encodables.at(steps.at(i))->getSkipString(true);
+
+                if(skip.empty())
+                    fixedlength.addToLength(encodables.at(steps.at(i))->encodedLength);
+            }
+
+            if(!fixedlength.maxEncodedLength.empty())
+                skip = TAB_IN + "_pg_byteindex += " + fixedlength.maxEncodedLength + ";\n";
+
+            int bitcount = 0;
+            for(std::size_t j = steps.at(i); j < steps.at(i + 1); j++)
+            {
+                ProtocolFile::makeLineSeparator(decode);
+                decode += encodables.at(j)->getDecodeString(&bitcount, true, i >= firstdefault);
+            }
+        }
+
+        skipcode += TAB_IN + "case " + std::to_string(i) + ":\n";
+        skipcode += indentCode(skip);
+        skipcode += TAB_IN + TAB_IN + "break;\n";
+        skipcode += "\n";
+
+        decodecode += TAB_IN + "case " + std::to_string(i) + ":\n";
+        decodecode += indentCode(decode);
+        decodecode += TAB_IN + TAB_IN + "break;\n";
+        decodecode += "\n";
+    }
+
+    bool c = (support.language == ProtocolSupport::c_language);
+    std::string decoder = support.prefix + name + "Decoder";
+    std::string countstep, skipstep, decodestep, start, feed;
+
+    // The array element is passed to the step functions of a packet with array steps
+    std::string element, elementarg;
+    if(elements)
+    {
+        element = "unsigned _pg_element, ";
+        elementarg = "_pg_decoder->element, ";
+    }
+
+    if(c)
+    {
+        countstep = "count" + support.prefix + name + "StepElements";
+        skipstep = "skip" + support.prefix + name + "Step";
+        decodestep = "decode" + support.prefix + name + "Step";
+        start = "start" + decoder;
+        feed = "feed" + decoder;
+    }
+    else
+    {
+        countstep = typeName + "::countStepElements";
+        skipstep = typeName + "::skipStep";
+        decodestep = typeName + "::decodeStep";
+        start = typeName + "::startDecoder";
+        feed = typeName + "::feedDecoder";
+    }
+
+    CodeEmitter output;
+
+    if(elements)
+    {
+        output.append("/*!\n");
+        output.append(" * Determine the number of array elements of one step of the resumable ", name, "\n");
+        output.append(" * decoder. An array is decoded one element at a time, any other step is one\n");
+        output.append(" * element. Only the fields decoded by earlier steps are used.\n");
+        if(c)
+            output.append(" * \\param _pg_user holds the fields decoded by earlier steps\n");
+        output.append(" * \\param _pg_step is the step to count\n");
+        output.append(" * \\return the number of elements of the step, which can be zero.\n");
+        output.append(" */\n");
+
+        if(c)
+            output.append("static unsigned ", countstep, "(const ", structName, "* _pg_user, int _pg_step)\n");
+        else
+            output.append("unsigned ", countstep, "(int _pg_step) const\n");
+
+        output.append("{\n");
+
+        if(c && (countcode.find("_pg_user") == std::string::npos))
+        {
+            output.append(TAB_IN, "(void)_pg_user;\n");
+            output.append("\n");
+        }
+
+        output.append(TAB_IN, "switch(_pg_step)\n");
+        output.append(TAB_IN, "{\n");
+        output.append(TAB_IN, "default:\n");
+        output.append(TAB_IN, TAB_IN, "return 1;\n");
+        output.append("\n");
+        output.append(countcode);
+        output.append(TAB_IN, "}\n");
+        output.append("\n");
+        output.append("}// ", countstep, "\n");
+        output.append("\n\n");
+    }
+
+    output.append("/*!\n");
+    output.append(" * Determine the number of bytes of one step of the resumable ", name, " decoder.\n");
+    output.append(" * Only the fields decoded by earlier steps are used.\n");
+    if(c)
+        output.append(" * \\param _pg_user holds the fields decoded by earlier steps\n");
+    output.append(" * \\param _pg_step is the step to skip\n");
+    if(elements)
+        output.append(" * \\param _pg_element is the array element to skip, if the step is an array\n");
+    output.append(" * \\param _pg_data points to the first byte of the step\n");
+    output.append(" * \\param _pg_bytecount receives the number of bytes of the step\n");
+    output.append(" * \\param _pg_numbytes is the number of bytes available\n");
+    output.append(" * \\return ", getReturnCode(true), " if all the bytes of the step are available, else ", getReturnCode(false), ".\n");
+    output.append(" */\n");
+
+    if(c)
+        output.append("static int ", skipstep, "(const ", structName, "* _pg_user, int _pg_step, ", element, "const uint8_t* _pg_data, int* _pg_bytecount, int _pg_numbytes)\n");
+    else
+        output.append("bool ", skipstep, "(int _pg_step, ", element, "const uint8_t* _pg_data, int* _pg_bytecount, int _pg_numbytes) const\n");
+
+    output.append("{\n");
+    output.append(TAB_IN, "int _pg_byteindex = 0;\n");
+
+    if(skipcode.find("_pg_i") != std::string::npos)
+        output.append(TAB_IN, "unsigned _pg_i = 0;\n");
+
+    if(skipcode.find("_pg_j") != std::string::npos)
+        output.append(TAB_IN, "unsigned _pg_j = 0;\n");
+
+    if(elements && (skipcode.find("_pg_element") == std::string::npos))
+        output.append(TAB_IN, "(void)_pg_element;\n");
+
+    if(skipcode.find("_pg_data") == std::string::npos)
+        output.append(TAB_IN, "(void)_pg_data;\n");
+
+    if(c && (skipcode.find("_pg_user") == std::string::npos))
+        output.append(TAB_IN, "(void)_pg_user;\n");
+
+    output.append("\n");
+    output.append(TAB_IN, "switch(_pg_step)\n");
+    output.append(TAB_IN, "{\n");
+    output.append(TAB_IN, "default:\n");
+    output.append(TAB_IN, TAB_IN, "return ", getReturnCode(false), ";\n");
+    output.append("\n");
+    output.append(skipcode);
+    output.append(TAB_IN, "}\n");
+    output.append("\n");
+    output.append(TAB_IN, "if(_pg_byteindex > _pg_numbytes)\n");
+    output.append(TAB_IN, TAB_IN, "return ", getReturnCode(false), ";\n");
+    output.append("\n");
+    output.append(TAB_IN, "*_pg_bytecount = _pg_byteindex;\n");
+    output.append("\n");
+    output.append(TAB_IN, "return ", getReturnCode(true), ";\n");
+    output.append("\n");
+    output.append("}// ", skipstep, "\n");
+
+    output.append("\n\n");
+    output.append("/*!\n");
+    output.append(" * Decode one step of the resumable ", name, " decoder. The bytes of the\n");
+    output.append(" * step must have been checked by ", (c ? skipstep : std::string("skipStep")), "(), except for\n");
+    output.append(" * default fields at the end of the packet, which are decoded as far as the\n");
+    output.append(" * packet data allow.\n");
+    if(c)
+        output.append(" * \\param _pg_user receives the fields of the step\n");
+    output.append(" * \\param _pg_step is the step to decode\n");
+    if(elements)
+        output.append(" * \\param _pg_element is the array element to decode, if the step is an array\n");
+    output.append(" * \\param _pg_data points to the first byte of the step\n");
+    output.append(" * \\param _pg_numbytes is the number of bytes available\n");
+    output.append(" * \\return ", getReturnCode(true), " if the step was decoded, else ", getReturnCode(false), ".\n");
+    output.append(" */\n");
+
+    if(c)
+        output.append("static int ", decodestep, "(", structName, "* _pg_user, int _pg_step, ", element, "const uint8_t* _pg_data, int _pg_numbytes)\n");
+    else
+        output.append("bool ", decodestep, "(int _pg_step, ", element, "const uint8_t* _pg_data, int _pg_numbytes)\n");
+
+    output.append("{\n");
+
+    if(decodecode.find("_pg_byteindex") != std::string::npos)
+        output.append(TAB_IN, "int _pg_byteindex = 0;\n");
+
+    if(decodecode.find("_pg_tempbitfield") != std::string::npos)
+        output.append(TAB_IN, "unsigned int _pg_tempbitfield = 0;\n");
+
+    if(decodecode.find("_pg_templongbitfield") != std::string::npos)
+        output.append(TAB_IN, "uint64_t _pg_templongbitfield = 0;\n");
+
+    if(decodecode.find("_pg_bitfieldbytes") != std::string::npos)
+    {
+        output.append(TAB_IN, "int _pg_bitfieldindex = 0;\n");
+        output.append(TAB_IN, "uint8_t _pg_bitfieldbytes[", std::to_string(numbitfieldgroupbytes), "];\n");
+    }
+
+    if(decodecode.find("_pg_i") != std::string::npos)
+        output.append(TAB_IN, "unsigned _pg_i = 0;\n");
+
+    if(decodecode.find("_pg_j") != std::string::npos)
+        output.append(TAB_IN, "unsigned _pg_j = 0;\n");
+
+    if(elements && (decodecode.find("_pg_element") == std::string::npos))
+        output.append(TAB_IN, "(void)_pg_element;\n");
+
+    if(decodecode.find("_pg_data") == std::string::npos)
+        output.append(TAB_IN, "(void)_pg_data;\n");
+
+    if(decodecode.find("_pg_numbytes") == std::string::npos)
+        output.append(TAB_IN, "(void)_pg_numbytes;\n");
+
+    if(c && (decodecode.find("_pg_user") == std::string::npos))
+        output.append(TAB_IN, "(void)_pg_user;\n");
+
+    output.append("\n");
+    output.append(TAB_IN, "switch(_pg_step)\n");
+    output.append(TAB_IN, "{\n");
+    output.append(TAB_IN, "default:\n");
+    output.append(TAB_IN, TAB_IN, "return ", getReturnCode(false), ";\n");
+    output.append("\n");
+    output.append(decodecode);
+    output.append(TAB_IN, "}\n");
+    output.append("\n");
+    output.append(TAB_IN, "return ", getReturnCode(true), ";\n");
+    output.append("\n");
+    output.append("}// ", decodestep, "\n");
+
+    output.append("\n\n");
+    output.append("/*!\n");
+    output.append(" * Start a resumable decode of a ", name, " packet. The packet data are\n");
+    output.append(" * then passed to ", (c ? feed : std::string("feedDecoder")), "() in fragments of any size.\n");
+    output.append(" * \\param _pg_decoder is the state of the decode\n");
+    output.append(" * \\param _pg_numbytes is the number of bytes of packet data, from the packet header\n");
+    if(c)
+        output.append(" * \\param _pg_user receives the data decoded from the packet\n");
+    output.append(" */\n");
+
+    if(c)
+        output.append("void ", start, "(", decoder, support.typeSuffix, "* _pg_decoder, int _pg_numbytes, ", structName, "* _pg_user)\n");
+    else
+        output.append("void ", start, "(Decoder* _pg_decoder, int _pg_numbytes)\n");
+
+    output.append("{\n");
+
+    std::string defaultcode;
+    if(defaults)
+    {
+        for(std::size_t i = 0; i < encodables.size(); i++)
+            defaultcode += encodables.at(i)->getSetToDefaultsString(true);
+    }
+
+    if(defaultcode.find("_pg_i") != std::string::npos)
+        output.append(TAB_IN, "unsigned _pg_i = 0;\n");
+
+    if(defaultcode.find("_pg_j") != std::string::npos)
+        output.append(TAB_IN, "unsigned _pg_j = 0;\n");
+
+    if(defaultcode.find("_pg_i") != std::string::npos)
+        output.append("\n");
+
+    output.append(TAB_IN, "_pg_decoder->step = 0;\n");
+    if(elements)
+        output.append(TAB_IN, "_pg_decoder->element = 0;\n");
+    output.append(TAB_IN, "_pg_decoder->byteindex = 0;\n");
+    output.append(TAB_IN, "_pg_decoder->numbytes = _pg_numbytes;\n");
+    output.append(TAB_IN, "_pg_decoder->numcarry = 0;\n");
+
+    if(defaults)
+    {
+        output.append("\n");
+        output.append(TAB_IN, "// this packet has default fields, make sure they are set\n");
+        output.append(defaultcode);
+    }
+    else if(c)
+        output.append(TAB_IN, "(void)_pg_user;\n");
+
+    output.append("\n");
+    output.append("}// ", start, "\n");
+
+    output.append("\n\n");
+    output.append("/*!\n");
+    output.append(" * Decode as much of a ", name, " packet as a fragment of its data allows.\n");
+    output.append(" * Fields which are only partly in the fragment are kept by the decoder and\n");
+    output.append(" * decoded when the next fragment completes them. Bytes beyond the end of the\n");
+    output.append(" * packet data are not used.\n");
+    output.append(" * \\param _pg_decoder is the state of the decode, from ", (c ? start : std::string("startDecoder")), "()\n");
+    output.append(" * \\param _pg_data points to the fragment of packet data\n");
+    output.append(" * \\param _pg_numbytes is the number of bytes in the fragment\n");
+    if(c)
+        output.append(" * \\param _pg_user receives the data decoded from the packet\n");
+    output.append(" * \\return 1 if the packet is completely decoded, 0 if more data are needed,\n");
+    output.append(" *         or -1 if the packet data are bad.\n");
+    output.append(" */\n");
+
+    if(c)
+        output.append("int ", feed, "(", decoder, support.typeSuffix, "* _pg_decoder, const uint8_t* _pg_data, int _pg_numbytes, ", structName, "* _pg_user)\n");
+    else
+        output.append("int ", feed, "(Decoder* _pg_decoder, const uint8_t* _pg_data, int _pg_numbytes)\n");
+
+    output.append("{\n");
+    output.append(TAB_IN, "int _pg_used = 0;\n");
+    output.append(TAB_IN, "int _pg_length;\n");
+    output.append("\n");
+    output.append(TAB_IN, "// Verify the packet size\n");
+    if(c)
+        output.append(TAB_IN, "if(_pg_decoder->numbytes < get", support.prefix, name, "MinDataLength())\n");
+    else
+        output.append(TAB_IN, "if(_pg_decoder->numbytes < minLength())\n");
+    output.append(TAB_IN, TAB_IN, "return -1;\n");
+    output.append("\n");
+    output.append(TAB_IN, "// Bytes beyond the end of the packet data are not used\n");
+    output.append(TAB_IN, "if(_pg_numbytes > _pg_decoder->numbytes - _pg_decoder->byteindex - _pg_decoder->numcarry)\n");
+    output.append(TAB_IN, TAB_IN, "_pg_numbytes = _pg_decoder->numbytes - _pg_decoder->byteindex - _pg_decoder->numcarry;\n");
+    output.append("\n");
+    output.append(TAB_IN, "while(_pg_decoder->step < ", std::to_string(numsteps), ")\n");
+    output.append(TAB_IN, "{\n");
+    output.append(TAB_IN, TAB_IN, "const uint8_t* _pg_bytes;\n");
+    output.append(TAB_IN, TAB_IN, "int _pg_available;\n");
+    output.append("\n");
+
+    if(elements)
+    {
+        output.append(TAB_IN, TAB_IN, "// An array is decoded one element at a time, the step ends after its last element\n");
+        if(c)
+            output.append(TAB_IN, TAB_IN, "if(_pg_decoder->element >= ", countstep, "(_pg_user, _pg_decoder->step))\n");
+        else
+            output.append(TAB_IN, TAB_IN, "if(_pg_decoder->element >= countStepElements(_pg_decoder->step))\n");
+        output.append(TAB_IN, TAB_IN, "{\n");
+        output.append(TAB_IN, TAB_IN, TAB_IN, "_pg_decoder->step++;\n");
+        output.append(TAB_IN, TAB_IN, TAB_IN, "_pg_decoder->element = 0;\n");
+        output.append(TAB_IN, TAB_IN, TAB_IN, "continue;\n");
+        output.append(TAB_IN, TAB_IN, "}\n");
+        output.append("\n");
+    }
+    output.append(TAB_IN, TAB_IN, "if(_pg_decoder->numcarry > 0)\n");
+    output.append(TAB_IN, TAB_IN, "{\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "// The first bytes of this step came with an earlier fragment\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "_pg_length = _pg_numbytes - _pg_used;\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "if(_pg_length > (int)sizeof(_pg_decoder->carry) - _pg_decoder->numcarry)\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, TAB_IN, "_pg_length = (int)sizeof(_pg_decoder->carry) - _pg_decoder->numcarry;\n");
+    output.append("\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "memcpy(_pg_decoder->carry + _pg_decoder->numcarry, _pg_data + _pg_used, _pg_length);\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "_pg_decoder->numcarry += _pg_length;\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "_pg_used += _pg_length;\n");
+    output.append("\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "_pg_bytes = _pg_decoder->carry;\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "_pg_available = _pg_decoder->numcarry;\n");
+    output.append(TAB_IN, TAB_IN, "}\n");
+    output.append(TAB_IN, TAB_IN, "else\n");
+    output.append(TAB_IN, TAB_IN, "{\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "// Decode directly from the fragment\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "_pg_bytes = _pg_data + _pg_used;\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "_pg_available = _pg_numbytes - _pg_used;\n");
+    output.append(TAB_IN, TAB_IN, "}\n");
+    output.append("\n");
+    output.append(TAB_IN, TAB_IN, "_pg_length = 0;\n");
+    if(c)
+        output.append(TAB_IN, TAB_IN, "if(", skipstep, "(_pg_user, _pg_decoder->step, ", elementarg, "_pg_bytes, &_pg_length, _pg_available) == 0)\n");
+    else
+        output.append(TAB_IN, TAB_IN, "if(!skipStep(_pg_decoder->step, ", elementarg, "_pg_bytes, &_pg_length, _pg_available))\n");
+    output.append(TAB_IN, TAB_IN, "{\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "// Check if the packet ended before this step\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "if(_pg_decoder->byteindex + _pg_available >= _pg_decoder->numbytes)\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "{\n");
+
+    if(firstdefault < numsteps)
+    {
+        output.append(TAB_IN, TAB_IN, TAB_IN, TAB_IN, "// Decode the default fields which are present, the rest keep their defaults\n");
+        output.append(TAB_IN, TAB_IN, TAB_IN, TAB_IN, "if(_pg_decoder->step >= ", std::to_string(firstdefault), ")\n");
+        output.append(TAB_IN, TAB_IN, TAB_IN, TAB_IN, "{\n");
+        if(c)
+            output.append(TAB_IN, TAB_IN, TAB_IN, TAB_IN, TAB_IN, "if(", decodestep, "(_pg_user, _pg_decoder->step, ", elementarg, "_pg_bytes, _pg_available) == 0)\n");
+        else
+            output.append(TAB_IN, TAB_IN, TAB_IN, TAB_IN, TAB_IN, "if(!decodeStep(_pg_decoder->step, ", elementarg, "_pg_bytes, _pg_available))\n");
+        output.append(TAB_IN, TAB_IN, TAB_IN, TAB_IN, TAB_IN, TAB_IN, "return -1;\n");
+        output.append("\n");
+        output.append(TAB_IN, TAB_IN, TAB_IN, TAB_IN, TAB_IN, "_pg_decoder->byteindex = _pg_decoder->numbytes;\n");
+        output.append(TAB_IN, TAB_IN, TAB_IN, TAB_IN, TAB_IN, "_pg_decoder->numcarry = 0;\n");
+        output.append(TAB_IN, TAB_IN, TAB_IN, TAB_IN, TAB_IN, "_pg_decoder->step = ", std::to_string(numsteps), ";\n");
+        output.append(TAB_IN, TAB_IN, TAB_IN, TAB_IN, TAB_IN, "return 1;\n");
+        output.append(TAB_IN, TAB_IN, TAB_IN, TAB_IN, "}\n");
+        output.append("\n");
+    }
+
+    output.append(TAB_IN, TAB_IN, TAB_IN, TAB_IN, "return -1;\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "}\n");
+    output.append("\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "// The carry is as big as the largest step or array element, this only happens if the data are bad\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "if(_pg_available >= (int)sizeof(_pg_decoder->carry))\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, TAB_IN, "return -1;\n");
+    output.append("\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "// Keep the bytes of this step until the next fragment\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "if(_pg_decoder->numcarry == 0)\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "{\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, TAB_IN, "memcpy(_pg_decoder->carry, _pg_bytes, _pg_available);\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, TAB_IN, "_pg_decoder->numcarry = _pg_available;\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "}\n");
+    output.append("\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "return 0;\n");
+    output.append(TAB_IN, TAB_IN, "}\n");
+    output.append("\n");
+    if(c)
+        output.append(TAB_IN, TAB_IN, "if(", decodestep, "(_pg_user, _pg_decoder->step, ", elementarg, "_pg_bytes, _pg_length) == 0)\n");
+    else
+        output.append(TAB_IN, TAB_IN, "if(!decodeStep(_pg_decoder->step, ", elementarg, "_pg_bytes, _pg_length))\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "return -1;\n");
+    output.append("\n");
+    output.append(TAB_IN, TAB_IN, "if(_pg_decoder->numcarry > 0)\n");
+    output.append(TAB_IN, TAB_IN, "{\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "// Carried bytes beyond this step belong to the next step\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "_pg_used -= _pg_decoder->numcarry - _pg_length;\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "_pg_decoder->numcarry = 0;\n");
+    output.append(TAB_IN, TAB_IN, "}\n");
+    output.append(TAB_IN, TAB_IN, "else\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "_pg_used += _pg_length;\n");
+    output.append("\n");
+    output.append(TAB_IN, TAB_IN, "_pg_decoder->byteindex += _pg_length;\n");
+    if(elements)
+        output.append(TAB_IN, TAB_IN, "_pg_decoder->element++;\n");
+    else
+        output.append(TAB_IN, TAB_IN, "_pg_decoder->step++;\n");
+    output.append("\n");
+    output.append(TAB_IN, "}// while steps to decode\n");
+    output.append("\n");
+    output.append(TAB_IN, "return 1;\n");
+    output.append("\n");
+    output.append("}// ", feed, "\n");
+
+    return output.take();
+
+}// ProtocolPacket::getResumableDecoderBody
+
+
+/*!
+ * Get the steps of the delta encoding, which are the steps of the resumable
+ * decoder. Each step that holds data has a bit in the bitmap at the start of
+ * a delta packet, and is sent if its condition is true. Steps which hold no
+ * data (constants and fields that are not in memory) are never sent.
+ * \param steps receives the index of the first encodable of each step, as for
+ *        getEncodableSteps().
+ * \param conditions receives the condition of each step, which is empty if
+ *        the step is never sent.
+ */
+void ProtocolPacket::getDeltaSteps(std::vector<std::size_t>& steps, std::vector<std::string>& conditions) const
+{
+    getEncodableSteps(steps);
+    conditions.clear();
+
+    for(std::size_t i = 0; i + 1 < steps.size(); i++)
+    {
+        std::string condition;
+
+        for(std::size_t j = steps.at(i); j < steps.at(i + 1); j++)
+        {
+            std::string changed = encodables.at(j)->getDeltaChangedCondition();
+            if(changed.empty())
+                continue;
+
+            if(!condition.empty())
+                condition += " ||\n" + TAB_IN + TAB_IN;
+
+            condition += changed;
+        }
+
+        // A single comparison does not need its own parentheses
+        if((condition.find(") ||") == std::string::npos) && (condition.size() > 2) && (condition.front() == '(') && (condition.back() == ')'))
+            condition = condition.substr(1, condition.size() - 2);
+
+        conditions.push_back(condition);
+    }
+
+}// ProtocolPacket::getDeltaSteps
+
+
+/*!
+ * Get the number of bits in the bitmap of the delta encoding, which is the
+ * number of steps that can be sent.
+ * \return the number of bits, zero if nothing can be sent.
+ */
+int ProtocolPacket::getNumberOfDeltaBits(void) const
+{
+    std::vector<std::size_t> steps;
+    std::vector<std::string> conditions;
+    getDeltaSteps(steps, conditions);
+
+    int bits = 0;
+    for(std::size_t i = 0; i < conditions.size(); i++)
+    {
+        if(!conditions.at(i).empty())
+            bits++;
+    }
+
+    return bits;
+
+}// ProtocolPacket::getNumberOfDeltaBits
+
+
+/*!
+ * Get the prototypes of the delta encode and decode functions.
+ * \param spacing is the offset for each line.
+ * \return the prototypes.
+ */
+std::string ProtocolPacket::getDeltaPrototypes(const std::string& spacing) const
+{
+    CodeEmitter output;
+    std::string id;
+
+    if(ids.size() > 1)
+        id = ", uint32_t id";
+
+    if(support.language == ProtocolSupport::c_language)
+    {
+        if(encode)
+        {
+            output.append(spacing, "//! Encode the fields of a ", name, " packet which differ from a reference copy\n");
+            output.append(spacing, "void encodeDelta", support.prefix, name, support.packetStructureSuffix, "(", support.pointerType, " pkt, const ", structName, "* user, const ", structName, "* reference", id, ");\n");
+        }
+
+        if(encode && decode)
+            output.append("\n");
+
+        if(decode)
+        {
+            output.append(spacing, "//! Decode a delta encoded ", name, " packet, changing only the fields which are in it\n");
+            output.append(spacing, "int decodeDelta", support.prefix, name, support.packetStructureSuffix, "(const ", support.pointerType, " pkt, ", structName, "* user);\n");
+        }
+    }
+    else
+    {
+        if(encode)
+        {
+            output.append(spacing, "//! Encode the fields of this packet which differ from a reference copy\n");
+            output.append(spacing, "void encodeDelta(", support.pointerType, " pkt, const ", structName, "* reference", id, ") const;\n");
+        }
+
+        if(encode && decode)
+            output.append("\n");
+
+        if(decode)
+        {
+            output.append(spacing, "//! Decode a delta encoded packet, changing only the fields which are in it\n");
+            output.append(spacing, "bool decodeDelta(const ", support.pointerType, " pkt);\n");
+        }
+    }
+
+    return output.take();
+
+}// ProtocolPacket::getDeltaPrototypes
+
+
+/*!
+ * Get the functions of the delta encoding. A delta packet starts with a
+ * bitmap which has one bit for each step that can be sent, least significant
+ * bit first, in the order of the fields. The steps whose bits are set follow
+ * the bitmap, each encoded exactly as it is in the full packet. The decoder
+ * changes only those fields, so it must be given the same data that the
+ * encoder used as its reference.
+ * \return the functions, including comments.
+ */
+std::string ProtocolPacket::getDeltaBody(void) const
+{
+    std::vector<std::size_t> steps;
+    std::vector<std::string> conditions;
+    getDeltaSteps(steps, conditions);
+
+    int numbits = getNumberOfDeltaBits();
+    std::string numbytes = std::to_string((numbits + 7)/8);
+
+    std::string encodecode;
+    std::string decodecode;
+
+    static const char* masks[8] = {"0x01", "0x02", "0x04", "0x08", "0x10", "0x20", "0x40", "0x80"};
+
+    int bit = 0;
+    for(std::size_t i = 0; i < conditions.size(); i++)
+    {
+        if(conditions.at(i).empty())
+            continue;
+
+        EncodedLength length;
+        std::string encodestep;
+        std::string decodestep;
+        int encodebitcount = 0;
+        int decodebitcount = 0;
+
+        // As for the resumable decoder a step has a fixed length if it is a
+        // run of bitfields, or if it cannot be skipped without reading it
+        bool fixed = encodables.at(steps.at(i))->isBitfield() || encodables.at(steps.at(i))->getSkipString(true).empty();
+
+        for(std::size_t j = steps.at(i); j < steps.at(i + 1); j++)
+        {
+            length.addToLength(encodables.at(j)->encodedLength);
+
+            ProtocolFile::makeLineSeparator(encodestep);
+            encodestep += encodables.at(j)->getEncodeString(&encodebitcount, true);
+
+            ProtocolFile::makeLineSeparator(decodestep);
+            decodestep += encodables.at(j)->getDecodeString(&decodebitcount, true);
+        }
+
+        // The steps are inside braces, where trailing blank lines look odd
+        while((encodestep.size() > 1) && (encodestep.compare(encodestep.size() - 2, 2, "\n\n") == 0))
+            encodestep.pop_back();
+
+        while((decodestep.size() > 1) && (decodestep.compare(decodestep.size() - 2, 2, "\n\n") == 0))
+            decodestep.pop_back();
+
+        std::string byte = "_pg_data[" + std::to_string(bit/8) + "]";
+        std::string mask = masks[bit%8];
+        bit++;
+
+        encodecode += "\n";
+        encodecode += TAB_IN + "if(" + conditions.at(i) + ")\n";
+        encodecode += TAB_IN + "{\n";
+        encodecode += TAB_IN + TAB_IN + byte + " |= " + mask + ";\n";
+        encodecode += indentCode(encodestep);
+        encodecode += TAB_IN + "}\n";
+
+        decodecode += "\n";
+        decodecode += TAB_IN + "if(" + byte + " & " + mask + ")\n";
+        decodecode += TAB_IN + "{\n";
+
+        // The length of a fixed step is its maximum, this ignores any default
+        std::string minlength = fixed ? length.maxEncodedLength : length.minEncodedLength;
+
+        if(!minlength.empty())
+        {
+            decodecode += TAB_IN + TAB_IN + "if(_pg_numbytes < _pg_byteindex + " + minlength + ")\n";
+            decodecode += TAB_IN + TAB_IN + TAB_IN + "return " + getReturnCode(false) + ";\n";
+            decodecode += "\n";
+        }
+
+        decodecode += indentCode(decodestep);
+
+        // Variable length steps are checked after they are decoded, as the full decode does
+        if(!fixed)
+        {
+            decodecode += "\n";
+            decodecode += TAB_IN + TAB_IN + "if(_pg_numbytes < _pg_byteindex)\n";
+            decodecode += TAB_IN + TAB_IN + TAB_IN + "return " + getReturnCode(false) + ";\n";
+        }
+
+        decodecode += TAB_IN + "}\n";
+    }
+
+    bool c = (support.language == ProtocolSupport::c_language);
+    std::string encodename, decodename;
+
+    if(c)
+    {
+        encodename = "encodeDelta" + support.prefix + name + support.packetStructureSuffix;
+        decodename = "decodeDelta" + support.prefix + name + support.packetStructureSuffix;
+    }
+    else
+    {
+        encodename = typeName + "::encodeDelta";
+        decodename = typeName + "::decodeDelta";
+    }
+
+    // The strings that get the identifier for the packet
+    std::string id;
+    if(ids.size() > 1)
+        id = "_pg_id";
+    else if(c)
+        id = "get" + support.prefix + name + support.packetParameterSuffix + "ID()";
+    else
+        id = "id()";
+
+    CodeEmitter output;
+
+    if(encode)
+    {
+        output.append("/*!\n");
+        output.append(" * \\brief Encode the fields of a ", name, " packet which differ from a reference copy\n");
+        output.append(" *\n");
+        output.append(" * The packet data start with a bitmap of ", numbytes, " byte", ((numbytes == "1") ? "" : "s"), ", which has one bit for each\n");
+        output.append(" * field (or run of bitfields) in the order of the fields. The fields whose\n");
+        output.append(" * bits are set follow the bitmap, encoded as they are in the full packet.\n");
+        output.append(" * \\param _pg_pkt points to the packet which will be created by this function\n");
+        if(c)
+            output.append(" * \\param _pg_user points to the user data that will be encoded in _pg_pkt\n");
+        output.append(" * \\param _pg_reference points to the data that the receiver already has\n");
+        if(ids.size() > 1)
+            output.append(" * \\param _pg_id is the packet identifier for _pg_pkt\n");
+        output.append(" */\n");
+
+        if(c)
+            output.append("void ", encodename, "(", support.pointerType, " _pg_pkt, const ", structName, "* _pg_user, const ", structName, "* _pg_reference");
+        else
+            output.append("void ", encodename, "(", support.pointerType, " _pg_pkt, const ", structName, "* _pg_reference");
+
+        if(ids.size() > 1)
+            output.append(", uint32_t _pg_id");
+
+        output.append(")");
+
+        if(!c)
+            output.append(" const");
+
+        output.append("\n");
+        output.append("{\n");
+        output.append(TAB_IN, "uint8_t* _pg_data = get", support.protoName, "PacketData(_pg_pkt);\n");
+        output.append(TAB_IN, "int _pg_byteindex = ", numbytes, ";\n");
+
+        if(encodecode.find("_pg_tempbitfield") != std::string::npos)
+            output.append(TAB_IN, "unsigned int _pg_tempbitfield = 0;\n");
+
+        if(encodecode.find("_pg_templongbitfield") != std::string::npos)
+            output.append(TAB_IN, "uint64_t _pg_templongbitfield = 0;\n");
+
+        if(encodecode.find("_pg_bitfieldbytes") != std::string::npos)
+        {
+            output.append(TAB_IN, "int _pg_bitfieldindex = 0;\n");
+            output.append(TAB_IN, "uint8_t _pg_bitfieldbytes[", std::to_string(numbitfieldgroupbytes), "];\n");
+        }
+
+        if(encodecode.find("_pg_i") != std::string::npos)
+            output.append(TAB_IN, "unsigned _pg_i = 0;\n");
+
+        if(encodecode.find("_pg_j") != std::string::npos)
+            output.append(TAB_IN, "unsigned _pg_j = 0;\n");
+
+        output.append("\n");
+        output.append(TAB_IN, "// The bitmap of the fields which follow\n");
+        output.append(TAB_IN, "memset(_pg_data, 0, ", numbytes, ");\n");
+        output.append(encodecode);
+        output.append("\n");
+        output.append(TAB_IN, "// complete the process of creating the packet\n");
+        output.append(TAB_IN, "finish", support.protoName, "Packet(_pg_pkt, _pg_byteindex, ", id, ");\n");
+        output.append("\n");
+        output.append("}// ", encodename, "\n");
+    }
+
+    if(encode && decode)
+        output.append("\n\n");
+
+    if(decode)
+    {
+        // The decode always checks the identifier, even if the encode is given one
+        if(ids.size() > 1)
+            id.clear();
+
+        CodeEmitter check;
+        check.indent();
+        emitPacketIdentifierCheck(check, id);
+
+        output.append("/*!\n");
+        output.append(" * \\brief Decode a delta encoded ", name, " packet, changing only the fields which are in it\n");
+        output.append(" *\n");
+        output.append(" * The fields which are not in the packet keep their values, which must be\n");
+        output.append(" * the reference that was given to the encoder.\n");
+        output.append(" * \\param _pg_pkt points to the packet being decoded by this function\n");
+        if(c)
+            output.append(" * \\param _pg_user holds the reference, and receives the data decoded from the packet\n");
+        output.append(" * \\return ", getReturnCode(false), " is returned if the packet ID or size is wrong, else ", getReturnCode(true), "\n");
+        output.append(" */\n");
+
+        if(c)
+            output.append("int ", decodename, "(const ", support.pointerType, " _pg_pkt, ", structName, "* _pg_user)\n");
+        else
+            output.append("bool ", decodename, "(const ", support.pointerType, " _pg_pkt)\n");
+
+        output.append("{\n");
+        output.append(TAB_IN, "int _pg_numbytes;\n");
+        output.append(TAB_IN, "int _pg_byteindex = ", numbytes, ";\n");
+        output.append(TAB_IN, "const uint8_t* _pg_data;\n");
+
+        if(decodecode.find("_pg_tempbitfield") != std::string::npos)
+            output.append(TAB_IN, "unsigned int _pg_tempbitfield = 0;\n");
+
+        if(decodecode.find("_pg_templongbitfield") != std::string::npos)
+            output.append(TAB_IN, "uint64_t _pg_templongbitfield = 0;\n");
+
+        if(decodecode.find("_pg_bitfieldbytes") != std::string::npos)
+        {
+            output.append(TAB_IN, "int _pg_bitfieldindex = 0;\n");
+            output.append(TAB_IN, "uint8_t _pg_bitfieldbytes[", std::to_string(numbitfieldgroupbytes), "];\n");
+        }
+
+        if(decodecode.find("_pg_i") != std::string::npos)
+            output.append(TAB_IN, "unsigned _pg_i = 0;\n");
+
+        if(decodecode.find("_pg_j") != std::string::npos)
+            output.append(TAB_IN, "unsigned _pg_j = 0;\n");
+
+        output.append("\n");
+        output.append(check.str());
+        output.append("\n");
+        output.append(TAB_IN, "// Verify the packet size, which must at least hold the bitmap\n");
+        output.append(TAB_IN, "_pg_numbytes = get", support.protoName, "PacketSize(_pg_pkt);\n");
+        output.append(TAB_IN, "if(_pg_numbytes < ", numbytes, ")\n");
+        output.append(TAB_IN, TAB_IN, "return ", getReturnCode(false), ";\n");
+        output.append("\n");
+        output.append(TAB_IN, "// The raw data from the packet\n");
+        output.append(TAB_IN, "_pg_data = get", support.protoName, "PacketDataConst(_pg_pkt);\n");
+        output.append(decodecode);
+        output.append("\n");
+        output.append(TAB_IN, "return ", getReturnCode(true), ";\n");
+        output.append("\n");
+        output.append("}// ", decodename, "\n");
+    }
+
+    return output.take();
+
+}// ProtocolPacket::getDeltaBody
+
+
+/*!
+ * Create the functions for encoding and decoding the packet to/from parameters
+ */
+void ProtocolPacket::createPacketFunctions(void)
+{
+    // The prototypes in the header file are only needed for C,
+    // in C++ these prototypes are part of the class declaration.
+    if(support.language == ProtocolSupport::c_language)
+    {
+        if(encode)
+        {
+            // The prototype for the packet encode function
+            header.makeLineSeparator();
+            header.write(getParameterPacketEncodePrototype(std::string()));
+        }
+
+        if(decode)
+        {
+            // The prototype for the packet decode function
+            header.makeLineSeparator();
+            header.write(getParameterPacketDecodePrototype(std::string()));
+        }
+    }
+
+    if(encode)
+    {
+        source.makeLineSeparator();
+        source.write(getParameterPacketEncodeBody());
+    }
+
+    if(decode)
+    {
+        source.makeLineSeparator();
+        source.write(getParameterPacketDecodeBody());
+
+    }// if decode function enabled
+
+}// createPacketFunctions
+
+
+/*!
+ * Get the signature of the packet encode function, without semicolon or
+ * comments or line feed, for the prototype or actual function.
+ * \param insource should be true to indicate this signature is in source code
+ *        (i.e. not a prototype) which determines if the "_pg_" decoration is
+ *        used as well as c++ access specifiers.
+ * \return the encode signature
+ */
+std::string ProtocolPacket::getParameterPacketEncodeSignature(bool insource) const
+{
+    std::string output;
+    std::string pg;
+
+    if(insource)
+        pg = "_pg_";
+
+    if(support.language == ProtocolSupport::c_language)
+    {
+        output = "void encode" + support.prefix + name + support.packetParameterSuffix + "(" + support.pointerType + " " + pg + "pkt";
+    }
+    else
+    {
+        // C++ class member, this function should be "static" as it does not depend on any variables in the class
+        if(!insource)
+            output += "static ";
+
+        output += "void ";
+
+        // In the source the function needs the class scope
+        if(insource)
+            output += typeName + "::";
+
+        output += "encode(" + support.pointerType + " " + pg + "pkt";
+    }
+
+    output += getDataEncodeParameterList();
+
+    if(ids.size() <= 1)
+        output += ")";
+    else
+        output += ", uint32_t " + pg + "id)";
+
+    return output;
+}
+
+
+/*!
+ * Get the prototype for the parameter packet encode function
+ * \param spacing is the offset for each line
+ * \return the prototype including semicolon and line fees
+ */
+std::string ProtocolPacket::getParameterPacketEncodePrototype(const std::string& spacing) const
+{
+    std::string output;
+
+    if(!encode)
         return output;
 
     output += spacing + "//! " + getDataEncodeBriefComment() + "\n";
@@ -1810,7 +3175,7 @@ std::string ProtocolPacket::getTopLevelMarkdown(bool global, const std::vector<s
     (void)global;
     (void)packetids;
 
-    std::string output;
+    CodeEmitter output(4096);
 
     if(ids.size() <= 1)
     {
@@ -1819,14 +3184,14 @@ std::string ProtocolPacket::getTopLevelMarkdown(bool global, const std::vector<s
 
         // Put an anchor in the identifier line which is the same as the ID. We'll link to it if we can
         if(title == name)
-            output += "## <a name=\"" + id + "\"></a>" + name + " packet\n\n";
+            output.append("## <a name=\"", id, "\"></a>", name, " packet\n\n");
         else
-            output += "## <a name=\"" + id + "\"></a>" + title + "\n\n";
+            output.append("## <a name=\"", id, "\"></a>", title, "\n\n");
 
         if(!comment.empty())
         {
-            output += comment + "\n";
-            output += "\n";
+            output.append(comment, "\n");
+            output.append("\n");
         }
 
         if(!ids.at(0).empty())
@@ -1835,9 +3200,9 @@ std::string ProtocolPacket::getTopLevelMarkdown(bool global, const std::vector<s
             idvalue = parser->replaceEnumerationNameWithValue(idvalue);
 
             if(id.compare(idvalue) == 0)
-                output += "- packet identifier: `" + id + "`\n";
+                output.append("- packet identifier: `", id, "`\n");
             else
-                output += "- packet identifier: `" + id + "` : " + idvalue + "\n";
+                output.append("- packet identifier: `", id, "` : ", idvalue, "\n");
         }
 
     }// if a single identifier
@@ -1845,18 +3210,18 @@ std::string ProtocolPacket::getTopLevelMarkdown(bool global, const std::vector<s
     {
         // Packet name heading
         if(title == name)
-            output += "## " + name + " packet\n\n";
+            output.append("## ", name, " packet\n\n");
         else
-            output += "## " + title + "\n\n";
+            output.append("## ", title, "\n\n");
 
         if(!comment.empty())
         {
-            output += comment + "\n";
-            output += "\n";
+            output.append(comment, "\n");
+            output.append("\n");
         }
 
-        output += "This packet supports multiple identifiers.\n";
-        output += "\n";
+        output.append("This packet supports multiple identifiers.\n");
+        output.append("\n");
         for(std::size_t i= 0; i < ids.size(); i++)
         {
             std::string id = ids.at(i);
@@ -1867,9 +3232,9 @@ std::string ProtocolPacket::getTopLevelMarkdown(bool global, const std::vector<s
 
             // Put the link here in this case
             if(id.compare(idvalue) == 0)
-                output += "- packet identifier: <a name=\"" + id + "\"></a>`" + id + "`\n";
+                output.append("- packet identifier: <a name=\"", id, "\"></a>`", id, "`\n");
             else
-                output += "- packet identifier: <a name=\"" + id + "\"></a>`" + id + "` : " + idvalue + "\n";
+                output.append("- packet identifier: <a name=\"", id, "\"></a>`", id, "` : ", idvalue, "\n");
 
         }// for all identifers
 
@@ -1890,7 +3255,7 @@ std::string ProtocolPacket::getTopLevelMarkdown(bool global, const std::vector<s
         // Output the length, replacing the multiply asterisk with a times symbol
         // We put spaces around the multiply symbol, so that the html tables can
         // better reflow the resulting text
-        output += "- data length: " + replace(minLength, "*", " &times; ") + "\n";
+        output.append("- data length: ", replace(minLength, "*", " &times; "), "\n");
     }
     else
     {
@@ -1909,27 +3274,27 @@ std::string ProtocolPacket::getTopLevelMarkdown(bool global, const std::vector<s
         // Output the length, replacing the multiply asterisk with a times symbol
         // We put spaces around the multiply symbol, so that the html tables can
         // better reflow the resulting text
-        output += "- minimum data length: " + replace(minLength, "*", " &times; ") + "\n";
+        output.append("- minimum data length: ", replace(minLength, "*", " &times; "), "\n");
 
         // Output the length, replacing the multiply asterisk with a times symbol
         // We put spaces around the multiply symbol, so that the html tables can
         // better reflow the resulting text
-        output += "- maximum data length: " + replace(maxLength, "*", " &times; ") + "\n";
+        output.append("- maximum data length: ", replace(maxLength, "*", " &times; "), "\n");
     }
 
     // Output any documetation data
-    output += "\n";
+    output.append("\n");
     for(std::size_t i = 0; i < documentList.size(); i++)
-        output += documentList.at(i)->getTopLevelMarkdown();
+        output.append(documentList.at(i)->getTopLevelMarkdown());
 
     for(std::size_t i = 0; i < enumList.size(); i++)
     {
         if(enumList[i] == nullptr)
             continue;
 
-        output += enumList[i]->getTopLevelMarkdown();
-        output += "\n";
-        output += "\n";
+        output.append(enumList[i]->getTopLevelMarkdown());
+        output.append("\n");
+        output.append("\n");
     }
 
     if(encodables.size() > 0)
@@ -2004,96 +3369,91 @@ std::string ProtocolPacket::getTopLevelMarkdown(bool global, const std::vector<s
         }
 
 
-        output += "\n";
+        output.append("\n");
 
         // Table header, notice the column markers lead and follow. We have to do this for merged cells
-        output +=  "| ";
-        output += spacedString(bytes.at(0), byteColumn);
-        output += " | ";
-        output += spacedString(names.at(0), nameColumn);
-        output += " | ";
-        output += spacedString(encodings.at(0), encodingColumn);
-        output += " | ";
-        output += spacedString(repeats.at(0), repeatColumn);
-        output += " | ";
-        output += spacedString(comments.at(0), commentColumn);
-        output += " |\n";
+        output.append("| ");
+        output.appendPadded(bytes.at(0), byteColumn);
+        output.append(" | ");
+        output.appendPadded(names.at(0), nameColumn);
+        output.append(" | ");
+        output.appendPadded(encodings.at(0), encodingColumn);
+        output.append(" | ");
+        output.appendPadded(repeats.at(0), repeatColumn);
+        output.append(" | ");
+        output.appendPadded(comments.at(0), commentColumn);
+        output.append(" |\n");
 
         // Underscore the header, first two columns left aligned
-        output +=  "| :";
-        for(std::size_t i = 1; i < byteColumn; i++)
-            output += "-";
+        output.append("| :");
+        output.appendRepeated('-', byteColumn - 1);
 
-        output +=  " | :";
-        for(std::size_t i = 1; i < nameColumn; i++)
-            output += "-";
+        output.append(" | :");
+        output.appendRepeated('-', nameColumn - 1);
 
         // Encoding column is centered
-        output += " | :";
-        for(std::size_t i = 1; i < encodingColumn-1; i++)
-            output += "-";
+        output.append(" | :");
+        output.appendRepeated('-', encodingColumn - 2);
 
         // Repeat column is centered
-        output += ": | :";
-        for(std::size_t i = 1; i < repeatColumn-1; i++)
-            output += "-";
+        output.append(": | :");
+        output.appendRepeated('-', repeatColumn - 2);
 
-        output += ": | ";
-        for(std::size_t i = 0; i < commentColumn; i++)
-            output += "-";
-        output += " |\n";
+        output.append(": | ");
+        output.appendRepeated('-', commentColumn);
+        output.append(" |\n");
 
         // Now write out the outputs
         for(std::size_t i = 1; i < names.size(); i++)
         {
             // Open the line
-            output +=  "| ";
-            output += spacedString(bytes.at(i), byteColumn);
-            output += " | ";
-            output += spacedString(names.at(i), nameColumn);
+            output.append("| ");
+            output.appendPadded(bytes.at(i), byteColumn);
+            output.append(" | ");
+            output.appendPadded(names.at(i), nameColumn);
 
             // We support the idea that repeats and or encodings could be empty, causing cells to be merged
             if(encodings.at(i).empty() && repeats.at(i).empty())
             {
-                output += spacedString("", encodingColumn + repeatColumn);
-                output += TAB_IN + " ||| ";
+                output.appendRepeated(' ', encodingColumn + repeatColumn);
+                output.append(TAB_IN, " ||| ");
             }
             else if(encodings.at(i).empty())
             {
-                output += spacedString(encodings.at(i), encodingColumn);
-                output += "   || ";
-                output += spacedString(repeats.at(i), repeatColumn);
-                output += " | ";
+                output.appendPadded(encodings.at(i), encodingColumn);
+                output.append("   || ");
+                output.appendPadded(repeats.at(i), repeatColumn);
+                output.append(" | ");
             }
             else if(repeats.at(i).empty())
             {
-                output += " | ";
-                output += spacedString(encodings.at(i), encodingColumn);
-                output += spacedString(repeats.at(i), repeatColumn);
-                output += "   || ";
+                output.append(" | ");
+                output.appendPadded(encodings.at(i), encodingColumn);
+                output.appendPadded(repeats.at(i), repeatColumn);
+                output.append("   || ");
 
             }
             else
             {
-                output += " | ";
-                output += spacedString(encodings.at(i), encodingColumn);
-                output += " | ";
-                output += spacedString(repeats.at(i), repeatColumn);
-                output += " | ";
+                output.append(" | ");
+                output.appendPadded(encodings.at(i), encodingColumn);
+                output.append(" | ");
+                output.appendPadded(repeats.at(i), repeatColumn);
+                output.append(" | ");
             }
 
-            output += spacedString(comments.at(i), commentColumn);
-            output += " |\n";
+            output.appendPadded(comments.at(i), commentColumn);
+            output.append(" |\n");
         }
 
         // Table caption
-        output += "[" + title + " packet bytes]\n";
+        output.append("[", title, " packet bytes]\n");
 
-        output += "\n";
+        output.append("\n");
 
     }
 
-    return output;
+    return output.take();
 
 }// ProtocolPacket::getTopLevelMarkdown
 
@@ -10,7 +10,7 @@ class ProtocolPacket : public ProtocolStructureModule
 {
 public:
     //! Construct the packet parsing object, with details about the overall protocol
-    ProtocolPacket(ProtocolParser* parse, ProtocolSupport supported);
+    ProtocolPacket(ProtocolParser* parse, const ProtocolSupport& supported);
 
     ~ProtocolPacket();
 
@@ -47,8 +47,14 @@ public:
     //! Return the flag indicating if this packet has DBC receive turned on
     bool dbcrx(void) const {return dbcrxon;}
 
+    //! Return the function which times the encode and decode of this packet, empty if it cannot be timed
+    std::string getBenchFunctionBody(void) const override;
+
 protected:
 
+    //! Determine if the encode and decode of this packet can be timed
+    bool isBenchable(void) const override;
+
     //! Get the class declaration, for this packet only (not its children) for the C++ language
     std::string getClassDeclaration_CPP(void) const override;
 
@@ -82,8 +88,44 @@ protected:
     //! Get the prototype for the structure packet decode function
     std::string getStructurePacketDecodePrototype(const std::string& spacing) const;
 
-    //! Get the prototype for the structure packet decode function
-    std::string getStructurePacketDecodeBody(void) const;
+    //! Output the body of the structure packet decode function
+    void emitStructurePacketDecodeBody(CodeEmitter& output) const;
+
+    //! Output the code that verifies the packet identifier in a decode function
+    void emitPacketIdentifierCheck(CodeEmitter& output, const std::string& id) const;
+
+    //! Get the first encodable of each step of the resumable decoder and the delta encoding
+    void getEncodableSteps(std::vector<std::size_t>& steps) const;
+
+    //! Determine if a step of the resumable decoder is an array which is decoded one element at a time
+    bool isElementStep(const std::vector<std::size_t>& steps, std::size_t step) const;
+
+    //! Determine if any step of the resumable decoder is an array which is decoded one element at a time
+    bool hasElementSteps(void) const;
+
+    //! Get the largest encoded length of one element of an array which is decoded one element at a time
+    std::string getElementStepLength(const Encodable* encodable) const;
+
+    //! Get the declaration of the state of the resumable decoder
+    std::string getResumableDecoderDeclaration(const std::string& spacing) const;
+
+    //! Get the prototypes of the resumable decoder functions
+    std::string getResumableDecoderPrototypes(const std::string& spacing) const;
+
+    //! Get the functions of the resumable decoder
+    std::string getResumableDecoderBody(void) const;
+
+    //! Get the steps of the delta encoding, and the condition that sends each one
+    void getDeltaSteps(std::vector<std::size_t>& steps, std::vector<std::string>& conditions) const;
+
+    //! Get the number of bits in the bitmap of the delta encoding
+    int getNumberOfDeltaBits(void) const;
+
+    //! Get the prototypes of the delta encoding functions
+    std::string getDeltaPrototypes(const std::string& spacing) const;
+
+    //! Get the functions of the delta encoding
+    std::string getDeltaBody(void) const;
 
     //! Get the packet encode signature
     std::string getParameterPacketEncodeSignature(bool insource) const;
@@ -132,6 +174,12 @@ protected:
     //! Flag to output structure functions
     bool structureFunctions;
 
+    //! Flag to output the resumable decoder, which decodes the packet data in fragments
+    bool resumable;
+
+    //! Flag to output the delta encoding, which sends only the fields that differ from a reference
+    bool delta;
+
     //! Flag for DBC transmit turned on
     bool dbctxon;
 
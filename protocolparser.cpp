@@ -5,14 +5,24 @@
 #include "protocolscaling.h"
 #include "fieldcoding.h"
 #include "protocolfloatspecial.h"
+#include "protocolfieldmap.h"
+#include "protocolfieldhash.h"
 #include "protocolsupport.h"
 #include "protocolbitfield.h"
 #include "protocoldocumentation.h"
 #include "shuntingyard.h"
+#include "protocolcache.h"
+#include "protocolbench.h"
 #include <string>
 #include <iostream>
 #include <filesystem>
 #include <fstream>
+#include <future>
+#include <cctype>
+
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#endif
 
 // The version of the protocol generator is set here
 const std::string ProtocolParser::genVersion = "3.6.i";
@@ -32,6 +42,9 @@ ProtocolParser::ProtocolParser() :
     noAboutSection(false),
     nocss(false),
     tableOfContents(false),
+    incremental(false),
+    bench(false),
+    cache(nullptr),
     dbcidtx(0),
     dbcidrx(0),
     dbcshift(0),
@@ -45,29 +58,28 @@ ProtocolParser::ProtocolParser() :
  */
 ProtocolParser::~ProtocolParser()
 {
-    // Delete all of our lists of new'ed objects
-    for(auto doc : documents)
-        delete doc;
-    documents.clear();
+    // Wait for any background loads, their documents are in the arena
+    pendingfiles.clear();
 
-    for(auto struc : structures)
-        delete struc;
-    structures.clear();
+    // Wait for any documentation tools, they may still be using our files
+    waitForRenderers();
 
-    for(auto enu : enums)
-        delete enu;
+    // The protocol model objects are owned by the arena, destroy them
+    // before the header, in the reverse order of their creation
+    alldocumentsinorder.clear();
+    documents.clear();
+    structures.clear();
+    packets.clear();
     enums.clear();
-
-    for(auto globalenu : globalEnums)
-        delete globalenu;
     globalEnums.clear();
-
-    for(auto xmldoc : xmldocs)
-        delete xmldoc;
     xmldocs.clear();
+    arena.clear();
 
     if(header != nullptr)
         delete header;
+
+    if(cache != nullptr)
+        delete cache;
 }
 
 
@@ -84,6 +96,9 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
     // Top level printout of the version information
     std::cout << "ProtoGen version " << genVersion << std::endl;
 
+    profiler.begin("Generate protocol", "phase");
+    profiler.begin("Load xml files", "phase");
+
     std::filesystem::path filepath(filename);
 
     // Remember the input path, in case there are files referenced by the main file
@@ -94,25 +109,26 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
 
     // Also remember the name of the file, which we use for warning outputs
     inputfile = filepath.filename().string();
-    std::fstream file(filename, std::ios_base::in);
 
-    if(!file.is_open())
+    XMLError error;
+    currentxml = loadFile(filename, error);
+    xmldocs.push_back(currentxml);
+
+    if(error == XML_ERROR_FILE_NOT_FOUND)
     {
         std::cerr << filename << " : error: Failed to open protocol file" << std::endl;
         return false;
     }
-
-    currentxml = new XMLDocument();
-    xmldocs.push_back(currentxml);
-    if(currentxml->Parse(std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>()).c_str()) != XML_SUCCESS)
+    else if(error != XML_SUCCESS)
     {
-        file.close();
         std::cerr << currentxml->ErrorStr() << std::endl;
         return false;
     }
 
-    // Done with the file
-    file.close();
+    // parseFile() will use this document rather than loading the file again
+    std::promise<XMLError> loaded;
+    loaded.set_value(error);
+    pendingfiles[filename] = PendingFile{currentxml, loaded.get_future().share()};
 
     // Set our output directory
     // Make the path as short as possible
@@ -206,6 +222,15 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
     // Finally the main file
     parseFile(filename);
 
+    // Wait for any background loads that were not used, the files were
+    // reached twice by different paths
+    pendingfiles.clear();
+
+    profiler.end();
+
+    // These are all the xml files that were read, for the dependency output
+    std::vector<std::string> inputs = filesparsed;
+
     // This is a resource file for bitfield testing
     if(support.bitfieldtest && support.bitfield && !nocode)
     {
@@ -225,16 +250,55 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
         }
     }
 
+    // Incremental output compares the inputs of each module against the previous run
+    if(incremental && !nocode)
+    {
+        ProtocolProfiler::Scope profile(profiler, "Compare incremental cache", "phase");
+
+        cache = new ProtocolCache();
+        cache->load(support.outputpath + name + ".protogencache");
+        cache->setCommonInputs(std::vector<const XMLDocument*>(xmldocs.begin(), xmldocs.end()), support.getOptionsText());
+
+        for(std::size_t i = 0; i < globalEnums.size(); i++)
+            cache->addModule("enum", globalEnums.at(i)->getElement());
+
+        for(std::size_t i = 0; i < structures.size(); i++)
+            cache->addModule("structure", structures.at(i)->getElement());
+
+        for(std::size_t i = 0; i < packets.size(); i++)
+            cache->addModule("packet", packets.at(i)->getElement());
+
+        // The protocol header is always output, anything that shares it must be output as well
+        std::vector<std::string> alwaysWritten(1, header->filePath() + header->fileName());
+
+        // The bitfield test is appended to the bitfieldtest module every time
+        if(support.bitfieldtest && support.bitfield)
+        {
+            alwaysWritten.push_back(header->filePath() + "bitfieldtest.h");
+
+            if(support.language == ProtocolSupport::c_language)
+                alwaysWritten.push_back(header->filePath() + "bitfieldtest.c");
+            else
+                alwaysWritten.push_back(header->filePath() + "bitfieldtest.cpp");
+        }
+
+        cache->findUnchangedModules(alwaysWritten);
+    }
+
     // Output the global enumerations first, they will go in the main
     // header file by default, unless the enum specifies otherwise
     ProtocolHeaderFile enumfile(support);
     ProtocolSourceFile enumSourceFile(support);
 
+    profiler.begin("Parse global enumerations", "phase");
+
     for(std::size_t i = 0; i < globalEnums.size(); i++)
     {
         EnumCreator* module = globalEnums.at(i);
+        ProtocolProfiler::Scope profile(profiler, "enumeration", "enumeration");
 
         module->parseGlobal(nocode);
+        profile.setName(module->getHierarchicalName());
 
         // If nocode is active, we still parse, we just don't generate
         if(nocode)
@@ -247,6 +311,13 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
             continue;
         }
 
+        // Don't output if the output from the previous run is still valid
+        if((cache != nullptr) && cache->isUnchanged(module->getElement()))
+        {
+            cache->setFiles(module->getElement(), std::vector<std::string>());
+            continue;
+        }
+
         std::vector<std::string> list;
         module->getIncludeDirectives(list);
 
@@ -274,15 +345,43 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
         // Keep a list of all the file names we used
         fileNameList.push_back(enumfile.fileName());
         filePathList.push_back(enumfile.filePath());
+
+        // Remember the files for the next run
+        if(cache != nullptr)
+        {
+            std::vector<std::string> files(1, enumfile.filePath() + enumfile.fileName());
+
+            if(!source.empty())
+                files.push_back(enumSourceFile.filePath() + enumSourceFile.fileName());
+
+            cache->setFiles(module->getElement(), files);
+        }
     }
 
+    profiler.end();
+
     // Now parse the global structures
+    profiler.begin("Parse global structures", "phase");
+
     for(std::size_t i = 0; i < structures.size(); i++)
     {
         ProtocolStructureModule* module = structures[i];
+        ProtocolProfiler::Scope profile(profiler, "structure", "structure");
+
+        // Skip the code output if the output from the previous run is still valid
+        if(cache != nullptr)
+        {
+            cache->setCurrentModule(module->getElement());
+            module->setUnchanged(cache->isUnchanged(module->getElement()));
+        }
 
         // Parse its XML and generate the output
         module->parse(nocode);
+        profile.setName(module->getHierarchicalName());
+
+        // Remember the files for the next run
+        if(cache != nullptr)
+            cache->setFiles(module->getElement(), module->getFilePathsAndNames());
 
         // If nocode is active, we still parse, we just don't generate
         if(nocode)
@@ -311,9 +410,16 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
         filePathList.push_back(module->getMapSourceFilePath());
         fileNameList.push_back(module->getMapHeaderFileName());
         filePathList.push_back(module->getMapHeaderFilePath());
+        fileNameList.push_back(module->getJsonSourceFileName());
+        filePathList.push_back(module->getJsonSourceFilePath());
+        fileNameList.push_back(module->getJsonHeaderFileName());
+        filePathList.push_back(module->getJsonHeaderFilePath());
 
     }// for all top level structures
 
+    profiler.end();
+    profiler.begin("Parse packets", "phase");
+
     // And the global packets. We want to sort the packets into two batches:
     // those packets which can be used by other packets; and those which cannot.
     // This way we can parse the first batch ahead of the second
@@ -324,8 +430,22 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
         if(!isFieldSet(packet->getElement(), "useInOtherPackets"))
             continue;
 
+        ProtocolProfiler::Scope profile(profiler, "packet", "packet");
+
+        // Skip the code output if the output from the previous run is still valid
+        if(cache != nullptr)
+        {
+            cache->setCurrentModule(packet->getElement());
+            packet->setUnchanged(cache->isUnchanged(packet->getElement()));
+        }
+
         // Parse its XML
         packet->parse(nocode);
+        profile.setName(packet->getHierarchicalName());
+
+        // Remember the files for the next run
+        if(cache != nullptr)
+            cache->setFiles(packet->getElement(), packet->getFilePathsAndNames());
 
         // The structures have been parsed, adding this packet to the list
         // makes it available for other packets to find as structure reference
@@ -358,6 +478,10 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
         filePathList.push_back(packet->getMapSourceFilePath());
         fileNameList.push_back(packet->getMapHeaderFileName());
         filePathList.push_back(packet->getMapHeaderFilePath());
+        fileNameList.push_back(packet->getJsonSourceFileName());
+        filePathList.push_back(packet->getJsonSourceFilePath());
+        fileNameList.push_back(packet->getJsonHeaderFileName());
+        filePathList.push_back(packet->getJsonHeaderFilePath());
 
     }
 
@@ -369,8 +493,22 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
         if(isFieldSet(packet->getElement(), "useInOtherPackets"))
             continue;
 
+        ProtocolProfiler::Scope profile(profiler, "packet", "packet");
+
+        // Skip the code output if the output from the previous run is still valid
+        if(cache != nullptr)
+        {
+            cache->setCurrentModule(packet->getElement());
+            packet->setUnchanged(cache->isUnchanged(packet->getElement()));
+        }
+
         // Parse its XML
         packet->parse(nocode);
+        profile.setName(packet->getHierarchicalName());
+
+        // Remember the files for the next run
+        if(cache != nullptr)
+            cache->setFiles(packet->getElement(), packet->getFilePathsAndNames());
 
         // If nocode is active, we still parse, we just don't generate
         if(nocode)
@@ -399,10 +537,18 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
         filePathList.push_back(packet->getMapSourceFilePath());
         fileNameList.push_back(packet->getMapHeaderFileName());
         filePathList.push_back(packet->getMapHeaderFilePath());
+        fileNameList.push_back(packet->getJsonSourceFileName());
+        filePathList.push_back(packet->getJsonSourceFilePath());
+        fileNameList.push_back(packet->getJsonHeaderFileName());
+        filePathList.push_back(packet->getJsonHeaderFilePath());
 
     }
 
+    profiler.end();
+
     // Parse all of the documentation
+    profiler.begin("Parse documentation", "phase");
+
     for(std::size_t i = 0; i < documents.size(); i++)
     {
         ProtocolDocumentation* doc = documents.at(i);
@@ -410,37 +556,91 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
         doc->parse();
     }
 
+    profiler.end();
+
     if(!nohelperfiles && !nocode)
     {
+        ProtocolProfiler::Scope profile(profiler, "Generate helper files", "phase");
+
         // Auto-generated files for coding
         ProtocolScaling(support).generate(fileNameList, filePathList);
         FieldCoding(support).generate(fileNameList, filePathList);
         ProtocolFloatSpecial(support).generate(fileNameList, filePathList);
+        ProtocolFieldMap(support).generate(fileNameList, filePathList);
+
+        // The hash helpers are only output if something is hashed
+        bool hash = false;
+        for(std::size_t i = 0; i < structures.size(); i++)
+            hash = hash || structures.at(i)->usesHash();
+
+        for(std::size_t i = 0; i < packets.size(); i++)
+            hash = hash || packets.at(i)->usesHash();
+
+        if(hash)
+            ProtocolFieldHash(support).generate(fileNameList, filePathList);
 
         // Code for testing bitfields
         if(support.bitfieldtest && support.bitfield)
             ProtocolBitfield::generatetest(support);
     }
 
+    if(bench && !nocode)
+    {
+        ProtocolProfiler::Scope profile(profiler, "Generate bench", "phase");
+        ProtocolBench(support).generate(structures, packets, header->fileName(), fileNameList, filePathList);
+    }
+
     if(!nomarkdown)
+    {
+        ProtocolProfiler::Scope profile(profiler, "Output markdown", "phase");
         outputMarkdown(inlinecss);
+    }
 
     if(!dbcfile.empty())
+    {
+        ProtocolProfiler::Scope profile(profiler, "Output DBC", "phase");
         outputDBC();
-
-    #ifndef _DEBUG
-    if(!nodoxygen)
-        outputDoxygen();
-    #endif
+    }
 
     // The last bit of the protocol header
     if(!nocode)
         finishProtocolHeader();
 
     // This is fun...replace all the temporary files with real ones if needed
+    profiler.begin("Copy temporary files", "phase");
+
     for(std::size_t i = 0; i < fileNameList.size(); i++)
         ProtocolFile::copyTemporaryFile(filePathList.at(i), fileNameList.at(i));
 
+    profiler.end();
+
+    // Doxygen reads the code, so it starts once the code is in place
+    #ifndef _DEBUG
+    if(!nodoxygen)
+    {
+        ProtocolProfiler::Scope profile(profiler, "Output doxygen", "phase");
+        outputDoxygen();
+    }
+    #endif
+
+    // Remember the module inputs for the next run
+    if(cache != nullptr)
+    {
+        cache->setCurrentModule(nullptr);
+        cache->save(support.outputpath + name + ".protogencache");
+
+        std::cout << "Skipped code output for " << cache->numUnchangedModules() << " of " << cache->numModules() << " unchanged modules" << std::endl;
+    }
+
+    if(!depfile.empty())
+        outputDependencyFile(inputs);
+
+    if(!renderers.empty())
+    {
+        ProtocolProfiler::Scope profile(profiler, "Wait for documentation tools", "phase");
+        waitForRenderers();
+    }
+
     // If we are putting the files in our local directory then we don't just want an empty string in our printout
     if(path.empty())
         path = "./";
@@ -450,6 +650,20 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
     else
         std::cout << "Generated protocol files in " << path << std::endl;
 
+    if(profiler.isEnabled())
+    {
+        // End of "Generate protocol"
+        profiler.end();
+        profiler.report(std::cout);
+
+        std::string tracefile = support.outputpath + name + ".profile.json";
+
+        if(profiler.writeTrace(tracefile))
+            std::cout << "Wrote profile trace to " << tracefile << std::endl;
+        else
+            std::cerr << "warning: Failed to write profile trace " << tracefile << std::endl;
+    }
+
     return true;
 
 }// ProtocolParser::parse
@@ -465,9 +679,6 @@ bool ProtocolParser::parseFile(std::string xmlFilename)
     // Path contains the path and file name and extension
     std::filesystem::path path(xmlFilename);
 
-    // We allow each xml file to alter the global filenames used, but only for the context of that xml.
-    ProtocolSupport localsupport(support);
-
     std::string absolutepathname;
 
     if(xmlFilename.at(0) == ':')
@@ -484,33 +695,22 @@ bool ProtocolParser::parseFile(std::string xmlFilename)
 
     std::cout << "Parsing file " << ProtocolFile::sanitizePath(path.parent_path().string()) << path.filename().string() << std::endl;
 
-    std::fstream xmlFile(xmlFilename, std::ios_base::in);
+    XMLError error;
+    XMLDocument* doc = loadFile(xmlFilename, error);
 
-    if(!xmlFile.is_open())
+    if(error == XML_ERROR_FILE_NOT_FOUND)
     {
         std::string warning = "error: Failed to open xml protocol file " + xmlFilename;
         std::cerr << warning << std::endl;
         return false;
     }
 
-    currentxml = new XMLDocument();
-    xmldocs.push_back(currentxml);
-    std::string contents = std::string((std::istreambuf_iterator<char>(xmlFile)), std::istreambuf_iterator<char>());
-
-    // Done with the file
-    xmlFile.close();
-
-    // Error parsing
-    std::string error;
-    //int errorLine, errorCol;
-
-    currentxml = new XMLDocument();
+    currentxml = doc;
 
     // Extract XML data
-    if(currentxml->Parse(contents.c_str()) != XML_SUCCESS)
+    if(error != XML_SUCCESS)
     {
         std::cerr << currentxml->ErrorStr() << std::endl;
-        delete currentxml;
 
         if(xmldocs.size() > 0)
             currentxml = xmldocs.back();
@@ -533,10 +733,19 @@ bool ProtocolParser::parseFile(std::string xmlFilename)
         return false;
     }
 
+    // We allow each xml file to alter the global filenames used, but only for
+    // the context of that xml. The objects created from this xml keep a
+    // reference to these options, so they are stored for the parser lifetime.
+    filesupports.push_back(support);
+    ProtocolSupport& localsupport = filesupports.back();
+
     // Protocol file options specified in the xml
     localsupport.parseFileNames(docElem->FirstAttribute());
     localsupport.sourcefile = xmlFilename;
 
+    // The required files are independent of each other, load them all now
+    prefetchRequiredFiles(docElem, xmlFilename);
+
     for(const XMLElement* element = docElem->FirstChildElement(); element != nullptr; element = element->NextSiblingElement())
     {
         std::string nodename = toLower(trimm(element->Name()));
@@ -565,7 +774,7 @@ bool ProtocolParser::parseFile(std::string xmlFilename)
         }
         else if( nodename == "struct" || nodename == "structure" )
         {
-            ProtocolStructureModule* module = new ProtocolStructureModule( this, localsupport );
+            ProtocolStructureModule* module = arena.create<ProtocolStructureModule>( this, localsupport );
 
             // Remember the XML
             module->setElement(element);
@@ -574,7 +783,7 @@ bool ProtocolParser::parseFile(std::string xmlFilename)
         }
         else if( nodename == "enum" || nodename == "enumeration" )
         {
-            EnumCreator* Enum = new EnumCreator( this, nodename, localsupport );
+            EnumCreator* Enum = arena.create<EnumCreator>( this, nodename, localsupport );
 
             Enum->setElement(element);
 
@@ -584,7 +793,7 @@ bool ProtocolParser::parseFile(std::string xmlFilename)
         // Define a packet
         else if( nodename == "packet" || nodename == "pkt" )
         {
-            ProtocolPacket* packet = new ProtocolPacket( this, localsupport );
+            ProtocolPacket* packet = arena.create<ProtocolPacket>( this, localsupport );
 
             packet->setElement(element);
 
@@ -593,7 +802,7 @@ bool ProtocolParser::parseFile(std::string xmlFilename)
         }
         else if ( nodename == "doc" || contains(nodename, "document"))
         {
-            ProtocolDocumentation* document = new ProtocolDocumentation( this, nodename, localsupport );
+            ProtocolDocumentation* document = arena.create<ProtocolDocumentation>( this, nodename, localsupport );
 
             document->setElement(element);
 
@@ -612,6 +821,85 @@ bool ProtocolParser::parseFile(std::string xmlFilename)
 }// ProtocolParser::parseFile
 
 
+/*!
+ * Start loading the files named by the "Require" tags of a document. Each
+ * file is read and parsed by tinyxml2 in its own thread, the resulting
+ * documents are used by parseFile() in the order of the "Require" tags, so
+ * the protocol model is the same as if the files were loaded one at a time.
+ * \param docElem is the top level element of the document.
+ * \param xmlFilename is the name of the document's file, required files are relative to it.
+ */
+void ProtocolParser::prefetchRequiredFiles(const XMLElement* docElem, const std::string& xmlFilename)
+{
+    std::filesystem::path path(xmlFilename);
+
+    for(const XMLElement* element = docElem->FirstChildElement(); element != nullptr; element = element->NextSiblingElement())
+    {
+        if(toLower(trimm(element->Name())) != "require")
+            continue;
+
+        std::string subfile = getAttribute("file", element->FirstAttribute());
+        if(subfile.empty())
+            continue;
+
+        if(!endsWith(subfile, ".xml"))
+            subfile += ".xml";
+
+        // This must match the name parseFile() is called with
+        subfile = ProtocolFile::sanitizePath(path.parent_path().string()) + subfile;
+
+        if(pendingfiles.find(subfile) != pendingfiles.end())
+            continue;
+
+        if((subfile.at(0) != ':') && contains(filesparsed, std::filesystem::absolute(subfile).string()))
+            continue;
+
+        // The arena is not thread safe, so the document is created here
+        XMLDocument* doc = arena.create<XMLDocument>();
+
+        try
+        {
+            std::shared_future<XMLError> result = std::async(std::launch::async, [doc, subfile]() {return doc->LoadFile(subfile.c_str());}).share();
+            pendingfiles[subfile] = PendingFile{doc, result};
+        }
+        catch(...)
+        {
+            // No threads available, parseFile() will load the file itself
+        }
+
+    }// for all top level elements
+
+}// ProtocolParser::prefetchRequiredFiles
+
+
+/*!
+ * Get the document for an xml file. If the file is being loaded in the
+ * background this waits for it, otherwise the file is loaded now. Either way
+ * the file is read directly into the document's buffer, there is no
+ * intermediate copy of the file contents.
+ * \param xmlFilename is the name of the file.
+ * \param error receives the result of loading the document.
+ * \return the document, which is owned by the arena and is never null.
+ */
+XMLDocument* ProtocolParser::loadFile(const std::string& xmlFilename, XMLError& error)
+{
+    std::map<std::string, PendingFile>::iterator it = pendingfiles.find(xmlFilename);
+
+    if(it != pendingfiles.end())
+    {
+        XMLDocument* doc = it->second.doc;
+        error = it->second.result.get();
+        pendingfiles.erase(it);
+        return doc;
+    }
+
+    XMLDocument* doc = arena.create<XMLDocument>();
+    error = doc->LoadFile(xmlFilename.c_str());
+    return doc;
+
+}// ProtocolParser::loadFile
+
+
 /*!
  * Create the header file for the top level module of the protocol
  * \param docElem is the "protocol" element from the DOM
@@ -913,6 +1201,25 @@ std::string ProtocolParser::getAttribute(const std::string &name, const XMLAttri
 }// ProtocolParser::getAttribute
 
 
+/*!
+ * Return the value of an attribute from an index of a Dom Element's attributes
+ * \param name is the name of the attribute to get
+ * \param map is the index of the element's attributes
+ * \param defaultIfNone is returned if the attribute is not present
+ * \return the trimmed value of the attribute, or defaultIfNone
+ */
+std::string ProtocolParser::getAttribute(const std::string& name, const AttributeIndex& map, const std::string& defaultIfNone)
+{
+    const XMLAttribute* a = map.find(name.c_str());
+
+    if(a != nullptr)
+        return trimm(a->Value());
+    else
+        return defaultIfNone;
+
+}// ProtocolParser::getAttribute
+
+
 /*!
  * Parse all enumerations which are direct children of a DomNode. The
  * enumerations will be stored in the global list
@@ -949,7 +1256,7 @@ void ProtocolParser::parseEnumerations(const std::string& parent, const XMLNode*
  */
 const EnumCreator* ProtocolParser::parseEnumeration(const std::string& parent, const XMLElement* element, bool nocode)
 {
-    EnumCreator* Enum = new EnumCreator(this, parent, support);
+    EnumCreator* Enum = arena.create<EnumCreator>(this, parent, support);
 
     Enum->setElement(element);
     Enum->parse(nocode);
@@ -963,7 +1270,6 @@ const EnumCreator* ProtocolParser::parseEnumeration(const std::string& parent, c
         // This is not a warning, just useful information
         std::cout << "Skipping code output for enumeration " << Enum->getHierarchicalName() << std::endl;
 
-        delete Enum;
         Enum = nullptr;
     }
     else
@@ -1045,6 +1351,9 @@ std::string ProtocolParser::lookUpIncludeFilenameForImplementation(const std::st
     {
         if(structures.at(i)->typeName == typeName)
         {
+            if(cache != nullptr)
+                cache->addDependency(structures.at(i)->getElement());
+
             return structures.at(i)->getHeaderFileName();
         }
     }
@@ -1053,6 +1362,9 @@ std::string ProtocolParser::lookUpIncludeFilenameForImplementation(const std::st
     {
         if(packets.at(i)->typeName == typeName)
         {
+            if(cache != nullptr)
+                cache->addDependency(packets.at(i)->getElement());
+
             return packets.at(i)->getHeaderFileName();
         }
     }
@@ -1085,6 +1397,9 @@ std::string ProtocolParser::lookUpIncludeFilenameForDefinition(const std::string
     {
         if((structures.at(i)->typeName == typeName) || structures.at(i)->definesEnumerationName(typeName))
         {
+            if(cache != nullptr)
+                cache->addDependency(structures.at(i)->getElement());
+
             return structures.at(i)->getDefinitionFileName();
         }
     }
@@ -1093,6 +1408,9 @@ std::string ProtocolParser::lookUpIncludeFilenameForDefinition(const std::string
     {
         if((packets.at(i)->typeName == typeName) || packets.at(i)->definesEnumerationName(typeName))
         {
+            if(cache != nullptr)
+                cache->addDependency(packets.at(i)->getElement());
+
             return packets.at(i)->getDefinitionFileName();
         }
     }
@@ -1112,6 +1430,9 @@ const ProtocolStructureModule* ProtocolParser::lookUpStructure(const std::string
     {
         if(structures.at(i)->typeName == typeName)
         {
+            if(cache != nullptr)
+                cache->addDependency(structures.at(i)->getElement());
+
             return structures.at(i);
         }
     }
@@ -1121,6 +1442,9 @@ const ProtocolStructureModule* ProtocolParser::lookUpStructure(const std::string
     {
         if(packets.at(i)->typeName == typeName)
         {
+            if(cache != nullptr)
+                cache->addDependency(packets.at(i)->getElement());
+
             return packets.at(i);
         }
     }
@@ -1383,6 +1707,10 @@ void ProtocolParser::outputMarkdown(std::string inlinecss)
     std::string filecontents = "\n\n";
     ProtocolFile file(filename, support, false);
 
+    // The headings are indexed as the markdown is built, for the table of contents
+    std::size_t indexed = 0;
+    markdownheadings.clear();
+
     std::vector<std::string> packetids;
     for(std::size_t i = 0; i < packets.size(); i++)
         packets.at(i)->appendIds(packetids);
@@ -1416,6 +1744,9 @@ void ProtocolParser::outputMarkdown(std::string inlinecss)
             if(!support.api.empty())
                 filecontents += title + " API is " + support.api + ".\n\n";
         }
+
+        if(tableOfContents)
+            indexMarkdownHeadings(filecontents, indexed);
     }
 
     for(std::size_t i = 0; i < alldocumentsinorder.size(); i++)
@@ -1429,45 +1760,55 @@ void ProtocolParser::outputMarkdown(std::string inlinecss)
 
         filecontents += alldocumentsinorder.at(i)->getTopLevelMarkdown(true, packetids);
         filecontents += "\n";
+
+        if(tableOfContents)
+            indexMarkdownHeadings(filecontents, indexed);
     }
 
     if (hasAboutSection())
+    {
         filecontents += getAboutSection();
 
+        if(tableOfContents)
+            indexMarkdownHeadings(filecontents, indexed);
+    }
+
     // The title attribute, remove any emphasis characters. We only put this
     // out if we have a title page, this preserves the behavior before 2.14,
     // which did not have a title attribute
+    std::string markdown;
+
     if(!titlePage.empty())
-        file.write("Title:" + title + "\n\n");
+        markdown += "Title:" + title + "\n\n";
 
     // Specific header-level definitions are required for LaTeX compatibility
     if (latexEnabled)
     {
-        file.write("Base Header Level: 1 \n");  // Base header level refers to the HTML output format
-        file.write("LaTeX Header Level: " + std::to_string(latexHeader) + " \n"); // LaTeX header level can be set by user
-        file.write("\n");
+        markdown += "Base Header Level: 1 \n";  // Base header level refers to the HTML output format
+        markdown += "LaTeX Header Level: " + std::to_string(latexHeader) + " \n"; // LaTeX header level can be set by user
+        markdown += "\n";
     }
 
     // Add stylesheet information (unless it is disabled entirely)
     if (!nocss)
     {
         // Open the style tag
-        file.write("<style>\n");
+        markdown += "<style>\n";
 
         if(inlinecss.empty())
-            file.write(getDefaultInlinCSS());
+            markdown += getDefaultInlinCSS();
         else
-            file.write(inlinecss);
+            markdown += inlinecss;
 
         // Close the style tag
-        file.write("</style>\n");
+        markdown += "</style>\n";
 
-        file.write("\n");
+        markdown += "\n";
     }
 
     if(tableOfContents)
     {
-        std::string temp = getTableOfContents(filecontents);
+        std::string temp = getTableOfContents();
         temp += "----------------------------\n\n";
         temp += filecontents;
         filecontents = temp;
@@ -1487,59 +1828,86 @@ void ProtocolParser::outputMarkdown(std::string inlinecss)
     // Deal with the degrees symbol, which doesn't render in html
     replaceinplace(filecontents, "°", "&deg;");
 
-    file.write(filecontents);
+    markdown += filecontents;
+
+    std::string htmlfile =  basepath + name + ".html";
+    std::string latexfile =  basepath + name + ".tex";
+
+    // Multimarkdown is slow for a large protocol, if the markdown is the same
+    // as last time, and the outputs are still there, it need not run again.
+    // A failed render deletes its outputs, so it is tried again next time.
+    bool unchanged = false;
+    if(std::filesystem::exists(htmlfile) && (!latexEnabled || std::filesystem::exists(latexfile)))
+    {
+        std::ifstream previous(filename);
+
+        if(previous.is_open())
+        {
+            // Notice parentheses to deal with "most vexing parse problem"
+            std::string previousdata((std::istreambuf_iterator<char>(previous)), std::istreambuf_iterator<char>());
+            unchanged = (previousdata == markdown);
+        }
+    }
+
+    file.write(markdown);
 
     file.flush();
 
-    // Write html documentation
-    std::string htmlfile =  basepath + name + ".html";
-    std::cout << "Writing HTML documentation to " << htmlfile << std::endl;
+    if(unchanged)
+    {
+        std::cout << "Documentation in " << htmlfile << " is up to date" << std::endl;
+        return;
+    }
+
     #if defined(__APPLE__) && defined(__MACH__)
-    std::system(("/usr/local/bin/MultiMarkdown " + filename + " > " + htmlfile).c_str());
+    std::string multimarkdown = "/usr/local/bin/MultiMarkdown ";
     #else
-    std::system(("multimarkdown " + filename + " > " + htmlfile).c_str());
+    std::string multimarkdown = "multimarkdown ";
     #endif
 
+    // The html and LaTeX are rendered in the background, while the generation
+    // finishes. They are collected at the end by waitForRenderers().
+    std::cout << "Writing HTML documentation to " << htmlfile << std::endl;
+    launchRenderer(multimarkdown + filename + " > " + htmlfile, {}, {htmlfile});
+
     if (latexEnabled)
     {
         // Write LaTeX documentation
-        std::string latexfile =  basepath + name + ".tex";
         std::cout << "Writing LaTeX documentation to " << latexfile << "\n";
-
-        #if defined(__APPLE__) && defined(__MACH__)
-        std::system(("/usr/local/bin/MultiMarkdown " + filename + " > " + latexfile + " --to=latex").c_str());
-        #else
-        std::system(("multimarkdown " + filename + " > " + latexfile + " --to=latex").c_str());
-        #endif
+        launchRenderer(multimarkdown + filename + " > " + latexfile + " --to=latex", {}, {latexfile});
     }
 }
 
 
 /*!
- * Get the table of contents, based on the file contents
- * \param filecontents are the file contents (without a TOC)
- * \return the table of contents data
+ * Add the headings of the markdown that has been appended since the last call
+ * to the heading index. The table of contents identifies all the heading
+ * references, which start with #. Each heading reference is also prefaced by
+ * two line feeds. This is called as the markdown is built, so the document
+ * is searched once, and only the heading lines are copied.
+ * \param markdown is the markdown being built.
+ * \param indexed is the position from which to continue the search, it is
+ *        updated for the next call.
  */
-std::string ProtocolParser::getTableOfContents(const std::string& filecontents)
+void ProtocolParser::indexMarkdownHeadings(const std::string& markdown, std::size_t& indexed)
 {
-    std::string output;
+    const std::string separator = "\n\n#";
 
-    // The table of contents identifies all the heding references, which start
-    // with #. Each heading reference is also prefaced by two line feeds. The
-    // level of the heading (and toc line) is defined by the number of #s.
-    std::vector<std::string> headings = split(filecontents, "\n\n#");
+    for(std::size_t index = markdown.find(separator, indexed); index < markdown.size(); index = markdown.find(separator, indexed))
+    {
+        std::size_t start = index + separator.size();
+        std::size_t end = markdown.find('\n', start);
 
-    if(headings.size() > 0)
-        output = "<toctitle id=\"tableofcontents\">Table of contents</toctitle>\n";
+        if(end == std::string::npos)
+            end = markdown.size();
 
-    for(std::size_t i = 0; i < headings.size(); i++)
-    {
-        std::string refname;
-        std::string text;
-        int level = 1;
+        indexed = start;
+
+        // The first # was part of the separator
+        MarkdownHeading heading;
+        heading.level = 1;
 
-        // Pull the first line out of the heading group
-        std::string line = headings.at(i).substr(0, headings.at(i).find("\n"));
+        std::string line = markdown.substr(start, end - start);
 
         std::size_t prolog;
         for(prolog = 0; prolog < line.size(); prolog++)
@@ -1547,7 +1915,7 @@ std::string ProtocolParser::getTableOfContents(const std::string& filecontents)
             char symbol = line.at(prolog);
 
             if(symbol == '#')       // Count the level
-                level++;
+                heading.level++;
             else if(symbol == ' ')  // Remove leading spaces
                 continue;
             else
@@ -1565,36 +1933,70 @@ std::string ProtocolParser::getTableOfContents(const std::string& filecontents)
 
         // Now figure out the reference. It is either going to be given by some
         // embedded html, or by the id that markdown will put into the output html
-        if(contains(line, "<a name=") && contains(line, "\""))
+        std::size_t anchor = line.find("<a name=");
+        std::size_t quote = line.find("\"");
+
+        if((anchor != std::string::npos) && (quote != std::string::npos))
         {
             // The text is after the reference closure
-            text = line.substr(line.find("</a>")+4);
+            heading.title = line.substr(line.find("</a>")+4);
 
             // In this case the reference name is contained within quotes
-            std::size_t start = line.find("\"") + 1;
-            refname = line.substr(start, line.find("\"", start) - start);
+            heading.anchor = line.substr(quote + 1, line.find("\"", quote + 1) - quote - 1);
         }
         else
         {
+            // The reference name is the whole line, lower case, no spaces and other special characters
+            heading.anchor.reserve(line.size());
+            for(std::size_t i = 0; i < line.size(); i++)
+            {
+                char symbol = line.at(i);
+
+                switch(symbol)
+                {
+                case ' ': case '(': case ')': case '{': case '}': case '[': case ']': case '`': case '"': case '*':
+                    break;
+
+                default:
+                    heading.anchor += (char)std::tolower((unsigned char)symbol);
+                    break;
+                }
+            }
+
             // The text for the line is the line
-            text = line;
-
-            // In this case the reference name is the whole line, lower case, no spaces and other special characters
-            refname = toLower(line);
-            replaceinplace(refname, " ");
-            replaceinplace(refname, "(");
-            replaceinplace(refname, ")");
-            replaceinplace(refname, "{");
-            replaceinplace(refname, "}");
-            replaceinplace(refname, "[");
-            replaceinplace(refname, "]");
-            replaceinplace(refname, "`");
-            replaceinplace(refname, "\"");
-            replaceinplace(refname, "*");
+            heading.title = std::move(line);
         }
 
-        // Finally the actual line
-        output += "<toc"+std::to_string(level)+"><a href=\"#" + refname + "\">" + text + "</a></toc"+std::to_string(level)+">\n";
+        markdownheadings.push_back(std::move(heading));
+
+    }// for all headings
+
+    // A separator may straddle the end of this markdown and the next
+    if((markdown.size() >= separator.size()) && (indexed < markdown.size() - separator.size() + 1))
+        indexed = markdown.size() - separator.size() + 1;
+
+}// ProtocolParser::indexMarkdownHeadings
+
+
+/*!
+ * Get the table of contents, based on the heading index built by
+ * indexMarkdownHeadings(). The level of the heading (and toc line) is defined
+ * by the number of #s.
+ * \return the table of contents data
+ */
+std::string ProtocolParser::getTableOfContents(void) const
+{
+    std::string output;
+
+    if(!markdownheadings.empty())
+        output = "<toctitle id=\"tableofcontents\">Table of contents</toctitle>\n";
+
+    for(std::size_t i = 0; i < markdownheadings.size(); i++)
+    {
+        const MarkdownHeading& heading = markdownheadings.at(i);
+        std::string level = std::to_string(heading.level);
+
+        output += "<toc" + level + "><a href=\"#" + heading.anchor + "\">" + heading.title + "</a></toc" + level + ">\n";
 
     }// for all headings
 
@@ -1637,7 +2039,24 @@ most of the work of encoding data from memory to the wire, and vice versa.\n";
 | :--------------------------: | ------------------------------------- | --------------------------------------------------------------------------- |\n\
 | UX                           | Unsigned integer X bits long          | X must be: 8, 16, 24, 32, 40, 48, 56, or 64                                 |\n\
 | IX                           | Signed integer X bits long            | X must be: 8, 16, 24, 32, 40, 48, 56, or 64                                 |\n\
-| BX                           | Unsigned integer bitfield X bits long | X must be greater than 0 and less than 32                                   |\n\
+| BX                           | Unsigned integer bitfield X bits long | X must be greater than 0 and less than 32                                   |\n";
+
+    // The variable length integers are only described if the protocol uses them
+    bool varint = false;
+    for(std::size_t i = 0; i < structures.size(); i++)
+        varint = varint || structures.at(i)->usesVarint();
+
+    for(std::size_t i = 0; i < packets.size(); i++)
+        varint = varint || packets.at(i)->usesVarint();
+
+    if(varint)
+    {
+        output += "\
+| VUX                          | Unsigned variable length integer      | 7 bits per byte, least significant first, top bit set if more bytes follow  |\n\
+| VIX                          | Signed variable length integer        | Zigzag encoded (0, -1, 1, -2, ...) then sent as VUX                         |\n";
+    }
+
+    output += "\
 | F16:X                        | 16 bit float with X significand bits  | 1 sign bit : 15-X exponent bits : X significant bits with implied leading 1 |\n\
 | F24:X                        | 24 bit float with X significand bits  | 1 sign bit : 23-X exponent bits : X significant bits with implied leading 1 |\n\
 | F32                          | 32 bit float (IEEE-754)               | 1 sign bit : 8 exponent bits : 23 significant bits with implied leading 1   |\n\
@@ -1695,6 +2114,18 @@ bool ProtocolParser::isFieldSet(const std::string& attribname, const XMLAttribut
 }
 
 
+/*!
+ * Determine if the value of an attribute is either {'true','yes','1'}
+ * \param attribname is the name of the attribute to test
+ * \param map is the index of the element's attributes
+ * \return true if the attribute value is "true", "yes", or "1"
+ */
+bool ProtocolParser::isFieldSet(const std::string& attribname, const AttributeIndex& map)
+{
+    return isFieldSet(ProtocolParser::getAttribute(attribname, map));
+}
+
+
 /*!
  * Determine if the value of an attribute is either {'true','yes','1'}
  * \param value is the attribute value to test
@@ -1740,6 +2171,18 @@ bool ProtocolParser::isFieldClear(const std::string& attribname, const XMLAttrib
 }
 
 
+/*!
+ * Determine if the value of an attribute is either {'false','no','0'}
+ * \param attribname is the name of the attribute to test
+ * \param map is the index of the element's attributes
+ * \return true if the attribute value is "false", "no", or "0"
+ */
+bool ProtocolParser::isFieldClear(const std::string& attribname, const AttributeIndex& map)
+{
+    return isFieldClear(ProtocolParser::getAttribute(attribname, map));
+}
+
+
 /*!
  * Determine if the value of an attribute is either {'false','no','0'}
  * \param value is the attribute value to test
@@ -1957,6 +2400,52 @@ void ProtocolParser::setDBCOptions(std::string _dbcfile, std::string _dbcidtx, s
 }
 
 
+/*!
+ * Output a make dependency file which lists every xml file that was read as a
+ * prerequisite of the dependency file itself. The generated files are only
+ * rewritten when their contents change, so they cannot be the target; the
+ * dependency file is written on every run. The format is understood by make
+ * and ninja.
+ * \param inputs is the list of xml files that were read
+ */
+void ProtocolParser::outputDependencyFile(const std::vector<std::string>& inputs)
+{
+    // Spaces and other special characters must be escaped for make
+    auto escape = [](std::string text)
+    {
+        replaceinplace(text, "$", "$$");
+        replaceinplace(text, "#", "\\#");
+        replaceinplace(text, " ", "\\ ");
+        return text;
+    };
+
+    std::string contents = escape(depfile) + ":";
+
+    for(std::size_t i = 0; i < inputs.size(); i++)
+    {
+        // Resource files are not on disk
+        if(startsWith(inputs.at(i), ":"))
+            continue;
+
+        contents += " \\\n  " + escape(inputs.at(i));
+    }
+
+    contents += "\n";
+
+    std::fstream file(depfile, std::ios_base::out);
+
+    if(!file.is_open())
+    {
+        std::cerr << "warning: failed to open dependency file " << depfile << std::endl;
+        return;
+    }
+
+    file << contents;
+    file.close();
+
+}// ProtocolParser::outputDependencyFile
+
+
 /*!
  * Output the doxygen HTML documentation
  */
@@ -1987,14 +2476,82 @@ void ProtocolParser::outputDoxygen(void)
 
     doxfile.close();
 
-    // On the mac doxygen is a utility inside the Doxygen.app bundle.
+    // Doxygen runs in the background, our temporary files are deleted when
+    // it is done. On the mac doxygen is a utility inside the Doxygen.app bundle.
     #if defined(__APPLE__) && defined(__MACH__)
-    std::system("/Applications/Doxygen.app/Contents/Resources/doxygen Doxyfile");
+    launchRenderer("/Applications/Doxygen.app/Contents/Resources/doxygen Doxyfile", {"Doxyfile", fileName});
     #else
-    std::system("doxygen Doxyfile");
+    launchRenderer("doxygen Doxyfile", {"Doxyfile", fileName});
     #endif
-
-    // Delete our temporary files
-    ProtocolFile::deleteFile("Doxyfile");
-    ProtocolFile::deleteFile(fileName);
 }
+
+
+/*!
+ * Start an external documentation tool, like multimarkdown or doxygen, in the
+ * background. The tool runs while the rest of the generation finishes, its
+ * exit status is collected by waitForRenderers().
+ * \param command is the command line to run.
+ * \param tempfiles are files which the tool reads, and which are deleted once
+ *        the tool is done.
+ * \param outputs are files which the tool writes, and which are deleted if the
+ *        tool fails, so a partial or empty output is never taken as up to date.
+ */
+void ProtocolParser::launchRenderer(const std::string& command, const std::vector<std::string>& tempfiles, const std::vector<std::string>& outputs)
+{
+    PendingRenderer renderer;
+    renderer.command = command;
+    renderer.tempfiles = tempfiles;
+    renderer.outputs = outputs;
+
+    try
+    {
+        renderer.result = std::async(std::launch::async, [command]() {return std::system(command.c_str());});
+    }
+    catch(...)
+    {
+        // No threads available, run the tool now
+        std::promise<int> status;
+        status.set_value(std::system(command.c_str()));
+        renderer.result = status.get_future();
+    }
+
+    renderers.push_back(std::move(renderer));
+
+}// ProtocolParser::launchRenderer
+
+
+/*!
+ * Wait for the external documentation tools started by launchRenderer(), warn
+ * about any that failed and delete their outputs, and delete their temporary
+ * files.
+ */
+void ProtocolParser::waitForRenderers(void)
+{
+    for(std::size_t i = 0; i < renderers.size(); i++)
+    {
+        PendingRenderer& renderer = renderers.at(i);
+
+        int status = renderer.result.get();
+
+        #if !defined(_WIN32)
+        // system() returns the wait status, not the exit code
+        if(WIFEXITED(status))
+            status = WEXITSTATUS(status);
+        #endif
+
+        if(status != 0)
+        {
+            std::cerr << "warning: \"" << renderer.command << "\" failed with status " << status << std::endl;
+
+            // The shell creates the output even if the tool is missing
+            for(std::size_t j = 0; j < renderer.outputs.size(); j++)
+                ProtocolFile::deleteFile(renderer.outputs.at(j));
+        }
+
+        for(std::size_t j = 0; j < renderer.tempfiles.size(); j++)
+            ProtocolFile::deleteFile(renderer.tempfiles.at(j));
+    }
+
+    renderers.clear();
+
+}// ProtocolParser::waitForRenderers
@@ -3,7 +3,13 @@
 
 #include "protocolfile.h"
 #include "protocolsupport.h"
+#include "protocolarena.h"
+#include "attributeindex.h"
+#include "protocolprofiler.h"
 #include "tinyxml2.h"
+#include <list>
+#include <map>
+#include <future>
 
 // Forward declarations
 class ProtocolDocumentation;
@@ -11,6 +17,7 @@ class ProtocolStructure;
 class ProtocolStructureModule;
 class ProtocolPacket;
 class EnumCreator;
+class ProtocolCache;
 
 class ProtocolParser
 {
@@ -75,6 +82,18 @@ public:
     //! Disable CSS entirely
     void disableCSS(bool disable) { nocss = disable; }
 
+    //! Option to only output code for modules whose inputs have changed
+    void enableIncremental(bool enable) {incremental = enable;}
+
+    //! Set the name of the make dependency file to output
+    void setDependencyFile(std::string file) {depfile = file;}
+
+    //! Option to output the encode and decode benchmark module
+    void enableBench(bool enable) {bench = enable;}
+
+    //! Record the time and memory of each phase and module of the generation
+    void enableProfile(bool enable) {profiler.enable(enable);}
+
     //! Parse the DOM from the xml file(s). This kicks off the auto code generation for the protocol
     bool parse(std::string filename, std::string path, std::vector<std::string> otherfiles);
 
@@ -84,6 +103,9 @@ public:
     //! Return the value of an attribute from a Dom Element
     static std::string getAttribute(const std::string& name, const XMLAttribute* attr, const std::string& defaultIfNone = std::string());
 
+    //! Return the value of an attribute from an index of a Dom Element's attributes
+    static std::string getAttribute(const std::string& name, const AttributeIndex& map, const std::string& defaultIfNone = std::string());
+
     //! Output a long string of text which should be wrapped at 80 characters.
     static void outputLongComment(ProtocolFile& file, const std::string& prefix, const std::string& comment);
 
@@ -141,6 +163,9 @@ public:
     //! Return the path of the xml source file
     std::string getInputPath(void) {return inputpath;}
 
+    //! Return the arena which owns the objects of the protocol model
+    ProtocolArena& getArena(void) {return arena;}
+
     //! Return true if the element has a particular attribute set to {'true','yes','1'}
     static bool isFieldSet(const XMLElement* e, const std::string& label);
 
@@ -150,6 +175,9 @@ public:
     //! Return true if the value of an attribute is 'true', 'yes', or '1'
     static bool isFieldSet(const std::string& attribname, const XMLAttribute* firstattrib);
 
+    //! Return true if the value of an indexed attribute is 'true', 'yes', or '1'
+    static bool isFieldSet(const std::string& attribname, const AttributeIndex& map);
+
     //! Return true if the element has a particular attribute set to {'false','no','0'}
     static bool isFieldClear(const XMLElement* e, const std::string& label);
 
@@ -159,6 +187,9 @@ public:
     //! Determine if the value of an attribute is either {'false','no','0'}
     static bool isFieldClear(const std::string& attribname, const XMLAttribute* firstattrib);
 
+    //! Determine if the value of an indexed attribute is either {'false','no','0'}
+    static bool isFieldClear(const std::string& attribname, const AttributeIndex& map);
+
     //! Set the license text
     void setLicenseText(const std::string text) { support.licenseText = text; }
 
@@ -175,8 +206,11 @@ protected:
     //! Create markdown documentation
     void outputMarkdown(std::string inlinecss);
 
-    //! Get the table of contents, based on the file contents
-    std::string getTableOfContents(const std::string& filecontents);
+    //! Add the headings of newly appended markdown to the heading index
+    void indexMarkdownHeadings(const std::string& markdown, std::size_t& indexed);
+
+    //! Get the table of contents, based on the heading index
+    std::string getTableOfContents(void) const;
 
     //! Get the "About this ICD" section to file
     std::string getAboutSection(void);
@@ -184,12 +218,69 @@ protected:
     //! Output the doxygen HTML documentation
     void outputDoxygen(void);
 
+    //! Start an external documentation tool which runs while the generation finishes
+    void launchRenderer(const std::string& command, const std::vector<std::string>& tempfiles = std::vector<std::string>(), const std::vector<std::string>& outputs = std::vector<std::string>());
+
+    //! Wait for the external documentation tools and report their exit status
+    void waitForRenderers(void);
+
+    //! Output the make dependency file
+    void outputDependencyFile(const std::vector<std::string>& inputs);
+
     //! Protocol support information
     ProtocolSupport support;
 
+    //! Protocol support information for each xml file, shared by the objects from that file
+    std::list<ProtocolSupport> filesupports;
+
+    //! Owner of the protocol model objects, which refer to filesupports
+    ProtocolArena arena;
+
+    //! Timing and memory of the phases of the generation
+    ProtocolProfiler profiler;
+
     //! The list of xml documents we created by loading files
     std::vector<tinyxml2::XMLDocument*> xmldocs;
 
+    //! Start loading the files required by an xml document in the background
+    void prefetchRequiredFiles(const tinyxml2::XMLElement* docElem, const std::string& xmlFilename);
+
+    //! Get the document for an xml file, which may have been loaded in the background
+    tinyxml2::XMLDocument* loadFile(const std::string& xmlFilename, tinyxml2::XMLError& error);
+
+    //! An xml file which is being loaded in the background
+    struct PendingFile
+    {
+        tinyxml2::XMLDocument* doc;                 //!< The document, owned by the arena
+        std::shared_future<tinyxml2::XMLError> result; //!< The result of loading the document
+    };
+
+    //! Files which are being loaded in the background, keyed by file name
+    std::map<std::string, PendingFile> pendingfiles;
+
+    //! An external documentation tool which is running in the background
+    struct PendingRenderer
+    {
+        std::string command;                //!< The command line, for reporting
+        std::vector<std::string> tempfiles; //!< Files to delete once the tool is done
+        std::vector<std::string> outputs;   //!< Files the tool writes, deleted if the tool fails
+        std::future<int> result;            //!< The exit status of the tool
+    };
+
+    //! A markdown heading, for the table of contents
+    struct MarkdownHeading
+    {
+        int level;          //!< The heading level, 1 for #
+        std::string anchor; //!< The html anchor of the heading
+        std::string title;  //!< The text of the heading
+    };
+
+    //! Headings of the markdown documentation, in order
+    std::vector<MarkdownHeading> markdownheadings;
+
+    //! External documentation tools which are running in the background
+    std::vector<PendingRenderer> renderers;
+
     //! The document currently being parsed
     tinyxml2::XMLDocument* currentxml;
 
@@ -214,6 +305,10 @@ protected:
     bool nocss;         //!< Disable all CSS output
     bool tableOfContents;//!< Enable table of contents
     std::string titlePage;     //!< Title page information
+    bool incremental;   //!< Only output code for modules whose inputs have changed
+    std::string depfile;//!< Name of the make dependency file to output
+    bool bench;         //!< Output the encode and decode benchmark module
+    ProtocolCache* cache;//!< Cache of module inputs for incremental output, null if not used
 
     std::vector<std::string> filesparsed;
     std::vector<ProtocolDocumentation*> alldocumentsinorder;
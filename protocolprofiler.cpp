@@ -0,0 +1,309 @@
+#include "protocolprofiler.h"
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include <fstream>
+#include <algorithm>
+#include <iomanip>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+    //! Number of calls to operator new
+    std::atomic<uint64_t> numallocations(0);
+
+    //! Number of bytes requested from operator new
+    std::atomic<uint64_t> numbytes(0);
+}
+
+/*!
+ * Replacement for the global operator new which counts the allocations. The
+ * array and nothrow forms of new call this one, so they are counted too. The
+ * count is always kept, it is only two relaxed atomic additions.
+ * \param size is the number of bytes to allocate.
+ * \return the allocated memory.
+ */
+void* operator new(std::size_t size)
+{
+    numallocations.fetch_add(1, std::memory_order_relaxed);
+    numbytes.fetch_add(size, std::memory_order_relaxed);
+
+    if(size == 0)
+        size = 1;
+
+    for(;;)
+    {
+        void* memory = std::malloc(size);
+
+        if(memory != nullptr)
+            return memory;
+
+        std::new_handler handler = std::get_new_handler();
+
+        if(handler == nullptr)
+            throw std::bad_alloc();
+
+        handler();
+    }
+}
+
+
+//! Replacement for the global operator delete, to match operator new
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+
+//! Replacement for the global sized operator delete, to match operator new
+void operator delete(void* memory, std::size_t size) noexcept
+{
+    (void)size;
+    std::free(memory);
+}
+
+
+/*!
+ * Construct a disabled profiler
+ */
+ProtocolProfiler::ProtocolProfiler(void) :
+    enabled(false),
+    origin(std::chrono::steady_clock::now())
+{
+}
+
+
+/*!
+ * Enable or disable the profiler. Events which are begun while the profiler
+ * is disabled are not recorded.
+ * \param on should be true to record events.
+ */
+void ProtocolProfiler::enable(bool on)
+{
+    enabled = on;
+}
+
+
+/*!
+ * \return the time in microseconds since the profiler was constructed
+ */
+int64_t ProtocolProfiler::now(void) const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+
+/*!
+ * \return the number of calls to operator new since the program started
+ */
+uint64_t ProtocolProfiler::allocationCount(void)
+{
+    return numallocations.load(std::memory_order_relaxed);
+}
+
+
+/*!
+ * \return the number of bytes requested from operator new since the program started
+ */
+uint64_t ProtocolProfiler::allocationBytes(void)
+{
+    return numbytes.load(std::memory_order_relaxed);
+}
+
+
+/*!
+ * \return the peak resident memory of the process in kilobytes, or 0 if it
+ *         cannot be determined on this platform.
+ */
+uint64_t ProtocolProfiler::peakResidentKB(void)
+{
+    #if defined(_WIN32)
+    return 0;
+    #else
+    struct rusage usage;
+
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+    #if defined(__APPLE__)
+    // Mac reports bytes, everyone else reports kilobytes
+    return (uint64_t)usage.ru_maxrss/1024;
+    #else
+    return (uint64_t)usage.ru_maxrss;
+    #endif
+    #endif
+}
+
+
+/*!
+ * Begin an event. Events nest, each begin() must be matched by an end().
+ * \param name is the name of the event, for example the name of a packet.
+ * \param category is the category of the event, for example "packet".
+ */
+void ProtocolProfiler::begin(const std::string& name, const std::string& category)
+{
+    if(!enabled)
+        return;
+
+    Event event;
+    event.name = name;
+    event.category = category;
+    event.start = now();
+    event.duration = 0;
+    event.allocations = allocationCount();
+    event.bytes = allocationBytes();
+    event.peakKB = 0;
+    event.depth = (int)open.size();
+
+    open.push_back(events.size());
+    events.push_back(event);
+
+}// ProtocolProfiler::begin
+
+
+/*!
+ * End the most recently begun event, recording its duration, allocations,
+ * and the peak memory.
+ */
+void ProtocolProfiler::end(void)
+{
+    if(open.empty())
+        return;
+
+    Event& event = events[open.back()];
+    open.pop_back();
+
+    event.duration = now() - event.start;
+    event.allocations = allocationCount() - event.allocations;
+    event.bytes = allocationBytes() - event.bytes;
+    event.peakKB = peakResidentKB();
+
+}// ProtocolProfiler::end
+
+
+/*!
+ * Change the name of the most recently begun event. Modules do not know
+ * their names until they have been parsed, so their events are named after.
+ * \param name is the new name of the event.
+ */
+void ProtocolProfiler::rename(const std::string& name)
+{
+    if(!open.empty())
+        events[open.back()].name = name;
+}
+
+
+/*!
+ * Print the time, allocations, and peak memory of each phase, followed by
+ * the slowest packets.
+ * \param output receives the report.
+ * \param topN is the number of packets to list.
+ */
+void ProtocolProfiler::report(std::ostream& output, std::size_t topN) const
+{
+    if(events.empty())
+        return;
+
+    // Left justified columns, the caller's formatting is restored at the end
+    std::ios_base::fmtflags flags = output.flags();
+
+    output << std::endl << "Profile of the protocol generation:" << std::endl << std::left;
+    output << std::setw(40) << "Phase" << std::setw(12) << "Time (ms)" << std::setw(14) << "Allocations" << "Peak memory (MB)" << std::endl;
+
+    for(std::size_t i = 0; i < events.size(); i++)
+    {
+        const Event& event = events.at(i);
+
+        if(event.category != "phase")
+            continue;
+
+        std::string name = std::string(2*event.depth, ' ') + event.name;
+
+        output << std::setw(40) << name
+               << std::setw(12) << std::to_string(event.duration/1000) + "." + std::to_string((event.duration/100)%10)
+               << std::setw(14) << std::to_string(event.allocations)
+               << std::to_string(event.peakKB/1024) << std::endl;
+    }
+
+    std::vector<const Event*> packets;
+    for(std::size_t i = 0; i < events.size(); i++)
+    {
+        if(events.at(i).category == "packet")
+            packets.push_back(&events.at(i));
+    }
+
+    if(packets.empty())
+    {
+        output.flags(flags);
+        return;
+    }
+
+    // Longest first, ties in the order they were parsed
+    std::stable_sort(packets.begin(), packets.end(), [](const Event* a, const Event* b) {return a->duration > b->duration;});
+
+    if(packets.size() > topN)
+        packets.resize(topN);
+
+    output << std::endl << "Slowest packets:" << std::endl;
+
+    for(std::size_t i = 0; i < packets.size(); i++)
+    {
+        output << std::setw(40) << packets.at(i)->name
+               << std::setw(12) << std::to_string(packets.at(i)->duration/1000) + "." + std::to_string((packets.at(i)->duration/100)%10)
+               << packets.at(i)->allocations << std::endl;
+    }
+
+    output << std::endl;
+    output.flags(flags);
+
+}// ProtocolProfiler::report
+
+
+/*!
+ * Write the events as a Chrome trace-event JSON file. Each event is a
+ * complete ("X") event with the allocations and peak memory as arguments.
+ * \param fileName is the name of the file to write.
+ * \return true if the file was written.
+ */
+bool ProtocolProfiler::writeTrace(const std::string& fileName) const
+{
+    std::ofstream file(fileName, std::ios_base::out | std::ios_base::trunc);
+
+    if(!file.is_open())
+        return false;
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    for(std::size_t i = 0; i < events.size(); i++)
+    {
+        const Event& event = events.at(i);
+
+        // Names come from the xml, which may contain quotes or backslashes
+        std::string name;
+        for(std::size_t j = 0; j < event.name.size(); j++)
+        {
+            char character = event.name.at(j);
+
+            if((character == '"') || (character == '\\'))
+                name += '\\';
+
+            if((unsigned char)character >= 0x20)
+                name += character;
+        }
+
+        if(i > 0)
+            file << ",";
+
+        file << "\n{\"name\":\"" << name << "\",\"cat\":\"" << event.category << "\",\"ph\":\"X\""
+             << ",\"ts\":" << event.start << ",\"dur\":" << event.duration << ",\"pid\":1,\"tid\":1"
+             << ",\"args\":{\"allocations\":" << event.allocations << ",\"bytes\":" << event.bytes << ",\"peakKB\":" << event.peakKB << "}}";
+    }
+
+    file << "\n]}\n";
+
+    return file.good();
+
+}// ProtocolProfiler::writeTrace
@@ -0,0 +1,100 @@
+#ifndef PROTOCOLPROFILER_H
+#define PROTOCOLPROFILER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <ostream>
+
+/*!
+ * The protocol profiler records the wall time, the number of allocations, and
+ * the peak resident memory of each phase of the generation, and of each
+ * module within a phase. Events nest, so a packet event is contained in the
+ * packet phase event. The events can be summarized to the console and written
+ * as a Chrome trace-event file (load it in chrome://tracing or Perfetto). The
+ * profiler does nothing unless it is enabled.
+ */
+class ProtocolProfiler
+{
+public:
+
+    //! Construct a disabled profiler
+    ProtocolProfiler(void);
+
+    //! Enable or disable the profiler
+    void enable(bool on);
+
+    //! Determine if the profiler is enabled
+    bool isEnabled(void) const {return enabled;}
+
+    //! Begin an event, which must be ended with end()
+    void begin(const std::string& name, const std::string& category);
+
+    //! End the most recently begun event
+    void end(void);
+
+    //! Change the name of the most recently begun event, which has not ended
+    void rename(const std::string& name);
+
+    //! Print the phase summary and the slowest modules
+    void report(std::ostream& output, std::size_t topN = 10) const;
+
+    //! Write the events as a Chrome trace-event JSON file
+    bool writeTrace(const std::string& fileName) const;
+
+    //! Get the number of allocations made by operator new
+    static uint64_t allocationCount(void);
+
+    //! Get the number of bytes requested from operator new
+    static uint64_t allocationBytes(void);
+
+    //! Get the peak resident memory of the process in kilobytes
+    static uint64_t peakResidentKB(void);
+
+    /*!
+     * Begins an event when constructed and ends it when destroyed, so the
+     * event covers a scope, including any early return from it.
+     */
+    class Scope
+    {
+    public:
+        Scope(ProtocolProfiler& profile, const std::string& name, const std::string& category) : profiler(profile) {profiler.begin(name, category);}
+        ~Scope() {profiler.end();}
+
+        //! Change the name of the event, useful when the name is not known until the work is done
+        void setName(const std::string& name) {profiler.rename(name);}
+
+    private:
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        ProtocolProfiler& profiler; //!< The profiler which records the event
+    };
+
+private:
+
+    //! Get the time in microseconds since the profiler was constructed
+    int64_t now(void) const;
+
+    //! One recorded event
+    struct Event
+    {
+        std::string name;       //!< Name of the event, like "Parse packets" or the name of a packet
+        std::string category;   //!< Category of the event, like "phase" or "packet"
+        int64_t start;          //!< Start time in microseconds
+        int64_t duration;       //!< Duration in microseconds
+        uint64_t allocations;   //!< Number of allocations during the event
+        uint64_t bytes;         //!< Number of bytes allocated during the event
+        uint64_t peakKB;        //!< Peak resident memory at the end of the event
+        int depth;              //!< Nesting depth of the event
+    };
+
+    bool enabled;                       //!< True if events should be recorded
+    std::chrono::steady_clock::time_point origin;//!< Time the profiler was constructed
+    std::vector<Event> events;          //!< All the events in the order they began
+    std::vector<std::size_t> open;      //!< Indices of the events which have not ended
+};
+
+#endif // PROTOCOLPROFILER_H
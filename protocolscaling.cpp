@@ -466,7 +466,7 @@ bool ProtocolScaling::areTypesSupported(inmemorytypes_t inmemory, encodedtypes_t
 /*!
  * Construct the protocol scaling object
  */
-ProtocolScaling::ProtocolScaling(ProtocolSupport sup) :
+ProtocolScaling::ProtocolScaling(const ProtocolSupport& sup) :
     header(sup),
     source(sup),
     support(sup)
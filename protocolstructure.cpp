@@ -10,7 +10,7 @@
  * \param parent is the hierarchical name of the object that owns this object.
  * \param support are the protocol support details
  */
-ProtocolStructure::ProtocolStructure(ProtocolParser* parse, std::string parent, ProtocolSupport supported) :
+ProtocolStructure::ProtocolStructure(ProtocolParser* parse, std::string parent, const ProtocolSupport& supported) :
     Encodable(parse, parent, supported),
     numbitfieldgroupbytes(0),
     bitfields(false),
@@ -36,10 +36,16 @@ ProtocolStructure::ProtocolStructure(ProtocolParser* parse, std::string parent,
     compare(false),
     print(false),
     mapEncode(false),
+    json(false),
+    hash(false),
+    encodedSize(false),
+    skipEncoded(false),
+    noinit(false),
     redefines(nullptr)
 {
     // List of attributes understood by ProtocolStructure
-    attriblist = {"name",  "title",  "array",  "variableArray",  "array2d",  "variable2dArray",  "dependsOn",  "comment",  "hidden",  "neverOmit", "limitOnEncode", "dbctx", "dbcrx"};
+    static const AttributeKeys structureattributes({"name",  "title",  "array",  "variableArray",  "array2d",  "variable2dArray",  "dependsOn",  "comment",  "hidden",  "neverOmit", "limitOnEncode", "dbctx", "dbcrx"});
+    attriblist = &structureattributes;
 
 }
 
@@ -51,17 +57,7 @@ void ProtocolStructure::clear(void)
 {
     Encodable::clear();
 
-    // Delete any encodable objects in our list
-    for(std::size_t i = 0; i < encodables.size(); i++)
-    {
-        if(encodables[i])
-        {
-            delete encodables[i];
-            encodables[i] = NULL;
-        }
-    }
-
-    // Empty the list itself
+    // Empty the list, the encodable objects are owned by the arena of the parser
     encodables.clear();
 
     // Objects in this list are owned by others, we just clear it, don't delete the objects
@@ -88,7 +84,7 @@ void ProtocolStructure::clear(void)
     hasinit = (support.language == ProtocolSupport::cpp_language);
     hasverify = false;
     encode = decode = true;
-    print = compare = mapEncode = false;
+    print = compare = mapEncode = json = hash = encodedSize = skipEncoded = false;
     structName.clear();
     redefines = nullptr;
 
@@ -103,7 +99,7 @@ void ProtocolStructure::parse(bool nocode)
     if(e == nullptr)
         return;
 
-    const XMLAttribute* map = e->FirstAttribute();
+    AttributeIndex map(e->FirstAttribute(), *attriblist);
 
     // All the attribute we care about
     name = ProtocolParser::getAttribute("name", map, "_unknown");
@@ -135,9 +131,9 @@ void ProtocolStructure::parse(bool nocode)
 
     // This will propagate to any of the children we create
     if(ProtocolParser::isFieldSet("limitOnEncode", map))
-        support.limitonencode = true;
+        limitonencode = true;
     else if(ProtocolParser::isFieldClear("limitOnEncode", map))
-        support.limitonencode = false;
+        limitonencode = false;
 
     testAndWarnAttributes(map);
 
@@ -283,6 +279,187 @@ std::string ProtocolStructure::getEncodeString(int* bitcount, bool isStructureMe
 }// ProtocolStructure::getEncodeString
 
 
+/*!
+ * Return the string that adds the encoded size of this structure to
+ * "_pg_byteindex", without encoding or decoding it.
+ * \param isStructureMember is true if this encodable is accessed by structure pointer
+ * \param skip should be true to size the structure from the encoded bytes in
+ *        "_pg_data", rather than from the user data.
+ * \return the string to add to the source, which is empty if the encoded size
+ *         of this structure is always its maximum encoded length.
+ */
+std::string ProtocolStructure::getLengthString(bool isStructureMember, bool skip) const
+{
+    CodeEmitter output;
+    std::string length;
+    std::string spacing = TAB_IN;
+
+    bool fixed = hasFixedEncodedLength(&length);
+
+    // Fixed size, and always present
+    if(fixed && variableArray.empty() && variable2dArray.empty() && dependsOn.empty())
+        return output.take();
+
+    if(!dependsOn.empty())
+    {
+        output.append(spacing, getEncodeDependsOnCondition(isStructureMember), "\n");
+        output.append(spacing, "{\n");
+        spacing += TAB_IN;
+    }
+
+    if(fixed)
+    {
+        if(isArray())
+            output.append(spacing, "_pg_byteindex += (int)(", getEncodedArrayCount(isStructureMember), ")*(", length, ");\n");
+        else
+            output.append(spacing, "_pg_byteindex += ", length, ";\n");
+    }
+    else
+    {
+        std::string access = getEncodeFieldAccess(isStructureMember);
+
+        // Each element of the array is asked for its size
+        output.append(getEncodeArrayIterationCode(spacing, isStructureMember));
+
+        if(isArray())
+        {
+            spacing += TAB_IN;
+            if(is2dArray())
+                spacing += TAB_IN;
+        }
+
+        if(skip)
+            output.append(getSkipValueString(spacing));
+        else if(support.language == ProtocolSupport::c_language)
+        {
+            if(getNumberOfEncodeParameters() > 0)
+                output.append(spacing, "_pg_byteindex += getEncodedSizeOf", typeName, "(", access, ");\n");
+            else
+                output.append(spacing, "_pg_byteindex += getEncodedSizeOf", typeName, "();\n");
+        }
+        else if(isStructureMember || isArray())
+            output.append(spacing, "_pg_byteindex += ", access, ".encodedSize();\n");
+        else
+            output.append(spacing, "_pg_byteindex += ", access, "->encodedSize();\n");
+    }
+
+    // Close the depends on block
+    if(!dependsOn.empty())
+        output.append(TAB_IN, "}\n");
+
+    return output.take();
+
+}// ProtocolStructure::getLengthString
+
+
+/*!
+ * Get the source needed to skip one value of this structure in "_pg_data",
+ * which is limited by "_pg_numbytes".
+ * \param spacing is the spacing that begins each line.
+ * \return the source, which returns from the function if the data are too short.
+ */
+std::string ProtocolStructure::getSkipValueString(const std::string& spacing) const
+{
+    CodeEmitter output;
+
+    // The structure checks its own size against the data
+    if(support.language == ProtocolSupport::c_language)
+        output.append(spacing, "if(skip", typeName, "(_pg_data, &_pg_byteindex, _pg_numbytes) == 0)\n");
+    else
+        output.append(spacing, "if(!", typeName, "::skip(_pg_data, &_pg_byteindex, _pg_numbytes))\n");
+
+    output.append(spacing, TAB_IN, "return ", getReturnCode(false), ";\n");
+
+    return output.take();
+
+}// ProtocolStructure::getSkipValueString
+
+
+/*!
+ * Get the source needed to decode the array element "_pg_i" of this
+ * structure. An element of a 2d array is a row of the second dimension. The
+ * element count and the dependsOn of the structure are left to the caller,
+ * which only decodes the elements that are present.
+ * \param isStructureMember is true if this encodable is accessed by structure pointer
+ * \return the source, empty if this structure is not an array.
+ */
+std::string ProtocolStructure::getDecodeElementString(bool isStructureMember) const
+{
+    if(!isDecodedByElement())
+        return std::string();
+
+    return getDecodeStringForStructure(isStructureMember, true);
+
+}// ProtocolStructure::getDecodeElementString
+
+
+/*!
+ * Get the source needed to skip one array element of this structure in
+ * "_pg_data", which is limited by "_pg_numbytes".
+ * \param isStructureMember should be true if variable array limits are members of a structure
+ * \return the source, which is empty if every element has the same encoded size.
+ */
+std::string ProtocolStructure::getSkipElementString(bool isStructureMember) const
+{
+    CodeEmitter output;
+    std::string length;
+    std::string spacing = TAB_IN;
+
+    bool fixed = hasFixedEncodedLength(&length);
+
+    // Every element has the same size
+    if(!isDecodedByElement() || (fixed && variable2dArray.empty()))
+        return output.take();
+
+    // An element of a 2d array is a row of the second dimension
+    output.append(getEncodeElementIterationCode(spacing, isStructureMember));
+
+    if(is2dArray())
+        spacing += TAB_IN;
+
+    if(fixed)
+        output.append(spacing, "_pg_byteindex += ", length, ";\n");
+    else
+        output.append(getSkipValueString(spacing));
+
+    return output.take();
+
+}// ProtocolStructure::getSkipElementString
+
+
+/*!
+ * Determine if every encoding of this structure has the same length, which is
+ * true if none of the children have variable arrays, dependsOn, variable
+ * length strings, or variable length structures. This ignores the array of
+ * this structure, and whether this structure depends on another field.
+ * \param length receives the encoded length of one of this structure, if it is fixed.
+ * \return true if the encoded length of this structure is fixed.
+ */
+bool ProtocolStructure::hasFixedEncodedLength(std::string* length) const
+{
+    EncodedLength sum;
+
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        if(!encodables.at(i)->getEncodedSizeString(true).empty())
+            return false;
+
+        sum.addToLength(encodables.at(i)->encodedLength);
+    }
+
+    if(length != nullptr)
+    {
+        if(sum.maxEncodedLength.empty())
+            *length = "0";
+        else
+            *length = sum.maxEncodedLength;
+    }
+
+    return true;
+
+}// ProtocolStructure::hasFixedEncodedLength
+
+
 /*!
  * Return the string that is used to decode this structure
  * \param bitcount points to the running count of bits in a bitfields and should persist between calls
@@ -294,6 +471,21 @@ std::string ProtocolStructure::getDecodeString(int* bitcount, bool isStructureMe
     (void)bitcount;
     (void)defaultEnabled;
 
+    return getDecodeStringForStructure(isStructureMember, false);
+
+}// ProtocolStructure::getDecodeString
+
+
+/*!
+ * Return the string that is used to decode this structure, or one of its
+ * array elements.
+ * \param isStructureMember is true if this encodable is accessed by structure pointer
+ * \param element should be true to decode only the array element "_pg_i",
+ *        without the dependsOn of the structure
+ * \return the string to add to the source to decode this structure
+ */
+std::string ProtocolStructure::getDecodeStringForStructure(bool isStructureMember, bool element) const
+{
     std::string output;
     std::string access = getEncodeFieldAccess(isStructureMember);
     std::string spacing = TAB_IN;
@@ -301,7 +493,7 @@ std::string ProtocolStructure::getDecodeString(int* bitcount, bool isStructureMe
     if(!comment.empty())
         output += spacing + "// " + comment + "\n";
 
-    if(!dependsOn.empty())
+    if(!dependsOn.empty() && !element)
     {
         output += spacing + "if(" + getDecodeFieldAccess(isStructureMember, dependsOn);
 
@@ -313,12 +505,16 @@ std::string ProtocolStructure::getDecodeString(int* bitcount, bool isStructureMe
     }
 
     // Array handling
-    output += getDecodeArrayIterationCode(spacing, isStructureMember);
+    if(element)
+        output += getDecodeElementIterationCode(spacing, isStructureMember);
+    else
+        output += getDecodeArrayIterationCode(spacing, isStructureMember);
 
     // Spacing for arrays
     if(isArray())
     {
-        spacing += TAB_IN;
+        if(!element)
+            spacing += TAB_IN;
         if(is2dArray())
             spacing += TAB_IN;
     }
@@ -339,12 +535,12 @@ std::string ProtocolStructure::getDecodeString(int* bitcount, bool isStructureMe
         output += spacing + TAB_IN + "return false;\n";
     }
 
-    if(!dependsOn.empty())
+    if(!dependsOn.empty() && !element)
         output += TAB_IN + "}\n";
 
     return output;
 
-}// ProtocolStructure::getDecodeString
+}// ProtocolStructure::getDecodeStringForStructure
 
 
 /*!
@@ -428,6 +624,46 @@ std::string ProtocolStructure::getSetInitialValueString(bool isStructureMember)
 }// ProtocolStructure::getSetInitialValueString
 
 
+/*!
+ * Get the code which sets this structure member to initial values in the C++
+ * initialize() function of the parent structure.
+ * \return the code to put in the source file
+ */
+std::string ProtocolStructure::getInitializeString(void) const
+{
+    CodeEmitter output;
+    std::string spacing = TAB_IN;
+    std::string access = name;
+
+    // Classes without members have no constructor, and no initialize()
+    if((support.language != ProtocolSupport::cpp_language) || (getNumberInMemory() <= 0))
+        return output.take();
+
+    // Every element is set, not just those that would be encoded
+    if(isArray())
+    {
+        output.append(spacing, "for(_pg_i = 0; _pg_i < ", array, "; _pg_i++)\n");
+        spacing += TAB_IN;
+        access += "[_pg_i]";
+
+        if(is2dArray())
+        {
+            output.append(spacing, "for(_pg_j = 0; _pg_j < ", array2d, "; _pg_j++)\n");
+            spacing += TAB_IN;
+            access += "[_pg_j]";
+        }
+    }
+
+    if(isNoInit())
+        output.append(spacing, access, ".initialize();\n");
+    else
+        output.append(spacing, access, " = ", typeName, "();\n");
+
+    return output.take();
+
+}// ProtocolStructure::getInitializeString
+
+
 //! Return the strings that #define initial and variable values
 std::string ProtocolStructure::getInitialAndVerifyDefines(bool includeComment) const
 {
@@ -582,69 +818,88 @@ std::string ProtocolStructure::getComparisonString(void) const
 
 
 /*!
- * Get the string used for printing this field as text.
- * \return the print string, which may be empty
+ * Get the string used for testing this structure for equality.
+ * \return the test string, which may be empty
  */
-std::string ProtocolStructure::getTextPrintString(void) const
+std::string ProtocolStructure::getEqualsString(void) const
 {
-    std::string output;
-    std::string access;
-    std::string spacing = TAB_IN;
+    CodeEmitter output;
+    std::string access1, access2;
 
-    // We must parameters that we decode to do a print out
-    if(!print || (getNumberOfDecodeParameters() == 0))
-        return output;
+    // We must have parameters that we decode to do a comparison
+    if(!hasEqualsFunction())
+        return output.take();
 
-    if(!comment.empty())
-        output += spacing + "// " + comment + "\n";
+    std::string spacing = TAB_IN;
 
-    output += getEncodeArrayIterationCode(spacing, true);
+    if(support.language == ProtocolSupport::c_language)
+    {
+        // The dereference of the array gets us back to the object, but we need the pointer
+        access1 = "&_pg_user1->" + name;
+        access2 = "&_pg_user2->" + name;
+    }
+    else
+    {
+        access1 = name;
+        access2 = "&_pg_user->" + name;
+    }
+
+    // Just like the comparison this does not obey variable array length limits
     if(isArray())
     {
+        output.append(spacing, "for(_pg_i = 0; _pg_i < ", array, "; _pg_i++)\n");
         spacing += TAB_IN;
+
+        access1 += "[_pg_i]";
+        access2 += "[_pg_i]";
+
         if(is2dArray())
+        {
+            access1 += "[_pg_j]";
+            access2 += "[_pg_j]";
+            output.append(spacing, "for(_pg_j = 0; _pg_j < ", array2d, "; _pg_j++)\n");
             spacing += TAB_IN;
-    }
 
-    if(support.language == ProtocolSupport::c_language)
-        output += spacing + "_pg_report += textPrint" + typeName + "(_pg_prename + \":" + name + "\"";
-    else
-        output += spacing + "_pg_report += " + getEncodeFieldAccess(true) + ".textPrint(_pg_prename + \":" + name + "\"";
-
-    if(isArray())
-        output += " + \"[\" + std::to_string(_pg_i) + \"]\"";
+        }// if 2D array of structures
 
-    if(is2dArray())
-        output += " + \"[\" + std::to_string(_pg_j) + \"]\"";
+    }// if array of structures
 
     if(support.language == ProtocolSupport::c_language)
-        output += ", " + getEncodeFieldAccess(true);
+        output.append(spacing, "if(!equals", typeName, "(", access1, ", ", access2, "))\n");
+    else
+        output.append(spacing, "if(!", access1, ".equals(", access2, "))\n");
 
-    output += ");\n";
+    output.append(spacing, TAB_IN, "return false;\n");
 
-    return output;
+    return output.take();
 
-}// ProtocolStructure::getTextPrintString
+}// ProtocolStructure::getEqualsString
 
 
 /*!
- * Get the string used for reading this field from text.
- * \return the read string, which may be empty
+ * Get the string used for combining this structure into a hash. Like the
+ * encode, variable length arrays are limited by their length, and a structure
+ * that depends on another field is only hashed if it is present.
+ * \return the hash string, which may be empty
  */
-std::string ProtocolStructure::getTextReadString(void) const
+std::string ProtocolStructure::getHashString(void) const
 {
-    std::string output;
-    std::string access;
+    CodeEmitter output;
     std::string spacing = TAB_IN;
 
-    // We must parameters that we decode to do a print out
-    if(!print || (getNumberOfDecodeParameters() == 0))
-        return output;
+    // We must have parameters that we encode to do a hash
+    if(!hash || (getNumberOfEncodeParameters() == 0))
+        return output.take();
 
-    if(!comment.empty())
-        output += spacing + "// " + comment + "\n";
+    if(!dependsOn.empty())
+    {
+        output.append(spacing, getEncodeDependsOnCondition(true), "\n");
+        output.append(spacing, "{\n");
+        spacing += TAB_IN;
+    }
+
+    output.append(getEncodeArrayIterationCode(spacing, true));
 
-    output += getEncodeArrayIterationCode(spacing, true);
     if(isArray())
     {
         spacing += TAB_IN;
@@ -653,100 +908,337 @@ std::string ProtocolStructure::getTextReadString(void) const
     }
 
     if(support.language == ProtocolSupport::c_language)
-        output += spacing + "_pg_fieldcount += textRead" + typeName + "(_pg_prename + \":" + name + "\"";
+        output.append(spacing, "_pg_hash = mixHash(_pg_hash, hash", typeName, "(", getEncodeFieldAccess(true), "));\n");
     else
-        output += spacing + "_pg_fieldcount += " + getEncodeFieldAccess(true) + ".textRead(_pg_prename + \":" + name + "\"";
-
-    if(isArray())
-        output += " + \"[\" + std::to_string(_pg_i) + \"]\"";
-
-    if(is2dArray())
-        output += " + \"[\" + std::to_string(_pg_j) + \"]\"";
-
-    output += ", _pg_source";
-
-    if(support.language == ProtocolSupport::c_language)
-        output += ", " + getEncodeFieldAccess(true);
+        output.append(spacing, "_pg_hash = mixHash(_pg_hash, ", getEncodeFieldAccess(true), ".hash());\n");
 
-    output += ");\n";
+    // Close the depends on block
+    if(!dependsOn.empty())
+        output.append(TAB_IN, "}\n");
 
-    return output;
+    return output.take();
 
-}// ProtocolStructure::getTextReadString
+}// ProtocolStructure::getHashString
 
 
 /*!
- * Return the string used for encoding this field to a map
- * \return the encode string, which may be empty
+ * Get the string used for printing this field as text. The structure name, and
+ * any array indices, are added to the prename for the structure print.
+ * \return the print string, which may be empty
  */
-std::string ProtocolStructure::getMapEncodeString(void) const
+std::string ProtocolStructure::getTextPrintString(void) const
 {
     std::string output;
     std::string spacing = TAB_IN;
 
     // We must parameters that we decode to do a print out
-    if(!mapEncode || (getNumberOfDecodeParameters() == 0))
+    if(!print || (getNumberOfDecodeParameters() == 0))
         return output;
 
     if(!comment.empty())
         output += spacing + "// " + comment + "\n";
 
-    std::string key = "\":" + name + "\"";
-
     output += getEncodeArrayIterationCode(spacing, true);
     if(isArray())
     {
         spacing += TAB_IN;
-        key += " + \"[\" + QString::number(_pg_i) + \"]\"";
+        if(is2dArray())
+            spacing += TAB_IN;
+
+        output += spacing.substr(TAB_IN.size()) + "{\n";
+    }
+
+    output += spacing + "_pg_prename.append(\":" + name;
+
+    if(isArray())
+    {
+        output += "[\");\n";
+        output += spacing + "appendUnsigned(_pg_prename, _pg_i);\n";
 
         if(is2dArray())
         {
-            spacing += TAB_IN;
-            key += " + \"[\" + QString::number(_pg_j) + \"]\"";
+            output += spacing + "_pg_prename.append(\"][\");\n";
+            output += spacing + "appendUnsigned(_pg_prename, _pg_j);\n";
         }
+
+        output += spacing + "_pg_prename.append(\"]\");\n";
     }
+    else
+        output += "\");\n";
 
     if(support.language == ProtocolSupport::c_language)
-        output += spacing + "mapEncode" + typeName + "(_pg_prename + " + key + ", _pg_map, " + getEncodeFieldAccess(true);
+        output += spacing + "textPrint" + typeName + "(_pg_report, _pg_prename, " + getEncodeFieldAccess(true) + ");\n";
     else
-        output += spacing + getEncodeFieldAccess(true) + ".mapEncode(_pg_prename + " + key + ", _pg_map";
+        output += spacing + getEncodeFieldAccess(true) + ".textPrint(_pg_report, _pg_prename);\n";
 
-    output += ");\n";
+    output += spacing + "_pg_prename.resize(_pg_length);\n";
+
+    if(isArray())
+        output += spacing.substr(TAB_IN.size()) + "}\n";
 
     return output;
 
-}// ProtocolStructure::getMapEncodeString
+}// ProtocolStructure::getTextPrintString
 
 
 /*!
- * Get the string used for decoding this field from a map.
- * \return the map decode string, which may be empty
+ * Get the estimated number of characters text printed for this structure as a
+ * member of another structure.
+ * \param lines is incremented by the number of lines printed, each of which
+ *        also includes the prename.
+ * \return the number of characters printed, not counting the prename
  */
-std::string ProtocolStructure::getMapDecodeString(void) const
+int ProtocolStructure::getTextPrintLength(int* lines) const
 {
-    std::string output;
-    std::string spacing = TAB_IN;
+    int sublines = 0;
+    int sublength;
+    int count = getMaximumArrayCount();
 
     // We must parameters that we decode to do a print out
-    if(!mapEncode || (getNumberOfDecodeParameters() == 0))
-        return output;
-
-    if(!comment.empty())
-        output += spacing + "// " + comment + "\n";
+    if(!print || (getNumberOfDecodeParameters() == 0))
+        return 0;
 
-    std::string key = "\":" + name + "\"";
+    sublength = getTextPrintContentsLength(&sublines);
 
-    output += getDecodeArrayIterationCode(spacing, true);
+    // Every line of the contents includes our name and array indices
+    int length = (int)name.size() + 1;
     if(isArray())
-    {
-        spacing += TAB_IN;
-        key += " + \"[\" + QString::number(_pg_i) + \"]\"";
+        length += 4;
+    if(is2dArray())
+        length += 4;
 
-        if(is2dArray())
-        {
-            spacing += TAB_IN;
-            key += " + \"[\" + QString::number(_pg_j) + \"]\"";
-        }
+    (*lines) += count*sublines;
+    return count*(sublength + sublines*length);
+
+}// ProtocolStructure::getTextPrintLength
+
+
+/*!
+ * Get the estimated number of characters text printed for the contents of
+ * this structure, which is used to reserve the report before it is printed.
+ * \param lines is incremented by the number of lines printed, each of which
+ *        also includes the prename.
+ * \return the number of characters printed, not counting the prename
+ */
+int ProtocolStructure::getTextPrintContentsLength(int* lines) const
+{
+    int length = 0;
+
+    for(std::size_t i = 0; i < encodables.size(); i++)
+        length += encodables.at(i)->getTextPrintLength(lines);
+
+    return length;
+
+}// ProtocolStructure::getTextPrintContentsLength
+
+
+/*!
+ * Get the string used for reading this field from text. The key of the
+ * structure is formed by extending the prename in place.
+ * \return the read string, which may be empty
+ */
+std::string ProtocolStructure::getTextReadString(void) const
+{
+    std::string output;
+    std::string spacing = TAB_IN;
+
+    // We must parameters that we decode to do a print out
+    if(!print || (getNumberOfDecodeParameters() == 0))
+        return output;
+
+    if(!comment.empty())
+        output += spacing + "// " + comment + "\n";
+
+    output += getEncodeArrayIterationCode(spacing, true);
+    if(isArray())
+    {
+        spacing += TAB_IN;
+        if(is2dArray())
+            spacing += TAB_IN;
+
+        output += spacing.substr(TAB_IN.size()) + "{\n";
+    }
+
+    // The structure name, and array indices, are added to the prename for the structure read
+    output += spacing + "_pg_prename.append(\":" + name;
+
+    if(isArray())
+    {
+        output += "[\");\n";
+        output += spacing + "appendUnsigned(_pg_prename, _pg_i);\n";
+
+        if(is2dArray())
+        {
+            output += spacing + "_pg_prename.append(\"][\");\n";
+            output += spacing + "appendUnsigned(_pg_prename, _pg_j);\n";
+        }
+
+        output += spacing + "_pg_prename.append(\"]\");\n";
+    }
+    else
+        output += "\");\n";
+
+    if(support.language == ProtocolSupport::c_language)
+        output += spacing + "_pg_fieldcount += textRead" + typeName + "(_pg_prename, _pg_index, " + getEncodeFieldAccess(true) + ");\n";
+    else
+        output += spacing + "_pg_fieldcount += " + getEncodeFieldAccess(true) + ".textRead(_pg_prename, _pg_index);\n";
+
+    output += spacing + "_pg_prename.resize(_pg_length);\n";
+
+    if(isArray())
+        output += spacing.substr(TAB_IN.size()) + "}\n";
+
+    return output;
+
+}// ProtocolStructure::getTextReadString
+
+
+/*!
+ * Return the string used for encoding this field to a map
+ * \return the encode string, which may be empty
+ */
+std::string ProtocolStructure::getMapEncodeString(void) const
+{
+    std::string output;
+    std::string spacing = TAB_IN;
+
+    // We must parameters that we decode to do a print out
+    if(!mapEncode || (getNumberOfDecodeParameters() == 0))
+        return output;
+
+    if(!comment.empty())
+        output += spacing + "// " + comment + "\n";
+
+    std::string key = "\":" + name + "\"";
+
+    output += getEncodeArrayIterationCode(spacing, true);
+
+    if(support.stdMap)
+    {
+        std::string indices;
+
+        if(isArray())
+        {
+            spacing += TAB_IN;
+            indices += ", _pg_i";
+            if(is2dArray())
+            {
+                spacing += TAB_IN;
+                indices += ", _pg_j";
+            }
+        }
+
+        // The brace lines up with the innermost for loop
+        std::string brace = spacing.substr(0, spacing.length() - TAB_IN.length());
+
+        if(isArray())
+            output += brace + "{\n";
+
+        output += spacing + "_pg_length = FieldMap::appendKey(_pg_key, " + key + indices + ");\n";
+
+        if(support.language == ProtocolSupport::c_language)
+            output += spacing + "mapEncode" + typeName + "(_pg_key, _pg_map, " + getEncodeFieldAccess(true) + ");\n";
+        else
+            output += spacing + getEncodeFieldAccess(true) + ".mapEncode(_pg_key, _pg_map);\n";
+
+        output += spacing + "_pg_key.resize(_pg_length);\n";
+
+        if(isArray())
+            output += brace + "}\n";
+
+        return output;
+    }
+
+    if(isArray())
+    {
+        spacing += TAB_IN;
+        key += " + \"[\" + QString::number(_pg_i) + \"]\"";
+
+        if(is2dArray())
+        {
+            spacing += TAB_IN;
+            key += " + \"[\" + QString::number(_pg_j) + \"]\"";
+        }
+    }
+
+    if(support.language == ProtocolSupport::c_language)
+        output += spacing + "mapEncode" + typeName + "(_pg_prename + " + key + ", _pg_map, " + getEncodeFieldAccess(true);
+    else
+        output += spacing + getEncodeFieldAccess(true) + ".mapEncode(_pg_prename + " + key + ", _pg_map";
+
+    output += ");\n";
+
+    return output;
+
+}// ProtocolStructure::getMapEncodeString
+
+
+/*!
+ * Get the string used for decoding this field from a map.
+ * \return the map decode string, which may be empty
+ */
+std::string ProtocolStructure::getMapDecodeString(void) const
+{
+    std::string output;
+    std::string spacing = TAB_IN;
+
+    // We must parameters that we decode to do a print out
+    if(!mapEncode || (getNumberOfDecodeParameters() == 0))
+        return output;
+
+    if(!comment.empty())
+        output += spacing + "// " + comment + "\n";
+
+    std::string key = "\":" + name + "\"";
+
+    output += getDecodeArrayIterationCode(spacing, true);
+
+    if(support.stdMap)
+    {
+        std::string indices;
+
+        if(isArray())
+        {
+            spacing += TAB_IN;
+            indices += ", _pg_i";
+            if(is2dArray())
+            {
+                spacing += TAB_IN;
+                indices += ", _pg_j";
+            }
+        }
+
+        // The brace lines up with the innermost for loop
+        std::string brace = spacing.substr(0, spacing.length() - TAB_IN.length());
+
+        if(isArray())
+            output += brace + "{\n";
+
+        output += spacing + "_pg_length = FieldMap::appendKey(_pg_key, " + key + indices + ");\n";
+
+        if(support.language == ProtocolSupport::c_language)
+            output += spacing + "mapDecode" + typeName + "(_pg_key, _pg_map, " + getDecodeFieldAccess(true) + ");\n";
+        else
+            output += spacing + getDecodeFieldAccess(true) + ".mapDecode(_pg_key, _pg_map);\n";
+
+        output += spacing + "_pg_key.resize(_pg_length);\n";
+
+        if(isArray())
+            output += brace + "}\n";
+
+        return output;
+    }
+
+    if(isArray())
+    {
+        spacing += TAB_IN;
+        key += " + \"[\" + QString::number(_pg_i) + \"]\"";
+
+        if(is2dArray())
+        {
+            spacing += TAB_IN;
+            key += " + \"[\" + QString::number(_pg_j) + \"]\"";
+        }
     }
 
     if(support.language == ProtocolSupport::c_language)
@@ -761,6 +1253,97 @@ std::string ProtocolStructure::getMapDecodeString(void) const
 }// ProtocolStructure::getMapDecodeString
 
 
+/*!
+ * Get the string used for encoding this structure to JSON, as a member of
+ * another structure.
+ * \param first should be true if this is the first member of the JSON object.
+ * \return the JSON encode string, which may be empty
+ */
+std::string ProtocolStructure::getJsonEncodeString(bool first) const
+{
+    CodeEmitter output;
+
+    // We must parameters that we decode to do a print out
+    if(!json || (getNumberOfDecodeParameters() == 0))
+        return output.take();
+
+    if(!comment.empty())
+        output.append(TAB_IN, "// ", comment, "\n");
+
+    output.append(getJsonEncodeMemberString(first));
+
+    return output.take();
+
+}// ProtocolStructure::getJsonEncodeString
+
+
+/*!
+ * Get the string used for decoding this structure from JSON, as a member of
+ * another structure.
+ * \return the JSON decode string, which may be empty
+ */
+std::string ProtocolStructure::getJsonDecodeString(void) const
+{
+    // We must parameters that we decode to do a print out
+    if(!json || (getNumberOfDecodeParameters() == 0))
+        return std::string();
+
+    return getJsonDecodeMemberString();
+
+}// ProtocolStructure::getJsonDecodeString
+
+
+/*!
+ * Get the string used for encoding one element of this structure to JSON.
+ * \param spacing is the indentation of the code.
+ * \param separator is the string literal (or expression) written before the element.
+ * \return the string used to encode the element
+ */
+std::string ProtocolStructure::getJsonEncodeValueString(const std::string& spacing, const std::string& separator) const
+{
+    CodeEmitter output;
+
+    output.append(spacing, "jsonText(_pg_json, _pg_size, _pg_index, ", separator, ");\n");
+
+    if(support.language == ProtocolSupport::c_language)
+        output.append(spacing, "jsonEncode", typeName, "(_pg_json, _pg_size, _pg_index, ", getEncodeFieldAccess(true), ");\n");
+    else
+        output.append(spacing, getEncodeFieldAccess(true), ".jsonEncode(_pg_json, _pg_size, _pg_index);\n");
+
+    return output.take();
+
+}// ProtocolStructure::getJsonEncodeValueString
+
+
+/*!
+ * Get the string used for decoding one element of this structure from JSON.
+ * \param spacing is the indentation of the code.
+ * \param condition determines if the element is stored, empty to always store
+ *        it. Elements that are not stored are skipped.
+ * \return the string used to decode the element
+ */
+std::string ProtocolStructure::getJsonDecodeValueString(const std::string& spacing, const std::string& condition) const
+{
+    CodeEmitter output;
+    std::string call;
+
+    if(support.language == ProtocolSupport::c_language)
+        call = "jsonDecode" + typeName + "(_pg_json, _pg_length, _pg_index, " + getDecodeFieldAccess(true) + ")";
+    else
+        call = getDecodeFieldAccess(true) + ".jsonDecode(_pg_json, _pg_length, _pg_index)";
+
+    if(condition.empty())
+        output.append(spacing, "if(!", call, ")\n");
+    else
+        output.append(spacing, "if((", condition, ") ? !", call, " : !jsonSkip(_pg_json, _pg_length, _pg_index))\n");
+
+    output.append(spacing, TAB_IN, "return false;\n");
+
+    return output.take();
+
+}// ProtocolStructure::getJsonDecodeValueString
+
+
 /*!
  * Parse all enumerations which are direct children of a DomNode
  * \param node is parent node.
@@ -796,7 +1379,7 @@ void ProtocolStructure::parseChildren(const XMLElement* field)
     // Make encodables out of them, and add to our list
     for(const XMLElement* child = field->FirstChildElement(); child != nullptr; child = child->NextSiblingElement())
     {
-        Encodable* encodable = generateEncodable(parser, getHierarchicalName(), support, child);
+        Encodable* encodable = generateEncodable(parser, getHierarchicalName(), support, child, limitonencode);
         if(encodable != NULL)
         {
             // If the encodable is null, then none of the metadata
@@ -822,7 +1405,6 @@ void ProtocolStructure::parseChildren(const XMLElement* field)
                         if(prev >= encodables.size())
                         {
                             field->emitWarning("override failed, could not find previous field");
-                            delete encodable;
                             continue;
                         }
 
@@ -1099,47 +1681,190 @@ void ProtocolStructure::setMapEncode(bool enable)
 }
 
 
-//! Get the maximum number of temporary bytes needed for a bitfield group of our children
-void ProtocolStructure::getBitfieldGroupNumBytes(int* num) const
+//! Set the json flag for this structure and all children structure
+void ProtocolStructure::setJson(bool enable)
 {
-    if(numbitfieldgroupbytes > (*num))
-        (*num) = numbitfieldgroupbytes;
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        // Is this encodable a structure?
+        ProtocolStructure* structure = dynamic_cast<ProtocolStructure*>(encodables.at(i));
+
+        if(structure == nullptr)
+            continue;
+
+        structure->setJson(enable);
+
+    }// for all children
+
+    json = enable;
 }
 
 
-/*!
- * Get the number of encoded fields. This is not the same as the length of the
- * encodables list, because some or all of them could be isNotEncoded()
- * \return the number of encodables in the packet.
- */
-int ProtocolStructure::getNumberOfEncodes(void) const
+//! Set the hash flag for this structure and all children structure
+void ProtocolStructure::setHash(bool enable)
 {
-    int numEncodes = 0;
     for(std::size_t i = 0; i < encodables.size(); i++)
     {
-        // If its not encoded at all, then it does not count
-        if(encodables.at(i)->isNotEncoded())
+        // Is this encodable a structure?
+        ProtocolStructure* structure = dynamic_cast<ProtocolStructure*>(encodables.at(i));
+
+        if(structure == nullptr)
             continue;
-        else
-            numEncodes++;
-    }
 
-    return numEncodes;
+        structure->setHash(enable);
+
+    }// for all children
+
+    hash = enable;
 }
 
 
-/*!
- * Get the number of encoded fields. This is not the same as the length of the
- * encodables list, because some or all of them could be isNotEncoded() or isConstant()
- * \return the number of encodables in the packet set by the user.
- */
-int ProtocolStructure::getNumberOfEncodeParameters(void) const
+//! Set the encodedSize flag for this structure and all children structure
+void ProtocolStructure::setEncodedSize(bool enable)
 {
-    int numEncodes = 0;
     for(std::size_t i = 0; i < encodables.size(); i++)
     {
-        // If its not encoded at all, or its encoded as a constant, then it does not count
-        if(encodables.at(i)->isNotEncoded() || encodables.at(i)->isConstant())
+        // Is this encodable a structure?
+        ProtocolStructure* structure = dynamic_cast<ProtocolStructure*>(encodables.at(i));
+
+        if(structure == nullptr)
+            continue;
+
+        structure->setEncodedSize(enable);
+
+    }// for all children
+
+    encodedSize = enable;
+}
+
+
+//! Set the skip flag for this structure and all children structure
+void ProtocolStructure::setSkip(bool enable)
+{
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        // Is this encodable a structure?
+        ProtocolStructure* structure = dynamic_cast<ProtocolStructure*>(encodables.at(i));
+
+        if(structure == nullptr)
+            continue;
+
+        structure->setSkip(enable);
+
+    }// for all children
+
+    skipEncoded = enable;
+}
+
+
+//! Set the noInit flag for this structure and all children structure
+void ProtocolStructure::setNoInit(bool enable)
+{
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        // Is this encodable a structure?
+        ProtocolStructure* structure = dynamic_cast<ProtocolStructure*>(encodables.at(i));
+
+        if(structure == nullptr)
+            continue;
+
+        structure->setNoInit(enable);
+
+    }// for all children
+
+    noinit = enable;
+}
+
+
+/*!
+ * Determine if the C++ constructor of this structure leaves its members to be
+ * set by the initialize() function. A structure which redefines another
+ * follows the structure it redefines, since that is where the members are.
+ * \return true if this structure has the initialize() function.
+ */
+bool ProtocolStructure::isNoInit(void) const
+{
+    if(support.language != ProtocolSupport::cpp_language)
+        return false;
+    else if(redefines != nullptr)
+        return redefines->isNoInit();
+    else
+        return noinit;
+}
+
+
+//! True if any of the children of this structure are encoded as variable length integers
+bool ProtocolStructure::usesVarint(void) const
+{
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        if(encodables.at(i)->usesVarint())
+            return true;
+    }
+
+    return false;
+}
+
+
+//! True if this structure, or any of its children, has a hash function
+bool ProtocolStructure::usesHash(void) const
+{
+    if(hash)
+        return true;
+
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        const ProtocolStructure* structure = dynamic_cast<const ProtocolStructure*>(encodables.at(i));
+
+        if((structure != nullptr) && structure->usesHash())
+            return true;
+    }
+
+    return false;
+}
+
+
+//! Get the maximum number of temporary bytes needed for a bitfield group of our children
+void ProtocolStructure::getBitfieldGroupNumBytes(int* num) const
+{
+    if(numbitfieldgroupbytes > (*num))
+        (*num) = numbitfieldgroupbytes;
+}
+
+
+/*!
+ * Get the number of encoded fields. This is not the same as the length of the
+ * encodables list, because some or all of them could be isNotEncoded()
+ * \return the number of encodables in the packet.
+ */
+int ProtocolStructure::getNumberOfEncodes(void) const
+{
+    int numEncodes = 0;
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        // If its not encoded at all, then it does not count
+        if(encodables.at(i)->isNotEncoded())
+            continue;
+        else
+            numEncodes++;
+    }
+
+    return numEncodes;
+}
+
+
+/*!
+ * Get the number of encoded fields. This is not the same as the length of the
+ * encodables list, because some or all of them could be isNotEncoded() or isConstant()
+ * \return the number of encodables in the packet set by the user.
+ */
+int ProtocolStructure::getNumberOfEncodeParameters(void) const
+{
+    int numEncodes = 0;
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        // If its not encoded at all, or its encoded as a constant, then it does not count
+        if(encodables.at(i)->isNotEncoded() || encodables.at(i)->isConstant())
             continue;
         else
             numEncodes++;
@@ -1298,6 +2023,20 @@ void ProtocolStructure::getPrintIncludeDirectives(std::vector<std::string>& list
 }
 
 
+/*!
+ * Return the include directives needed for this encodable's JSON functions
+ * \param list is appended with any directives this encodable requires.
+ */
+void ProtocolStructure::getJsonIncludeDirectives(std::vector<std::string>& list) const
+{
+    // Includes that our encodable members may need
+    for(std::size_t i = 0; i < encodables.size(); i++)
+        encodables.at(i)->getJsonIncludeDirectives(list);
+
+    removeDuplicates(list);
+}
+
+
 /*!
  * Determine if this structure (or its children) defines an enumeration name
  * \param name is the name of the enumeration element to look for
@@ -1375,8 +2114,18 @@ std::string ProtocolStructure::getStructureDeclaration(bool alwaysCreate) const
     if(support.language == ProtocolSupport::c_language)
         output += getStructureDeclaration_C(alwaysCreate);
     else
+    {
         output += getClassDeclaration_CPP();
 
+        // The hash lets the class be the key of an unordered container
+        std::string specialization = getStdHashSpecialization();
+        if(!specialization.empty())
+        {
+            ProtocolFile::makeLineSeparator(output);
+            output += specialization;
+        }
+    }
+
     return output;
 
 }// ProtocolStructure::getStructureDeclaration
@@ -1474,6 +2223,8 @@ std::string ProtocolStructure::getClassDeclaration_CPP(void) const
         ProtocolFile::makeLineSeparator(output);
         output += getEncodeFunctionPrototype(TAB_IN, false);
         ProtocolFile::makeLineSeparator(output);
+        output += getEncodedSizeFunctionPrototype(TAB_IN, false);
+        ProtocolFile::makeLineSeparator(output);
     }
 
     if(decode)
@@ -1481,6 +2232,8 @@ std::string ProtocolStructure::getClassDeclaration_CPP(void) const
         ProtocolFile::makeLineSeparator(output);
         output += getDecodeFunctionPrototype(TAB_IN, false);
         ProtocolFile::makeLineSeparator(output);
+        output += getSkipFunctionPrototype(TAB_IN, false);
+        ProtocolFile::makeLineSeparator(output);
     }
 
     if((encode != false) || (decode != false))
@@ -1517,6 +2270,15 @@ std::string ProtocolStructure::getClassDeclaration_CPP(void) const
             ProtocolFile::makeLineSeparator(output);
         }
 
+        if(json)
+        {
+            ProtocolFile::makeLineSeparator(output);
+            output += getJsonEncodeFunctionPrototype(TAB_IN, false);
+            ProtocolFile::makeLineSeparator(output);
+            output += getJsonDecodeFunctionPrototype(TAB_IN, false);
+            ProtocolFile::makeLineSeparator(output);
+        }
+
         if(compare)
         {
             ProtocolFile::makeLineSeparator(output);
@@ -1524,6 +2286,13 @@ std::string ProtocolStructure::getClassDeclaration_CPP(void) const
             ProtocolFile::makeLineSeparator(output);
         }
 
+        if(hash)
+        {
+            ProtocolFile::makeLineSeparator(output);
+            output += getHashFunctionPrototype(TAB_IN, false);
+            ProtocolFile::makeLineSeparator(output);
+        }
+
         // Now declare the members of this class
         for(std::size_t i = 0; i < encodables.size(); i++)
             structure += encodables[i]->getDeclaration();
@@ -1703,8 +2472,21 @@ std::string ProtocolStructure::getEncodeFunctionPrototype(const std::string& spa
  */
 std::string ProtocolStructure::getEncodeFunctionBody(bool includeChildren) const
 {
-    std::string output;
+    CodeEmitter output;
+    emitEncodeFunctionBody(output, includeChildren);
+    return output.take();
+
+}// ProtocolStructure::getEncodeFunctionBody
+
 
+/*!
+ * Output the function used to encode this structure and all its children to a
+ * simple byte array.
+ * \param output receives the comments and code with linefeeds and semicolons.
+ * \param includeChildren should be true to output the children's functions.
+ */
+void ProtocolStructure::emitEncodeFunctionBody(CodeEmitter& output, bool includeChildren) const
+{
     if(includeChildren)
     {
         for(std::size_t i = 0; i < encodables.size(); i++)
@@ -1715,73 +2497,73 @@ std::string ProtocolStructure::getEncodeFunctionBody(bool includeChildren) const
             if(structure == nullptr)
                 continue;
 
-            ProtocolFile::makeLineSeparator(output);
-            output += structure->getEncodeFunctionBody(includeChildren);
+            output.makeLineSeparator();
+            structure->emitEncodeFunctionBody(output, includeChildren);
         }
-        ProtocolFile::makeLineSeparator(output);
+        output.makeLineSeparator();
     }
 
     // My encoding function
-    output += "/*!\n";
-    output += " * \\brief Encode a " + typeName + " into a byte array\n";
-    output += " *\n";
-    output += ProtocolParser::outputLongComment(" * ", comment) + "\n";
-    output += " * \\param _pg_data points to the byte array to add encoded data to\n";
-    output += " * \\param _pg_bytecount points to the starting location in the byte array, and will be incremented by the number of encoded bytes.\n";
+    output.line("/*!");
+    output.line(" * \\brief Encode a ", typeName, " into a byte array");
+    output.line(" *");
+    output.line(ProtocolParser::outputLongComment(" * ", comment));
+    output.line(" * \\param _pg_data points to the byte array to add encoded data to");
+    output.line(" * \\param _pg_bytecount points to the starting location in the byte array, and will be incremented by the number of encoded bytes.");
     if((support.language == ProtocolSupport::c_language) && (getNumberOfEncodeParameters() > 0))
-        output += " * \\param _pg_user is the data to encode in the byte array\n";
-    output += " */\n";
+        output.line(" * \\param _pg_user is the data to encode in the byte array");
+    output.line(" */");
 
-    output += getEncodeFunctionSignature(true) + "\n";
-    output += "{\n";
+    output.line(getEncodeFunctionSignature(true));
+    output.line("{");
+    output.indent();
 
-    output += TAB_IN + "int _pg_byteindex = *_pg_bytecount;\n";
+    output.line("int _pg_byteindex = *_pg_bytecount;");
 
     if(usestempencodebitfields)
-        output += TAB_IN + "unsigned int _pg_tempbitfield = 0;\n";
+        output.line("unsigned int _pg_tempbitfield = 0;");
 
     if(usestempencodelongbitfields)
-        output += TAB_IN + "uint64_t _pg_templongbitfield = 0;\n";
+        output.line("uint64_t _pg_templongbitfield = 0;");
 
     if(numbitfieldgroupbytes > 0)
     {
-        output += TAB_IN + "int _pg_bitfieldindex = 0;\n";
-        output += TAB_IN + "uint8_t _pg_bitfieldbytes[" + std::to_string(numbitfieldgroupbytes) + "];\n";
+        output.line("int _pg_bitfieldindex = 0;");
+        output.line("uint8_t _pg_bitfieldbytes[", numbitfieldgroupbytes, "];");
     }
 
     if(needsEncodeIterator)
-        output += TAB_IN + "unsigned _pg_i = 0;\n";
+        output.line("unsigned _pg_i = 0;");
 
     if(needs2ndEncodeIterator)
-        output += TAB_IN + "unsigned _pg_j = 0;\n";
+        output.line("unsigned _pg_j = 0;");
 
     int bitcount = 0;
     for(std::size_t i = 0; i < encodables.size(); i++)
     {
-        ProtocolFile::makeLineSeparator(output);
-        output += encodables[i]->getEncodeString(&bitcount, true);
+        output.makeLineSeparator();
+        output.append(encodables[i]->getEncodeString(&bitcount, true));
     }
 
-    ProtocolFile::makeLineSeparator(output);
-    output += TAB_IN + "*_pg_bytecount = _pg_byteindex;\n";
-    output += "\n";
+    output.makeLineSeparator();
+    output.line("*_pg_bytecount = _pg_byteindex;");
+    output.unindent();
+    output.line();
 
     if(support.language == ProtocolSupport::c_language)
-        output += "}// encode" + typeName + "\n";
+        output.line("}// encode", typeName);
     else
-        output += "}// " + typeName + "::encode\n";
-
-    return output;
+        output.line("}// ", typeName, "::encode");
 
-}// ProtocolStructure::getEncodeFunctionBody
+}// ProtocolStructure::emitEncodeFunctionBody
 
 
 /*!
- * Get the signature of the function that decodes this structure.
+ * Get the signature of the function that computes the encoded size of this structure.
  * \param insource should be true to indicate this signature is in source code
- * \return the signature of the decode function.
+ * \return the signature of the encoded size function.
  */
-std::string ProtocolStructure::getDecodeFunctionSignature(bool insource) const
+std::string ProtocolStructure::getEncodedSizeFunctionSignature(bool insource) const
 {
     std::string output;
 
@@ -1792,40 +2574,49 @@ std::string ProtocolStructure::getDecodeFunctionSignature(bool insource) const
         if(insource)
             pg = "_pg_";
 
-        if(getNumberOfDecodeParameters() > 0)
-        {
-            output = "int decode" + typeName + "(const uint8_t* " + pg + "data, int* " + pg + "bytecount, " + structName + "* " + pg + "user)";
-        }
+        if(getNumberOfEncodeParameters() > 0)
+            output = "int getEncodedSizeOf" + typeName + "(const " + structName + "* " + pg + "user)";
         else
-        {
-            output = "int decode" + typeName + "(const uint8_t* " + pg + "data, int* " + pg + "bytecount)";
-        }
+            output = "int getEncodedSizeOf" + typeName + "(void)";
     }
     else
     {
-        // For C++ these functions are within the class namespace and they
-        // reference their own members.
-        if(insource)
-            output = "bool " + typeName + "::decode(const uint8_t* _pg_data, int* _pg_bytecount)";
+        // Like encode, this is const, or static if there are no encode parameters
+        if(getNumberOfEncodeParameters() > 0)
+        {
+            if(insource)
+                output = "int " + typeName + "::encodedSize(void) const";
+            else
+                output = "int encodedSize(void) const";
+        }
         else
-            output = "bool decode(const uint8_t* data, int* bytecount)";
+        {
+            if(insource)
+                output = "int " + typeName + "::encodedSize(void)";
+            else
+                output = "static int encodedSize(void)";
+        }
     }
 
     return output;
 
-}// ProtocolStructure::getDecodeFunctionSignature
+}// ProtocolStructure::getEncodedSizeFunctionSignature
 
 
 /*!
- * Return the string that gives the prototype of the functions used to decode
- * the structure. The encoding is to a simple byte array.
+ * Return the string that gives the prototype of the functions used to compute
+ * the encoded size of the structure, and all child structures.
  * \param spacing gives the spacing to offset each line.
  * \param includeChildren should be true to output the children's prototypes.
  * \return The string including the comments and prototypes with linefeeds and semicolons.
  */
-std::string ProtocolStructure::getDecodeFunctionPrototype(const std::string& spacing, bool includeChildren) const
+std::string ProtocolStructure::getEncodedSizeFunctionPrototype(const std::string& spacing, bool includeChildren) const
 {
-    std::string output;
+    CodeEmitter output;
+
+    // The encoded size function is optional, and includes the children
+    if(!encodedSize)
+        return output.take();
 
     // Only the C language needs this. C++ declares the prototype within the class
     if(includeChildren && (support.language == ProtocolSupport::c_language))
@@ -1838,29 +2629,48 @@ std::string ProtocolStructure::getDecodeFunctionPrototype(const std::string& spa
             if(structure == nullptr)
                 continue;
 
-            ProtocolFile::makeLineSeparator(output);
-            output += structure->getDecodeFunctionPrototype(spacing, includeChildren);
+            output.makeLineSeparator();
+            output.append(structure->getEncodedSizeFunctionPrototype(spacing, includeChildren));
         }
-        ProtocolFile::makeLineSeparator(output);
+        output.makeLineSeparator();
+
     }
 
-    output += spacing + "//! Decode a " + typeName + " from a byte array\n";
-    output += spacing + getDecodeFunctionSignature(false) + ";\n";
+    output.append(spacing, "//! Compute the number of bytes used to encode a ", typeName, "\n");
+    output.append(spacing, getEncodedSizeFunctionSignature(false), ";\n");
 
-    return output;
+    return output.take();
 
-}// ProtocolStructure::getDecodeFunctionPrototype
+}// ProtocolStructure::getEncodedSizeFunctionPrototype
 
 
 /*!
- * Return the string that gives the function used to decode this structure.
- * The decoding is from a simple byte array.
+ * Return the string that gives the function used to compute the encoded size
+ * of this structure, and all its children. The function follows the encode
+ * function without touching any data, so buffers can be sized exactly.
  * \param includeChildren should be true to output the children's functions.
  * \return The string including the comments and code with linefeeds and semicolons.
  */
-std::string ProtocolStructure::getDecodeFunctionBody(bool includeChildren) const
+std::string ProtocolStructure::getEncodedSizeFunctionBody(bool includeChildren) const
 {
-    std::string output;
+    CodeEmitter output;
+    emitEncodedSizeFunctionBody(output, includeChildren);
+    return output.take();
+
+}// ProtocolStructure::getEncodedSizeFunctionBody
+
+
+/*!
+ * Output the function used to compute the encoded size of this structure, and
+ * all its children.
+ * \param output receives the comments and code with linefeeds and semicolons.
+ * \param includeChildren should be true to output the children's functions.
+ */
+void ProtocolStructure::emitEncodedSizeFunctionBody(CodeEmitter& output, bool includeChildren) const
+{
+    // The encoded size function is optional, and includes the children
+    if(!encodedSize)
+        return;
 
     if(includeChildren)
     {
@@ -1872,75 +2682,560 @@ std::string ProtocolStructure::getDecodeFunctionBody(bool includeChildren) const
             if(structure == nullptr)
                 continue;
 
-            ProtocolFile::makeLineSeparator(output);
-            output += structure->getDecodeFunctionBody();
+            output.makeLineSeparator();
+            structure->emitEncodedSizeFunctionBody(output, includeChildren);
         }
-        ProtocolFile::makeLineSeparator(output);
+        output.makeLineSeparator();
     }
 
-    output += "/*!\n";
-    output += " * \\brief Decode a " + typeName + " from a byte array\n";
-    output += " *\n";
-    output += ProtocolParser::outputLongComment(" * ", comment) + "\n";
-    output += " * \\param _pg_data points to the byte array to decoded data from\n";
-    output += " * \\param _pg_bytecount points to the starting location in the byte array, and will be incremented by the number of bytes decoded\n";
-    if((support.language == ProtocolSupport::c_language) && (getNumberOfDecodeParameters() > 0))
-        output += " * \\param _pg_user is the data to decode from the byte array\n";
+    // The fixed part of the encoding is summed by the generator
+    EncodedLength fixedlength;
+    std::string code;
 
-    output += " * \\return " + getReturnCode(true) + " if the data are decoded, else " + getReturnCode(false) + ".\n";
-    output += " */\n";
-    output += getDecodeFunctionSignature(true) + "\n";
-    output += "{\n";
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        std::string size = encodables.at(i)->getEncodedSizeString(true);
 
-    output += TAB_IN + "int _pg_byteindex = *_pg_bytecount;\n";
+        if(size.empty())
+            fixedlength.addToLength(encodables.at(i)->encodedLength);
+        else
+        {
+            ProtocolFile::makeLineSeparator(code);
+            code += size;
+        }
+    }
 
-    if(usestempdecodebitfields)
-        output += TAB_IN + "unsigned int _pg_tempbitfield = 0;\n";
+    std::string fixed = fixedlength.maxEncodedLength;
+    if(fixed.empty())
+        fixed = "0";
 
-    if(usestempdecodelongbitfields)
-        output += TAB_IN + "uint64_t _pg_templongbitfield = 0;\n";
+    output.append("/*!\n");
+    output.append(" * \\brief Compute the number of bytes that encode would output for a ", typeName, ", without encoding it\n");
+    output.append(" *\n");
+    output.append(ProtocolParser::outputLongComment(" * ", comment), "\n");
+    if((support.language == ProtocolSupport::c_language) && (getNumberOfEncodeParameters() > 0))
+        output.append(" * \\param _pg_user is the data that would be encoded\n");
+    output.append(" * \\return the number of bytes that encode would output\n");
+    output.append(" */\n");
 
-    if(numbitfieldgroupbytes > 0)
+    output.append(getEncodedSizeFunctionSignature(true), "\n");
+    output.append("{\n");
+
+    // Constant strings are sized without the user structure
+    if((support.language == ProtocolSupport::c_language) && (getNumberOfEncodeParameters() > 0) && (code.find("_pg_user") == std::string::npos))
+        output.append(TAB_IN, "(void)_pg_user;\n");
+
+    if(code.empty())
+        output.append(TAB_IN, "return ", fixed, ";\n");
+    else
     {
-        output += TAB_IN + "int _pg_bitfieldindex = 0;\n";
-        output += TAB_IN + "uint8_t _pg_bitfieldbytes[" + std::to_string(numbitfieldgroupbytes) + "];\n";
-    }
+        output.append(TAB_IN, "int _pg_byteindex = ", fixed, ";\n");
 
-    if(needsDecodeIterator)
-        output += TAB_IN + "unsigned _pg_i = 0;\n";
+        if(code.find("_pg_i") != std::string::npos)
+            output.append(TAB_IN, "unsigned _pg_i = 0;\n");
 
-    if(needs2ndDecodeIterator)
-        output += TAB_IN + "unsigned _pg_j = 0;\n";
+        if(code.find("_pg_j") != std::string::npos)
+            output.append(TAB_IN, "unsigned _pg_j = 0;\n");
 
-    int bitcount = 0;
-    for(std::size_t i = 0; i < encodables.size(); i++)
-    {
-        ProtocolFile::makeLineSeparator(output);
-        output += encodables[i]->getDecodeString(&bitcount, true);
+        output.makeLineSeparator();
+        output.append(code);
+        output.makeLineSeparator();
+        output.append(TAB_IN, "return _pg_byteindex;\n");
     }
 
-    ProtocolFile::makeLineSeparator(output);
-    output += TAB_IN + "*_pg_bytecount = _pg_byteindex;\n\n";
-    output += TAB_IN + "return " + getReturnCode(true) + ";\n";
-    output += "\n";
+    output.append("\n");
 
     if(support.language == ProtocolSupport::c_language)
-        output += "}// decode" + typeName + "\n";
+        output.append("}// getEncodedSizeOf", typeName, "\n");
     else
-        output += "}// " + typeName + "::decode\n";
-
-    return output;
+        output.append("}// ", typeName, "::encodedSize\n");
 
-}// ProtocolStructure::getDecodeFunctionBody
+}// ProtocolStructure::emitEncodedSizeFunctionBody
 
 
 /*!
- * Get the signature of the function that sets initial values of this structure.
- * This is just the constructor for C++
- * \param insource should be true to indicate this signature is in source code.
- * \return the signature of the set to initial value function.
+ * Get the signature of the function that skips this structure in a byte array.
+ * \param insource should be true to indicate this signature is in source code
+ * \return the signature of the skip function.
  */
-std::string ProtocolStructure::getSetToInitialValueFunctionSignature(bool insource) const
+std::string ProtocolStructure::getSkipFunctionSignature(bool insource) const
+{
+    std::string output;
+    std::string pg;
+
+    if(insource)
+        pg = "_pg_";
+
+    if(support.language == ProtocolSupport::c_language)
+        output = "int skip" + typeName + "(const uint8_t* " + pg + "data, int* " + pg + "bytecount, int " + pg + "numbytes)";
+    else
+    {
+        // The skip does not need any members, so it is always static
+        if(insource)
+            output = "bool " + typeName + "::skip(const uint8_t* _pg_data, int* _pg_bytecount, int _pg_numbytes)";
+        else
+            output = "static bool skip(const uint8_t* data, int* bytecount, int numbytes)";
+    }
+
+    return output;
+
+}// ProtocolStructure::getSkipFunctionSignature
+
+
+/*!
+ * Return the string that gives the prototype of the functions used to skip
+ * the structure, and all child structures.
+ * \param spacing gives the spacing to offset each line.
+ * \param includeChildren should be true to output the children's prototypes.
+ * \return The string including the comments and prototypes with linefeeds and semicolons.
+ */
+std::string ProtocolStructure::getSkipFunctionPrototype(const std::string& spacing, bool includeChildren) const
+{
+    CodeEmitter output;
+
+    // The skip function is optional, and includes the children
+    if(!skipEncoded)
+        return output.take();
+
+    // Only the C language needs this. C++ declares the prototype within the class
+    if(includeChildren && (support.language == ProtocolSupport::c_language))
+    {
+        for(std::size_t i = 0; i < encodables.size(); i++)
+        {
+            // Is this encodable a structure?
+            ProtocolStructure* structure = dynamic_cast<ProtocolStructure*>(encodables.at(i));
+
+            if(structure == nullptr)
+                continue;
+
+            output.makeLineSeparator();
+            output.append(structure->getSkipFunctionPrototype(spacing, includeChildren));
+        }
+        output.makeLineSeparator();
+
+    }
+
+    output.append(spacing, "//! Skip over an encoded ", typeName, " without decoding it\n");
+    output.append(spacing, getSkipFunctionSignature(false), ";\n");
+
+    return output.take();
+
+}// ProtocolStructure::getSkipFunctionPrototype
+
+
+/*!
+ * Return the string that gives the function used to skip this structure, and
+ * all its children, in a byte array. Only the fields which determine the
+ * length of the encoding (variable array sizes and dependsOn fields) are
+ * decoded, everything else is skipped using its encoded length.
+ * \param includeChildren should be true to output the children's functions.
+ * \return The string including the comments and code with linefeeds and semicolons.
+ */
+std::string ProtocolStructure::getSkipFunctionBody(bool includeChildren) const
+{
+    CodeEmitter output;
+    emitSkipFunctionBody(output, includeChildren);
+    return output.take();
+
+}// ProtocolStructure::getSkipFunctionBody
+
+
+/*!
+ * Output the function used to skip this structure, and all its children, in a
+ * byte array.
+ * \param output receives the comments and code with linefeeds and semicolons.
+ * \param includeChildren should be true to output the children's functions.
+ */
+void ProtocolStructure::emitSkipFunctionBody(CodeEmitter& output, bool includeChildren) const
+{
+    // The skip function is optional, and includes the children
+    if(!skipEncoded)
+        return;
+
+    if(includeChildren)
+    {
+        for(std::size_t i = 0; i < encodables.size(); i++)
+        {
+            // Is this encodable a structure?
+            ProtocolStructure* structure = dynamic_cast<ProtocolStructure*>(encodables.at(i));
+
+            if(structure == nullptr)
+                continue;
+
+            output.makeLineSeparator();
+            structure->emitSkipFunctionBody(output, includeChildren);
+        }
+        output.makeLineSeparator();
+    }
+
+    // The names of the fields which determine the length of the encoding
+    std::vector<std::string> controls;
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        if(!encodables.at(i)->variableArray.empty())
+            controls.push_back(encodables.at(i)->variableArray);
+
+        if(!encodables.at(i)->variable2dArray.empty())
+            controls.push_back(encodables.at(i)->variable2dArray);
+
+        if(!encodables.at(i)->dependsOn.empty())
+            controls.push_back(encodables.at(i)->dependsOn);
+    }
+
+    CodeEmitter code;
+    std::string declarations;
+    EncodedLength fixedlength;
+
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        // Bitfields are decoded as a run, because each one depends on the bit count of the previous
+        std::size_t last = i;
+        if(encodables.at(i)->isBitfield())
+        {
+            while(((last + 1) < encodables.size()) && encodables.at(last + 1)->isBitfield())
+                last++;
+        }
+
+        bool control = false;
+        for(std::size_t j = i; j <= last; j++)
+        {
+            if(contains(controls, encodables.at(j)->name, true))
+                control = true;
+        }
+
+        if(control)
+        {
+            EncodedLength length;
+            for(std::size_t j = i; j <= last; j++)
+                length.addToLength(encodables.at(j)->encodedLength);
+
+            // Catch up to the field, and make sure it is in the data
+            if(!fixedlength.maxEncodedLength.empty())
+            {
+                code.makeLineSeparator();
+                code.append(TAB_IN, "_pg_byteindex += ", fixedlength.maxEncodedLength, ";\n");
+                fixedlength.clear();
+            }
+
+            // A control whose length depends on its value, like a variable
+            // length integer, is scanned before it is decoded
+            std::string skip;
+            if(!encodables.at(i)->isBitfield())
+                skip = encodables.at(i)->getSkipString(true);
+
+            code.makeLineSeparator();
+            if(skip.empty())
+            {
+                code.append(TAB_IN, "if(_pg_byteindex + ", length.maxEncodedLength, " > _pg_numbytes)\n");
+                code.append(TAB_IN, TAB_IN, "return ", getReturnCode(false), ";\n");
+            }
+            else
+            {
+                code.append(TAB_IN, "_pg_start = _pg_byteindex;\n");
+                code.append(skip);
+                code.append(TAB_IN, "if(_pg_byteindex > _pg_numbytes)\n");
+                code.append(TAB_IN, TAB_IN, "return ", getReturnCode(false), ";\n");
+                code.append("\n");
+                code.append(TAB_IN, "_pg_byteindex = _pg_start;\n");
+            }
+
+            int bitcount = 0;
+            for(std::size_t j = i; j <= last; j++)
+            {
+                code.makeLineSeparator();
+                code.append(encodables.at(j)->getDecodeString(&bitcount, true));
+
+                if(support.language == ProtocolSupport::c_language)
+                    declarations += TAB_IN + encodables.at(j)->getDeclaration();
+                else
+                    declarations += encodables.at(j)->getLocalDeclaration();
+            }
+        }
+        else
+        {
+            for(std::size_t j = i; j <= last; j++)
+            {
+                std::string skip = encodables.at(j)->getSkipString(true);
+
+                if(skip.empty())
+                    fixedlength.addToLength(encodables.at(j)->encodedLength);
+                else
+                {
+                    if(!fixedlength.maxEncodedLength.empty())
+                    {
+                        code.makeLineSeparator();
+                        code.append(TAB_IN, "_pg_byteindex += ", fixedlength.maxEncodedLength, ";\n");
+                        fixedlength.clear();
+                    }
+
+                    code.makeLineSeparator();
+                    code.append(skip);
+                }
+            }
+        }
+
+        i = last;
+
+    }// for all encodables
+
+    if(!fixedlength.maxEncodedLength.empty())
+    {
+        code.makeLineSeparator();
+        code.append(TAB_IN, "_pg_byteindex += ", fixedlength.maxEncodedLength, ";\n");
+    }
+
+    output.append("/*!\n");
+    output.append(" * \\brief Skip over an encoded ", typeName, " without decoding it\n");
+    output.append(" *\n");
+    output.append(ProtocolParser::outputLongComment(" * ", comment), "\n");
+    output.append(" * \\param _pg_data points to the byte array that holds the encoded data\n");
+    output.append(" * \\param _pg_bytecount points to the starting location in the byte array, and will be incremented by the number of encoded bytes\n");
+    output.append(" * \\param _pg_numbytes is the number of bytes in the byte array\n");
+    output.append(" * \\return ", getReturnCode(true), " if the encoded data fit in the byte array, else ", getReturnCode(false), ".\n");
+    output.append(" */\n");
+
+    output.append(getSkipFunctionSignature(true), "\n");
+    output.append("{\n");
+    output.append(TAB_IN, "int _pg_byteindex = *_pg_bytecount;\n");
+
+    if(code.str().find("_pg_start") != std::string::npos)
+        output.append(TAB_IN, "int _pg_start = 0;\n");
+
+    if(code.str().find("_pg_tempbitfield") != std::string::npos)
+        output.append(TAB_IN, "unsigned int _pg_tempbitfield = 0;\n");
+
+    if(code.str().find("_pg_templongbitfield") != std::string::npos)
+        output.append(TAB_IN, "uint64_t _pg_templongbitfield = 0;\n");
+
+    if(code.str().find("_pg_bitfieldbytes") != std::string::npos)
+    {
+        output.append(TAB_IN, "int _pg_bitfieldindex = 0;\n");
+        output.append(TAB_IN, "uint8_t _pg_bitfieldbytes[", std::to_string(numbitfieldgroupbytes), "];\n");
+    }
+
+    if(code.str().find("_pg_i") != std::string::npos)
+        output.append(TAB_IN, "unsigned _pg_i = 0;\n");
+
+    if(code.str().find("_pg_j") != std::string::npos)
+        output.append(TAB_IN, "unsigned _pg_j = 0;\n");
+
+    if(!declarations.empty())
+    {
+        output.append("\n");
+        output.append(TAB_IN, "// Only the fields which determine the length are decoded\n");
+
+        if(support.language == ProtocolSupport::c_language)
+        {
+            output.append(TAB_IN, "struct\n");
+            output.append(TAB_IN, "{\n");
+            output.append(declarations);
+            output.append(TAB_IN, "}_pg_fields, *_pg_user = &_pg_fields;\n");
+        }
+        else
+            output.append(declarations);
+    }
+
+    if(code.str().find("_pg_data") == std::string::npos)
+        output.append(TAB_IN, "(void)_pg_data;\n");
+
+    output.makeLineSeparator();
+    output.append(code.str());
+    output.makeLineSeparator();
+    output.append(TAB_IN, "if(_pg_byteindex > _pg_numbytes)\n");
+    output.append(TAB_IN, TAB_IN, "return ", getReturnCode(false), ";\n");
+    output.append("\n");
+    output.append(TAB_IN, "*_pg_bytecount = _pg_byteindex;\n");
+    output.append("\n");
+    output.append(TAB_IN, "return ", getReturnCode(true), ";\n");
+    output.append("\n");
+
+    if(support.language == ProtocolSupport::c_language)
+        output.append("}// skip", typeName, "\n");
+    else
+        output.append("}// ", typeName, "::skip\n");
+
+}// ProtocolStructure::emitSkipFunctionBody
+
+
+/*!
+ * Get the signature of the function that decodes this structure.
+ * \param insource should be true to indicate this signature is in source code
+ * \return the signature of the decode function.
+ */
+std::string ProtocolStructure::getDecodeFunctionSignature(bool insource) const
+{
+    std::string output;
+
+    if(support.language == ProtocolSupport::c_language)
+    {
+        std::string pg;
+
+        if(insource)
+            pg = "_pg_";
+
+        if(getNumberOfDecodeParameters() > 0)
+        {
+            output = "int decode" + typeName + "(const uint8_t* " + pg + "data, int* " + pg + "bytecount, " + structName + "* " + pg + "user)";
+        }
+        else
+        {
+            output = "int decode" + typeName + "(const uint8_t* " + pg + "data, int* " + pg + "bytecount)";
+        }
+    }
+    else
+    {
+        // For C++ these functions are within the class namespace and they
+        // reference their own members.
+        if(insource)
+            output = "bool " + typeName + "::decode(const uint8_t* _pg_data, int* _pg_bytecount)";
+        else
+            output = "bool decode(const uint8_t* data, int* bytecount)";
+    }
+
+    return output;
+
+}// ProtocolStructure::getDecodeFunctionSignature
+
+
+/*!
+ * Return the string that gives the prototype of the functions used to decode
+ * the structure. The encoding is to a simple byte array.
+ * \param spacing gives the spacing to offset each line.
+ * \param includeChildren should be true to output the children's prototypes.
+ * \return The string including the comments and prototypes with linefeeds and semicolons.
+ */
+std::string ProtocolStructure::getDecodeFunctionPrototype(const std::string& spacing, bool includeChildren) const
+{
+    std::string output;
+
+    // Only the C language needs this. C++ declares the prototype within the class
+    if(includeChildren && (support.language == ProtocolSupport::c_language))
+    {
+        for(std::size_t i = 0; i < encodables.size(); i++)
+        {
+            // Is this encodable a structure?
+            ProtocolStructure* structure = dynamic_cast<ProtocolStructure*>(encodables.at(i));
+
+            if(structure == nullptr)
+                continue;
+
+            ProtocolFile::makeLineSeparator(output);
+            output += structure->getDecodeFunctionPrototype(spacing, includeChildren);
+        }
+        ProtocolFile::makeLineSeparator(output);
+    }
+
+    output += spacing + "//! Decode a " + typeName + " from a byte array\n";
+    output += spacing + getDecodeFunctionSignature(false) + ";\n";
+
+    return output;
+
+}// ProtocolStructure::getDecodeFunctionPrototype
+
+
+/*!
+ * Return the string that gives the function used to decode this structure.
+ * The decoding is from a simple byte array.
+ * \param includeChildren should be true to output the children's functions.
+ * \return The string including the comments and code with linefeeds and semicolons.
+ */
+std::string ProtocolStructure::getDecodeFunctionBody(bool includeChildren) const
+{
+    CodeEmitter output;
+    emitDecodeFunctionBody(output, includeChildren);
+    return output.take();
+
+}// ProtocolStructure::getDecodeFunctionBody
+
+
+/*!
+ * Output the function used to decode this structure. The decoding is from a
+ * simple byte array.
+ * \param output receives the comments and code with linefeeds and semicolons.
+ * \param includeChildren should be true to output the children's functions.
+ */
+void ProtocolStructure::emitDecodeFunctionBody(CodeEmitter& output, bool includeChildren) const
+{
+    if(includeChildren)
+    {
+        for(std::size_t i = 0; i < encodables.size(); i++)
+        {
+            // Is this encodable a structure?
+            ProtocolStructure* structure = dynamic_cast<ProtocolStructure*>(encodables.at(i));
+
+            if(structure == nullptr)
+                continue;
+
+            output.makeLineSeparator();
+            structure->emitDecodeFunctionBody(output);
+        }
+        output.makeLineSeparator();
+    }
+
+    output.line("/*!");
+    output.line(" * \\brief Decode a ", typeName, " from a byte array");
+    output.line(" *");
+    output.line(ProtocolParser::outputLongComment(" * ", comment));
+    output.line(" * \\param _pg_data points to the byte array to decoded data from");
+    output.line(" * \\param _pg_bytecount points to the starting location in the byte array, and will be incremented by the number of bytes decoded");
+    if((support.language == ProtocolSupport::c_language) && (getNumberOfDecodeParameters() > 0))
+        output.line(" * \\param _pg_user is the data to decode from the byte array");
+
+    output.line(" * \\return ", getReturnCode(true), " if the data are decoded, else ", getReturnCode(false), ".");
+    output.line(" */");
+    output.line(getDecodeFunctionSignature(true));
+    output.line("{");
+    output.indent();
+
+    output.line("int _pg_byteindex = *_pg_bytecount;");
+
+    if(usestempdecodebitfields)
+        output.line("unsigned int _pg_tempbitfield = 0;");
+
+    if(usestempdecodelongbitfields)
+        output.line("uint64_t _pg_templongbitfield = 0;");
+
+    if(numbitfieldgroupbytes > 0)
+    {
+        output.line("int _pg_bitfieldindex = 0;");
+        output.line("uint8_t _pg_bitfieldbytes[", numbitfieldgroupbytes, "];");
+    }
+
+    if(needsDecodeIterator)
+        output.line("unsigned _pg_i = 0;");
+
+    if(needs2ndDecodeIterator)
+        output.line("unsigned _pg_j = 0;");
+
+    int bitcount = 0;
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        output.makeLineSeparator();
+        encodables[i]->emitDecodeString(output, &bitcount, true);
+    }
+
+    output.makeLineSeparator();
+    output.line("*_pg_bytecount = _pg_byteindex;");
+    output.append("\n");
+    output.line("return ", getReturnCode(true), ";");
+    output.unindent();
+    output.line();
+
+    if(support.language == ProtocolSupport::c_language)
+        output.line("}// decode", typeName);
+    else
+        output.line("}// ", typeName, "::decode");
+
+}// ProtocolStructure::emitDecodeFunctionBody
+
+
+/*!
+ * Get the signature of the function that sets initial values of this structure.
+ * This is just the constructor for C++
+ * \param insource should be true to indicate this signature is in source code.
+ * \return the signature of the set to initial value function.
+ */
+std::string ProtocolStructure::getSetToInitialValueFunctionSignature(bool insource) const
 {
     std::string output;
 
@@ -2030,11 +3325,20 @@ std::string ProtocolStructure::getSetToInitialValueFunctionPrototype(const std::
     // My set to initial values function
     if(support.language == ProtocolSupport::c_language)
         output += spacing + "//! Set a " + typeName + " to initial values\n";
+    else if(isNoInit() && (redefines == nullptr))
+        output += spacing + "//! Construct a " + typeName + " without setting its members, see initialize()\n";
     else
         output += spacing + "//! Construct a " + typeName + "\n";
 
     output += spacing + getSetToInitialValueFunctionSignature(false) + ";\n";
 
+    if(isNoInit() && (redefines == nullptr))
+    {
+        output += "\n";
+        output += spacing + "//! Set a " + typeName + " to initial values, which the constructor does not do\n";
+        output += spacing + "void initialize(void);\n";
+    }
+
     return output;
 
 }// ProtocolStructure::getSetToInitialValueFunctionPrototype
@@ -2074,11 +3378,23 @@ std::string ProtocolStructure::getSecondSetToInitialValueFunctionPrototype(const
  */
 std::string ProtocolStructure::getSetToInitialValueFunctionBody(bool includeChildren) const
 {
-    std::string output;
+    CodeEmitter output;
+    emitSetToInitialValueFunctionBody(output, includeChildren);
+    return output.take();
 
+}// ProtocolStructure::getSetToInitialValueFunctionBody
+
+
+/*!
+ * Output the function used to set this structure to initial values.
+ * \param output receives the comments and code with linefeeds and semicolons.
+ * \param includeChildren should be true to output the children's functions.
+ */
+void ProtocolStructure::emitSetToInitialValueFunctionBody(CodeEmitter& output, bool includeChildren) const
+{
     // C++ always has init (constructor) functions, but not C
     if(!hasInit() && (support.language == ProtocolSupport::c_language))
-        return output;
+        return;
 
     // Go get any children structures set to initial functions
     if(includeChildren)
@@ -2090,40 +3406,40 @@ std::string ProtocolStructure::getSetToInitialValueFunctionBody(bool includeChil
             if(!structure)
                 continue;
 
-            ProtocolFile::makeLineSeparator(output);
-            output += structure->getSetToInitialValueFunctionBody(includeChildren);
+            output.makeLineSeparator();
+            structure->emitSetToInitialValueFunctionBody(output, includeChildren);
         }
-        ProtocolFile::makeLineSeparator(output);
+        output.makeLineSeparator();
     }
 
     if(support.language == ProtocolSupport::c_language)
     {
         // My set to initial values function
-        output += "/*!\n";
-        output += " * \\brief Set a " + typeName + " to initial values.\n";
-        output += " *\n";
-        output += " * Set a " + typeName + " to initial values. Not all fields are set,\n";
-        output += " * only those which the protocol specifies.\n";
-        output += " * \\param _pg_user is the structure whose data are set to initial values\n";
-        output += " */\n";
-        output += getSetToInitialValueFunctionSignature(true) + "\n";
-        output += "{\n";
+        output.append("/*!\n");
+        output.append(" * \\brief Set a ", typeName, " to initial values.\n");
+        output.append(" *\n");
+        output.append(" * Set a ", typeName, " to initial values. Not all fields are set,\n");
+        output.append(" * only those which the protocol specifies.\n");
+        output.append(" * \\param _pg_user is the structure whose data are set to initial values\n");
+        output.append(" */\n");
+        output.append(getSetToInitialValueFunctionSignature(true), "\n");
+        output.append("{\n");
 
         if(needsInitIterator)
-            output += TAB_IN + "int _pg_i = 0;\n";
+            output.append(TAB_IN, "int _pg_i = 0;\n");
 
         if(needs2ndInitIterator)
-            output += TAB_IN + "int _pg_j = 0;\n";
+            output.append(TAB_IN, "int _pg_j = 0;\n");
 
         for(std::size_t i = 0; i < encodables.size(); i++)
         {
             /// TODO: change this to zeroize all fields
-            ProtocolFile::makeLineSeparator(output);
-            output += encodables[i]->getSetInitialValueString(true);
+            output.makeLineSeparator();
+            output.append(encodables[i]->getSetInitialValueString(true));
         }
 
-        ProtocolFile::makeLineSeparator(output);
-        output += "}// init" + typeName + "\n";
+        output.makeLineSeparator();
+        output.append("}// init", typeName, "\n");
 
     }// If the C language output
     else
@@ -2132,7 +3448,11 @@ std::string ProtocolStructure::getSetToInitialValueFunctionBody(bool includeChil
         // member that is not itself another class (they take care of themselves).
         std::string initializerlist;
 
-        if(redefines == nullptr)
+        if(isNoInit() && (redefines == nullptr))
+        {
+            // The members are left for initialize(), so there is no initializer list
+        }
+        else if(redefines == nullptr)
         {
             for(std::size_t i = 0; i < encodables.size(); i++)
             {
@@ -2158,18 +3478,77 @@ std::string ProtocolStructure::getSetToInitialValueFunctionBody(bool includeChil
         else
             initializerlist = " :\n" + initializerlist;
 
-        output += "/*!\n";
-        output += " * Construct a " + typeName + "\n";
-        output += " */\n";
-        output += getSetToInitialValueFunctionSignature(true) + initializerlist;
-        output += "{\n";
-        output += "}// " + typeName + "::" + typeName + "\n";
+        if(isNoInit() && (redefines == nullptr))
+        {
+            output.append("/*!\n");
+            output.append(" * Construct a ", typeName, ". The members are not set, which saves\n");
+            output.append(" * the time it takes to set them when the ", typeName, " is about to be\n");
+            output.append(" * decoded. Call initialize() to set the members to their initial values.\n");
+            output.append(" */\n");
+            output.append(getSetToInitialValueFunctionSignature(true), initializerlist);
+            output.append("{\n");
+            output.append("}// ", typeName, "::", typeName, "\n");
+
+            std::string members;
+            for(std::size_t i = 0; i < encodables.size(); i++)
+                members += encodables.at(i)->getInitializeString();
 
-    }// else if C++ language
+            output.append("\n\n");
+            output.append("/*!\n");
+            output.append(" * Set a ", typeName, " to initial values. This is what the constructor\n");
+            output.append(" * would do if the ", typeName, " did not have the noInit attribute.\n");
+            output.append(" */\n");
+            output.append("void ", typeName, "::initialize(void)\n");
+            output.append("{\n");
 
-    return output;
+            if(contains(members, "_pg_i"))
+                output.append(TAB_IN, "int _pg_i = 0;\n");
 
-}// ProtocolStructure::getSetToInitialValueFunctionBody
+            if(contains(members, "_pg_j"))
+                output.append(TAB_IN, "int _pg_j = 0;\n");
+
+            if(contains(members, "_pg_i") || contains(members, "_pg_j"))
+                output.append("\n");
+
+            output.append(members);
+            output.append("}// ", typeName, "::initialize\n");
+        }
+        else
+        {
+            // Members whose class has the noInit attribute do not take care
+            // of themselves, so the constructor calls their initialize()
+            std::string members;
+            if(redefines == nullptr)
+            {
+                for(std::size_t i = 0; i < encodables.size(); i++)
+                {
+                    if(encodables.at(i)->isNoInit())
+                        members += encodables.at(i)->getInitializeString();
+                }
+            }
+
+            output.append("/*!\n");
+            output.append(" * Construct a ", typeName, "\n");
+            output.append(" */\n");
+            output.append(getSetToInitialValueFunctionSignature(true), initializerlist);
+            output.append("{\n");
+
+            if(contains(members, "_pg_i"))
+                output.append(TAB_IN, "int _pg_i = 0;\n");
+
+            if(contains(members, "_pg_j"))
+                output.append(TAB_IN, "int _pg_j = 0;\n");
+
+            if(contains(members, "_pg_i") || contains(members, "_pg_j"))
+                output.append("\n");
+
+            output.append(members);
+            output.append("}// ", typeName, "::", typeName, "\n");
+        }
+
+    }// else if C++ language
+
+}// ProtocolStructure::emitSetToInitialValueFunctionBody
 
 
 /*!
@@ -2216,6 +3595,56 @@ std::string ProtocolStructure::getSecondSetToInitialValueFunctionBody(bool inclu
 }// ProtocolStructure::getSecondSetToInitialValueFunctionBody
 
 
+/*!
+ * Return the code which makes this structure encode to its maximum length:
+ * every variable length array is full, every field that depends on another
+ * field is present, and every string is as long as it can be. Child
+ * structures that are not arrays are included. This is used by the bench
+ * module, after the structure has been set to its initial values.
+ * \param spacing is the indentation of each line.
+ * \param access is the text which accesses the members of this structure, like "user.".
+ * \return The code, which may be empty if the structure is always the same length
+ */
+std::string ProtocolStructure::getSetToMaximumLengthString(const std::string& spacing, const std::string& access) const
+{
+    CodeEmitter output;
+
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        const Encodable* encodable = encodables.at(i);
+
+        if(encodable->isNotInMemory() || encodable->isConstant())
+            continue;
+
+        if(!encodable->variableArray.empty())
+            output.append(spacing, access, encodable->variableArray, " = (", encodable->array, ");\n");
+
+        if(!encodable->variable2dArray.empty())
+            output.append(spacing, access, encodable->variable2dArray, " = (", encodable->array2d, ");\n");
+
+        // Only equality can be forced, other comparisons are left alone
+        if(!encodable->dependsOn.empty())
+        {
+            if(encodable->dependsOnValue.empty())
+                output.append(spacing, access, encodable->dependsOn, " = 1;\n");
+            else if(encodable->dependsOnCompare.empty() || (encodable->dependsOnCompare == "=="))
+                output.append(spacing, access, encodable->dependsOn, " = (", encodable->dependsOnValue, ");\n");
+        }
+
+        if(encodable->isString() && encodable->isArray() && !encodable->is2dArray())
+            output.append(spacing, "memset(", access, encodable->name, ", 'x', sizeof(", access, encodable->name, ") - 1);\n");
+
+        const ProtocolStructure* structure = dynamic_cast<const ProtocolStructure*>(encodable);
+
+        if((structure != nullptr) && !structure->isArray())
+            output.append(structure->getSetToMaximumLengthString(spacing, access + encodable->name + "."));
+    }
+
+    return output.take();
+
+}// ProtocolStructure::getSetToMaximumLengthString
+
+
 /*!
  * Get the signature of the verify function.
  * \param insource should be true to indicate this signature is in source code.
@@ -2380,12 +3809,37 @@ std::string ProtocolStructure::getComparisonFunctionSignature(bool insource) con
     else
     {
         if(insource)
-            return "std::string " + typeName + "::compare(const std::string& _pg_prename, const " + structName + "* _pg_user) const";
+            return "std::string " + typeName + "::compare(const std::string& _pg_prename, const " + structName + "* _pg_user) const";
+        else
+            return "std::string compare(const std::string& prename, const " + structName + "* user) const";
+    }
+
+}// ProtocolStructure::getComparisonFunctionSignature
+
+
+/*!
+ * Get the signature of the equals function.
+ * \param insource should be true to indicate this signature is in source code.
+ * \return the signature of the equals function.
+ */
+std::string ProtocolStructure::getEqualsFunctionSignature(bool insource) const
+{
+    if(support.language == ProtocolSupport::c_language)
+    {
+        if(insource)
+            return "bool equals" + typeName + "(const " + structName + "* _pg_user1, const " + structName + "* _pg_user2)";
+        else
+            return "bool equals" + typeName + "(const " + structName + "* user1, const " + structName + "* user2)";
+    }
+    else
+    {
+        if(insource)
+            return "bool " + typeName + "::equals(const " + structName + "* _pg_user) const";
         else
-            return "std::string compare(const std::string& prename, const " + structName + "* user) const";
+            return "bool equals(const " + structName + "* user) const";
     }
 
-}// ProtocolStructure::getComparisonFunctionSignature
+}// ProtocolStructure::getEqualsFunctionSignature
 
 
 /*!
@@ -2419,9 +3873,12 @@ std::string ProtocolStructure::getComparisonFunctionPrototype(const std::string&
     }
 
 
-    // My comparison function
+    // My comparison functions
     output += spacing + "//! Compare two " + typeName + " and generate a report\n";
     output += spacing + getComparisonFunctionSignature(false) + ";\n";
+    output += "\n";
+    output += spacing + "//! Determine if two " + typeName + " are equal, without generating a report\n";
+    output += spacing + getEqualsFunctionSignature(false) + ";\n";
 
     return output;
 
@@ -2487,6 +3944,14 @@ std::string ProtocolStructure::getComparisonFunctionBody(bool includeChildren) c
     if(needs2ndDecodeIterator)
         output += TAB_IN + "unsigned _pg_j = 0;\n";
 
+    output += "\n";
+    output += TAB_IN + "// The report is only generated if there is a difference\n";
+    if(support.language == ProtocolSupport::c_language)
+        output += TAB_IN + "if(equals" + typeName + "(_pg_user1, _pg_user2))\n";
+    else
+        output += TAB_IN + "if(equals(_pg_user))\n";
+    output += TAB_IN + TAB_IN + "return _pg_report;\n";
+
     for(std::size_t i = 0; i < encodables.size(); i++)
     {
         ProtocolFile::makeLineSeparator(output);
@@ -2501,33 +3966,331 @@ std::string ProtocolStructure::getComparisonFunctionBody(bool includeChildren) c
     else
         output += "}// " + typeName + "::compare\n";
 
+    output += "\n";
+    output += getEqualsFunctionBody();
+
     return output;
 
 }// ProtocolStructure::getComparisonFunctionBody
 
 
 /*!
- * Get the signature of the textPrint function.
+ * Return the string that gives the function used to test this structure for
+ * equality, but not the functions of its children.
+ * \return the function string
+ */
+std::string ProtocolStructure::getEqualsFunctionBody(void) const
+{
+    CodeEmitter output;
+    std::string code;
+
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        ProtocolFile::makeLineSeparator(code);
+        code += encodables[i]->getEqualsString();
+    }
+
+    // My equals function
+    output.append("/*!\n");
+
+    if(support.language == ProtocolSupport::c_language)
+    {
+        output.append(" * Determine if two ", typeName, " are equal. This stops at the first\n");
+        output.append(" * difference, and does not allocate memory. Two ", typeName, " are equal\n");
+        output.append(" * if compare", typeName, "() would not report any differences.\n");
+        output.append(" * \\param _pg_user1 is the first data to compare\n");
+        output.append(" * \\param _pg_user2 is the second data to compare\n");
+        output.append(" * \\return true if _pg_user1 and _pg_user2 are equal\n");
+    }
+    else
+    {
+        output.append(" * Determine if this ", typeName, " is equal to another ", typeName, ". This stops\n");
+        output.append(" * at the first difference, and does not allocate memory. They are equal if\n");
+        output.append(" * compare() would not report any differences.\n");
+        output.append(" * \\param _pg_user is the data to compare\n");
+        output.append(" * \\return true if this ", typeName, " and `_pg_user` are equal\n");
+    }
+    output.append(" */\n");
+    output.append(getEqualsFunctionSignature(true), "\n");
+    output.append("{\n");
+
+    std::string declarations;
+
+    if(code.find("_pg_i") != std::string::npos)
+        declarations += TAB_IN + "unsigned _pg_i = 0;\n";
+
+    if(code.find("_pg_j") != std::string::npos)
+        declarations += TAB_IN + "unsigned _pg_j = 0;\n";
+
+    if(!declarations.empty())
+        output.append(declarations, "\n");
+
+    output.append(code);
+
+    output.makeLineSeparator();
+    output.append(TAB_IN, "return true;\n");
+    output.append("\n");
+    if(support.language == ProtocolSupport::c_language)
+        output.append("}// equals", typeName, "\n");
+    else
+        output.append("}// ", typeName, "::equals\n");
+
+    return output.take();
+
+}// ProtocolStructure::getEqualsFunctionBody
+
+
+/*!
+ * Get the signature of the hash function.
  * \param insource should be true to indicate this signature is in source code.
- * \return the signature of the comparison function.
+ * \return the signature of the hash function.
  */
-std::string ProtocolStructure::getTextPrintFunctionSignature(bool insource) const
+std::string ProtocolStructure::getHashFunctionSignature(bool insource) const
 {
     if(support.language == ProtocolSupport::c_language)
     {
         if(insource)
-            return "std::string textPrint" + typeName + "(const std::string& _pg_prename, const " + structName + "* _pg_user)";
+            return "uint64_t hash" + typeName + "(const " + structName + "* _pg_user)";
         else
-            return "std::string textPrint" + typeName + "(const std::string& prename, const " + structName + "* user)";
+            return "uint64_t hash" + typeName + "(const " + structName + "* user)";
     }
     else
     {
         if(insource)
-            return "std::string " + typeName + "::textPrint(const std::string& _pg_prename) const";
+            return "uint64_t " + typeName + "::hash(void) const";
         else
-            return "std::string textPrint(const std::string& prename) const";
+            return "uint64_t hash(void) const";
+    }
+
+}// ProtocolStructure::getHashFunctionSignature
+
+
+/*!
+ * Return the string that gives the prototype of the function used to hash this structure
+ * \param spacing gives the spacing to offset each line.
+ * \param includeChildren should be true to include the function prototypes of the children structures of this structure
+ * \return the function prototype string, which may be empty
+ */
+std::string ProtocolStructure::getHashFunctionPrototype(const std::string& spacing, bool includeChildren) const
+{
+    CodeEmitter output;
+
+    // We must have parameters that we encode to do a hash
+    if(!hash || (getNumberOfEncodeParameters() == 0))
+        return output.take();
+
+    // Go get any children structures hash functions
+    if(includeChildren && (support.language == ProtocolSupport::c_language))
+    {
+        for(std::size_t i = 0; i < encodables.size(); i++)
+        {
+            ProtocolStructure* structure = dynamic_cast<ProtocolStructure*>(encodables.at(i));
+
+            if(!structure)
+                continue;
+
+            output.makeLineSeparator();
+            output.append(structure->getHashFunctionPrototype(spacing, includeChildren));
+        }
+        output.makeLineSeparator();
+    }
+
+    output.append(spacing, "//! Compute a hash of the encoded fields of a ", typeName, "\n");
+    output.append(spacing, getHashFunctionSignature(false), ";\n");
+
+    // In C++ the key of an unordered container needs operator==, which the equals function provides
+    if((support.language == ProtocolSupport::cpp_language) && hasEqualsFunction())
+    {
+        if(!compare)
+        {
+            output.append("\n");
+            output.append(spacing, "//! Determine if two ", typeName, " are equal\n");
+            output.append(spacing, getEqualsFunctionSignature(false), ";\n");
+        }
+
+        output.append("\n");
+        output.append(spacing, "//! Determine if two ", typeName, " are equal, for the key of an unordered container\n");
+        output.append(spacing, "bool operator==(const ", structName, "& user) const {return equals(&user);}\n");
+    }
+
+    return output.take();
+
+}// ProtocolStructure::getHashFunctionPrototype
+
+
+/*!
+ * Return the string that gives the function used to hash this structure. The
+ * hash combines the fields in the order they are encoded, using the in-memory
+ * values, so it does not depend on padding, byte order, or unused array space.
+ * \param includeChildren should be true to include the functions of the
+ *        children structures of this structure
+ * \return the function string, which may be empty
+ */
+std::string ProtocolStructure::getHashFunctionBody(bool includeChildren) const
+{
+    CodeEmitter output;
+    emitHashFunctionBody(output, includeChildren);
+    return output.take();
+
+}// ProtocolStructure::getHashFunctionBody
+
+
+/*!
+ * Output the function used to hash this structure.
+ * \param output receives the comments and code with linefeeds and semicolons.
+ * \param includeChildren should be true to output the children's functions.
+ */
+void ProtocolStructure::emitHashFunctionBody(CodeEmitter& output, bool includeChildren) const
+{
+    // We must have parameters that we encode to do a hash
+    if(!hash || (getNumberOfEncodeParameters() == 0))
+        return;
+
+    // Go get any childrens structure hash functions
+    if(includeChildren)
+    {
+        for(std::size_t i = 0; i < encodables.size(); i++)
+        {
+            ProtocolStructure* structure = dynamic_cast<ProtocolStructure*>(encodables.at(i));
+
+            if(!structure)
+                continue;
+
+            output.makeLineSeparator();
+            structure->emitHashFunctionBody(output, includeChildren);
+        }
+        output.makeLineSeparator();
+    }
+
+    // In C++ the equals function comes with the hash, if it is not already output with the compare
+    if((support.language == ProtocolSupport::cpp_language) && hasEqualsFunction() && !compare)
+    {
+        output.append(getEqualsFunctionBody());
+        output.append("\n");
+    }
+
+    std::string code;
+
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        ProtocolFile::makeLineSeparator(code);
+        code += encodables[i]->getHashString();
+    }
+
+    output.append("/*!\n");
+    output.append(" * \\brief Compute a hash of the fields of a ", typeName, " which are encoded\n");
+    output.append(" *\n");
+    output.append(" * Variable length arrays are hashed up to their length, and fields which\n");
+    output.append(" * depend on another field are only hashed if they are present. Two\n");
+    output.append(" * ", typeName, " which are equal have the same hash. This is not a cryptographic hash.\n");
+    if(support.language == ProtocolSupport::c_language)
+        output.append(" * \\param _pg_user is the data to hash\n");
+    output.append(" * \\return the 64-bit hash\n");
+    output.append(" */\n");
+    output.append(getHashFunctionSignature(true), "\n");
+    output.append("{\n");
+    output.append(TAB_IN, "uint64_t _pg_hash = 0x27D4EB2F165667C5ull;\n");
+
+    if(code.find("_pg_i") != std::string::npos)
+        output.append(TAB_IN, "unsigned _pg_i = 0;\n");
+
+    if(code.find("_pg_j") != std::string::npos)
+        output.append(TAB_IN, "unsigned _pg_j = 0;\n");
+
+    // Fields which are not in memory are not hashed
+    if((support.language == ProtocolSupport::c_language) && (code.find("_pg_user") == std::string::npos))
+        output.append(TAB_IN, "(void)_pg_user;\n");
+
+    output.makeLineSeparator();
+    output.append(code);
+    output.makeLineSeparator();
+    output.append(TAB_IN, "return finishHash(_pg_hash);\n");
+    output.append("\n");
+    if(support.language == ProtocolSupport::c_language)
+        output.append("}// hash", typeName, "\n");
+    else
+        output.append("}// ", typeName, "::hash\n");
+
+}// ProtocolStructure::emitHashFunctionBody
+
+
+/*!
+ * Determine if the equals function of this structure is output. It comes
+ * with the compare function, and in C++ with the hash function.
+ * \return true if the equals function is output
+ */
+bool ProtocolStructure::hasEqualsFunction(void) const
+{
+    // We must have parameters that we decode to do a comparison
+    if(getNumberOfDecodeParameters() == 0)
+        return false;
+
+    if(compare)
+        return true;
+
+    return hash && (support.language == ProtocolSupport::cpp_language) && (getNumberOfEncodeParameters() > 0);
+
+}// ProtocolStructure::hasEqualsFunction
+
+
+/*!
+ * Get the specialization of std::hash for this class, which lets it be the
+ * key of an unordered container. This is only for the C++ language, and goes
+ * after the class declaration.
+ * \return the specialization, which may be empty
+ */
+std::string ProtocolStructure::getStdHashSpecialization(void) const
+{
+    CodeEmitter output;
+
+    // A redefined class inherits the hash function of its base class
+    const ProtocolStructure* base = this;
+    if(redefines != nullptr)
+        base = redefines;
+
+    if((support.language == ProtocolSupport::c_language) || !base->hash || (base->getNumberOfEncodeParameters() == 0))
+        return output.take();
+
+    output.append("namespace std\n");
+    output.append("{\n");
+    output.append(TAB_IN, "//! Hash a ", typeName, " by its encoded fields, so it can be the key of an unordered container\n");
+    output.append(TAB_IN, "template<> struct hash<", typeName, ">\n");
+    output.append(TAB_IN, "{\n");
+    output.append(TAB_IN, TAB_IN, "std::size_t operator()(const ", typeName, "& user) const {return (std::size_t)user.hash();}\n");
+    output.append(TAB_IN, "};\n");
+    output.append("}\n");
+
+    return output.take();
+
+}// ProtocolStructure::getStdHashSpecialization
+
+
+/*!
+ * Get the signature of the textPrint function.
+ * \param insource should be true to indicate this signature is in source code.
+ * \param append should be true for the function that appends to a report,
+ *        rather than returning it.
+ * \return the signature of the comparison function.
+ */
+std::string ProtocolStructure::getTextPrintFunctionSignature(bool insource, bool append) const
+{
+    std::string prefix = insource ? "_pg_" : "";
+    std::string returntype = "std::string ";
+    std::string parameters = "const std::string& " + prefix + "prename";
+
+    if(append)
+    {
+        returntype = "void ";
+        parameters = "std::string& " + prefix + "report, std::string& " + prefix + "prename";
     }
 
+    if(support.language == ProtocolSupport::c_language)
+        return returntype + "textPrint" + typeName + "(" + parameters + ", const " + structName + "* " + prefix + "user)";
+    else if(insource)
+        return returntype + typeName + "::textPrint(" + parameters + ") const";
+    else
+        return returntype + "textPrint(" + parameters + ") const";
+
 }// ProtocolStructure::getTextPrintFunctionSignature
 
 
@@ -2561,9 +4324,12 @@ std::string ProtocolStructure::getTextPrintFunctionPrototype(const std::string&
         ProtocolFile::makeLineSeparator(output);
     }
 
-    // My textPrint function
+    // My textPrint functions
     output += spacing + "//! Generate a string that describes the contents of a " + typeName + "\n";
     output += spacing + getTextPrintFunctionSignature(false) + ";\n";
+    output += "\n";
+    output += spacing + "//! Append a description of the contents of a " + typeName + " to a report\n";
+    output += spacing + getTextPrintFunctionSignature(false, true) + ";\n";
 
     return output;
 
@@ -2578,11 +4344,23 @@ std::string ProtocolStructure::getTextPrintFunctionPrototype(const std::string&
  */
 std::string ProtocolStructure::getTextPrintFunctionBody(bool includeChildren) const
 {
-    std::string output;
+    CodeEmitter output;
+    emitTextPrintFunctionBody(output, includeChildren);
+    return output.take();
 
+}// ProtocolStructure::getTextPrintFunctionBody
+
+
+/*!
+ * Output the function used to print this structure as text.
+ * \param output receives the comments and code with linefeeds and semicolons.
+ * \param includeChildren should be true to output the children's functions.
+ */
+void ProtocolStructure::emitTextPrintFunctionBody(CodeEmitter& output, bool includeChildren) const
+{
     // We must have parameters that we decode to do a print out
     if(!print || (getNumberOfDecodeParameters() == 0))
-        return output;
+        return;
 
     // Go get any childrens structure textPrint functions
     if(includeChildren)
@@ -2594,71 +4372,126 @@ std::string ProtocolStructure::getTextPrintFunctionBody(bool includeChildren) co
             if(!structure)
                 continue;
 
-            ProtocolFile::makeLineSeparator(output);
-            output += structure->getTextPrintFunctionBody(includeChildren);
+            output.makeLineSeparator();
+            structure->emitTextPrintFunctionBody(output, includeChildren);
         }
-        ProtocolFile::makeLineSeparator(output);
+        output.makeLineSeparator();
     }
 
-    // My textPrint function
-    output += "/*!\n";
-    output += " * Generate a string that describes the contents of a " + typeName + "\n";
-    output += " * \\param _pg_prename is prepended to the name of the data field in the report\n";
-    if(support.language == ProtocolSupport::c_language)
-        output += " * \\param _pg_user is the structure to report\n";
-    output += " * \\return a string containing a report of the contents of user\n";
-    output += " */\n";
-    output += getTextPrintFunctionSignature(true) + "\n";
-    output += "{\n";
-    output += TAB_IN + "std::string _pg_report;\n";
+    int lines = 0;
+    int length = getTextPrintContentsLength(&lines);
 
-    if(needsDecodeIterator)
-        output += TAB_IN + "unsigned _pg_i = 0;\n";
+    // My textPrint function, which reserves the report and appends to it
+    output.append("/*!\n");
+    output.append(" * Generate a string that describes the contents of a ", typeName, "\n");
+    output.append(" * \\param _pg_prename is prepended to the name of the data field in the report\n");
+    if(support.language == ProtocolSupport::c_language)
+        output.append(" * \\param _pg_user is the structure to report\n");
+    output.append(" * \\return a string containing a report of the contents of user\n");
+    output.append(" */\n");
+    output.append(getTextPrintFunctionSignature(true), "\n");
+    output.append("{\n");
+    output.append(TAB_IN, "std::string _pg_report;\n");
+    output.append(TAB_IN, "std::string _pg_name(_pg_prename);\n");
+    output.append("\n");
+    output.append(TAB_IN, "// The estimated size of the report, every line of which includes the prename\n");
+    output.append(TAB_IN, "_pg_report.reserve(", std::to_string(length), " + ", std::to_string(lines), "*_pg_prename.size());\n");
+    output.append("\n");
+    if(support.language == ProtocolSupport::c_language)
+    {
+        output.append(TAB_IN, "textPrint", typeName, "(_pg_report, _pg_name, _pg_user);\n");
+        output.append("\n");
+        output.append(TAB_IN, "return _pg_report;\n");
+        output.append("\n");
+        output.append("}// textPrint", typeName, "\n");
+    }
+    else
+    {
+        output.append(TAB_IN, "textPrint(_pg_report, _pg_name);\n");
+        output.append("\n");
+        output.append(TAB_IN, "return _pg_report;\n");
+        output.append("\n");
+        output.append("}// ", typeName, "::textPrint\n");
+    }
 
-    if(needs2ndDecodeIterator)
-        output += TAB_IN + "unsigned _pg_j = 0;\n";
+    std::string code;
 
     for(std::size_t i = 0; i < encodables.size(); i++)
     {
-        ProtocolFile::makeLineSeparator(output);
-        output += encodables[i]->getTextPrintString();
+        ProtocolFile::makeLineSeparator(code);
+        code += encodables[i]->getTextPrintString();
     }
 
-    ProtocolFile::makeLineSeparator(output);
-    output += TAB_IN + "return _pg_report;\n";
-    output += "\n";
+    // The textPrint function that does the work
+    output.append("\n");
+    output.append("/*!\n");
+    output.append(" * Append a description of the contents of a ", typeName, " to a report\n");
+    output.append(" * \\param _pg_report receives the description of the contents\n");
+    output.append(" * \\param _pg_prename is prepended to the name of the data field in the report.\n");
+    output.append(" *        It is extended for sub-structures, and restored when this returns.\n");
     if(support.language == ProtocolSupport::c_language)
-        output += "}// textPrint" + typeName + "\n";
-    else
-        output += "}// " + typeName + "::textPrint\n";
+        output.append(" * \\param _pg_user is the structure to report\n");
+    output.append(" */\n");
+    output.append(getTextPrintFunctionSignature(true, true), "\n");
+    output.append("{\n");
 
-    return output;
+    std::string declarations;
 
-}// ProtocolStructure::getTextPrintFunctionString
+    if(code.find("_pg_length") != std::string::npos)
+        declarations += TAB_IN + "std::string::size_type _pg_length = _pg_prename.size();\n";
+
+    if(needsDecodeIterator)
+        declarations += TAB_IN + "unsigned _pg_i = 0;\n";
+
+    if(needs2ndDecodeIterator)
+        declarations += TAB_IN + "unsigned _pg_j = 0;\n";
+
+    if(!declarations.empty())
+        output.append(declarations, "\n");
+
+    output.append(code);
+
+    output.makeLineSeparator();
+    if(support.language == ProtocolSupport::c_language)
+        output.append("}// textPrint", typeName, "\n");
+    else
+        output.append("}// ", typeName, "::textPrint\n");
+
+}// ProtocolStructure::emitTextPrintFunctionBody
 
 
 /*!
  * Get the signature of the textRead function.
  * \param insource should be true to indicate this signature is in source code.
+ * \param indexed should be true for the function that reads from the index of
+ *        the text, rather than the text itself.
  * \return the signature of the comparison function.
  */
-std::string ProtocolStructure::getTextReadFunctionSignature(bool insource) const
+std::string ProtocolStructure::getTextReadFunctionSignature(bool insource, bool indexed) const
 {
-    if(support.language == ProtocolSupport::c_language)
+    std::string prename = "const std::string& ";
+    std::string source = "const std::string& ";
+    std::string prefix = insource ? "_pg_" : "";
+
+    // The indexed function extends the prename in place to form the keys
+    if(indexed)
     {
-        if(insource)
-            return "int textRead" + typeName + "(const std::string& _pg_prename, const std::string& _pg_source, " + structName + "* _pg_user)";
-        else
-            return "int textRead" + typeName + "(const std::string& prename, const std::string& source, " + structName + "* user)";
+        prename = "std::string& " + prefix + "prename";
+        source = "const std::unordered_map<std::string_view, std::string_view>& " + prefix + "index";
     }
     else
     {
-        if(insource)
-            return "int " + typeName + "::textRead(const std::string& _pg_prename, const std::string& _pg_source)";
-        else
-            return "int textRead(const std::string& prename, const std::string& source)";
+        prename += prefix + "prename";
+        source += prefix + "source";
     }
 
+    if(support.language == ProtocolSupport::c_language)
+        return "int textRead" + typeName + "(" + prename + ", " + source + ", " + structName + "* " + prefix + "user)";
+    else if(insource)
+        return "int " + typeName + "::textRead(" + prename + ", " + source + ")";
+    else
+        return "int textRead(" + prename + ", " + source + ")";
+
 }// ProtocolStructure::getTextReadFunctionSignature
 
 
@@ -2694,9 +4527,12 @@ std::string ProtocolStructure::getTextReadFunctionPrototype(const std::string& s
         ProtocolFile::makeLineSeparator(output);
     }
 
-    // My textRead function
+    // My textRead functions
     output += spacing + "//! Read the contents of a " + typeName + " from text\n";
     output += spacing + getTextReadFunctionSignature(false) + ";\n";
+    output += "\n";
+    output += spacing + "//! Read the contents of a " + typeName + " from the index of the text\n";
+    output += spacing + getTextReadFunctionSignature(false, true) + ";\n";
 
     return output;
 
@@ -2711,11 +4547,23 @@ std::string ProtocolStructure::getTextReadFunctionPrototype(const std::string& s
  */
 std::string ProtocolStructure::getTextReadFunctionBody(bool includeChildren) const
 {
-    std::string output;
+    CodeEmitter output;
+    emitTextReadFunctionBody(output, includeChildren);
+    return output.take();
+
+}// ProtocolStructure::getTextReadFunctionBody
 
+
+/*!
+ * Output the function used to read this structure from text.
+ * \param output receives the comments and code with linefeeds and semicolons.
+ * \param includeChildren should be true to output the children's functions.
+ */
+void ProtocolStructure::emitTextReadFunctionBody(CodeEmitter& output, bool includeChildren) const
+{
     // We must have parameters that we decode to do a read
     if(!print || (getNumberOfDecodeParameters() == 0))
-        return output;
+        return;
 
     // Go get any childrens structure textRead functions
     if(includeChildren)
@@ -2727,58 +4575,130 @@ std::string ProtocolStructure::getTextReadFunctionBody(bool includeChildren) con
             if(!structure)
                 continue;
 
-            ProtocolFile::makeLineSeparator(output);
-            output += structure->getTextReadFunctionBody(includeChildren);
+            output.makeLineSeparator();
+            structure->emitTextReadFunctionBody(output, includeChildren);
         }
-        ProtocolFile::makeLineSeparator(output);
+        output.makeLineSeparator();
     }
 
-    // My textRead function
-    output += "/*!\n";
-    output += " * Read the contents of a " + typeName + " structure from text\n";
-    output += " * \\param _pg_prename is prepended to the name of the data field to form the text key\n";
-    output += " * \\param _pg_source is text to search to find the data field keys\n";
+    // My textRead function, which indexes the text once for all the fields
+    output.append("/*!\n");
+    output.append(" * Read the contents of a ", typeName, " structure from text\n");
+    output.append(" * \\param _pg_prename is prepended to the name of the data field to form the text key\n");
+    output.append(" * \\param _pg_source is text to search to find the data field keys\n");
     if(support.language == ProtocolSupport::c_language)
-        output += " * \\param _pg_user receives any data read from the text source\n";
-    output += " * \\return The number of fields that were read from the text source\n";
-    output += " */\n";
-    output += getTextReadFunctionSignature(true) + "\n";
-    output += "{\n";
-    output += TAB_IN + "std::string _pg_text;\n";
-    output += TAB_IN + "int _pg_fieldcount = 0;\n";
-
-    if(needsDecodeIterator)
-        output += TAB_IN + "unsigned _pg_i = 0;\n";
+        output.append(" * \\param _pg_user receives any data read from the text source\n");
+    output.append(" * \\return The number of fields that were read from the text source\n");
+    output.append(" */\n");
+    output.append(getTextReadFunctionSignature(true), "\n");
+    output.append("{\n");
+    output.append(TAB_IN, "std::string _pg_name(_pg_prename);\n");
+    output.append("\n");
+    if(support.language == ProtocolSupport::c_language)
+    {
+        output.append(TAB_IN, "return textRead", typeName, "(_pg_name, indexText(_pg_source), _pg_user);\n");
+        output.append("\n");
+        output.append("}// textRead", typeName, "\n");
+    }
+    else
+    {
+        output.append(TAB_IN, "return textRead(_pg_name, indexText(_pg_source));\n");
+        output.append("\n");
+        output.append("}// ", typeName, "::textRead\n");
+    }
 
-    if(needs2ndDecodeIterator)
-        output += TAB_IN + "unsigned _pg_j = 0;\n";
+    std::string code;
 
     for(std::size_t i = 0; i < encodables.size(); i++)
     {
-        ProtocolFile::makeLineSeparator(output);
-        output += encodables[i]->getTextReadString();
+        ProtocolFile::makeLineSeparator(code);
+        code += encodables[i]->getTextReadString();
     }
 
-    ProtocolFile::makeLineSeparator(output);
-    output += TAB_IN + "return _pg_fieldcount;\n";
-    output += "\n";
+    // The textRead function that does the work
+    output.append("\n");
+    output.append("/*!\n");
+    output.append(" * Read the contents of a ", typeName, " structure from the index of a text source\n");
+    output.append(" * \\param _pg_prename is prepended to the name of the data field to form the text key.\n");
+    output.append(" *        It is extended for each field, and restored when this returns.\n");
+    output.append(" * \\param _pg_index is the index of the text source, from indexText()\n");
     if(support.language == ProtocolSupport::c_language)
-        output += "}// textRead" + typeName + "\n";
+        output.append(" * \\param _pg_user receives any data read from the text source\n");
+    output.append(" * \\return The number of fields that were read from the text source\n");
+    output.append(" */\n");
+    output.append(getTextReadFunctionSignature(true, true), "\n");
+    output.append("{\n");
+
+    if(code.find("_pg_length") != std::string::npos)
+        output.append(TAB_IN, "std::string::size_type _pg_length = _pg_prename.size();\n");
+
+    if(code.find("_pg_text") != std::string::npos)
+        output.append(TAB_IN, "std::string_view _pg_text;\n");
+
+    if(code.find("_pg_signed") != std::string::npos)
+        output.append(TAB_IN, "long long _pg_signed = 0;\n");
+
+    if(code.find("_pg_unsigned") != std::string::npos)
+        output.append(TAB_IN, "unsigned long long _pg_unsigned = 0;\n");
+
+    if(code.find("_pg_double") != std::string::npos)
+        output.append(TAB_IN, "double _pg_double = 0;\n");
+
+    output.append(TAB_IN, "int _pg_fieldcount = 0;\n");
+
+    if(needsDecodeIterator)
+        output.append(TAB_IN, "unsigned _pg_i = 0;\n");
+
+    if(needs2ndDecodeIterator)
+        output.append(TAB_IN, "unsigned _pg_j = 0;\n");
+
+    output.makeLineSeparator();
+    output.append(code);
+
+    output.makeLineSeparator();
+    output.append(TAB_IN, "return _pg_fieldcount;\n");
+    output.append("\n");
+    if(support.language == ProtocolSupport::c_language)
+        output.append("}// textRead", typeName, "\n");
     else
-        output += "}// " + typeName + "::textRead\n";
+        output.append("}// ", typeName, "::textRead\n");
 
-    return output;
+}// ProtocolStructure::emitTextReadFunctionBody
+
+
+/*!
+ * Get the signature of the mapEncode function.
+ * \param insource should be true to indicate this signature is in source code.
+ * \param inplace should be true for the signature of the function that
+ *        extends and restores the key in place, which is only output if the
+ *        map does not use Qt.
+ * \return the signature of the comparison function.
+ */
+std::string ProtocolStructure::getMapEncodeFunctionSignature(bool insource, bool inplace) const
+{
+    if(support.stdMap)
+    {
+        std::string key = inplace ? "std::string& key" : "std::string_view prename";
 
-}// ProtocolStructure::getTextReadFunctionString
+        if(insource)
+            key = inplace ? "std::string& _pg_key" : "std::string_view _pg_prename";
 
+        if(support.language == ProtocolSupport::c_language)
+        {
+            if(insource)
+                return "void mapEncode" + typeName + "(" + key + ", FieldMap& _pg_map, const " + structName + "* _pg_user)";
+            else
+                return "void mapEncode" + typeName + "(" + key + ", FieldMap& map, const " + structName + "* user)";
+        }
+        else
+        {
+            if(insource)
+                return "void " + typeName + "::mapEncode(" + key + ", FieldMap& _pg_map) const";
+            else
+                return "void mapEncode(" + key + ", FieldMap& map) const";
+        }
+    }
 
-/*!
- * Get the signature of the mapEncode function.
- * \param insource should be true to indicate this signature is in source code.
- * \return the signature of the comparison function.
- */
-std::string ProtocolStructure::getMapEncodeFunctionSignature(bool insource) const
-{
     if(support.language == ProtocolSupport::c_language)
     {
         if(insource)
@@ -2834,6 +4754,13 @@ std::string ProtocolStructure::getMapEncodeFunctionPrototype(const std::string&
     output += spacing + "//! Encode the contents of a " + typeName + " to a string Key:Value map\n";
     output += spacing + getMapEncodeFunctionSignature(false) + ";\n";
 
+    if(support.stdMap)
+    {
+        output += "\n";
+        output += spacing + "//! Encode the contents of a " + typeName + " to a Key:Value map, extending the key in place\n";
+        output += spacing + getMapEncodeFunctionSignature(false, true) + ";\n";
+    }
+
     return output;
 
 }// ProtocolStructure::getMapEncodeFunctionPrototype
@@ -2867,6 +4794,10 @@ std::string ProtocolStructure::getMapEncodeFunctionBody(bool includeChildren) co
         ProtocolFile::makeLineSeparator(output);
     }
 
+    // Without Qt the functions are quite different
+    if(support.stdMap)
+        return output + getStdMapFunctionBody(true);
+
     // My mapEncode function
     output += "/*!\n";
     output += " * Encode the contents of a " + typeName + " to a Key:Value string map\n";
@@ -2906,10 +4837,36 @@ std::string ProtocolStructure::getMapEncodeFunctionBody(bool includeChildren) co
 /*!
  * Get the signature of the mapDecode function.
  * \param insource should be true to indicate this signature is in source code.
+ * \param inplace should be true for the signature of the function that
+ *        extends and restores the key in place, which is only output if the
+ *        map does not use Qt.
  * \return the signature of the comparison function.
  */
-std::string ProtocolStructure::getMapDecodeFunctionSignature(bool insource) const
+std::string ProtocolStructure::getMapDecodeFunctionSignature(bool insource, bool inplace) const
 {
+    if(support.stdMap)
+    {
+        std::string key = inplace ? "std::string& key" : "std::string_view prename";
+
+        if(insource)
+            key = inplace ? "std::string& _pg_key" : "std::string_view _pg_prename";
+
+        if(support.language == ProtocolSupport::c_language)
+        {
+            if(insource)
+                return "void mapDecode" + typeName + "(" + key + ", const FieldMap& _pg_map, " + structName + "* _pg_user)";
+            else
+                return "void mapDecode" + typeName + "(" + key + ", const FieldMap& map, " + structName + "* user)";
+        }
+        else
+        {
+            if(insource)
+                return "void " + typeName + "::mapDecode(" + key + ", const FieldMap& _pg_map)";
+            else
+                return "void mapDecode(" + key + ", const FieldMap& map)";
+        }
+    }
+
     if(support.language == ProtocolSupport::c_language)
     {
         if(insource)
@@ -2964,6 +4921,13 @@ std::string ProtocolStructure::getMapDecodeFunctionPrototype(const std::string&
     output += spacing + "//! Decode the contents of a " + typeName + " from a string Key:Value map\n";
     output += spacing + getMapDecodeFunctionSignature(false) + ";\n";
 
+    if(support.stdMap)
+    {
+        output += "\n";
+        output += spacing + "//! Decode the contents of a " + typeName + " from a Key:Value map, extending the key in place\n";
+        output += spacing + getMapDecodeFunctionSignature(false, true) + ";\n";
+    }
+
     return output;
 
 }// ProtocolStructure::getMapDecodeeFunctionPrototype
@@ -2998,6 +4962,10 @@ std::string ProtocolStructure::getMapDecodeFunctionBody(bool includeChildren) co
         ProtocolFile::makeLineSeparator(output);
     }
 
+    // Without Qt the functions are quite different
+    if(support.stdMap)
+        return output + getStdMapFunctionBody(false);
+
     // We need to know if any of our encodables are primitives (versus structures),
     // because that requires an "ok" local parameter
     bool containsprimitives = false;
@@ -3051,6 +5019,521 @@ std::string ProtocolStructure::getMapDecodeFunctionBody(bool includeChildren) co
 }// ProtocolStructure::getMapDecodeFunctionString
 
 
+/*!
+ * Get the string that gives the map encode or decode functions of this
+ * structure when the map does not use Qt. There are two functions: one that
+ * takes the key prefix as a string view and copies it to a key string, and
+ * one that extends that key string in place for each field and restores it,
+ * which is also used for sub-structures.
+ * \param encode should be true for the encode functions, else the decode functions are returned.
+ * \return the function string
+ */
+std::string ProtocolStructure::getStdMapFunctionBody(bool encode) const
+{
+    CodeEmitter output;
+    std::string contents;
+    std::string function = encode ? "mapEncode" : "mapDecode";
+    std::string verb = encode ? "Encode" : "Decode";
+    std::string direction = encode ? " to a" : " from a";
+
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        ProtocolFile::makeLineSeparator(contents);
+        contents += encode ? encodables[i]->getMapEncodeString() : encodables[i]->getMapDecodeString();
+    }
+
+    ProtocolFile::makeLineSeparator(contents);
+
+    // The public function, which copies the prefix
+    output.append("/*!\n");
+    output.append(" * ", verb, " the contents of a ", typeName, direction, " Key:Value map\n");
+    output.append(" * \\param _pg_prename is prepended to the key fields in the map\n");
+    output.append(" * \\param _pg_map is a reference to the map\n");
+    if(support.language == ProtocolSupport::c_language)
+        output.append(" * \\param _pg_user is the structure to ", toLower(verb), "\n");
+    output.append(" */\n");
+    output.append((encode ? getMapEncodeFunctionSignature(true) : getMapDecodeFunctionSignature(true)), "\n");
+    output.append("{\n");
+    output.append(TAB_IN, "std::string _pg_key(_pg_prename);\n");
+    output.append("\n");
+
+    if(support.language == ProtocolSupport::c_language)
+    {
+        output.append(TAB_IN, function, typeName, "(_pg_key, _pg_map, _pg_user);\n");
+        output.append("\n");
+        output.append("}// ", function, typeName, "\n");
+    }
+    else
+    {
+        output.append(TAB_IN, function, "(_pg_key, _pg_map);\n");
+        output.append("\n");
+        output.append("}// ", typeName, "::", function, "\n");
+    }
+
+    output.append("\n\n");
+
+    // The function that does the work, extending the key in place
+    output.append("/*!\n");
+    output.append(" * ", verb, " the contents of a ", typeName, direction, " Key:Value map\n");
+    output.append(" * \\param _pg_key is prepended to the key fields in the map. It is extended\n");
+    output.append(" *        for each field, and restored before returning.\n");
+    output.append(" * \\param _pg_map is a reference to the map\n");
+    if(support.language == ProtocolSupport::c_language)
+        output.append(" * \\param _pg_user is the structure to ", toLower(verb), "\n");
+    output.append(" */\n");
+    output.append((encode ? getMapEncodeFunctionSignature(true, true) : getMapDecodeFunctionSignature(true, true)), "\n");
+    output.append("{\n");
+
+    std::size_t declarations = output.str().size();
+
+    if(contents.find("_pg_length") != std::string::npos)
+        output.append(TAB_IN, "std::size_t _pg_length = 0;\n");
+
+    if(contents.find("_pg_signed") != std::string::npos)
+        output.append(TAB_IN, "long long _pg_signed = 0;\n");
+
+    if(contents.find("_pg_unsigned") != std::string::npos)
+        output.append(TAB_IN, "unsigned long long _pg_unsigned = 0;\n");
+
+    if(contents.find("_pg_double") != std::string::npos)
+        output.append(TAB_IN, "double _pg_double = 0;\n");
+
+    if(needsDecodeIterator)
+        output.append(TAB_IN, "unsigned _pg_i = 0;\n");
+
+    if(needs2ndDecodeIterator)
+        output.append(TAB_IN, "unsigned _pg_j = 0;\n");
+
+    if(output.str().size() > declarations)
+        output.makeLineSeparator();
+
+    output.append(contents);
+
+    if(support.language == ProtocolSupport::c_language)
+        output.append("}// ", function, typeName, "\n");
+    else
+        output.append("}// ", typeName, "::", function, "\n");
+
+    return output.take();
+
+}// ProtocolStructure::getStdMapFunctionBody
+
+
+/*!
+ * Get the signature of the jsonEncode function.
+ * \param insource should be true to indicate this signature is in source code.
+ * \param inplace should be true for the signature of the function that writes
+ *        at an index of the buffer, which is also used for sub-structures.
+ * \return the signature of the jsonEncode function.
+ */
+std::string ProtocolStructure::getJsonEncodeFunctionSignature(bool insource, bool inplace) const
+{
+    std::string prefix = insource ? "_pg_" : "";
+    std::string returntype = inplace ? "void " : "int ";
+    std::string parameters = "char* " + prefix + "json, int " + prefix + "size";
+
+    if(inplace)
+        parameters += ", int* " + prefix + "index";
+
+    if(support.language == ProtocolSupport::c_language)
+        return returntype + "jsonEncode" + typeName + "(" + parameters + ", const " + structName + "* " + prefix + "user)";
+    else if(insource)
+        return returntype + typeName + "::jsonEncode(" + parameters + ") const";
+    else
+        return returntype + "jsonEncode(" + parameters + ") const";
+
+}// ProtocolStructure::getJsonEncodeFunctionSignature
+
+
+/*!
+ * Return the string that gives the prototype of the functions used to encode
+ * this structure to JSON
+ * \param spacing gives the spacing to offset each line.
+ * \param includeChildren should be true to include the function prototypes of
+ *        the children structures of this structure
+ * \return the function prototype string, which may be empty
+ */
+std::string ProtocolStructure::getJsonEncodeFunctionPrototype(const std::string& spacing, bool includeChildren) const
+{
+    CodeEmitter output;
+
+    // We must have parameters that we decode to do a print out
+    if(!json || (getNumberOfDecodeParameters() == 0))
+        return output.take();
+
+    // Go get any children structures jsonEncode functions
+    if(includeChildren && (support.language == ProtocolSupport::c_language))
+    {
+        for(std::size_t i = 0; i < encodables.size(); i++)
+        {
+            ProtocolStructure* structure = dynamic_cast<ProtocolStructure*>(encodables.at(i));
+
+            if(!structure)
+                continue;
+
+            output.makeLineSeparator();
+            output.append(structure->getJsonEncodeFunctionPrototype(spacing, includeChildren));
+        }
+        output.makeLineSeparator();
+    }
+
+    // My jsonEncode functions
+    output.append(spacing, "//! Encode the contents of a ", typeName, " as null terminated JSON text\n");
+    output.append(spacing, getJsonEncodeFunctionSignature(false), ";\n");
+    output.append("\n");
+    output.append(spacing, "//! Encode the contents of a ", typeName, " as JSON text at an index of a buffer\n");
+    output.append(spacing, getJsonEncodeFunctionSignature(false, true), ";\n");
+
+    return output.take();
+
+}// ProtocolStructure::getJsonEncodeFunctionPrototype
+
+
+/*!
+ * Get the string that gives the functions used to encode this structure to
+ * JSON. The text is written directly into the caller's buffer, the keys are
+ * string literals, and numbers are formatted with std::to_chars, so nothing
+ * is allocated.
+ * \param includeChildren should be true to include the functions of the
+ *        children structures of this structure
+ * \return the function string, which may be empty
+ */
+std::string ProtocolStructure::getJsonEncodeFunctionBody(bool includeChildren) const
+{
+    CodeEmitter output;
+    emitJsonEncodeFunctionBody(output, includeChildren);
+    return output.take();
+
+}// ProtocolStructure::getJsonEncodeFunctionBody
+
+
+/*!
+ * Output the functions used to encode this structure to JSON.
+ * \param output receives the comments and code with linefeeds and semicolons.
+ * \param includeChildren should be true to output the children's functions.
+ */
+void ProtocolStructure::emitJsonEncodeFunctionBody(CodeEmitter& output, bool includeChildren) const
+{
+    // We must have parameters that we decode to do a print out
+    if(!json || (getNumberOfDecodeParameters() == 0))
+        return;
+
+    // Go get any childrens structure jsonEncode functions
+    if(includeChildren)
+    {
+        for(std::size_t i = 0; i < encodables.size(); i++)
+        {
+            ProtocolStructure* structure = dynamic_cast<ProtocolStructure*>(encodables.at(i));
+
+            if(!structure)
+                continue;
+
+            output.makeLineSeparator();
+            structure->emitJsonEncodeFunctionBody(output, includeChildren);
+        }
+        output.makeLineSeparator();
+    }
+
+    // The public function, which terminates the text
+    output.append("/*!\n");
+    output.append(" * Encode the contents of a ", typeName, " as null terminated JSON text\n");
+    output.append(" * \\param _pg_json receives the JSON text\n");
+    output.append(" * \\param _pg_size is the number of bytes that _pg_json can hold\n");
+    if(support.language == ProtocolSupport::c_language)
+        output.append(" * \\param _pg_user is the structure to encode\n");
+    output.append(" * \\return the length of the JSON text, not counting the terminator. If this\n");
+    output.append(" *         is not less than _pg_size the text was truncated.\n");
+    output.append(" */\n");
+    output.append(getJsonEncodeFunctionSignature(true), "\n");
+    output.append("{\n");
+    output.append(TAB_IN, "int _pg_index = 0;\n");
+    output.append("\n");
+
+    if(support.language == ProtocolSupport::c_language)
+        output.append(TAB_IN, "jsonEncode", typeName, "(_pg_json, _pg_size, &_pg_index, _pg_user);\n");
+    else
+        output.append(TAB_IN, "jsonEncode(_pg_json, _pg_size, &_pg_index);\n");
+
+    output.append("\n");
+    output.append(TAB_IN, "// Terminate the text, truncating it if needed\n");
+    output.append(TAB_IN, "if(_pg_size > 0)\n");
+    output.append(TAB_IN, TAB_IN, "_pg_json[(_pg_index < _pg_size) ? _pg_index : _pg_size - 1] = '\\0';\n");
+    output.append("\n");
+    output.append(TAB_IN, "return _pg_index;\n");
+    output.append("\n");
+
+    if(support.language == ProtocolSupport::c_language)
+        output.append("}// jsonEncode", typeName, "\n");
+    else
+        output.append("}// ", typeName, "::jsonEncode\n");
+
+    std::string contents;
+    bool first = true;
+
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        std::string member = encodables[i]->getJsonEncodeString(first);
+
+        if(member.empty())
+            continue;
+
+        ProtocolFile::makeLineSeparator(contents);
+        contents += member;
+        first = false;
+    }
+
+    ProtocolFile::makeLineSeparator(contents);
+
+    // The function that does the work, the first member opens the object
+    if(first)
+        contents += TAB_IN + "jsonText(_pg_json, _pg_size, _pg_index, \"{}\");\n";
+    else
+        contents += TAB_IN + "jsonText(_pg_json, _pg_size, _pg_index, \"}\");\n";
+
+    output.append("\n\n");
+    output.append("/*!\n");
+    output.append(" * Encode the contents of a ", typeName, " as JSON text at an index of a buffer\n");
+    output.append(" * \\param _pg_json receives the JSON text, which is not terminated\n");
+    output.append(" * \\param _pg_size is the number of bytes that _pg_json can hold. Text beyond\n");
+    output.append(" *        this is not written, but it is still counted by _pg_index.\n");
+    output.append(" * \\param _pg_index is the index in _pg_json to write, which is advanced by\n");
+    output.append(" *        the length of the text.\n");
+    if(support.language == ProtocolSupport::c_language)
+        output.append(" * \\param _pg_user is the structure to encode\n");
+    output.append(" */\n");
+    output.append(getJsonEncodeFunctionSignature(true, true), "\n");
+    output.append("{\n");
+
+    std::size_t declarations = output.str().size();
+
+    if(needsDecodeIterator)
+        output.append(TAB_IN, "unsigned _pg_i = 0;\n");
+
+    if(needs2ndDecodeIterator)
+        output.append(TAB_IN, "unsigned _pg_j = 0;\n");
+
+    if(output.str().size() > declarations)
+        output.makeLineSeparator();
+
+    output.append(contents);
+    output.append("\n");
+
+    if(support.language == ProtocolSupport::c_language)
+        output.append("}// jsonEncode", typeName, "\n");
+    else
+        output.append("}// ", typeName, "::jsonEncode\n");
+
+}// ProtocolStructure::emitJsonEncodeFunctionBody
+
+
+/*!
+ * Get the signature of the jsonDecode function.
+ * \param insource should be true to indicate this signature is in source code.
+ * \param inplace should be true for the signature of the function that reads
+ *        from an index of the text, which is also used for sub-structures.
+ * \return the signature of the jsonDecode function.
+ */
+std::string ProtocolStructure::getJsonDecodeFunctionSignature(bool insource, bool inplace) const
+{
+    std::string prefix = insource ? "_pg_" : "";
+    std::string returntype = inplace ? "bool " : "int ";
+    std::string parameters = "const char* " + prefix + "json, int " + prefix + "length";
+
+    if(inplace)
+        parameters += ", int* " + prefix + "index";
+
+    if(support.language == ProtocolSupport::c_language)
+        return returntype + "jsonDecode" + typeName + "(" + parameters + ", " + structName + "* " + prefix + "user)";
+    else if(insource)
+        return returntype + typeName + "::jsonDecode(" + parameters + ")";
+    else
+        return returntype + "jsonDecode(" + parameters + ")";
+
+}// ProtocolStructure::getJsonDecodeFunctionSignature
+
+
+/*!
+ * Return the string that gives the prototype of the functions used to decode
+ * this structure from JSON
+ * \param spacing gives the spacing to offset each line.
+ * \param includeChildren should be true to include the function prototypes of
+ *        the children structures of this structure
+ * \return the function prototype string, which may be empty
+ */
+std::string ProtocolStructure::getJsonDecodeFunctionPrototype(const std::string& spacing, bool includeChildren) const
+{
+    CodeEmitter output;
+
+    // We must have parameters that we decode to do a read
+    if(!json || (getNumberOfDecodeParameters() == 0))
+        return output.take();
+
+    // Go get any children structures jsonDecode functions
+    if(includeChildren && (support.language == ProtocolSupport::c_language))
+    {
+        for(std::size_t i = 0; i < encodables.size(); i++)
+        {
+            ProtocolStructure* structure = dynamic_cast<ProtocolStructure*>(encodables.at(i));
+
+            if(!structure)
+                continue;
+
+            output.makeLineSeparator();
+            output.append(structure->getJsonDecodeFunctionPrototype(spacing, includeChildren));
+        }
+        output.makeLineSeparator();
+    }
+
+    // My jsonDecode functions
+    output.append(spacing, "//! Decode the contents of a ", typeName, " from JSON text\n");
+    output.append(spacing, getJsonDecodeFunctionSignature(false), ";\n");
+    output.append("\n");
+    output.append(spacing, "//! Decode the contents of a ", typeName, " from JSON text at an index of a buffer\n");
+    output.append(spacing, getJsonDecodeFunctionSignature(false, true), ";\n");
+
+    return output.take();
+
+}// ProtocolStructure::getJsonDecodeFunctionPrototype
+
+
+/*!
+ * Get the string that gives the functions used to decode this structure from
+ * JSON. The text is parsed in a single pass directly into the structure, the
+ * members can be in any order, and unknown members are skipped.
+ * \param includeChildren should be true to include the functions of the
+ *        children structures of this structure
+ * \return the function string, which may be empty
+ */
+std::string ProtocolStructure::getJsonDecodeFunctionBody(bool includeChildren) const
+{
+    CodeEmitter output;
+    emitJsonDecodeFunctionBody(output, includeChildren);
+    return output.take();
+
+}// ProtocolStructure::getJsonDecodeFunctionBody
+
+
+/*!
+ * Output the functions used to decode this structure from JSON.
+ * \param output receives the comments and code with linefeeds and semicolons.
+ * \param includeChildren should be true to output the children's functions.
+ */
+void ProtocolStructure::emitJsonDecodeFunctionBody(CodeEmitter& output, bool includeChildren) const
+{
+    // We must have parameters that we decode to do a read
+    if(!json || (getNumberOfDecodeParameters() == 0))
+        return;
+
+    // Go get any childrens structure jsonDecode functions
+    if(includeChildren)
+    {
+        for(std::size_t i = 0; i < encodables.size(); i++)
+        {
+            ProtocolStructure* structure = dynamic_cast<ProtocolStructure*>(encodables.at(i));
+
+            if(!structure)
+                continue;
+
+            output.makeLineSeparator();
+            structure->emitJsonDecodeFunctionBody(output, includeChildren);
+        }
+        output.makeLineSeparator();
+    }
+
+    // The public function
+    output.append("/*!\n");
+    output.append(" * Decode the contents of a ", typeName, " from JSON text\n");
+    output.append(" * \\param _pg_json is the JSON text, which does not need to be terminated\n");
+    output.append(" * \\param _pg_length is the number of characters of _pg_json\n");
+    if(support.language == ProtocolSupport::c_language)
+        output.append(" * \\param _pg_user receives the data decoded from the JSON text\n");
+    output.append(" * \\return the number of characters that were decoded, or -1 if the JSON text\n");
+    output.append(" *         is not valid. Members of the object that are not known are ignored.\n");
+    output.append(" */\n");
+    output.append(getJsonDecodeFunctionSignature(true), "\n");
+    output.append("{\n");
+    output.append(TAB_IN, "int _pg_index = 0;\n");
+    output.append("\n");
+
+    if(support.language == ProtocolSupport::c_language)
+        output.append(TAB_IN, "if(jsonDecode", typeName, "(_pg_json, _pg_length, &_pg_index, _pg_user))\n");
+    else
+        output.append(TAB_IN, "if(jsonDecode(_pg_json, _pg_length, &_pg_index))\n");
+
+    output.append(TAB_IN, TAB_IN, "return _pg_index;\n");
+    output.append(TAB_IN, "else\n");
+    output.append(TAB_IN, TAB_IN, "return -1;\n");
+    output.append("\n");
+
+    if(support.language == ProtocolSupport::c_language)
+        output.append("}// jsonDecode", typeName, "\n");
+    else
+        output.append("}// ", typeName, "::jsonDecode\n");
+
+    std::string contents;
+
+    for(std::size_t i = 0; i < encodables.size(); i++)
+        contents += encodables[i]->getJsonDecodeString();
+
+    // The function that does the work
+    output.append("\n\n");
+    output.append("/*!\n");
+    output.append(" * Decode the contents of a ", typeName, " from JSON text at an index of a buffer\n");
+    output.append(" * \\param _pg_json is the JSON text, which does not need to be terminated\n");
+    output.append(" * \\param _pg_length is the number of characters of _pg_json\n");
+    output.append(" * \\param _pg_index is the index in _pg_json of the object to decode, which is\n");
+    output.append(" *        advanced past the object.\n");
+    if(support.language == ProtocolSupport::c_language)
+        output.append(" * \\param _pg_user receives the data decoded from the JSON text\n");
+    output.append(" * \\return true if the object was decoded, false if the JSON text is not valid\n");
+    output.append(" */\n");
+    output.append(getJsonDecodeFunctionSignature(true, true), "\n");
+    output.append("{\n");
+    output.append(TAB_IN, "std::string_view _pg_key;\n");
+
+    if(contents.find("_pg_signed") != std::string::npos)
+        output.append(TAB_IN, "long long _pg_signed = 0;\n");
+
+    if(contents.find("_pg_unsigned") != std::string::npos)
+        output.append(TAB_IN, "unsigned long long _pg_unsigned = 0;\n");
+
+    if(contents.find("_pg_double") != std::string::npos)
+        output.append(TAB_IN, "double _pg_double = 0;\n");
+
+    output.append(TAB_IN, "unsigned _pg_count = 0;\n");
+    output.append(TAB_IN, "int _pg_next = 0;\n");
+
+    if(needsDecodeIterator)
+        output.append(TAB_IN, "unsigned _pg_i = 0;\n");
+
+    if(needs2ndDecodeIterator)
+        output.append(TAB_IN, "unsigned _pg_j = 0;\n");
+
+    output.append("\n");
+    output.append(TAB_IN, "if(!jsonBegin(_pg_json, _pg_length, _pg_index, '{'))\n");
+    output.append(TAB_IN, TAB_IN, "return false;\n");
+    output.append("\n");
+    output.append(TAB_IN, "// Members can be in any order, unknown members are skipped\n");
+    output.append(TAB_IN, "for(_pg_count = 0; (_pg_next = jsonNext(_pg_json, _pg_length, _pg_index, _pg_count, '}')) > 0; _pg_count++)\n");
+    output.append(TAB_IN, "{\n");
+    output.append(TAB_IN, TAB_IN, "if(!jsonKey(_pg_json, _pg_length, _pg_index, &_pg_key))\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "return false;\n");
+    output.append(contents);
+    output.append(TAB_IN, TAB_IN, "else if(!jsonSkip(_pg_json, _pg_length, _pg_index))\n");
+    output.append(TAB_IN, TAB_IN, TAB_IN, "return false;\n");
+    output.append(TAB_IN, "}\n");
+    output.append("\n");
+    output.append(TAB_IN, "return (_pg_next == 0);\n");
+    output.append("\n");
+
+    if(support.language == ProtocolSupport::c_language)
+        output.append("}// jsonDecode", typeName, "\n");
+    else
+        output.append("}// ", typeName, "::jsonDecode\n");
+
+}// ProtocolStructure::emitJsonDecodeFunctionBody
+
+
 /*!
  * Get details needed to produce documentation for this encodable.
  * \param parentName is the name of the parent which will be pre-pended to the name of this encodable
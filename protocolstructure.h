@@ -12,7 +12,7 @@ class ProtocolStructure : public Encodable
 public:
 
     //! Default constructor for protocol structure
-    ProtocolStructure(ProtocolParser* parse, std::string Parent, ProtocolSupport supported);
+    ProtocolStructure(ProtocolParser* parse, std::string Parent, const ProtocolSupport& supported);
 
     //! Reset all data to defaults
     void clear(void) override;
@@ -35,12 +35,33 @@ public:
     //! Return the string that is used to decode this encoable
     std::string getDecodeString(int* bitcount, bool isStructureMember, bool defaultEnabled = false) const override;
 
+    //! Return the string that adds the encoded size of this structure, empty if the size is always the maximum
+    std::string getEncodedSizeString(bool isStructureMember) const override {return getLengthString(isStructureMember, false);}
+
+    //! Return the string that skips this structure in a byte array, empty if the size is always the maximum
+    std::string getSkipString(bool isStructureMember) const override {return getLengthString(isStructureMember, true);}
+
+    //! True if this structure is an array, whose elements can be decoded one at a time by the steps of a resumable decoder
+    bool isDecodedByElement(void) const override {return isArray();}
+
+    //! Return the string that decodes the array element `_pg_i` of this structure
+    std::string getDecodeElementString(bool isStructureMember) const override;
+
+    //! Return the string that skips one array element of this structure in a byte array, empty if every element has the same size
+    std::string getSkipElementString(bool isStructureMember) const override;
+
+    //! Determine if every encoding of this structure has the same length
+    bool hasFixedEncodedLength(std::string* length = nullptr) const;
+
     //! Get the string used for verifying this field.
     std::string getVerifyString(void) const override;
 
     //! Return the string that sets this encodable to its initial value in code
     std::string getSetInitialValueString(bool isStructureMember) const override;
 
+    //! Return the string that sets this encodable to its initial value in the C++ initialize() function
+    std::string getInitializeString(void) const override;
+
     //! Return the strings that #define initial and variable values
     std::string getInitialAndVerifyDefines(bool includeComment = true) const override;
 
@@ -56,9 +77,21 @@ public:
     //! Get the string used for comparing this structure.
     std::string getComparisonString(void) const override;
 
+    //! Get the string used for testing this structure for equality.
+    std::string getEqualsString(void) const override;
+
+    //! Get the string used for combining this structure into a hash.
+    std::string getHashString(void) const override;
+
     //! Get the string used for text printing this structure.
     std::string getTextPrintString(void) const override;
 
+    //! Get the estimated number of characters text printed for this structure, not counting the prename
+    int getTextPrintLength(int* lines) const override;
+
+    //! Get the estimated number of characters text printed for the contents of this structure, not counting the prename
+    int getTextPrintContentsLength(int* lines) const;
+
     //! Get the string used for text reading this structure.
     std::string getTextReadString(void) const override;
 
@@ -68,6 +101,18 @@ public:
     //! Return the string used for map decoding this structure
     std::string getMapDecodeString(void) const override;
 
+    //! Return the string used for JSON encoding this structure
+    std::string getJsonEncodeString(bool first) const override;
+
+    //! Return the string used for JSON decoding this structure
+    std::string getJsonDecodeString(void) const override;
+
+    //! Return the string used for JSON encoding one element of this structure
+    std::string getJsonEncodeValueString(const std::string& spacing, const std::string& separator) const override;
+
+    //! Return the string used for JSON decoding one element of this structure
+    std::string getJsonDecodeValueString(const std::string& spacing, const std::string& condition) const override;
+
     //! Parse the DOM data for this structures children
     void parseChildren(const XMLElement* field);
 
@@ -80,6 +125,24 @@ public:
     //! Set the mapEncode flag for this structure and all children structure
     void setMapEncode(bool enable);
 
+    //! Set the json flag for this structure and all children structure
+    void setJson(bool enable);
+
+    //! Set the hash flag for this structure and all children structure
+    void setHash(bool enable);
+
+    //! Set the encodedSize flag for this structure and all children structure
+    void setEncodedSize(bool enable);
+
+    //! Set the skip flag for this structure and all children structure
+    void setSkip(bool enable);
+
+    //! Set the noInit flag for this structure and all children structure
+    void setNoInit(bool enable);
+
+    //! True if the C++ constructor leaves the members to be set by initialize()
+    bool isNoInit(void) const override;
+
     //! Determine if this encodable is a primitive, rather than a structure
     bool isPrimitive(void) const override {return false;}
 
@@ -131,6 +194,12 @@ public:
     //! True if this encodable has a direct child that uses defaults
     bool usesDefaults(void) const override {return defaults;}
 
+    //! True if any of the children of this encodable are encoded as variable length integers
+    bool usesVarint(void) const override;
+
+    //! True if this structure, or any of its children, has a hash function
+    bool usesHash(void) const;
+
 
     //! Return the string that is used to prototype the encode routine for this encodable
     virtual std::string getEncodeFunctionSignature(bool insource) const;
@@ -141,6 +210,35 @@ public:
     //! Return the string that gives the function used to encode this encodable, may be empty
     virtual std::string getEncodeFunctionBody(bool includeChildren = true) const;
 
+    //! Output the function used to encode this structure
+    void emitEncodeFunctionBody(CodeEmitter& output, bool includeChildren = true) const;
+
+
+    //! Return the string that is used to prototype the encoded size routine for this structure
+    virtual std::string getEncodedSizeFunctionSignature(bool insource) const;
+
+    //! Return the string that gives the prototype of the function used to compute the encoded size of this structure
+    virtual std::string getEncodedSizeFunctionPrototype(const std::string& spacing = std::string(), bool includeChildren = true) const;
+
+    //! Return the string that gives the function used to compute the encoded size of this structure
+    virtual std::string getEncodedSizeFunctionBody(bool includeChildren = true) const;
+
+    //! Output the function used to compute the encoded size of this structure
+    void emitEncodedSizeFunctionBody(CodeEmitter& output, bool includeChildren = true) const;
+
+
+    //! Return the string that is used to prototype the skip routine for this structure
+    virtual std::string getSkipFunctionSignature(bool insource) const;
+
+    //! Return the string that gives the prototype of the function used to skip this structure
+    virtual std::string getSkipFunctionPrototype(const std::string& spacing = std::string(), bool includeChildren = true) const;
+
+    //! Return the string that gives the function used to skip this structure
+    virtual std::string getSkipFunctionBody(bool includeChildren = true) const;
+
+    //! Output the function used to skip this structure
+    void emitSkipFunctionBody(CodeEmitter& output, bool includeChildren = true) const;
+
 
     //! Return the string that is used to prototype the decode routine for this encodable
     virtual std::string getDecodeFunctionSignature(bool insource) const;
@@ -151,6 +249,9 @@ public:
     //! Return the string that gives the function used to decode this encodable, may be empty
     virtual std::string getDecodeFunctionBody(bool includeChildren = true) const;
 
+    //! Output the function used to decode this structure
+    void emitDecodeFunctionBody(CodeEmitter& output, bool includeChildren = true) const;
+
 
     //! Return the string that gives the signature of the function used to initialize this structure
     virtual std::string getVerifyFunctionSignature(bool insource) const;
@@ -165,15 +266,40 @@ public:
     //! Return the string that gives the signature of the function used to compare this structure
     virtual std::string getComparisonFunctionSignature(bool insource) const;
 
+    //! Return the string that gives the signature of the function used to test this structure for equality
+    virtual std::string getEqualsFunctionSignature(bool insource) const;
+
     //! Return the string that gives the prototype of the function used to compare this structure
     virtual std::string getComparisonFunctionPrototype(const std::string& spacing = std::string(), bool includeChildren = true) const;
 
     //! Return the string that gives the function used to compare this structure
     virtual std::string getComparisonFunctionBody(bool includeChildren = true) const;
 
+    //! Return the string that gives the function used to test this structure for equality
+    std::string getEqualsFunctionBody(void) const;
+
+    //! Determine if the function used to test this structure for equality is output
+    bool hasEqualsFunction(void) const;
+
+
+    //! Return the string that gives the signature of the function used to hash this structure
+    virtual std::string getHashFunctionSignature(bool insource) const;
+
+    //! Return the string that gives the prototype of the function used to hash this structure
+    virtual std::string getHashFunctionPrototype(const std::string& spacing = std::string(), bool includeChildren = true) const;
+
+    //! Return the string that gives the function used to hash this structure
+    virtual std::string getHashFunctionBody(bool includeChildren = true) const;
+
+    //! Output the function used to hash this structure
+    void emitHashFunctionBody(CodeEmitter& output, bool includeChildren = true) const;
+
+    //! Return the string that specializes std::hash for this structure, in the C++ language
+    std::string getStdHashSpecialization(void) const;
+
 
     //! Return the string that gives the signature of the function used to text print this structure
-    virtual std::string getTextPrintFunctionSignature(bool insource) const;
+    virtual std::string getTextPrintFunctionSignature(bool insource, bool append = false) const;
 
     //! Return the string that gives the prototype of the function used to text print this structure
     virtual std::string getTextPrintFunctionPrototype(const std::string& spacing = std::string(), bool includeChildren = true) const;
@@ -181,9 +307,12 @@ public:
     //! Return the string that gives the function used to text print this structure
     virtual std::string getTextPrintFunctionBody(bool includeChildren = true) const;
 
+    //! Output the function used to text print this structure
+    void emitTextPrintFunctionBody(CodeEmitter& output, bool includeChildren = true) const;
+
 
     //! Return the string that gives the signature of the function used to read this structure from text
-    virtual std::string getTextReadFunctionSignature(bool insource) const;
+    virtual std::string getTextReadFunctionSignature(bool insource, bool indexed = false) const;
 
     //! Return the string that gives the prototype of the function used to read this structure from text
     virtual std::string getTextReadFunctionPrototype(const std::string& spacing = std::string(), bool includeChildren = true) const;
@@ -191,9 +320,12 @@ public:
     //! Return the string that gives the function used to read this structure this structure from text
     virtual std::string getTextReadFunctionBody(bool includeChildren = true) const;
 
+    //! Output the function used to read this structure from text
+    void emitTextReadFunctionBody(CodeEmitter& output, bool includeChildren = true) const;
+
 
     //! Return the string that gives the signature of the function used to encode this structure to a map
-    virtual std::string getMapEncodeFunctionSignature(bool insource) const;
+    virtual std::string getMapEncodeFunctionSignature(bool insource, bool inplace = false) const;
 
     //! Return the string that gives the prototype of the function used to encode this structure to a map
     virtual std::string getMapEncodeFunctionPrototype(const std::string& spacing = std::string(), bool includeChildren = true) const;
@@ -203,7 +335,7 @@ public:
 
 
     //! Return the string that gives the signature of the function used to decode this structure from a map
-    virtual std::string getMapDecodeFunctionSignature(bool insource) const;
+    virtual std::string getMapDecodeFunctionSignature(bool insource, bool inplace = false) const;
 
     //! Return the string that gives the prototype of the function used to decode this structure from a map
     virtual std::string getMapDecodeFunctionPrototype(const std::string& spacing = std::string(), bool includeChildren = true) const;
@@ -211,6 +343,35 @@ public:
     //! Return the string that gives the function used to decode this structure from a map
     virtual std::string getMapDecodeFunctionBody(bool includeChildren = true) const;
 
+    //! Return the string that gives the map functions when the map does not use Qt
+    std::string getStdMapFunctionBody(bool encode) const;
+
+
+    //! Return the string that gives the signature of the function used to encode this structure to JSON
+    virtual std::string getJsonEncodeFunctionSignature(bool insource, bool inplace = false) const;
+
+    //! Return the string that gives the prototype of the function used to encode this structure to JSON
+    virtual std::string getJsonEncodeFunctionPrototype(const std::string& spacing = std::string(), bool includeChildren = true) const;
+
+    //! Return the string that gives the function used to encode this structure to JSON
+    virtual std::string getJsonEncodeFunctionBody(bool includeChildren = true) const;
+
+    //! Output the function used to encode this structure to JSON
+    void emitJsonEncodeFunctionBody(CodeEmitter& output, bool includeChildren = true) const;
+
+
+    //! Return the string that gives the signature of the function used to decode this structure from JSON
+    virtual std::string getJsonDecodeFunctionSignature(bool insource, bool inplace = false) const;
+
+    //! Return the string that gives the prototype of the function used to decode this structure from JSON
+    virtual std::string getJsonDecodeFunctionPrototype(const std::string& spacing = std::string(), bool includeChildren = true) const;
+
+    //! Return the string that gives the function used to decode this structure from JSON
+    virtual std::string getJsonDecodeFunctionBody(bool includeChildren = true) const;
+
+    //! Output the function used to decode this structure from JSON
+    void emitJsonDecodeFunctionBody(CodeEmitter& output, bool includeChildren = true) const;
+
 
     //! Return the string that gives the signature of the function used to initialize this structure
     virtual std::string getSetToInitialValueFunctionSignature(bool insource) const;
@@ -221,6 +382,9 @@ public:
     //! Return the string that gives the function used to initialize this structure
     virtual std::string getSetToInitialValueFunctionBody(bool includeChildren = true) const;
 
+    //! Output the function used to initialize this structure
+    void emitSetToInitialValueFunctionBody(CodeEmitter& output, bool includeChildren = true) const;
+
 
     //! Return the string that gives the signature of the second function used to initialize this structure
     virtual std::string getSecondSetToInitialValueFunctionSignature(bool insource) const;
@@ -231,6 +395,9 @@ public:
     //! Return the string that gives the second function used to initialize this structure
     virtual std::string getSecondSetToInitialValueFunctionBody(bool includeChildren = true) const;
 
+    //! Return the code which sets this structure to its maximum encoded length
+    std::string getSetToMaximumLengthString(const std::string& spacing, const std::string& access) const;
+
 
     //! Get the number of fields that are encoded
     int getNumberOfEncodes(void) const;
@@ -262,6 +429,9 @@ public:
     //! Return the include directives needed for this encodable's print functions
     void getPrintIncludeDirectives(std::vector<std::string>& list) const override;
 
+    //! Return the include directives needed for this encodable's JSON functions
+    void getJsonIncludeDirectives(std::vector<std::string>& list) const override;
+
     //! Get details needed to produce documentation for this encodable.
     void getDocumentationDetails(std::vector<int>& outline, std::string& startByte, std::vector<std::string>& bytes, std::vector<std::string>& names, std::vector<std::string>& encodings, std::vector<std::string>& repeats, std::vector<std::string>& comments) const override;
 
@@ -282,6 +452,15 @@ public:
 
 protected:
 
+    //! Get the source needed to add the encoded size of this structure, or to skip it
+    std::string getLengthString(bool isStructureMember, bool skip) const;
+
+    //! Get the source needed to skip one value of this structure
+    std::string getSkipValueString(const std::string& spacing) const;
+
+    //! Get the source needed to decode this structure, or one of its array elements
+    std::string getDecodeStringForStructure(bool isStructureMember, bool element) const;
+
     //! Get the declaration that goes in the header which declares this structure and all its children
     std::string getStructureDeclaration(bool alwaysCreate) const;
 
@@ -332,6 +511,11 @@ protected:
     bool compare;                       //!< True if the comparison function is output
     bool print;                         //!< True if the textPrint function is output
     bool mapEncode;                     //!< True if the mapEncode function is output
+    bool json;                          //!< True if the jsonEncode and jsonDecode functions are output
+    bool hash;                          //!< True if the hash function is output
+    bool encodedSize;                   //!< True if the encoded size function is output
+    bool skipEncoded;                   //!< True if the function to skip the encoded structure is output
+    bool noinit;                        //!< True if the C++ constructor does not set the members, initialize() does
     const ProtocolStructureModule* redefines; //!< Pointer to a structure that we are redefining
 
 };
@@ -7,7 +7,7 @@
  * \param parse points to the global protocol parser that owns everything
  * \param supported gives the supported features of the protocol
  */
-ProtocolStructureModule::ProtocolStructureModule(ProtocolParser* parse, ProtocolSupport supported) :
+ProtocolStructureModule::ProtocolStructureModule(ProtocolParser* parse, const ProtocolSupport& supported) :
     ProtocolStructure(parse, supported.protoName, supported),
     source(supported),
     header(supported),
@@ -20,6 +20,8 @@ ProtocolStructureModule::ProtocolStructureModule(ProtocolParser* parse, Protocol
     _printHeader(supported),
     _mapSource(supported),
     _mapHeader(supported),
+    _jsonSource(supported),
+    _jsonHeader(supported),
     structHeader(&header),
     verifySource(&source),
     verifyHeader(&header),
@@ -28,7 +30,10 @@ ProtocolStructureModule::ProtocolStructureModule(ProtocolParser* parse, Protocol
     printSource(nullptr),
     printHeader(nullptr),
     mapSource(nullptr),
-    mapHeader(nullptr)
+    mapHeader(nullptr),
+    jsonSource(nullptr),
+    jsonHeader(nullptr),
+    unchanged(false)
 {
     // In the C language these files must have their modules, because they use
     // c++ features, in c++ they can output to the source and header files
@@ -40,13 +45,15 @@ ProtocolStructureModule::ProtocolStructureModule(ProtocolParser* parse, Protocol
         printHeader = &header;
         mapSource = &source;
         mapHeader = &header;
+        jsonSource = &source;
+        jsonHeader = &header;
     }
 
     // These are attributes on top of the normal structure that we support
-    std::vector<std::string> newattribs({"encode", "decode", "file", "deffile", "verifyfile", "comparefile", "printfile", "mapfile", "redefine", "compare", "print", "map"});
+    static const AttributeKeys moduleattributes(*attriblist, {"encode", "decode", "file", "deffile", "verifyfile", "comparefile", "printfile", "mapfile", "jsonfile", "redefine", "compare", "print", "map", "json", "hash", "encodedSize", "skip", "noInit"});
 
-    // Now append the new attributes onto our old list
-    attriblist.insert(attriblist.end(), newattribs.begin(), newattribs.end());
+    // Now use the new attributes plus our old list
+    attriblist = &moduleattributes;
 }
 
 
@@ -70,6 +77,8 @@ void ProtocolStructureModule::clear(void)
     _printSource.clear();
     _mapSource.clear();
     _mapHeader.clear();
+    _jsonSource.clear();
+    _jsonHeader.clear();
     structHeader = &header;
     verifyHeader = &header;
     verifySource = &source;
@@ -83,6 +92,8 @@ void ProtocolStructureModule::clear(void)
         printHeader = nullptr;
         mapSource = nullptr;
         mapHeader = nullptr;
+        jsonSource = nullptr;
+        jsonHeader = nullptr;
     }
     else
     {
@@ -92,6 +103,8 @@ void ProtocolStructureModule::clear(void)
         printHeader = &header;
         mapSource = &source;
         mapHeader = &header;
+        jsonSource = &source;
+        jsonHeader = &header;
     }
 
     // Note that api, version, and support are not changed
@@ -103,7 +116,7 @@ void ProtocolStructureModule::clear(void)
  * Issue warnings for the structure module. This should be called after the
  * attributes have been parsed.
  */
-void ProtocolStructureModule::issueWarnings(const XMLAttribute* map)
+void ProtocolStructureModule::issueWarnings(const AttributeIndex& map)
 {
     (void)map;
 
@@ -146,7 +159,7 @@ void ProtocolStructureModule::parse(bool nocode)
     // Me and all my children, which may themselves be structures
     ProtocolStructure::parse();
 
-    const XMLAttribute* map = e->FirstAttribute();
+    AttributeIndex map(e->FirstAttribute(), *attriblist);
 
     std::string moduleName = ProtocolParser::getAttribute("file", map);
     std::string defheadermodulename = ProtocolParser::getAttribute("deffile", map);
@@ -154,6 +167,7 @@ void ProtocolStructureModule::parse(bool nocode)
     std::string comparemodulename = ProtocolParser::getAttribute("comparefile", map);
     std::string printmodulename = ProtocolParser::getAttribute("printfile", map);
     std::string mapmodulename = ProtocolParser::getAttribute("mapfile", map);
+    std::string jsonmodulename = ProtocolParser::getAttribute("jsonfile", map);
 
     encode = !ProtocolParser::isFieldClear(ProtocolParser::getAttribute("encode", map));
     decode = !ProtocolParser::isFieldClear(ProtocolParser::getAttribute("decode", map));
@@ -161,33 +175,60 @@ void ProtocolStructureModule::parse(bool nocode)
     // It is possible to suppress the globally specified compare output
     if(ProtocolParser::isFieldClear(ProtocolParser::getAttribute("compare", map)))
     {
-        support.compare = compare = false;
+        compare = false;
         comparemodulename.clear();
-        support.globalCompareName.clear();
     }
-    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("compare", map)))
+    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("compare", map)) || !support.globalCompareName.empty() || support.compare)
         compare = true;
 
     // It is possible to suppress the globally specified print output
     if(ProtocolParser::isFieldClear(ProtocolParser::getAttribute("print", map)))
     {
-        support.print = print = false;
+        print = false;
         printmodulename.clear();
-        support.globalPrintName.clear();
     }
-    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("print", map)))
+    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("print", map)) || !support.globalPrintName.empty() || support.print)
         print = true;
 
     // It is possible to suppress the globally specified map output
     if(ProtocolParser::isFieldClear(ProtocolParser::getAttribute("map", map)))
     {
-        support.mapEncode = mapEncode = false;
+        mapEncode = false;
         mapmodulename.clear();
-        support.globalMapName.clear();
     }
-    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("map", map)))
+    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("map", map)) || !support.globalMapName.empty() || support.mapEncode)
         mapEncode = true;
 
+    // It is possible to suppress the globally specified JSON output
+    if(ProtocolParser::isFieldClear(ProtocolParser::getAttribute("json", map)))
+    {
+        json = false;
+        jsonmodulename.clear();
+    }
+    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("json", map)) || !support.globalJsonName.empty() || support.json)
+        json = true;
+
+    // It is possible to suppress the globally specified hash output
+    if(ProtocolParser::isFieldClear(ProtocolParser::getAttribute("hash", map)))
+        hash = false;
+    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("hash", map)) || support.hash)
+        hash = true;
+
+    // It is possible to suppress the globally specified encoded size output
+    if(ProtocolParser::isFieldClear(ProtocolParser::getAttribute("encodedSize", map)))
+        encodedSize = false;
+    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("encodedSize", map)) || support.encodedSize)
+        encodedSize = true;
+
+    // It is possible to suppress the globally specified skip output
+    if(ProtocolParser::isFieldClear(ProtocolParser::getAttribute("skip", map)))
+        skipEncoded = false;
+    else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("skip", map)) || support.skip)
+        skipEncoded = true;
+
+    // The C++ constructor can leave the members to be set by initialize()
+    noinit = ProtocolParser::isFieldSet(ProtocolParser::getAttribute("noInit", map));
+
     std::string redefinename = ProtocolParser::getAttribute("redefine", map);
 
     // Warnings for users
@@ -220,7 +261,14 @@ void ProtocolStructureModule::parse(bool nocode)
     }
 
     // Do the bulk of the file creation and setup
-    setupFiles(moduleName, defheadermodulename, verifymodulename, comparemodulename, printmodulename, mapmodulename, true, true);
+    setupFiles(moduleName, defheadermodulename, verifymodulename, comparemodulename, printmodulename, mapmodulename, jsonmodulename, true, true);
+
+    // The file names are known now, which is all that other modules need from us
+    if(unchanged)
+    {
+        discardFiles();
+        return;
+    }
 
     // The functions to encoding and ecoding
     createStructureFunctions();
@@ -251,6 +299,13 @@ void ProtocolStructureModule::parse(bool nocode)
         mapHeader->flush();
     }
 
+    // Only write the JSON functions if we have JSON functions to support
+    if(json)
+    {
+        jsonSource->flush();
+        jsonHeader->flush();
+    }
+
     // We don't write the verify files to disk if we are not initializing or verifying anything
     if(hasInit() || hasVerify())
     {
@@ -261,6 +316,51 @@ void ProtocolStructureModule::parse(bool nocode)
 }// ProtocolStructureModule::parse
 
 
+/*!
+ * Discard the contents of all files, so nothing is written to disk. This is
+ * used when the code outputs from a previous run are still valid.
+ */
+void ProtocolStructureModule::discardFiles(void)
+{
+    source.clear();
+    header.clear();
+    _structHeader.clear();
+    _verifySource.clear();
+    _verifyHeader.clear();
+    _compareSource.clear();
+    _compareHeader.clear();
+    _printSource.clear();
+    _printHeader.clear();
+    _mapSource.clear();
+    _mapHeader.clear();
+    _jsonSource.clear();
+    _jsonHeader.clear();
+
+}// ProtocolStructureModule::discardFiles
+
+
+/*!
+ * Return the path and name of every file this module can write to, whether
+ * or not the file has any content. Some of the files may be the same.
+ * \return the list of file paths and names.
+ */
+std::vector<std::string> ProtocolStructureModule::getFilePathsAndNames(void) const
+{
+    std::vector<const ProtocolFile*> files = {&header, &source, structHeader, verifySource, verifyHeader, compareSource, compareHeader, printSource, printHeader, mapSource, mapHeader, jsonSource, jsonHeader};
+    std::vector<std::string> list;
+
+    for(const ProtocolFile* file : files)
+    {
+        // Files that have no name are not used
+        if((file != nullptr) && !file->moduleName().empty())
+            list.push_back(file->filePath(true) + file->fileName(true));
+    }
+
+    return list;
+
+}// ProtocolStructureModule::getFilePathsAndNames
+
+
 /*!
  * Setup the files, which accounts for all the ways the fils can be organized for this structure.
  * \param moduleName is the module name from the attributes
@@ -268,6 +368,8 @@ void ProtocolStructureModule::parse(bool nocode)
  * \param verifymodulename is the verify module name from the attributes
  * \param comparemodulename is the comparison module name from the attributes
  * \param printmodulename is the print module name from the attributes
+ * \param mapmodulename is the map module name from the attributes
+ * \param jsonmodulename is the JSON module name from the attributes
  * \param forceStructureDeclaration should be true to force the declaration of the structure, even if it only has one member
  * \param outputUtilties should be true to output the helper macros
  */
@@ -277,25 +379,41 @@ void ProtocolStructureModule::setupFiles(std::string moduleName,
                                          std::string comparemodulename,
                                          std::string printmodulename,
                                          std::string mapmodulename,
+                                         std::string jsonmodulename,
                                          bool forceStructureDeclaration, bool outputUtilities)
 {
-    // User can provide compare flag, or the file name, or set the global flag
-    if(!comparemodulename.empty() || !support.globalCompareName.empty() || support.compare)
+    // User can provide compare flag, or the file name, the global flag is handled by our parse()
+    if(!comparemodulename.empty())
         compare = true;
 
-    // User can provide print flag, or the file name, or set the global flag
-    if(!printmodulename.empty() || !support.globalPrintName.empty() || support.print)
+    // User can provide print flag, or the file name, the global flag is handled by our parse()
+    if(!printmodulename.empty())
         print = true;
 
-    // User can provide map flag, or the file name, or set the global flag
-    if(!mapmodulename.empty() || !support.globalMapName.empty() || support.mapEncode)
+    // User can provide map flag, or the file name, the global flag is handled by our parse()
+    if(!mapmodulename.empty())
         mapEncode = true;
 
-    // In order to do compare, print, map, verify or init we must actually have some parameters
+    // User can provide JSON flag, or the file name, the global flag is handled by our parse()
+    if(!jsonmodulename.empty())
+        json = true;
+
+    // In order to do compare, print, map, JSON, verify or init we must actually have some parameters
     if((getNumberOfEncodeParameters() <= 0) && (getNumberOfDecodeParameters() <= 0))
-        compare = print = mapEncode = hasverify = hasinit = false;
+        compare = print = mapEncode = json = hasverify = hasinit = false;
+
+    // The hash is of the encoded fields, and is output with the encode and decode functions
+    if((getNumberOfEncodeParameters() <= 0) || (!encode && !decode))
+        hash = false;
+
+    // The encoded size goes with the encode function, and the skip with the decode function
+    if(!encode)
+        encodedSize = false;
+
+    if(!decode)
+        skipEncoded = false;
 
-    // We need to reflect the compare, print, and mapEncode flags to our child structures
+    // We need to reflect the compare, print, mapEncode, and json flags to our child structures
     for(std::size_t i = 0; i < encodables.size(); i++)
     {
         // Is this encodable a structure?
@@ -312,10 +430,25 @@ void ProtocolStructureModule::setupFiles(std::string moduleName,
 
         if(mapEncode)
             structure->setMapEncode(true);
+
+        if(json)
+            structure->setJson(true);
+
+        if(hash)
+            structure->setHash(true);
+
+        if(encodedSize)
+            structure->setEncodedSize(true);
+
+        if(skipEncoded)
+            structure->setSkip(true);
+
+        if(noinit)
+            structure->setNoInit(true);
     }
 
     // Must have a structure definition to do any of these operations
-    if(compare || print || mapEncode || hasverify || hasinit)
+    if(compare || print || mapEncode || json || hash || hasverify || hasinit)
         forceStructureDeclaration = true;
 
     // The file directive tells us if we are creating a separate file, or if we are appending an existing one
@@ -425,13 +558,43 @@ void ProtocolStructureModule::setupFiles(std::string moduleName,
 
         // Make sure to provide the helper functions
         printSource->makeLineSeparator();
-        printSource->writeOnce(getToFormattedStringFunction());
+        printSource->writeOnce(getAppendTextFunction());
         printSource->makeLineSeparator();
         printSource->writeOnce(getExtractTextFunction());
         printSource->makeLineSeparator();
 
     }
 
+    if(json)
+    {
+        if(jsonmodulename.empty())
+            jsonmodulename = support.globalJsonName;
+
+        // In C the JSON outputs cannot be in the main code files, because they are c++
+        if(jsonmodulename.empty() && (support.language == ProtocolSupport::c_language))
+            jsonmodulename = support.prefix + name + "_json";
+
+        if(jsonmodulename.empty())
+        {
+            jsonHeader = &header;
+            jsonSource = &source;
+        }
+        else
+        {
+            _jsonHeader.setModuleNameAndPath(jsonmodulename, support.outputpath, ProtocolSupport::cpp_language);
+            _jsonSource.setModuleNameAndPath(jsonmodulename, support.outputpath, ProtocolSupport::cpp_language);
+            jsonHeader = &_jsonHeader;
+            jsonSource = &_jsonSource;
+        }
+
+        // Make sure to provide the helper functions
+        jsonSource->makeLineSeparator();
+        jsonSource->writeOnce(getJsonWriteFunction());
+        jsonSource->makeLineSeparator();
+        jsonSource->writeOnce(getJsonReadFunction());
+        jsonSource->makeLineSeparator();
+    }
+
     // Include the protocol top level module. This module may already be included, but in that case it won't be included twice
     header.writeIncludeDirective(support.protoName + "Protocol");
 
@@ -492,6 +655,17 @@ void ProtocolStructureModule::setupFiles(std::string moduleName,
         compareHeader->makeLineSeparator();
     }
 
+    // The specialization of std::hash needs the declaration of std::hash
+    if(hash && (support.language == ProtocolSupport::cpp_language))
+        structHeader->writeIncludeDirective("functional", std::string(), true, false);
+
+    // The initialize() functions use memset() and strncpy()
+    if(isNoInit())
+    {
+        source.writeIncludeDirective("cstring", std::string(), true, false);
+        verifySource->writeIncludeDirective("cstring", std::string(), true, false);
+    }
+
     // The print details may be spread across multiple files
     if(print)
     {
@@ -501,11 +675,18 @@ void ProtocolStructureModule::setupFiles(std::string moduleName,
         printSource->writeIncludeDirective("sstream", std::string(), true, false);
         printSource->writeIncludeDirective("iomanip", std::string(), true, false);
         printSource->writeIncludeDirective("cstring", std::string(), true, false);
+        printSource->writeIncludeDirective("charconv", std::string(), true, false);
+        printSource->writeIncludeDirective("cstdlib", std::string(), true, false);
+        printSource->writeIncludeDirective("cstdio", std::string(), true, false);
+        printHeader->writeIncludeDirective("string_view", std::string(), true, false);
+        printHeader->writeIncludeDirective("unordered_map", std::string(), true, false);
 
         if(support.language == ProtocolSupport::cpp_language)
         {
             // In C++ these function declarations are in the class declaration
             structHeader->writeIncludeDirective("string", std::string(), true, false);
+            structHeader->writeIncludeDirective("string_view", std::string(), true, false);
+            structHeader->writeIncludeDirective("unordered_map", std::string(), true, false);
             printSource->writeIncludeDirective("fieldencode.hpp", std::string(), false);
         }
         else
@@ -522,14 +703,32 @@ void ProtocolStructureModule::setupFiles(std::string moduleName,
     {
         mapHeader->writeIncludeDirective(structHeader->fileName());
         mapHeader->writeIncludeDirective(header.fileName());
-        mapHeader->writeIncludeDirective("QVariant", std::string(), true, false);
-        mapHeader->writeIncludeDirective("QString", std::string(), true, false);
 
-        if(support.language == ProtocolSupport::cpp_language)
+        if(support.stdMap)
         {
-            // In C++ these function declarations are in the class declaration
-            structHeader->writeIncludeDirective("QString", std::string(), true, false);
-            structHeader->writeIncludeDirective("QVariant", std::string(), true, false);
+            mapHeader->writeIncludeDirective("fieldmap.hpp", std::string(), false, false);
+            mapHeader->writeIncludeDirective("string", std::string(), true, false);
+            mapHeader->writeIncludeDirective("string_view", std::string(), true, false);
+
+            if(support.language == ProtocolSupport::cpp_language)
+            {
+                // In C++ these function declarations are in the class declaration
+                structHeader->writeIncludeDirective("fieldmap.hpp", std::string(), false, false);
+                structHeader->writeIncludeDirective("string", std::string(), true, false);
+                structHeader->writeIncludeDirective("string_view", std::string(), true, false);
+            }
+        }
+        else
+        {
+            mapHeader->writeIncludeDirective("QVariant", std::string(), true, false);
+            mapHeader->writeIncludeDirective("QString", std::string(), true, false);
+
+            if(support.language == ProtocolSupport::cpp_language)
+            {
+                // In C++ these function declarations are in the class declaration
+                structHeader->writeIncludeDirective("QString", std::string(), true, false);
+                structHeader->writeIncludeDirective("QVariant", std::string(), true, false);
+            }
         }
 
         list.clear();
@@ -538,6 +737,24 @@ void ProtocolStructureModule::setupFiles(std::string moduleName,
         mapHeader->makeLineSeparator();
     }
 
+    // The JSON details may be spread across multiple files
+    if(json)
+    {
+        jsonHeader->writeIncludeDirective(structHeader->fileName());
+        jsonHeader->writeIncludeDirective(header.fileName());
+        jsonSource->writeIncludeDirective("string_view", std::string(), true, false);
+        jsonSource->writeIncludeDirective("charconv", std::string(), true, false);
+        jsonSource->writeIncludeDirective("cstring", std::string(), true, false);
+        jsonSource->writeIncludeDirective("cmath", std::string(), true, false);
+        jsonSource->writeIncludeDirective("cstdio", std::string(), true, false);
+        jsonSource->writeIncludeDirective("cstdlib", std::string(), true, false);
+
+        list.clear();
+        getJsonIncludeDirectives(list);
+        jsonHeader->writeIncludeDirectives(list);
+        jsonHeader->makeLineSeparator();
+    }
+
     // Add other includes specific to this structure
     parser->outputIncludes(getHierarchicalName(), *structHeader, e);
 
@@ -759,6 +976,23 @@ void ProtocolStructureModule::getPrintIncludeDirectives(std::vector<std::string>
 }
 
 
+/*!
+ * Return the include directives needed for this encodable's JSON functions
+ * \param list is appended with any directives this encodable requires.
+ */
+void ProtocolStructureModule::getJsonIncludeDirectives(std::vector<std::string>& list) const
+{
+    // Our header
+    if(jsonHeader != nullptr)
+        list.push_back(jsonHeader->fileName());
+
+    // And any of our children's headers
+    ProtocolStructure::getJsonIncludeDirectives(list);
+
+    removeDuplicates(list);
+}
+
+
 /*!
  * Get the string which identifies this encodable in a CAN DBC file. This is the "BO_" string and the signals that go with it.
  * \param ID is the identifier to use, with the MSB set as needed for 29-bit identifiers
@@ -858,7 +1092,8 @@ void ProtocolStructureModule::createSubStructureFunctions()
             if(structure->getNumberInMemory() > 0)
             {
                 source.makeLineSeparator();
-                source.write(structure->getSetToInitialValueFunctionBody());
+                CodeEmitter initoutput(source);
+                structure->emitSetToInitialValueFunctionBody(initoutput);
                 source.makeLineSeparator();
                 source.write(structure->getSecondSetToInitialValueFunctionBody());
             }
@@ -869,7 +1104,8 @@ void ProtocolStructureModule::createSubStructureFunctions()
             verifyHeader->write(structure->getSetToInitialValueFunctionPrototype());
 
             verifySource->makeLineSeparator();
-            verifySource->write(structure->getSetToInitialValueFunctionBody());
+            CodeEmitter initoutput(*verifySource);
+            structure->emitSetToInitialValueFunctionBody(initoutput);
         }
 
         if(encode)
@@ -879,10 +1115,16 @@ void ProtocolStructureModule::createSubStructureFunctions()
             {
                 header.makeLineSeparator();
                 header.write(structure->getEncodeFunctionPrototype());
+                header.makeLineSeparator();
+                header.write(structure->getEncodedSizeFunctionPrototype());
             }
 
             source.makeLineSeparator();
-            source.write(structure->getEncodeFunctionBody(support.bigendian));
+            CodeEmitter encodeoutput(source);
+            structure->emitEncodeFunctionBody(encodeoutput, support.bigendian);
+            source.makeLineSeparator();
+            CodeEmitter sizeoutput(source);
+            structure->emitEncodedSizeFunctionBody(sizeoutput);
         }
 
         if(decode)
@@ -892,10 +1134,16 @@ void ProtocolStructureModule::createSubStructureFunctions()
             {
                 header.makeLineSeparator();
                 header.write(structure->getDecodeFunctionPrototype());
+                header.makeLineSeparator();
+                header.write(structure->getSkipFunctionPrototype());
             }
 
             source.makeLineSeparator();
-            source.write(structure->getDecodeFunctionBody(support.bigendian));
+            CodeEmitter decodeoutput(source);
+            structure->emitDecodeFunctionBody(decodeoutput, support.bigendian);
+            source.makeLineSeparator();
+            CodeEmitter skipoutput(source);
+            structure->emitSkipFunctionBody(skipoutput);
         }
 
         if(hasVerify() && (verifyHeader != nullptr) && (verifySource != nullptr))
@@ -936,9 +1184,11 @@ void ProtocolStructureModule::createSubStructureFunctions()
             }
 
             printSource->makeLineSeparator();
-            printSource->write(structure->getTextPrintFunctionBody());
+            CodeEmitter printoutput(*printSource);
+            structure->emitTextPrintFunctionBody(printoutput);
             printSource->makeLineSeparator();
-            printSource->write(structure->getTextReadFunctionBody());
+            CodeEmitter readoutput(*printSource);
+            structure->emitTextReadFunctionBody(readoutput);
         }
 
         if(mapEncode && (mapSource != nullptr))
@@ -958,6 +1208,37 @@ void ProtocolStructureModule::createSubStructureFunctions()
             mapSource->write(structure->getMapDecodeFunctionBody());
         }
 
+        if(json && (jsonSource != nullptr))
+        {
+            // In C++ this is part of the class declaration
+            if((support.language == ProtocolSupport::c_language) && (jsonHeader != nullptr))
+            {
+                jsonHeader->makeLineSeparator();
+                jsonHeader->write(structure->getJsonEncodeFunctionPrototype());
+                jsonHeader->makeLineSeparator();
+                jsonHeader->write(structure->getJsonDecodeFunctionPrototype());
+            }
+
+            jsonSource->makeLineSeparator();
+            CodeEmitter jsonencodeoutput(*jsonSource);
+            structure->emitJsonEncodeFunctionBody(jsonencodeoutput);
+            jsonSource->makeLineSeparator();
+            CodeEmitter jsondecodeoutput(*jsonSource);
+            structure->emitJsonDecodeFunctionBody(jsondecodeoutput);
+        }
+
+        if(hash)
+        {
+            // In C++ this is part of the class declaration
+            if(support.language == ProtocolSupport::c_language)
+            {
+                header.makeLineSeparator();
+                header.write(structure->getHashFunctionPrototype());
+            }
+
+            writeHashFunction(structure->getHashFunctionBody());
+        }
+
     }// for all of our structure children
 
     source.makeLineSeparator();
@@ -986,7 +1267,8 @@ void ProtocolStructureModule::createTopLevelStructureFunctions()
         }
 
         verifySource->makeLineSeparator();
-        verifySource->write(getSetToInitialValueFunctionBody(false));
+        CodeEmitter initoutput(*verifySource);
+        emitSetToInitialValueFunctionBody(initoutput, false);
         verifySource->makeLineSeparator();
         verifySource->write(getSecondSetToInitialValueFunctionBody(false));
         verifySource->makeLineSeparator();
@@ -999,10 +1281,16 @@ void ProtocolStructureModule::createTopLevelStructureFunctions()
         {
             header.makeLineSeparator();
             header.write(getEncodeFunctionPrototype(std::string(), false));
+            header.makeLineSeparator();
+            header.write(getEncodedSizeFunctionPrototype(std::string(), false));
         }
 
         source.makeLineSeparator();
-        source.write(getEncodeFunctionBody(false));
+        CodeEmitter encodeoutput(source);
+        emitEncodeFunctionBody(encodeoutput, false);
+        source.makeLineSeparator();
+        CodeEmitter sizeoutput(source);
+        emitEncodedSizeFunctionBody(sizeoutput, false);
     }
 
     if(decode)
@@ -1012,10 +1300,16 @@ void ProtocolStructureModule::createTopLevelStructureFunctions()
         {
             header.makeLineSeparator();
             header.write(getDecodeFunctionPrototype(std::string(), false));
+            header.makeLineSeparator();
+            header.write(getSkipFunctionPrototype(std::string(), false));
         }
 
         source.makeLineSeparator();
-        source.write(getDecodeFunctionBody(false));
+        CodeEmitter decodeoutput(source);
+        emitDecodeFunctionBody(decodeoutput, false);
+        source.makeLineSeparator();
+        CodeEmitter skipoutput(source);
+        emitSkipFunctionBody(skipoutput, false);
     }
 
     header.makeLineSeparator();
@@ -1082,9 +1376,11 @@ void ProtocolStructureModule::createTopLevelStructureHelperFunctions(void)
         }
 
         printSource->makeLineSeparator();
-        printSource->write(getTextPrintFunctionBody(false));
+        CodeEmitter printoutput(*printSource);
+        emitTextPrintFunctionBody(printoutput, false);
         printSource->makeLineSeparator();
-        printSource->write(getTextReadFunctionBody(false));
+        CodeEmitter readoutput(*printSource);
+        emitTextReadFunctionBody(readoutput, false);
         printSource->makeLineSeparator();
     }
 
@@ -1107,9 +1403,316 @@ void ProtocolStructureModule::createTopLevelStructureHelperFunctions(void)
         mapSource->makeLineSeparator();
     }
 
+    if(json && (jsonSource != nullptr))
+    {
+        // In C++ this is part of the class declaration
+        if((support.language == ProtocolSupport::c_language) && (jsonHeader != nullptr))
+        {
+            jsonHeader->makeLineSeparator();
+            jsonHeader->write(getJsonEncodeFunctionPrototype(std::string(), false));
+            jsonHeader->makeLineSeparator();
+            jsonHeader->write(getJsonDecodeFunctionPrototype(std::string(), false));
+            jsonHeader->makeLineSeparator();
+        }
+
+        jsonSource->makeLineSeparator();
+        CodeEmitter jsonencodeoutput(*jsonSource);
+        emitJsonEncodeFunctionBody(jsonencodeoutput, false);
+        jsonSource->makeLineSeparator();
+        CodeEmitter jsondecodeoutput(*jsonSource);
+        emitJsonDecodeFunctionBody(jsondecodeoutput, false);
+        jsonSource->makeLineSeparator();
+    }
+
+    if(hash)
+    {
+        // In C++ this is part of the class declaration
+        if(support.language == ProtocolSupport::c_language)
+        {
+            header.makeLineSeparator();
+            header.write(getHashFunctionPrototype(std::string(), false));
+            header.makeLineSeparator();
+        }
+
+        writeHashFunction(getHashFunctionBody(false));
+    }
+
 }// ProtocolStructureModule::createTopLevelStructureFunctions
 
 
+/*!
+ * Write a hash function to the source file. The functions that the hash uses
+ * to combine fields are in the fieldhash module, which is shared by every
+ * module with a hash.
+ * \param function is the hash function to write, which may be empty
+ */
+void ProtocolStructureModule::writeHashFunction(const std::string& function)
+{
+    if(function.empty())
+        return;
+
+    source.writeIncludeDirective("fieldhash");
+
+    // memcmp() or strncmp() for the C++ equals function
+    if((function.find("memcmp(") != std::string::npos) || (function.find("strncmp(") != std::string::npos))
+        source.writeIncludeDirective("string.h", std::string(), true, false);
+
+    source.makeLineSeparator();
+    source.write(function);
+    source.makeLineSeparator();
+
+}// ProtocolStructureModule::writeHashFunction
+
+
+/*!
+ * Determine if the encode and decode of this structure can be timed by the
+ * bench module. This requires both functions, with the structure as their
+ * parameter, and the structure must not redefine another one.
+ * \return true if the bench module can time this structure
+ */
+bool ProtocolStructureModule::isBenchable(void) const
+{
+    if(isHidden() && !neverOmit && support.omitIfHidden)
+        return false;
+
+    if((redefines != nullptr) || !encode || !decode)
+        return false;
+
+    return (getNumberOfEncodeParameters() > 0) && (getNumberOfDecodeParameters() > 0);
+}
+
+
+/*!
+ * Return the include directives needed by the bench function of this structure
+ * \param list is appended with the directives.
+ */
+void ProtocolStructureModule::getBenchIncludeDirectives(std::vector<std::string>& list) const
+{
+    if(!isBenchable())
+        return;
+
+    list.push_back(structHeader->fileName());
+    list.push_back(header.fileName());
+
+    // In C the init and verify functions may be in their own module
+    if((support.language == ProtocolSupport::c_language) && (hasInit() || hasVerify()) && (verifyHeader != nullptr))
+        list.push_back(verifyHeader->fileName());
+}
+
+
+/*!
+ * Return the signature of the function that times the encode and decode of
+ * this structure. Every bench function has the same parameters, so the bench
+ * module can call them all the same way.
+ * \return the signature of the bench function
+ */
+std::string ProtocolStructureModule::getBenchFunctionSignature(void) const
+{
+    return "static void " + getBenchFunctionName() + "(" + support.pointerType + " pkt, int maxdata, uint32_t iterations, " + support.protoName + "BenchClock_t timer)";
+}
+
+
+/*!
+ * Return the function that times the encode and decode of this structure,
+ * using a buffer large enough for the maximum encoded length.
+ * \return the function, or an empty string if this structure cannot be timed
+ */
+std::string ProtocolStructureModule::getBenchFunctionBody(void) const
+{
+    if(!isBenchable())
+        return std::string();
+
+    std::string locals;
+    std::string encodecall;
+    std::string decodecall;
+
+    if(support.language == ProtocolSupport::c_language)
+    {
+        locals += TAB_IN + "static uint8_t data[getMaxLengthOf" + typeName + "() + 1];\n";
+        encodecall = "encode" + typeName + "(data, &bytecount, &user);";
+        decodecall = "decode" + typeName + "(data, &bytecount, &user);";
+    }
+    else
+    {
+        locals += TAB_IN + "std::vector<uint8_t> data(" + typeName + "::maxLength() + 1);\n";
+        encodecall = "user.encode(data.data(), &bytecount);";
+        decodecall = "user.decode(data.data(), &bytecount);";
+    }
+
+    locals += TAB_IN + "int bytecount = 0;\n";
+
+    // Each encode and decode starts from the beginning of the buffer
+    encodecall = "bytecount = 0;\n" + TAB_IN + TAB_IN + encodecall;
+    decodecall = "bytecount = 0;\n" + TAB_IN + TAB_IN + decodecall;
+
+    return createBenchFunction("structure", locals, encodecall, decodecall, "bytecount", std::string(), std::string());
+
+}// ProtocolStructureModule::getBenchFunctionBody
+
+
+/*!
+ * Create the function that times the encode and decode of this structure.
+ * The structure is set to its initial values and constrained by its verify
+ * limits, then timed. If the structure has variable length content it is
+ * timed again with that content at its maximum length.
+ * \param kind is the kind of structure for the comment, like "packet".
+ * \param locals declares any local variables the calls need.
+ * \param encodecall is the statement that encodes the structure in "user".
+ * \param decodecall is the statement that decodes the structure into "user".
+ * \param length is the expression which gives the number of encoded bytes.
+ * \param minlength is the expression which gives the minimum encoded length,
+ *        if not empty it is compared to "maxdata" to skip the timing.
+ * \param maxlength is the expression which gives the maximum encoded length,
+ *        if not empty it is compared to "maxdata" to skip the maximum timing.
+ * \return the bench function
+ */
+std::string ProtocolStructureModule::createBenchFunction(const std::string& kind, const std::string& locals, const std::string& encodecall, const std::string& decodecall, const std::string& length, const std::string& minlength, const std::string& maxlength) const
+{
+    CodeEmitter output;
+    std::string print = toUpper(support.protoName + "Bench") + "_PRINTF";
+    std::string report = "report" + support.protoName + "Bench";
+    std::string maximum = getSetToMaximumLengthString(TAB_IN, "user.");
+
+    // The timing loops, which are the same for both variants
+    std::string timing;
+    timing += TAB_IN + "start = timer();\n";
+    timing += TAB_IN + "for(i = 0; i < iterations; i++)\n";
+    timing += TAB_IN + "{\n";
+    timing += TAB_IN + TAB_IN + encodecall + "\n";
+    timing += TAB_IN + "}\n";
+    timing += TAB_IN + "encodetime = timer() - start;\n";
+    timing += "\n";
+    timing += TAB_IN + "start = timer();\n";
+    timing += TAB_IN + "for(i = 0; i < iterations; i++)\n";
+    timing += TAB_IN + "{\n";
+    timing += TAB_IN + TAB_IN + decodecall + "\n";
+    timing += TAB_IN + "}\n";
+    timing += TAB_IN + "decodetime = timer() - start;\n";
+    timing += "\n";
+
+    output.append("/*!\n");
+    output.append(" * Time the encode and decode of the ", name, " ", kind, "\n");
+    output.append(" * \\param pkt is the packet used for encoding and decoding packets.\n");
+    output.append(" * \\param maxdata is the number of data bytes that pkt can hold.\n");
+    output.append(" * \\param iterations is the number of times to encode and decode.\n");
+    output.append(" * \\param timer returns the time in nanoseconds.\n");
+    output.append(" */\n");
+    output.append(getBenchFunctionSignature(), "\n");
+    output.append("{\n");
+
+    if(support.language == ProtocolSupport::c_language)
+        output.append(TAB_IN, structName, " user;\n");
+    else
+        output.append(TAB_IN, typeName, " user;\n");
+
+    output.append(locals);
+    output.append(TAB_IN, "uint64_t start, encodetime, decodetime;\n");
+    output.append(TAB_IN, "uint32_t i;\n");
+    output.append("\n");
+
+    if(minlength.empty())
+        output.append(TAB_IN, "(void)pkt;\n", TAB_IN, "(void)maxdata;\n\n");
+    else
+    {
+        output.append(TAB_IN, "if(", minlength, " > maxdata)\n");
+        output.append(TAB_IN, "{\n");
+        output.append(TAB_IN, TAB_IN, print, "(\"%-40s does not fit in the packet\\n\", \"", name, "\");\n");
+        output.append(TAB_IN, TAB_IN, "return;\n");
+        output.append(TAB_IN, "}\n");
+        output.append("\n");
+    }
+
+    if(support.language == ProtocolSupport::c_language)
+    {
+        output.append(TAB_IN, "// Start from the initial values, constrained by the verify limits\n");
+        output.append(TAB_IN, "memset(&user, 0, sizeof(user));\n");
+
+        if(hasInit())
+            output.append(TAB_IN, "init", typeName, "(&user);\n");
+
+        if(hasVerify())
+            output.append(TAB_IN, "verify", typeName, "(&user);\n");
+    }
+    else
+    {
+        output.append(TAB_IN, "// The constructor set the initial values, constrain them by the verify limits\n");
+
+        if(isNoInit())
+            output.append(TAB_IN, "user.initialize();\n");
+
+        if(hasVerify())
+            output.append(TAB_IN, "user.verify();\n");
+    }
+
+    output.append("\n");
+    output.append(timing);
+    output.append(TAB_IN, report, "(\"", name, "\", iterations, encodetime, decodetime, ", length, ");\n");
+
+    // In C++ the bench can also time the text and JSON representations of the same contents
+    if((support.language == ProtocolSupport::cpp_language) && this->print && json && (redefines == nullptr))
+    {
+        output.append("\n");
+        output.append(TAB_IN, "// The same contents as text, and as JSON, which do not need the packet\n");
+        output.append(TAB_IN, "{\n");
+        output.append(TAB_IN, TAB_IN, "std::string text = user.textPrint(std::string());\n");
+        output.append(TAB_IN, TAB_IN, "std::vector<char> json((std::size_t)user.jsonEncode(nullptr, 0) + 1);\n");
+        output.append(TAB_IN, TAB_IN, "int jsonlength = 0;\n");
+        output.append("\n");
+        output.append(TAB_IN, TAB_IN, "start = timer();\n");
+        output.append(TAB_IN, TAB_IN, "for(i = 0; i < iterations; i++)\n");
+        output.append(TAB_IN, TAB_IN, TAB_IN, "text = user.textPrint(std::string());\n");
+        output.append(TAB_IN, TAB_IN, "encodetime = timer() - start;\n");
+        output.append("\n");
+        output.append(TAB_IN, TAB_IN, "start = timer();\n");
+        output.append(TAB_IN, TAB_IN, "for(i = 0; i < iterations; i++)\n");
+        output.append(TAB_IN, TAB_IN, TAB_IN, "user.textRead(std::string(), text);\n");
+        output.append(TAB_IN, TAB_IN, "decodetime = timer() - start;\n");
+        output.append("\n");
+        output.append(TAB_IN, TAB_IN, report, "(\"", name, " (text)\", iterations, encodetime, decodetime, (int)text.size());\n");
+        output.append("\n");
+        output.append(TAB_IN, TAB_IN, "start = timer();\n");
+        output.append(TAB_IN, TAB_IN, "for(i = 0; i < iterations; i++)\n");
+        output.append(TAB_IN, TAB_IN, TAB_IN, "jsonlength = user.jsonEncode(json.data(), (int)json.size());\n");
+        output.append(TAB_IN, TAB_IN, "encodetime = timer() - start;\n");
+        output.append("\n");
+        output.append(TAB_IN, TAB_IN, "start = timer();\n");
+        output.append(TAB_IN, TAB_IN, "for(i = 0; i < iterations; i++)\n");
+        output.append(TAB_IN, TAB_IN, TAB_IN, "user.jsonDecode(json.data(), jsonlength);\n");
+        output.append(TAB_IN, TAB_IN, "decodetime = timer() - start;\n");
+        output.append("\n");
+        output.append(TAB_IN, TAB_IN, report, "(\"", name, " (json)\", iterations, encodetime, decodetime, jsonlength);\n");
+        output.append(TAB_IN, "}\n");
+    }
+
+    if(!maximum.empty())
+    {
+        output.append("\n");
+
+        if(!maxlength.empty())
+        {
+            output.append(TAB_IN, "if(", maxlength, " > maxdata)\n");
+            output.append(TAB_IN, "{\n");
+            output.append(TAB_IN, TAB_IN, print, "(\"%-40s does not fit in the packet\\n\", \"", name, " (max)\");\n");
+            output.append(TAB_IN, TAB_IN, "return;\n");
+            output.append(TAB_IN, "}\n");
+            output.append("\n");
+        }
+
+        output.append(TAB_IN, "// Every variable length array full and every optional field present\n");
+        output.append(maximum);
+        output.append("\n");
+        output.append(timing);
+        output.append(TAB_IN, report, "(\"", name, " (max)\", iterations, encodetime, decodetime, ", length, ");\n");
+    }
+
+    output.append("\n");
+    output.append("}// ", getBenchFunctionName(), "\n");
+
+    return output.take();
+
+}// ProtocolStructureModule::createBenchFunction
+
+
 //! Get the text used to print a formatted string function
 std::string ProtocolStructureModule::getToFormattedStringFunction(void)
 {
@@ -1137,55 +1740,956 @@ std::string to_formatted_string(double number, int precision)
 }// ProtocolStructureModule::getToFormattedStringFunction
 
 
-//! Get the text used to extract text for text read functions
-std::string ProtocolStructureModule::getExtractTextFunction(void)
+//! Get the text used to append numbers for text print functions
+std::string ProtocolStructureModule::getAppendTextFunction(void)
 {
-    return R"(//! Extract text that is identified by a key
-static std::string extractText(const std::string& key, const std::string& source, int* fieldcount);
+    // The helpers are marked maybe_unused because a module may not need all of them
+    return R"(//! Append a signed integer to a string
+[[maybe_unused]] static void appendSigned(std::string& report, long long value);
+
+//! Append an unsigned integer to a string
+[[maybe_unused]] static void appendUnsigned(std::string& report, unsigned long long value);
+
+//! Append a floating point number to a string with a specific number of significant digits
+[[maybe_unused]] static void appendDouble(std::string& report, double value, int precision);
 
 /*!
- * Extract text that is identified by a key
- * \param key is the key, the text to extract follows the key and is on the same line
- * \param source is the source information to find the key in
- * \param fieldcount is incremented whenever the key is found in the source
- * \return the extracted text, which may be empty
+ * Append a signed integer to a string, in decimal
+ * \param report receives the text of the integer
+ * \param value is the integer to append
  */
-std::string extractText(const std::string& key, const std::string& source, int* fieldcount)
+void appendSigned(std::string& report, long long value)
 {
-    std::string text;
+    char text[32];
+    report.append(text, std::to_chars(text, text + sizeof(text), value).ptr);
 
-    // All fields follow the key with " '". Use that as part of the search; to
-    // prevent detecting shorter keys that are repeated within longer keys
-    std::string::size_type index = source.find(key + " '");
+}// appendSigned
 
-    if(index < source.size())
-    {
-        // This is the location of the first character after the key
-        std::string::size_type first = index + key.size() + 2;
 
-        // The location of the next linefeed after the key
-        std::string::size_type linefeed = source.find("\n", first);
+/*!
+ * Append an unsigned integer to a string, in decimal
+ * \param report receives the text of the integer
+ * \param value is the integer to append
+ */
+void appendUnsigned(std::string& report, unsigned long long value)
+{
+    char text[32];
+    report.append(text, std::to_chars(text, text + sizeof(text), value).ptr);
 
-        // This is how many characters until we get to the linefeed
-        if((linefeed > first) && (linefeed < source.size()))
-        {
-            // This is the number of characters to remove
-            std::string::size_type length = linefeed - first;
+}// appendUnsigned
 
-            // Increment our field count
-            (*fieldcount)++;
 
-            // Extract the text between the key and the linefeed
-            text = source.substr(first, length);
+/*!
+ * Append a floating point number to a string with a specific number of
+ * significant digits, which is the same as printf's "%.*g". Floating point
+ * std::to_chars() is not in every C++17 library, so snprintf() is used if it
+ * is missing
+ * \param report receives the text of the number
+ * \param value is the number to append
+ * \param precision is the number of significant digits
+ */
+void appendDouble(std::string& report, double value, int precision)
+{
+    char text[64];
+    #ifdef __cpp_lib_to_chars
+    report.append(text, std::to_chars(text, text + sizeof(text), value, std::chars_format::general, precision).ptr);
+    #else
+    report.append(text, (std::size_t)std::snprintf(text, sizeof(text), "%.*g", precision, value));
+    #endif
 
-            // Remove the last "'" from the string
-            if((text.size() > 0) && (text.back() == '\''))
-                text.erase(text.size()-1, 1);
-        }
-    }
+}// appendDouble)";
 
-    return text;
+}// ProtocolStructureModule::getAppendTextFunction
 
-}// extractText)";
 
-}// ProtocolStructureModule::getExtractTextFunction
+//! Get the text used to index and extract text for text read functions
+std::string ProtocolStructureModule::getExtractTextFunction(void)
+{
+    // The helpers are marked maybe_unused because a module may not need all of them
+    return R"(//! Index the keys of a text source
+[[maybe_unused]] static std::unordered_map<std::string_view, std::string_view> indexText(const std::string& source);
+
+//! Extract text that is identified by a key
+[[maybe_unused]] static std::string_view extractText(std::string_view key, const std::unordered_map<std::string_view, std::string_view>& index, int* fieldcount);
+
+//! Convert text to a signed integer
+[[maybe_unused]] static bool textToSigned(std::string_view text, long long* value);
+
+//! Convert text to an unsigned integer
+[[maybe_unused]] static bool textToUnsigned(std::string_view text, unsigned long long* value);
+
+//! Convert text to a floating point number
+[[maybe_unused]] static bool textToDouble(std::string_view text, double* value);
+
+//! Copy text to a null terminated string
+[[maybe_unused]] static void textToString(std::string_view text, char* string, int maxLength);
+
+/*!
+ * Index the keys of a text source in a single pass, so that reading every
+ * field of the source does not require a search of the entire source.
+ * \param source is the source information, each line of which is a key
+ *        followed by " '", the text, and "'".
+ * \return the index of each key to its text; the index refers to source,
+ *         which must outlive it. If a key is repeated the first one is used.
+ */
+std::unordered_map<std::string_view, std::string_view> indexText(const std::string& source)
+{
+    std::unordered_map<std::string_view, std::string_view> index;
+    std::string_view text(source);
+
+    while(!text.empty())
+    {
+        // The location of the next linefeed, or the end of the source
+        std::string_view::size_type linefeed = text.find('\n');
+        std::string_view line = text.substr(0, linefeed);
+
+        if(linefeed < text.size())
+            text.remove_prefix(linefeed + 1);
+        else
+            text = std::string_view();
+
+        // All fields follow the key with " '"
+        std::string_view::size_type separator = line.find(" '");
+        if(separator >= line.size())
+            continue;
+
+        std::string_view value = line.substr(separator + 2);
+
+        // Remove the last "'" from the text
+        if(!value.empty() && (value.back() == '\''))
+            value.remove_suffix(1);
+
+        index.emplace(line.substr(0, separator), value);
+    }
+
+    return index;
+
+}// indexText
+
+
+/*!
+ * Extract text that is identified by a key
+ * \param key is the key to look up
+ * \param index is the index of the source information, from indexText()
+ * \param fieldcount is incremented whenever the key is found in the index
+ * \return the extracted text, which may be empty
+ */
+std::string_view extractText(std::string_view key, const std::unordered_map<std::string_view, std::string_view>& index, int* fieldcount)
+{
+    std::unordered_map<std::string_view, std::string_view>::const_iterator it = index.find(key);
+
+    if(it == index.end())
+        return std::string_view();
+
+    // Increment our field count
+    (*fieldcount)++;
+
+    return it->second;
+
+}// extractText
+
+
+/*!
+ * Convert text to a signed integer. As with strtoll() and a base of 0 the text
+ * is decimal, hexadecimal if it starts with "0x", or octal if it starts with "0"
+ * \param text is the text to convert
+ * \param value receives the integer if the conversion succeeds
+ * \return true if the text started with an integer
+ */
+bool textToSigned(std::string_view text, long long* value)
+{
+    unsigned long long magnitude = 0;
+    bool negative = !text.empty() && (text.front() == '-');
+
+    if(negative)
+        text.remove_prefix(1);
+
+    if(!textToUnsigned(text, &magnitude))
+        return false;
+
+    if(negative)
+    {
+        if(magnitude > 9223372036854775808ull)
+            return false;
+
+        // Negate without overflow, the magnitude may be one more than the largest value
+        *value = (magnitude == 0) ? 0 : -(long long)(magnitude - 1) - 1;
+    }
+    else
+    {
+        if(magnitude > 9223372036854775807ull)
+            return false;
+
+        *value = (long long)magnitude;
+    }
+
+    return true;
+
+}// textToSigned
+
+
+/*!
+ * Convert text to an unsigned integer. As with strtoull() and a base of 0 the
+ * text is decimal, hexadecimal if it starts with "0x", or octal if it starts with "0"
+ * \param text is the text to convert
+ * \param value receives the integer if the conversion succeeds
+ * \return true if the text started with an integer
+ */
+bool textToUnsigned(std::string_view text, unsigned long long* value)
+{
+    int base = 10;
+
+    if(!text.empty() && (text.front() == '+'))
+        text.remove_prefix(1);
+
+    if((text.size() > 2) && (text[0] == '0') && ((text[1] == 'x') || (text[1] == 'X')))
+    {
+        text.remove_prefix(2);
+        base = 16;
+    }
+    else if((text.size() > 1) && (text[0] == '0'))
+        base = 8;
+
+    return (std::from_chars(text.data(), text.data() + text.size(), *value, base).ec == std::errc());
+
+}// textToUnsigned
+
+
+/*!
+ * Convert text to a floating point number. Floating point std::from_chars()
+ * is not in every C++17 library, so strtod() is used if it is missing
+ * \param text is the text to convert
+ * \param value receives the number if the conversion succeeds
+ * \return true if the text started with a number
+ */
+bool textToDouble(std::string_view text, double* value)
+{
+    if(!text.empty() && (text.front() == '+'))
+        text.remove_prefix(1);
+
+    #ifdef __cpp_lib_to_chars
+    return (std::from_chars(text.data(), text.data() + text.size(), *value).ec == std::errc());
+    #else
+    // strtod() needs a terminated string
+    std::string terminated(text);
+    char* end = nullptr;
+    double number = std::strtod(terminated.c_str(), &end);
+
+    if(end == terminated.c_str())
+        return false;
+
+    *value = number;
+    return true;
+    #endif
+
+}// textToDouble
+
+
+/*!
+ * Copy text to a string whose maximum length (with null terminator) is
+ * `maxLength`, like pgstrncpy(). The string is always null terminated.
+ * \param text is the text to copy, which may be empty
+ * \param string receives the text
+ * \param maxLength is the size of the `string` buffer
+ */
+void textToString(std::string_view text, char* string, int maxLength)
+{
+    if(maxLength <= 0)
+        return;
+
+    if(text.size() >= (std::size_t)maxLength)
+        text = text.substr(0, maxLength - 1);
+
+    string[text.copy(string, text.size())] = '\0';
+
+}// textToString)";
+
+}// ProtocolStructureModule::getExtractTextFunction
+
+
+//! Get the text used to write JSON text for JSON encode functions
+std::string ProtocolStructureModule::getJsonWriteFunction(void)
+{
+    // The helpers are marked maybe_unused because a module may not need all of them
+    return R"(//! Write text to a JSON buffer
+[[maybe_unused]] static void jsonText(char* json, int size, int* index, std::string_view text);
+
+//! Write a key and a signed integer to a JSON buffer
+[[maybe_unused]] static void jsonSigned(char* json, int size, int* index, std::string_view key, long long value);
+
+//! Write a key and an unsigned integer to a JSON buffer
+[[maybe_unused]] static void jsonUnsigned(char* json, int size, int* index, std::string_view key, unsigned long long value);
+
+//! Write a key and a double precision number to a JSON buffer
+[[maybe_unused]] static void jsonDouble(char* json, int size, int* index, std::string_view key, double value);
+
+//! Write a key and a single precision number to a JSON buffer
+[[maybe_unused]] static void jsonFloat(char* json, int size, int* index, std::string_view key, float value);
+
+//! Write a key and a boolean to a JSON buffer
+[[maybe_unused]] static void jsonBool(char* json, int size, int* index, std::string_view key, bool value);
+
+//! Write a key and a string to a JSON buffer
+[[maybe_unused]] static void jsonString(char* json, int size, int* index, std::string_view key, const char* value, int max);
+
+/*!
+ * Write text to a JSON buffer. Only the text that fits is written, but all of
+ * it is counted, so the caller can learn the size needed.
+ * \param json is the buffer to write
+ * \param size is the number of bytes json can hold
+ * \param index is the location in json to write, which is advanced by the
+ *        length of the text.
+ * \param text is the text to write
+ */
+void jsonText(char* json, int size, int* index, std::string_view text)
+{
+    int length = (int)text.size();
+
+    if(*index + length <= size)
+        memcpy(json + *index, text.data(), length);
+    else if(*index < size)
+        memcpy(json + *index, text.data(), size - *index);
+
+    (*index) += length;
+
+}// jsonText
+
+
+/*!
+ * Write a key and a number to a JSON buffer. The number is formatted directly
+ * into the buffer if it fits; numbers are formatted with the shortest text
+ * that reads back to the same value.
+ * \param json is the buffer to write
+ * \param size is the number of bytes json can hold
+ * \param index is the location in json to write, which is advanced
+ * \param key is the text that precedes the number
+ * \param value is the number to write
+ */
+template<typename T> static void jsonNumber(char* json, int size, int* index, std::string_view key, T value)
+{
+    char text[32];
+
+    jsonText(json, size, index, key);
+
+    if(*index < size)
+    {
+        std::to_chars_result result = std::to_chars(json + *index, json + size, value);
+
+        if(result.ec == std::errc())
+        {
+            *index = (int)(result.ptr - json);
+            return;
+        }
+    }
+
+    // Does not fit, but it still must be counted
+    jsonText(json, size, index, std::string_view(text, std::to_chars(text, text + sizeof(text), value).ptr - text));
+
+}// jsonNumber
+
+
+/*!
+ * Write a key and a signed integer to a JSON buffer
+ * \param json is the buffer to write
+ * \param size is the number of bytes json can hold
+ * \param index is the location in json to write, which is advanced
+ * \param key is the text that precedes the number
+ * \param value is the number to write
+ */
+void jsonSigned(char* json, int size, int* index, std::string_view key, long long value)
+{
+    jsonNumber(json, size, index, key, value);
+
+}// jsonSigned
+
+
+/*!
+ * Write a key and an unsigned integer to a JSON buffer
+ * \param json is the buffer to write
+ * \param size is the number of bytes json can hold
+ * \param index is the location in json to write, which is advanced
+ * \param key is the text that precedes the number
+ * \param value is the number to write
+ */
+void jsonUnsigned(char* json, int size, int* index, std::string_view key, unsigned long long value)
+{
+    jsonNumber(json, size, index, key, value);
+
+}// jsonUnsigned
+
+
+/*!
+ * Write a key and a double precision number to a JSON buffer. JSON cannot
+ * represent infinity or NaN, so those are written as null. Floating point
+ * std::to_chars() is not in every C++17 library, so snprintf() is used if it
+ * is missing.
+ * \param json is the buffer to write
+ * \param size is the number of bytes json can hold
+ * \param index is the location in json to write, which is advanced
+ * \param key is the text that precedes the number
+ * \param value is the number to write
+ */
+void jsonDouble(char* json, int size, int* index, std::string_view key, double value)
+{
+    if(std::isfinite(value))
+    {
+        #ifdef __cpp_lib_to_chars
+        jsonNumber(json, size, index, key, value);
+        #else
+        char text[32];
+        jsonText(json, size, index, key);
+        jsonText(json, size, index, std::string_view(text, (std::size_t)std::snprintf(text, sizeof(text), "%.17g", value)));
+        #endif
+    }
+    else
+    {
+        jsonText(json, size, index, key);
+        jsonText(json, size, index, "null");
+    }
+
+}// jsonDouble
+
+
+/*!
+ * Write a key and a single precision number to a JSON buffer, with the
+ * shortest text that reads back to the same single precision value. JSON
+ * cannot represent infinity or NaN, so those are written as null. If floating
+ * point std::to_chars() is missing snprintf() is used, with 9 digits.
+ * \param json is the buffer to write
+ * \param size is the number of bytes json can hold
+ * \param index is the location in json to write, which is advanced
+ * \param key is the text that precedes the number
+ * \param value is the number to write
+ */
+void jsonFloat(char* json, int size, int* index, std::string_view key, float value)
+{
+    if(std::isfinite(value))
+    {
+        #ifdef __cpp_lib_to_chars
+        jsonNumber(json, size, index, key, value);
+        #else
+        char text[32];
+        jsonText(json, size, index, key);
+        jsonText(json, size, index, std::string_view(text, (std::size_t)std::snprintf(text, sizeof(text), "%.9g", (double)value)));
+        #endif
+    }
+    else
+    {
+        jsonText(json, size, index, key);
+        jsonText(json, size, index, "null");
+    }
+
+}// jsonFloat
+
+
+/*!
+ * Write a key and a boolean to a JSON buffer
+ * \param json is the buffer to write
+ * \param size is the number of bytes json can hold
+ * \param index is the location in json to write, which is advanced
+ * \param key is the text that precedes the boolean
+ * \param value is the boolean to write
+ */
+void jsonBool(char* json, int size, int* index, std::string_view key, bool value)
+{
+    jsonText(json, size, index, key);
+    jsonText(json, size, index, value ? "true" : "false");
+
+}// jsonBool
+
+
+/*!
+ * Write a key and a string to a JSON buffer, escaping the quote, the reverse
+ * solidus, and the control characters
+ * \param json is the buffer to write
+ * \param size is the number of bytes json can hold
+ * \param index is the location in json to write, which is advanced
+ * \param key is the text that precedes the string
+ * \param value is the null terminated string to write
+ * \param max is the maximum number of characters of value
+ */
+void jsonString(char* json, int size, int* index, std::string_view key, const char* value, int max)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    jsonText(json, size, index, key);
+    jsonText(json, size, index, "\"");
+
+    for(int i = 0; (i < max) && (value[i] != '\0'); i++)
+    {
+        unsigned char c = (unsigned char)value[i];
+        char escape[6] = {'\\', (char)c, '0', '0', hex[c >> 4], hex[c & 0x0F]};
+
+        if((c == '"') || (c == '\\'))
+            jsonText(json, size, index, std::string_view(escape, 2));
+        else if(c < 0x20)
+        {
+            escape[1] = 'u';
+            jsonText(json, size, index, std::string_view(escape, 6));
+        }
+        else
+        {
+            if(*index < size)
+                json[*index] = (char)c;
+
+            (*index)++;
+        }
+    }
+
+    jsonText(json, size, index, "\"");
+
+}// jsonString)";
+
+}// ProtocolStructureModule::getJsonWriteFunction
+
+
+//! Get the text used to parse JSON text for JSON decode functions
+std::string ProtocolStructureModule::getJsonReadFunction(void)
+{
+    // The helpers are marked maybe_unused because a module may not need all of them
+    return R"(//! Open a JSON object or array
+[[maybe_unused]] static bool jsonBegin(const char* json, int length, int* index, char open);
+
+//! Determine if a JSON object or array has another member
+[[maybe_unused]] static int jsonNext(const char* json, int length, int* index, unsigned count, char close);
+
+//! Read the key of a member of a JSON object
+[[maybe_unused]] static bool jsonKey(const char* json, int length, int* index, std::string_view* key);
+
+//! Read a JSON value as a signed integer
+[[maybe_unused]] static bool jsonToSigned(const char* json, int length, int* index, long long* value);
+
+//! Read a JSON value as an unsigned integer
+[[maybe_unused]] static bool jsonToUnsigned(const char* json, int length, int* index, unsigned long long* value);
+
+//! Read a JSON value as a floating point number
+[[maybe_unused]] static bool jsonToDouble(const char* json, int length, int* index, double* value);
+
+//! Read a JSON string
+[[maybe_unused]] static bool jsonToString(const char* json, int length, int* index, char* value, int size);
+
+//! Skip any JSON value
+[[maybe_unused]] static bool jsonSkip(const char* json, int length, int* index, int depth = 0);
+
+/*!
+ * Skip the white space of JSON text
+ * \param json is the JSON text
+ * \param length is the number of characters of json
+ * \param index is the location in json, which is advanced past the white space
+ */
+static void jsonSpace(const char* json, int length, int* index)
+{
+    while((*index < length) && ((json[*index] == ' ') || (json[*index] == '\t') || (json[*index] == '\n') || (json[*index] == '\r')))
+        (*index)++;
+
+}// jsonSpace
+
+
+/*!
+ * Read a quoted JSON string, without changing any escapes
+ * \param json is the JSON text
+ * \param length is the number of characters of json
+ * \param index is the location of the opening quote, which is advanced past
+ *        the closing quote.
+ * \param text receives the characters between the quotes
+ * \return true if the string was read
+ */
+static bool jsonQuoted(const char* json, int length, int* index, std::string_view* text)
+{
+    if((*index >= length) || (json[*index] != '"'))
+        return false;
+
+    int start = ++(*index);
+
+    while(*index < length)
+    {
+        if(json[*index] == '"')
+        {
+            *text = std::string_view(json + start, *index - start);
+            (*index)++;
+            return true;
+        }
+
+        // The escaped character cannot end the string
+        if(json[*index] == '\\')
+            (*index)++;
+
+        (*index)++;
+    }
+
+    return false;
+
+}// jsonQuoted
+
+
+/*!
+ * Read a JSON number or literal (true, false, null)
+ * \param json is the JSON text
+ * \param length is the number of characters of json
+ * \param index is the location in json, which is advanced past the token
+ * \return the token, which is empty if there is not one
+ */
+static std::string_view jsonToken(const char* json, int length, int* index)
+{
+    jsonSpace(json, length, index);
+
+    int start = *index;
+
+    while((*index < length) && (strchr(",}] \t\r\n", json[*index]) == nullptr))
+        (*index)++;
+
+    return std::string_view(json + start, *index - start);
+
+}// jsonToken
+
+
+/*!
+ * Open a JSON object or array
+ * \param json is the JSON text
+ * \param length is the number of characters of json
+ * \param index is the location in json, which is advanced past the opening
+ * \param open is the character that opens the object or array
+ * \return true if the object or array was opened
+ */
+bool jsonBegin(const char* json, int length, int* index, char open)
+{
+    jsonSpace(json, length, index);
+
+    if((*index >= length) || (json[*index] != open))
+        return false;
+
+    (*index)++;
+    return true;
+
+}// jsonBegin
+
+
+/*!
+ * Determine if a JSON object or array has another member, consuming the comma
+ * that separates the members, or the character that closes the object or array
+ * \param json is the JSON text
+ * \param length is the number of characters of json
+ * \param index is the location in json, which is advanced
+ * \param count is the number of members already read
+ * \param close is the character that closes the object or array
+ * \return 1 if there is another member, 0 if the object or array was closed,
+ *         or -1 if the JSON text is not valid.
+ */
+int jsonNext(const char* json, int length, int* index, unsigned count, char close)
+{
+    jsonSpace(json, length, index);
+
+    if(*index >= length)
+        return -1;
+
+    if(json[*index] == close)
+    {
+        (*index)++;
+        return 0;
+    }
+
+    if(count == 0)
+        return 1;
+
+    if(json[*index] != ',')
+        return -1;
+
+    (*index)++;
+    return 1;
+
+}// jsonNext
+
+
+/*!
+ * Read the key of a member of a JSON object, and the colon that follows it
+ * \param json is the JSON text
+ * \param length is the number of characters of json
+ * \param index is the location in json, which is advanced to the value
+ * \param key receives the key, which refers to json
+ * \return true if the key was read
+ */
+bool jsonKey(const char* json, int length, int* index, std::string_view* key)
+{
+    jsonSpace(json, length, index);
+
+    if(!jsonQuoted(json, length, index, key))
+        return false;
+
+    jsonSpace(json, length, index);
+
+    if((*index >= length) || (json[*index] != ':'))
+        return false;
+
+    (*index)++;
+    return true;
+
+}// jsonKey
+
+
+/*!
+ * Convert a JSON token to a floating point number, with strtod() if floating
+ * point std::from_chars() is missing
+ * \param token is the text to convert
+ * \param value receives the number if the conversion succeeds
+ * \return true if the whole token was converted
+ */
+static bool jsonTokenToDouble(std::string_view token, double* value)
+{
+    if(token == "true")
+        *value = 1;
+    else if(token == "false")
+        *value = 0;
+    else if(token == "null")
+        *value = NAN;
+    else
+    {
+        #ifdef __cpp_lib_to_chars
+        std::from_chars_result result = std::from_chars(token.data(), token.data() + token.size(), *value);
+        return (result.ec == std::errc()) && (result.ptr == token.data() + token.size());
+        #else
+        // strtod() needs a terminated string
+        std::string terminated(token);
+        char* end = nullptr;
+
+        *value = std::strtod(terminated.c_str(), &end);
+        return !terminated.empty() && (end == terminated.c_str() + terminated.size());
+        #endif
+    }
+
+    return true;
+
+}// jsonTokenToDouble
+
+
+/*!
+ * Read a JSON value as a signed integer. Numbers with a fraction or exponent
+ * are truncated, and true or false are 1 or 0.
+ * \param json is the JSON text
+ * \param length is the number of characters of json
+ * \param index is the location in json, which is advanced past the value
+ * \param value receives the integer if the conversion succeeds
+ * \return true if the value was read
+ */
+bool jsonToSigned(const char* json, int length, int* index, long long* value)
+{
+    std::string_view token = jsonToken(json, length, index);
+    double number = 0;
+
+    std::from_chars_result result = std::from_chars(token.data(), token.data() + token.size(), *value);
+    if((result.ec == std::errc()) && (result.ptr == token.data() + token.size()))
+        return true;
+
+    if(!jsonTokenToDouble(token, &number) || !(std::fabs(number) < 9.2e18))
+        return false;
+
+    *value = (long long)number;
+    return true;
+
+}// jsonToSigned
+
+
+/*!
+ * Read a JSON value as an unsigned integer. Numbers with a fraction or
+ * exponent are truncated, and true or false are 1 or 0.
+ * \param json is the JSON text
+ * \param length is the number of characters of json
+ * \param index is the location in json, which is advanced past the value
+ * \param value receives the integer if the conversion succeeds
+ * \return true if the value was read
+ */
+bool jsonToUnsigned(const char* json, int length, int* index, unsigned long long* value)
+{
+    std::string_view token = jsonToken(json, length, index);
+    double number = 0;
+
+    std::from_chars_result result = std::from_chars(token.data(), token.data() + token.size(), *value);
+    if((result.ec == std::errc()) && (result.ptr == token.data() + token.size()))
+        return true;
+
+    if(!jsonTokenToDouble(token, &number) || !((number > -1.0) && (number < 1.8e19)))
+        return false;
+
+    *value = (unsigned long long)number;
+    return true;
+
+}// jsonToUnsigned
+
+
+/*!
+ * Read a JSON value as a floating point number, null is NaN, and true or
+ * false are 1 or 0.
+ * \param json is the JSON text
+ * \param length is the number of characters of json
+ * \param index is the location in json, which is advanced past the value
+ * \param value receives the number if the conversion succeeds
+ * \return true if the value was read
+ */
+bool jsonToDouble(const char* json, int length, int* index, double* value)
+{
+    return jsonTokenToDouble(jsonToken(json, length, index), value);
+
+}// jsonToDouble
+
+
+/*!
+ * Read four hexadecimal digits of a JSON unicode escape
+ * \param text is the text of the digits
+ * \param code receives the code unit
+ * \return true if the digits were read
+ */
+static bool jsonHex(std::string_view text, unsigned* code)
+{
+    return (text.size() >= 4) && (std::from_chars(text.data(), text.data() + 4, *code, 16).ptr == text.data() + 4);
+
+}// jsonHex
+
+
+/*!
+ * Read a JSON string, resolving the escapes. Unicode escapes are converted to
+ * UTF-8. The string is truncated if it does not fit.
+ * \param json is the JSON text
+ * \param length is the number of characters of json
+ * \param index is the location in json, which is advanced past the string
+ * \param value receives the null terminated string
+ * \param size is the number of bytes that value can hold, including the terminator
+ * \return true if the string was read
+ */
+bool jsonToString(const char* json, int length, int* index, char* value, int size)
+{
+    std::string_view text;
+    char utf8[4];
+    int count = 0;
+
+    jsonSpace(json, length, index);
+
+    if(!jsonQuoted(json, length, index, &text) || (size <= 0))
+        return false;
+
+    for(std::size_t i = 0; i < text.size(); i++)
+    {
+        unsigned code = (unsigned char)text[i];
+        bool unicode = false;
+        int bytes = 1;
+
+        if((code == '\\') && (i + 1 < text.size()))
+        {
+            code = (unsigned char)text[++i];
+
+            if(code == 'b')
+                code = '\b';
+            else if(code == 'f')
+                code = '\f';
+            else if(code == 'n')
+                code = '\n';
+            else if(code == 'r')
+                code = '\r';
+            else if(code == 't')
+                code = '\t';
+            else if(code == 'u')
+            {
+                if(!jsonHex(text.substr(i + 1), &code))
+                    return false;
+
+                unicode = true;
+                i += 4;
+
+                // A surrogate pair is one code point
+                unsigned low = 0;
+                if((code >= 0xD800) && (code < 0xDC00) && (text.substr(i + 1, 2) == "\\u") && jsonHex(text.substr(i + 3), &low) && (low >= 0xDC00) && (low < 0xE000))
+                {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+            }
+        }
+
+        // Characters that are not unicode escapes are already UTF-8
+        if(!unicode || (code < 0x80))
+            utf8[0] = (char)code;
+        else if(code < 0x800)
+        {
+            utf8[0] = (char)(0xC0 | (code >> 6));
+            utf8[1] = (char)(0x80 | (code & 0x3F));
+            bytes = 2;
+        }
+        else if(code < 0x10000)
+        {
+            utf8[0] = (char)(0xE0 | (code >> 12));
+            utf8[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+            utf8[2] = (char)(0x80 | (code & 0x3F));
+            bytes = 3;
+        }
+        else
+        {
+            utf8[0] = (char)(0xF0 | (code >> 18));
+            utf8[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+            utf8[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+            utf8[3] = (char)(0x80 | (code & 0x3F));
+            bytes = 4;
+        }
+
+        // Escapes only produce whole characters
+        if(count + bytes < size)
+        {
+            memcpy(value + count, utf8, bytes);
+            count += bytes;
+        }
+    }
+
+    value[count] = '\0';
+    return true;
+
+}// jsonToString
+
+
+/*!
+ * Skip any JSON value, including objects and arrays
+ * \param json is the JSON text
+ * \param length is the number of characters of json
+ * \param index is the location in json, which is advanced past the value
+ * \param depth is the nesting depth of the value, which is limited to protect the stack
+ * \return true if the value was skipped
+ */
+bool jsonSkip(const char* json, int length, int* index, int depth)
+{
+    std::string_view text;
+    unsigned count = 0;
+    int next = 0;
+
+    jsonSpace(json, length, index);
+
+    if((*index >= length) || (depth > 64))
+        return false;
+
+    if(json[*index] == '"')
+        return jsonQuoted(json, length, index, &text);
+
+    if(json[*index] == '{')
+    {
+        (*index)++;
+        for(count = 0; (next = jsonNext(json, length, index, count, '}')) > 0; count++)
+        {
+            if(!jsonKey(json, length, index, &text) || !jsonSkip(json, length, index, depth + 1))
+                return false;
+        }
+
+        return (next == 0);
+    }
+
+    if(json[*index] == '[')
+    {
+        (*index)++;
+        for(count = 0; (next = jsonNext(json, length, index, count, ']')) > 0; count++)
+        {
+            if(!jsonSkip(json, length, index, depth + 1))
+                return false;
+        }
+
+        return (next == 0);
+    }
+
+    return !jsonToken(json, length, index).empty();
+
+}// jsonSkip)";
+
+}// ProtocolStructureModule::getJsonReadFunction
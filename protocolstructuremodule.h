@@ -10,7 +10,7 @@ class ProtocolStructureModule : public ProtocolStructure
 public:
 
     //! Construct the structure parsing object, with details about the overall protocol
-    ProtocolStructureModule(ProtocolParser* parse, ProtocolSupport supported);
+    ProtocolStructureModule(ProtocolParser* parse, const ProtocolSupport& supported);
 
     //! Parse a packet from the DOM
     void parse(bool nocode = false) override;
@@ -21,6 +21,12 @@ public:
     //! Destroy the protocol packet
     ~ProtocolStructureModule(void);
 
+    //! Set to true if the code outputs from a previous run are still valid
+    void setUnchanged(bool isunchanged) {unchanged = isunchanged;}
+
+    //! Return the path and name of every file this module can write to
+    std::vector<std::string> getFilePathsAndNames(void) const;
+
     //! Return the include directives needed for this encodable
     void getIncludeDirectives(std::vector<std::string>& list) const override;
 
@@ -39,6 +45,9 @@ public:
     //! Return the include directives needed for this encodable's print functions
     void getPrintIncludeDirectives(std::vector<std::string>& list) const override;
 
+    //! Return the include directives needed for this encodable's JSON functions
+    void getJsonIncludeDirectives(std::vector<std::string>& list) const override;
+
     //! Get the string which identifies this encodable in a CAN DBC file
     std::string getDBCMessageString(uint32_t ID) const;
 
@@ -114,8 +123,38 @@ public:
     //! Get the path of the source file that encompasses this structure map functions
     std::string getMapSourceFilePath(void) const {return (mapSource == nullptr) ? std::string() : mapSource->filePath();}
 
+    //! Get the name of the header file that encompasses this structure JSON functions
+    std::string getJsonHeaderFileName(void) const {return (jsonHeader == nullptr) ? std::string() : jsonHeader->fileName();}
+
+    //! Get the name of the source file that encompasses this structure JSON functions
+    std::string getJsonSourceFileName(void) const {return (jsonSource == nullptr) ? std::string() : jsonSource->fileName();}
+
+    //! Get the path of the header file that encompasses this structure JSON functions
+    std::string getJsonHeaderFilePath(void) const {return (jsonHeader == nullptr) ? std::string() : jsonHeader->filePath();}
+
+    //! Get the path of the source file that encompasses this structure JSON functions
+    std::string getJsonSourceFilePath(void) const {return (jsonSource == nullptr) ? std::string() : jsonSource->filePath();}
+
+    //! Return the name of the function which times the encode and decode of this structure
+    std::string getBenchFunctionName(void) const {return "bench" + typeName;}
+
+    //! Return the function which times the encode and decode of this structure, empty if it cannot be timed
+    virtual std::string getBenchFunctionBody(void) const;
+
+    //! Return the include directives needed by the bench function
+    void getBenchIncludeDirectives(std::vector<std::string>& list) const;
+
 protected:
 
+    //! Determine if the encode and decode of this structure can be timed
+    virtual bool isBenchable(void) const;
+
+    //! Return the signature of the bench function
+    std::string getBenchFunctionSignature(void) const;
+
+    //! Create the bench function from the statements that encode and decode this structure
+    std::string createBenchFunction(const std::string& kind, const std::string& locals, const std::string& encodecall, const std::string& decodecall, const std::string& length, const std::string& minlength, const std::string& maxlength) const;
+
     //! Setup the files, which accounts for all the ways the files can be organized for this structure.
     void setupFiles(std::string moduleName,
                     std::string defheadermodulename,
@@ -123,13 +162,14 @@ protected:
                     std::string comparemodulename,
                     std::string printmodulename,
                     std::string mapmodulename,
+                    std::string jsonmodulename,
                     bool forceStructureDeclaration = true, bool outputUtilities = true);
 
     //! Create utility functions for structure lengths
     std::string createUtilityFunctions(const std::string& spacing) const override;
 
     //! Issue warnings for the structure module.
-    void issueWarnings(const XMLAttribute* map);
+    void issueWarnings(const AttributeIndex& map);
 
     //! Write data to the source and header files to encode and decode this structure and all its children
     void createStructureFunctions(void);
@@ -143,12 +183,27 @@ protected:
     //! Write data to the source and header files for helper functions for this structure but not its children
     void createTopLevelStructureHelperFunctions(void);
 
+    //! Discard the contents of all files, so nothing is written to disk
+    void discardFiles(void);
+
+    //! Write a hash function to the source file, including the helper module it uses
+    void writeHashFunction(const std::string& function);
+
     //! Get the text used to print a formatted string function
     static std::string getToFormattedStringFunction(void);
 
-    //! Get the text used to extract text for text read functions
+    //! Get the text used to append numbers for text print functions
+    static std::string getAppendTextFunction(void);
+
+    //! Get the text used to index and extract text for text read functions
     static std::string getExtractTextFunction(void);
 
+    //! Get the text used to write JSON text for JSON encode functions
+    static std::string getJsonWriteFunction(void);
+
+    //! Get the text used to parse JSON text for JSON decode functions
+    static std::string getJsonReadFunction(void);
+
     // These files are always used
     ProtocolSourceFile source;          //!< The source file (*.c)
     ProtocolHeaderFile header;          //!< The header file (*.h)
@@ -163,6 +218,8 @@ protected:
     ProtocolHeaderFile _printHeader;    //!< Optional header file for print code (*.h)
     ProtocolSourceFile _mapSource;      //!< Optional source file for map code (*.cpp)
     ProtocolHeaderFile _mapHeader;      //!< Optional header file for map code (*.h)
+    ProtocolSourceFile _jsonSource;     //!< Optional source file for JSON code (*.cpp)
+    ProtocolHeaderFile _jsonHeader;     //!< Optional header file for JSON code (*.h)
 
     // These are the pointers that get aliased to the correct output file
     ProtocolHeaderFile* structHeader;   //!< Pointer to the header file for the structure definition
@@ -174,6 +231,10 @@ protected:
     ProtocolHeaderFile* printHeader;    //!< Pointer to the header file for print code (*.h)
     ProtocolSourceFile* mapSource;      //!< Pointer to the source file for map code (*.cpp)
     ProtocolHeaderFile* mapHeader;      //!< Pointer to the header file for map code (*.h)
+    ProtocolSourceFile* jsonSource;     //!< Pointer to the source file for JSON code (*.cpp)
+    ProtocolHeaderFile* jsonHeader;     //!< Pointer to the header file for JSON code (*.h)
+
+    bool unchanged;                     //!< True if the code outputs from a previous run are still valid
 };
 
 #endif // PROTOCOLSTRUCTUREMODULE_H
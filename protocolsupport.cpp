@@ -435,6 +435,13 @@ ProtocolSupport::ProtocolSupport() :
     compare(false),
     print(false),
     mapEncode(false),
+    stdMap(false),
+    json(false),
+    resumable(false),
+    delta(false),
+    hash(false),
+    encodedSize(false),
+    skip(false),
     showAllItems(false),
     omitIfHidden(false),
     packetStructureSuffix("PacketStructure"),
@@ -463,6 +470,7 @@ std::vector<std::string> ProtocolSupport::getAttriblist(void) const
     attribs.push_back("comparefile");
     attribs.push_back("printfile");
     attribs.push_back("mapfile");
+    attribs.push_back("jsonfile");
     attribs.push_back("prefix");
     attribs.push_back("prefixC");
     attribs.push_back("prefixCPP");
@@ -482,6 +490,13 @@ std::vector<std::string> ProtocolSupport::getAttriblist(void) const
     attribs.push_back("compare");
     attribs.push_back("print");
     attribs.push_back("map");
+    attribs.push_back("stdMap");
+    attribs.push_back("json");
+    attribs.push_back("resumable");
+    attribs.push_back("delta");
+    attribs.push_back("hash");
+    attribs.push_back("encodedSize");
+    attribs.push_back("skip");
     attribs.push_back("api");
     attribs.push_back("version");
     attribs.push_back("translate");
@@ -556,6 +571,27 @@ void ProtocolSupport::parse(const XMLAttribute* map)
     print = ProtocolParser::isFieldSet(ProtocolParser::getAttribute("print", map));
     mapEncode = ProtocolParser::isFieldSet(ProtocolParser::getAttribute("map", map));
 
+    // Global flag to output the map functions without Qt
+    stdMap = ProtocolParser::isFieldSet(ProtocolParser::getAttribute("stdMap", map));
+
+    // Global flag to output the JSON functions for all structures
+    json = ProtocolParser::isFieldSet(ProtocolParser::getAttribute("json", map));
+
+    // Global flag to output the resumable decoder of every packet
+    resumable = ProtocolParser::isFieldSet(ProtocolParser::getAttribute("resumable", map));
+
+    // Global flag to output the delta encoding of every packet
+    delta = ProtocolParser::isFieldSet(ProtocolParser::getAttribute("delta", map));
+
+    // Global flag to output the hash function of every structure
+    hash = ProtocolParser::isFieldSet(ProtocolParser::getAttribute("hash", map));
+
+    // Global flag to output the encoded size function of every structure
+    encodedSize = ProtocolParser::isFieldSet(ProtocolParser::getAttribute("encodedSize", map));
+
+    // Global flag to output the skip function of every structure
+    skip = ProtocolParser::isFieldSet(ProtocolParser::getAttribute("skip", map));
+
     // The global file names
     parseFileNames(map);
 
@@ -625,11 +661,68 @@ void ProtocolSupport::parseFileNames(const XMLAttribute* map)
     globalCompareName = ProtocolParser::getAttribute("comparefile", map);
     globalPrintName = ProtocolParser::getAttribute("printfile", map);
     globalMapName = ProtocolParser::getAttribute("mapfile", map);
+    globalJsonName = ProtocolParser::getAttribute("jsonfile", map);
 
     replaceinplace(globalFileName, ".");
     replaceinplace(globalVerifyName, ".");
     replaceinplace(globalCompareName, ".");
     replaceinplace(globalPrintName, ".");
     replaceinplace(globalMapName, ".");
+    replaceinplace(globalJsonName, ".");
 
 }// ProtocolSupport::parseFileNames
+
+
+/*!
+ * Get a text description of all the options in this support object. Two
+ * support objects with the same options will produce the same text, which is
+ * useful for determining if the options have changed.
+ * \return the text description of the options
+ */
+std::string ProtocolSupport::getOptionsText(void) const
+{
+    std::string text;
+
+    text += "language=" + std::to_string(language) + "\n";
+    text += "maxdatasize=" + std::to_string(maxdatasize) + "\n";
+    text += "int64=" + std::to_string(int64) + "\n";
+    text += "float64=" + std::to_string(float64) + "\n";
+    text += "specialFloat=" + std::to_string(specialFloat) + "\n";
+    text += "bitfield=" + std::to_string(bitfield) + "\n";
+    text += "longbitfield=" + std::to_string(longbitfield) + "\n";
+    text += "bitfieldtest=" + std::to_string(bitfieldtest) + "\n";
+    text += "bigendian=" + std::to_string(bigendian) + "\n";
+    text += "supportbool=" + std::to_string(supportbool) + "\n";
+    text += "limitonencode=" + std::to_string(limitonencode) + "\n";
+    text += "compare=" + std::to_string(compare) + "\n";
+    text += "print=" + std::to_string(print) + "\n";
+    text += "mapEncode=" + std::to_string(mapEncode) + "\n";
+    text += "stdMap=" + std::to_string(stdMap) + "\n";
+    text += "json=" + std::to_string(json) + "\n";
+    text += "resumable=" + std::to_string(resumable) + "\n";
+    text += "delta=" + std::to_string(delta) + "\n";
+    text += "hash=" + std::to_string(hash) + "\n";
+    text += "encodedSize=" + std::to_string(encodedSize) + "\n";
+    text += "skip=" + std::to_string(skip) + "\n";
+    text += "omitIfHidden=" + std::to_string(omitIfHidden) + "\n";
+    text += "api=" + api + "\n";
+    text += "version=" + version + "\n";
+    text += "globalFileName=" + globalFileName + "\n";
+    text += "globalVerifyName=" + globalVerifyName + "\n";
+    text += "globalCompareName=" + globalCompareName + "\n";
+    text += "globalPrintName=" + globalPrintName + "\n";
+    text += "globalMapName=" + globalMapName + "\n";
+    text += "globalJsonName=" + globalJsonName + "\n";
+    text += "outputpath=" + outputpath + "\n";
+    text += "packetStructureSuffix=" + packetStructureSuffix + "\n";
+    text += "packetParameterSuffix=" + packetParameterSuffix + "\n";
+    text += "protoName=" + protoName + "\n";
+    text += "prefix=" + prefix + "\n";
+    text += "typeSuffix=" + typeSuffix + "\n";
+    text += "pointerType=" + pointerType + "\n";
+    text += "licenseText=" + licenseText + "\n";
+    text += "globaltranslate=" + globaltranslate + "\n";
+
+    return text;
+
+}// ProtocolSupport::getOptionsText
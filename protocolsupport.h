@@ -72,6 +72,9 @@ public:
     //! Return the list of attributes understood by ProtocolSupport
     std::vector<std::string> getAttriblist(void) const;
 
+    //! Get a text description of all the options
+    std::string getOptionsText(void) const;
+
     //! The type of language being output
     typedef enum
     {
@@ -101,6 +104,13 @@ public:
     bool compare;                      //!< True if the compare function is output for all structures
     bool print;                        //!< True if the textPrint and textRead function is output for all structures
     bool mapEncode;                    //!< True if the mapEncode and mapDecode function is output for all structures
+    bool stdMap;                       //!< True if the map functions use the generated FieldMap instead of Qt
+    bool json;                         //!< True if the jsonEncode and jsonDecode functions are output for all structures
+    bool resumable;                    //!< True if a resumable decoder is output for all packets
+    bool delta;                        //!< True if the delta encoding is output for all packets
+    bool hash;                         //!< True if the hash function is output for all structures
+    bool encodedSize;                  //!< True if the encoded size function is output for all structures
+    bool skip;                         //!< True if the skip function is output for all structures
     bool showAllItems;                 //!< Generate documentation even for elements marked hidden
     bool omitIfHidden;                 //!< Omit code generation for items marked hidden
     std::string api;                   //!< The protocol API enumeration
@@ -110,6 +120,7 @@ public:
     std::string globalCompareName;     //!< Comparison file name to be used if a name is not given
     std::string globalPrintName;       //!< Print file name to be used if a name is not given
     std::string globalMapName;         //!< Map file name to be used if a name is not given
+    std::string globalJsonName;        //!< JSON file name to be used if a name is not given
     std::string outputpath;            //!< path to output files to
     std::string packetStructureSuffix; //!< Name to use at end of encode/decode Packet structure functions
     std::string packetParameterSuffix; //!< Name to use at end of encode/decode Packet parameter functions
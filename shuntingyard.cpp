@@ -2,6 +2,20 @@
 #include "protocolsupport.h"
 #include <math.h>
 #include <list>
+#include <unordered_map>
+
+namespace
+{
+    //! The result of computing one infix expression
+    struct CachedResult
+    {
+        double value;   //!< The computed value, 0 if the computation failed
+        bool ok;        //!< True if the computation succeeded
+    };
+
+    //! Results of computeInfix() keyed by the expression text
+    std::unordered_map<std::string, CachedResult> infixcache;
+}
 
 
 /*!
@@ -21,12 +35,41 @@ std::string& ShuntingYard::replacePie(std::string& input)
 
 /*!
  * Given a raw (untokenized) mathematical expression in infix notation, compute
- * the result. Allowable operators are " ( ) + - * / ^ ".
+ * the result. Allowable operators are " ( ) + - * / ^ ". The same expression
+ * text is computed many times during generation (array lengths, enumeration
+ * values, encoded lengths), so every result, including failures, is cached by
+ * the expression text and the expression is only parsed the first time.
  * \param infix is the infix expresions to compute
  * \param ok is set to true if the computation is good. ok can point to NULL.
  * \return the computational result, or 0 if the computation cannot be performed.
  */
 double ShuntingYard::computeInfix(const std::string& infix, bool* ok)
+{
+    std::unordered_map<std::string, CachedResult>::const_iterator it = infixcache.find(infix);
+
+    if(it == infixcache.end())
+    {
+        CachedResult result;
+        result.value = computeInfixUncached(infix, &result.ok);
+        it = infixcache.emplace(infix, result).first;
+    }
+
+    if(ok != 0)
+        *ok = it->second.ok;
+
+    return it->second.value;
+
+}// ShuntingYard::computeInfix
+
+
+/*!
+ * Given a raw (untokenized) mathematical expression in infix notation, compute
+ * the result without using the result cache.
+ * \param infix is the infix expresions to compute
+ * \param ok is set to true if the computation is good. ok can point to NULL.
+ * \return the computational result, or 0 if the computation cannot be performed.
+ */
+double ShuntingYard::computeInfixUncached(const std::string& infix, bool* ok)
 {
     bool inputok;
     std::string postfix = infixToPostfix(infix, &inputok);
@@ -31,9 +31,12 @@ class ShuntingYard
 {
 public:
 
-    //! Compute an infix expresions
+    //! Compute an infix expresions, using the result cache if possible
     static double computeInfix(const std::string& infix, bool* ok = nullptr);
 
+    //! Compute an infix expression without consulting the result cache
+    static double computeInfixUncached(const std::string& infix, bool* ok = nullptr);
+
     //! Convert an infix expression toa properly delimited postfix expression
     static std::string infixToPostfix(const std::string& infix, bool* ok = nullptr);
 